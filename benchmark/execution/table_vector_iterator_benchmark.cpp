@@ -0,0 +1,138 @@
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "catalog/catalog.h"
+#include "catalog/catalog_accessor.h"
+#include "common/scoped_timer.h"
+#include "execution/exec/execution_context.h"
+#include "execution/sql/memory_pool.h"
+#include "execution/sql/table_vector_iterator.h"
+#include "execution/sql/thread_state_container.h"
+#include "parser/expression/constant_value_expression.h"
+#include "storage/garbage_collector.h"
+#include "storage/sql_table.h"
+#include "tbb/task_scheduler_init.h"
+#include "transaction/deferred_action_manager.h"
+#include "transaction/transaction_manager.h"
+#include "transaction/transaction_util.h"
+#include "type/transient_value_factory.h"
+
+namespace terrier {
+
+// This benchmark measures the throughput of TableVectorIterator::ParallelScan on a table that spans many blocks, as
+// the number of threads available to the scan grows. The scan function only counts the tuples it sees, so this
+// measures the cost of the morsel-driven scan itself rather than any query processing on top of it.
+class TableVectorIteratorBenchmark : public benchmark::Fixture {
+ public:
+  void SetUp(const benchmark::State &state) final {
+    timestamp_manager_ = new transaction::TimestampManager;
+    deferred_action_manager_ = new transaction::DeferredActionManager(timestamp_manager_);
+    txn_manager_ = new transaction::TransactionManager(timestamp_manager_, deferred_action_manager_, &buffer_pool_,
+                                                       true, DISABLED);
+    gc_ = new storage::GarbageCollector(timestamp_manager_, deferred_action_manager_, txn_manager_, nullptr);
+    catalog_ = new catalog::Catalog(txn_manager_, &block_store_);
+
+    auto *txn = txn_manager_->BeginTransaction();
+    db_ = catalog_->CreateDatabase(txn, "terrier", true);
+    auto accessor = catalog_->GetAccessor(txn, db_);
+
+    // Create a table of two integer columns
+    std::vector<catalog::Schema::Column> cols;
+    cols.emplace_back("col_a", type::TypeId::INTEGER, false,
+                      parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type::TypeId::INTEGER)));
+    cols.emplace_back("col_b", type::TypeId::INTEGER, false,
+                      parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type::TypeId::INTEGER)));
+    table_oid_ = accessor->CreateTable(accessor->GetDefaultNamespace(), "scan_table", catalog::Schema(cols));
+    const auto &schema = accessor->GetSchema(table_oid_);
+    auto *table = new storage::SqlTable(&block_store_, schema);
+    accessor->SetTablePointer(table_oid_, table);
+
+    // Populate it
+    std::vector<catalog::col_oid_t> col_oids;
+    for (const auto &col : schema.GetColumns()) col_oids.emplace_back(col.Oid());
+    const auto initializer = table->InitializerForProjectedRow(col_oids);
+    for (uint32_t i = 0; i < num_tuples_; i++) {
+      auto *const redo = txn->StageWrite(db_, table_oid_, initializer);
+      *reinterpret_cast<int32_t *>(redo->Delta()->AccessForceNotNull(0)) = static_cast<int32_t>(i);
+      *reinterpret_cast<int32_t *>(redo->Delta()->AccessForceNotNull(1)) = static_cast<int32_t>(i);
+      table->Insert(txn, redo);
+    }
+    txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    gc_->PerformGarbageCollection();
+    gc_->PerformGarbageCollection();
+  }
+
+  void TearDown(const benchmark::State &state) final {
+    catalog_->TearDown();
+    gc_->PerformGarbageCollection();
+    gc_->PerformGarbageCollection();
+    gc_->PerformGarbageCollection();
+
+    delete catalog_;
+    delete gc_;
+    delete txn_manager_;
+    delete deferred_action_manager_;
+    delete timestamp_manager_;
+  }
+
+  // Workload
+  const uint32_t num_tuples_ = 10000000;
+
+  // Test infrastructure
+  storage::RecordBufferSegmentPool buffer_pool_{num_tuples_, num_tuples_};
+  storage::BlockStore block_store_{1000, 1000};
+  transaction::TimestampManager *timestamp_manager_;
+  transaction::DeferredActionManager *deferred_action_manager_;
+  transaction::TransactionManager *txn_manager_;
+  storage::GarbageCollector *gc_;
+  catalog::Catalog *catalog_;
+  catalog::db_oid_t db_;
+  catalog::table_oid_t table_oid_;
+};
+
+// Scan the whole table in parallel with the number of threads given as the benchmark argument
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(TableVectorIteratorBenchmark, ParallelScan)(benchmark::State &state) {
+  struct Counter {
+    uint32_t c_;
+  };
+  auto init_count = [](void *ctx, void *tls) { reinterpret_cast<Counter *>(tls)->c_ = 0; };
+  auto scanner = [](void *query_state, void *tls, execution::sql::TableVectorIterator *tvi) {
+    auto *counter = reinterpret_cast<Counter *>(tls);
+    while (tvi->Advance()) {
+      for (auto *pci = tvi->GetProjectedColumnsIterator(); pci->HasNext(); pci->Advance()) {
+        counter->c_++;
+      }
+    }
+  };
+
+  tbb::task_scheduler_init scheduler(static_cast<int>(state.range(0)));
+  std::array<uint32_t, 1> col_oids{1};
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    auto *txn = txn_manager_->BeginTransaction();
+    execution::exec::ExecutionContext exec_ctx(db_, txn, nullptr, nullptr, catalog_->GetAccessor(txn, db_));
+    execution::sql::ThreadStateContainer thread_state_container(exec_ctx.GetMemoryPool());
+    thread_state_container.Reset(sizeof(Counter), init_count, nullptr, nullptr);
+    uint64_t elapsed_ms;
+    {
+      common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
+      execution::sql::TableVectorIterator::ParallelScan(!table_oid_, col_oids.data(),
+                                                        static_cast<uint32_t>(col_oids.size()), nullptr, &exec_ctx,
+                                                        &thread_state_container, scanner);
+    }
+    txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    state.SetIterationTime(static_cast<double>(elapsed_ms) / 1000.0);
+  }
+  state.SetItemsProcessed(state.iterations() * num_tuples_);
+}
+
+BENCHMARK_REGISTER_F(TableVectorIteratorBenchmark, ParallelScan)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->UseManualTime()
+    ->RangeMultiplier(2)
+    ->Range(1, 32);
+}  // namespace terrier
@@ -1,9 +1,12 @@
 // Whether pin to core, only for GC now. TODO : discuss it later
 #define MY_PIN_TO_CORE
 
+#include <algorithm>
 #include <atomic>
+#include <cmath>
 #include <memory>
 #include <numeric>
+#include <random>
 #include <sched.h>
 #include <vector>
 
@@ -16,6 +19,7 @@
 #include "portable_endian/portable_endian.h"
 #include "storage/garbage_collector_thread.h"
 #include "storage/index/compact_ints_key.h"
+#include "storage/index/hash_index.h"
 #include "storage/index/index_builder.h"
 #include "storage/projected_row.h"
 #include "storage/sql_table.h"
@@ -849,4 +853,354 @@ namespace terrier {
     BENCHMARK_REGISTER_F(IndexBenchmark, RandomInsert)
             ->Unit(benchmark::kMillisecond)
             ->MinTime(1);
+
+    /*
+     * Compares the index types on inserts, point lookups, batched point lookups, short range scans and a mix of lookups
+     * and inserts over BIGINT keys. Every benchmark takes the storage::index::IndexType to run against as its
+     * argument.
+     */
+    class IndexTypeBenchmark : public benchmark::Fixture {
+    public:
+        const uint32_t num_keys_ = 1000000;
+        // Number of keys each range scan reads
+        const uint32_t scan_length_ = 16;
+        // Every lookup_ratio_-th operation of the mixed workload is an insert
+        const uint32_t lookup_ratio_ = 10;
+        // Number of keys each batched lookup probes, as many as an outer vector of a join holds
+        const uint32_t batch_size_ = common::Constants::K_DEFAULT_VECTOR_SIZE;
+        // Number of distinct keys the rows of the skewed workload share
+        const uint32_t num_skewed_keys_ = num_keys_ / 10;
+
+        std::default_random_engine generator_;
+        // Key i is stored in slots_[i], keys_ holds them in random order
+        std::vector<int64_t> keys_;
+        std::vector<storage::TupleSlot> slots_;
+
+        storage::BlockStore block_store_{10000, 10000};
+        storage::RecordBufferSegmentPool buffer_pool_{1000000, 1000000};
+        transaction::TimestampManager tm_manager_{};
+        transaction::DeferredActionManager da_manager_{&tm_manager_};
+        transaction::TransactionManager txn_manager_{&tm_manager_, &da_manager_, &buffer_pool_, true, nullptr};
+        storage::SqlTable *sql_table_;
+
+        void SetUp(const benchmark::State &state) final {
+            auto col = catalog::Schema::Column(
+                    "attribute", type::TypeId::BIGINT, false,
+                    parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type::TypeId::BIGINT)));
+            StorageTestUtil::ForceOid(&(col), catalog::col_oid_t(1));
+            sql_table_ = new storage::SqlTable(&block_store_, catalog::Schema({col}));
+            const auto tuple_initializer = sql_table_->InitializerForProjectedRow({catalog::col_oid_t(1)});
+
+            slots_.clear();
+            keys_.clear();
+            auto *const txn = txn_manager_.BeginTransaction();
+            for (uint32_t i = 0; i < num_keys_; i++) {
+                auto *const redo = txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID,
+                                                   tuple_initializer);
+                *reinterpret_cast<int64_t *>(redo->Delta()->AccessForceNotNull(0)) = i;
+                slots_.push_back(sql_table_->Insert(txn, redo));
+                keys_.push_back(i);
+            }
+            txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+            std::shuffle(keys_.begin(), keys_.end(), generator_);
+        }
+
+        void TearDown(const benchmark::State &state) final {
+            delete sql_table_;
+        }
+
+        storage::index::Index *IndexInit(storage::index::IndexType index_type) {
+            std::vector<catalog::IndexSchema::Column> keycols;
+            keycols.emplace_back(
+                    "", type::TypeId::BIGINT, false,
+                    parser::ColumnValueExpression(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID,
+                                                  catalog::col_oid_t(1)));
+            StorageTestUtil::ForceOid(&(keycols[0]), catalog::indexkeycol_oid_t(1));
+            catalog::IndexSchema schema(keycols, index_type, false, false, false, true);
+            return (storage::index::IndexBuilder().SetKeySchema(schema)).Build();
+        }
+
+        /*
+         * Draws a key for every row from a zipfian distribution over num_skewed_keys_ keys with parameter
+         * theta_percent / 100, so a few keys have many values and most have one or two
+         */
+        std::vector<int64_t> ZipfianRowKeys(const int64_t theta_percent) {
+            const double theta = static_cast<double>(theta_percent) / 100;
+            std::vector<double> weights(num_skewed_keys_);
+            for (uint32_t i = 0; i < num_skewed_keys_; i++) weights[i] = 1.0 / std::pow(i + 1, theta);
+            std::discrete_distribution<int64_t> zipfian(weights.begin(), weights.end());
+            std::vector<int64_t> row_keys(num_keys_);
+            for (auto &row_key : row_keys) row_key = zipfian(generator_);
+            return row_keys;
+        }
+
+        /*
+         * Inserts the keys keys_[begin, end) into the index
+         */
+        void IndexFill(storage::index::Index *index, transaction::TransactionContext *txn, storage::ProjectedRow *key,
+                       uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                *reinterpret_cast<int64_t *>(key->AccessForceNotNull(0)) = keys_[i];
+                index->Insert(txn, *key, slots_[keys_[i]]);
+            }
+        }
+    };
+
+    // NOLINTNEXTLINE
+    BENCHMARK_DEFINE_F(IndexTypeBenchmark, Insert)(benchmark::State &state) {
+        const auto index_type = static_cast<storage::index::IndexType>(state.range(0));
+        for (auto _ : state) {
+            state.PauseTiming();
+            auto *const index = IndexInit(index_type);
+            auto *const key_buffer =
+                    common::AllocationUtil::AllocateAligned(index->GetProjectedRowInitializer().ProjectedRowSize());
+            auto *const key = index->GetProjectedRowInitializer().InitializeRow(key_buffer);
+            auto *const txn = txn_manager_.BeginTransaction();
+            state.ResumeTiming();
+
+            IndexFill(index, txn, key, 0, num_keys_);
+
+            state.PauseTiming();
+            txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+            delete[] key_buffer;
+            delete index;
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(state.iterations() * num_keys_);
+    }
+
+    // NOLINTNEXTLINE
+    BENCHMARK_DEFINE_F(IndexTypeBenchmark, Lookup)(benchmark::State &state) {
+        auto *const index = IndexInit(static_cast<storage::index::IndexType>(state.range(0)));
+        auto *const key_buffer =
+                common::AllocationUtil::AllocateAligned(index->GetProjectedRowInitializer().ProjectedRowSize());
+        auto *const key = index->GetProjectedRowInitializer().InitializeRow(key_buffer);
+        auto *const txn = txn_manager_.BeginTransaction();
+        IndexFill(index, txn, key, 0, num_keys_);
+
+        std::vector<storage::TupleSlot> results;
+        for (auto _ : state) {
+            for (uint32_t i = 0; i < num_keys_; i++) {
+                *reinterpret_cast<int64_t *>(key->AccessForceNotNull(0)) = keys_[i];
+                index->ScanKey(*txn, *key, &results);
+                results.clear();
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * num_keys_);
+
+        txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+        delete[] key_buffer;
+        delete index;
+    }
+
+    // NOLINTNEXTLINE
+    BENCHMARK_DEFINE_F(IndexTypeBenchmark, LookupBatch)(benchmark::State &state) {
+        auto *const index = IndexInit(static_cast<storage::index::IndexType>(state.range(0)));
+        const auto key_size = index->GetProjectedRowInitializer().ProjectedRowSize();
+        auto *const txn = txn_manager_.BeginTransaction();
+        {
+            auto *const key_buffer = common::AllocationUtil::AllocateAligned(key_size);
+            IndexFill(index, txn, index->GetProjectedRowInitializer().InitializeRow(key_buffer), 0, num_keys_);
+            delete[] key_buffer;
+        }
+
+        // The same keys as Lookup, in batches
+        auto *const keys_buffer = common::AllocationUtil::AllocateAligned(key_size * batch_size_);
+        std::vector<storage::ProjectedRow *> batch_keys;
+        for (uint32_t i = 0; i < batch_size_; i++)
+            batch_keys.push_back(index->GetProjectedRowInitializer().InitializeRow(keys_buffer + i * key_size));
+
+        std::vector<const storage::ProjectedRow *> keys;
+        std::vector<storage::TupleSlot> results;
+        std::vector<uint32_t> offsets;
+        for (auto _ : state) {
+            for (uint32_t begin = 0; begin < num_keys_; begin += batch_size_) {
+                const uint32_t end = std::min(begin + batch_size_, num_keys_);
+                for (uint32_t i = begin; i < end; i++) {
+                    *reinterpret_cast<int64_t *>(batch_keys[i - begin]->AccessForceNotNull(0)) = keys_[i];
+                    keys.push_back(batch_keys[i - begin]);
+                }
+                index->ScanKeyBatch(*txn, keys, &results, &offsets);
+                keys.clear();
+                results.clear();
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * num_keys_);
+
+        txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+        delete[] keys_buffer;
+        delete index;
+    }
+
+    // NOLINTNEXTLINE
+    BENCHMARK_DEFINE_F(IndexTypeBenchmark, ScanAscending)(benchmark::State &state) {
+        auto *const index = IndexInit(static_cast<storage::index::IndexType>(state.range(0)));
+        auto *const low_key_buffer =
+                common::AllocationUtil::AllocateAligned(index->GetProjectedRowInitializer().ProjectedRowSize());
+        auto *const high_key_buffer =
+                common::AllocationUtil::AllocateAligned(index->GetProjectedRowInitializer().ProjectedRowSize());
+        auto *const low_key = index->GetProjectedRowInitializer().InitializeRow(low_key_buffer);
+        auto *const high_key = index->GetProjectedRowInitializer().InitializeRow(high_key_buffer);
+        auto *const txn = txn_manager_.BeginTransaction();
+        IndexFill(index, txn, low_key, 0, num_keys_);
+
+        const uint32_t num_scans = num_keys_ / scan_length_;
+        std::vector<storage::TupleSlot> results;
+        for (auto _ : state) {
+            for (uint32_t i = 0; i < num_scans; i++) {
+                *reinterpret_cast<int64_t *>(low_key->AccessForceNotNull(0)) = keys_[i];
+                *reinterpret_cast<int64_t *>(high_key->AccessForceNotNull(0)) = keys_[i] + scan_length_ - 1;
+                index->ScanAscending(*txn, *low_key, *high_key, &results);
+                results.clear();
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * num_scans);
+
+        txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+        delete[] low_key_buffer;
+        delete[] high_key_buffer;
+        delete index;
+    }
+
+    // NOLINTNEXTLINE
+    BENCHMARK_DEFINE_F(IndexTypeBenchmark, LookupInsertMix)(benchmark::State &state) {
+        const auto index_type = static_cast<storage::index::IndexType>(state.range(0));
+        // Half of the keys are loaded up front, the mix looks up those and inserts the other half
+        const uint32_t num_loaded = num_keys_ / 2;
+        const uint32_t num_ops = (num_keys_ - num_loaded) * lookup_ratio_;
+        std::uniform_int_distribution<uint32_t> loaded_dist(0, num_loaded - 1);
+        std::vector<uint32_t> lookups(num_ops);
+        for (auto &lookup : lookups) lookup = loaded_dist(generator_);
+
+        std::vector<storage::TupleSlot> results;
+        for (auto _ : state) {
+            state.PauseTiming();
+            auto *const index = IndexInit(index_type);
+            auto *const key_buffer =
+                    common::AllocationUtil::AllocateAligned(index->GetProjectedRowInitializer().ProjectedRowSize());
+            auto *const key = index->GetProjectedRowInitializer().InitializeRow(key_buffer);
+            auto *const txn = txn_manager_.BeginTransaction();
+            IndexFill(index, txn, key, 0, num_loaded);
+            state.ResumeTiming();
+
+            uint32_t next_insert = num_loaded;
+            for (uint32_t i = 0; i < num_ops; i++) {
+                if (i % lookup_ratio_ == 0) {
+                    IndexFill(index, txn, key, next_insert, next_insert + 1);
+                    next_insert++;
+                } else {
+                    *reinterpret_cast<int64_t *>(key->AccessForceNotNull(0)) = keys_[lookups[i]];
+                    index->ScanKey(*txn, *key, &results);
+                    results.clear();
+                }
+            }
+
+            state.PauseTiming();
+            txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+            delete[] key_buffer;
+            delete index;
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(state.iterations() * num_ops);
+    }
+
+    // NOLINTNEXTLINE
+    BENCHMARK_DEFINE_F(IndexTypeBenchmark, ZipfianLookup)(benchmark::State &state) {
+        // Lookups probe the keys of the rows, i.e. with the same skew
+        const std::vector<int64_t> row_keys = ZipfianRowKeys(state.range(0));
+
+        auto *const index = IndexInit(storage::index::IndexType::HASHMAP);
+        auto *const key_buffer =
+                common::AllocationUtil::AllocateAligned(index->GetProjectedRowInitializer().ProjectedRowSize());
+        auto *const key = index->GetProjectedRowInitializer().InitializeRow(key_buffer);
+        auto *const txn = txn_manager_.BeginTransaction();
+        for (uint32_t i = 0; i < num_keys_; i++) {
+            *reinterpret_cast<int64_t *>(key->AccessForceNotNull(0)) = row_keys[i];
+            index->Insert(txn, *key, slots_[i]);
+        }
+
+        std::vector<storage::TupleSlot> results;
+        for (auto _ : state) {
+            for (uint32_t i = 0; i < num_keys_; i++) {
+                *reinterpret_cast<int64_t *>(key->AccessForceNotNull(0)) = row_keys[keys_[i]];
+                index->ScanKey(*txn, *key, &results);
+                results.clear();
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * num_keys_);
+        // A BIGINT key is stored as HashKey<8>, see IndexBuilder
+        const auto heap_usage =
+                static_cast<storage::index::HashIndex<storage::index::HashKey<8>> *>(index)->GetHeapUsage();
+        state.counters["bytes_per_row"] = static_cast<double>(heap_usage) / num_keys_;
+
+        txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+        delete[] key_buffer;
+        delete index;
+    }
+
+    // NOLINTNEXTLINE
+    BENCHMARK_DEFINE_F(IndexTypeBenchmark, ZipfianDelete)(benchmark::State &state) {
+        const std::vector<int64_t> row_keys = ZipfianRowKeys(state.range(0));
+        for (auto _ : state) {
+            state.PauseTiming();
+            auto *const index = IndexInit(storage::index::IndexType::HASHMAP);
+            auto *const key_buffer =
+                    common::AllocationUtil::AllocateAligned(index->GetProjectedRowInitializer().ProjectedRowSize());
+            auto *const key = index->GetProjectedRowInitializer().InitializeRow(key_buffer);
+            // The rows go in in random order, so that the abort takes their values out of the keys in random order too
+            auto *const txn = txn_manager_.BeginTransaction();
+            for (uint32_t i = 0; i < num_keys_; i++) {
+                *reinterpret_cast<int64_t *>(key->AccessForceNotNull(0)) = row_keys[keys_[i]];
+                index->Insert(txn, *key, slots_[keys_[i]]);
+            }
+            state.ResumeTiming();
+
+            // Aborting removes every value it inserted from its key again, one at a time
+            txn_manager_.Abort(txn);
+
+            state.PauseTiming();
+            delete[] key_buffer;
+            delete index;
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(state.iterations() * num_keys_);
+    }
+
+    BENCHMARK_REGISTER_F(IndexTypeBenchmark, Insert)
+            ->Arg(static_cast<int64_t>(storage::index::IndexType::BWTREE))
+            ->Arg(static_cast<int64_t>(storage::index::IndexType::ART))
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+    BENCHMARK_REGISTER_F(IndexTypeBenchmark, Lookup)
+            ->Arg(static_cast<int64_t>(storage::index::IndexType::BWTREE))
+            ->Arg(static_cast<int64_t>(storage::index::IndexType::HASHMAP))
+            ->Arg(static_cast<int64_t>(storage::index::IndexType::ART))
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+    BENCHMARK_REGISTER_F(IndexTypeBenchmark, LookupBatch)
+            ->Arg(static_cast<int64_t>(storage::index::IndexType::BWTREE))
+            ->Arg(static_cast<int64_t>(storage::index::IndexType::HASHMAP))
+            ->Arg(static_cast<int64_t>(storage::index::IndexType::ART))
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+    BENCHMARK_REGISTER_F(IndexTypeBenchmark, ScanAscending)
+            ->Arg(static_cast<int64_t>(storage::index::IndexType::BWTREE))
+            ->Arg(static_cast<int64_t>(storage::index::IndexType::ART))
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+    BENCHMARK_REGISTER_F(IndexTypeBenchmark, LookupInsertMix)
+            ->Arg(static_cast<int64_t>(storage::index::IndexType::BWTREE))
+            ->Arg(static_cast<int64_t>(storage::index::IndexType::ART))
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+    BENCHMARK_REGISTER_F(IndexTypeBenchmark, ZipfianLookup)
+            ->Arg(50)
+            ->Arg(99)
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+    BENCHMARK_REGISTER_F(IndexTypeBenchmark, ZipfianDelete)
+            ->Arg(50)
+            ->Arg(99)
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
 }  // namespace terrier
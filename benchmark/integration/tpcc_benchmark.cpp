@@ -42,8 +42,10 @@ class TPCCBenchmark : public benchmark::Fixture {
   // Settings for log manager
   const uint64_t num_log_buffers_ = 100;
   const std::chrono::microseconds log_serialization_interval_{5};
+  const uint64_t num_log_serializer_threads_ = 1;
   const std::chrono::milliseconds log_persist_interval_{10};
   const uint64_t log_persist_threshold_ = (1U << 20U);  // 1MB
+  const bool log_group_commit_ = false;
 
   const bool only_count_new_order_ = false;  // TPC-C specification is to only measure throughput for New Order in final
                                              // result, but most academic papers use all txn types
@@ -162,7 +164,8 @@ BENCHMARK_DEFINE_F(TPCCBenchmark, ScaleFactor4WithLogging)(benchmark::State &sta
     unlink(LOG_FILE_NAME);
     // we need transactions, TPCC database, and GC
     log_manager_ = new storage::LogManager(LOG_FILE_NAME, num_log_buffers_, log_serialization_interval_,
-                                           log_persist_interval_, log_persist_threshold_, &buffer_pool_,
+                                           num_log_serializer_threads_, log_persist_interval_, log_persist_threshold_,
+                                           log_group_commit_, &buffer_pool_,
                                            common::ManagedPointer<common::DedicatedThreadRegistry>(&thread_registry_));
     log_manager_->Start();
     transaction::TimestampManager timestamp_manager;
@@ -0,0 +1,147 @@
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/scoped_timer.h"
+#include "storage/block_compactor.h"
+#include "storage/block_tiering_manager.h"
+#include "storage/garbage_collector.h"
+#include "transaction/deferred_action_manager.h"
+#include "util/storage_test_util.h"
+
+namespace terrier {
+// Freezes a dataset of num_blocks_ blocks, which is five times the memory budget of the tiering manager, so that most
+// of it has to be spilled to disk
+class BlockTieringBenchmark : public benchmark::Fixture {
+ protected:
+  storage::BlockStore block_store_{5000, 5000};
+  std::default_random_engine generator_;
+  storage::RecordBufferSegmentPool buffer_pool_{100000, 100000};
+  storage::BlockLayout layout_{{8, 8, VARLEN_COLUMN}};
+  storage::TupleAccessStrategy accessor_{layout_};
+
+  storage::DataTable table_{&block_store_, layout_, storage::layout_version_t(0)};
+  transaction::TimestampManager timestamp_manager_;
+  transaction::DeferredActionManager deferred_action_manager_{&timestamp_manager_};
+  transaction::TransactionManager txn_manager_{&timestamp_manager_, &deferred_action_manager_, &buffer_pool_, true,
+                                               DISABLED};
+  storage::GarbageCollector gc_{&timestamp_manager_, &deferred_action_manager_, &txn_manager_, nullptr};
+
+  uint32_t num_blocks_ = 500;
+  uint64_t memory_budget_ = num_blocks_ / 5 * common::Constants::BLOCK_SIZE;
+
+  std::vector<storage::RawBlock *> FreezeBlocks(storage::BlockCompactor *compactor) {
+    std::vector<storage::RawBlock *> blocks;
+    for (uint32_t i = 0; i < num_blocks_; i++) {
+      storage::RawBlock *block = block_store_.Get();
+      block->data_table_ = &table_;
+      StorageTestUtil::PopulateBlockRandomlyNoBookkeeping(&table_, block, 0.1, &generator_);
+      auto &arrow_metadata = accessor_.GetArrowBlockMetadata(block);
+      for (storage::col_id_t col_id : layout_.AllColumns()) {
+        if (layout_.IsVarlen(col_id))
+          arrow_metadata.GetColumnInfo(layout_, col_id).Type() = storage::ArrowColumnType::GATHERED_VARLEN;
+        else
+          arrow_metadata.GetColumnInfo(layout_, col_id).Type() = storage::ArrowColumnType::FIXED_LENGTH;
+      }
+      blocks.push_back(block);
+    }
+    for (storage::RawBlock *block : blocks) compactor->PutInQueue(block);
+    compactor->ProcessCompactionQueue(&deferred_action_manager_, &txn_manager_);
+    gc_.PerformGarbageCollection();
+    gc_.PerformGarbageCollection();
+    for (storage::RawBlock *block : blocks) compactor->PutInQueue(block);
+    compactor->ProcessCompactionQueue(&deferred_action_manager_, &txn_manager_);
+    return blocks;
+  }
+
+  // The tiering manager, if any, has to let go of the blocks before they go back to the block store
+  void ReleaseBlocks(const std::vector<storage::RawBlock *> &blocks,
+                     storage::BlockTieringManager *tiering_manager = nullptr) {
+    gc_.PerformGarbageCollection();
+    gc_.PerformGarbageCollection();
+    for (storage::RawBlock *block : blocks) {
+      if (tiering_manager != nullptr) tiering_manager->Untrack(block);
+      for (storage::col_id_t col_id : layout_.Varlens())
+        accessor_.GetArrowBlockMetadata(block).GetColumnInfo(layout_, col_id).Deallocate();
+      block_store_.Release(block);
+    }
+  }
+
+  // Sums up the first fixed-length column of every block in place, faulting spilled blocks back in
+  uint64_t Scan(const std::vector<storage::RawBlock *> &blocks) {
+    const storage::col_id_t col_id = layout_.AllColumns()[0];
+    uint64_t sum = 0;
+    for (storage::RawBlock *block : blocks) {
+      if (!table_.TryAcquireInPlaceRead(block)) continue;
+      const auto *values = reinterpret_cast<const uint64_t *>(table_.InPlaceColumnValues(block, col_id, 0));
+      const uint32_t num_records = table_.InPlaceNumRecords(block);
+      for (uint32_t i = 0; i < num_records; i++) sum += values[i];
+      table_.ReleaseInPlaceRead(block);
+    }
+    return sum;
+  }
+};
+
+// Spill frozen blocks until the rest fit in the memory budget
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(BlockTieringBenchmark, Spill)(benchmark::State &state) {
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    storage::BlockTieringManager tiering_manager("tiering_benchmark", memory_budget_);
+    storage::BlockCompactor compactor(&tiering_manager);
+    std::vector<storage::RawBlock *> blocks = FreezeBlocks(&compactor);
+    uint64_t elapsed_ms;
+    {
+      common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
+      tiering_manager.ProcessBlocks();
+    }
+    ReleaseBlocks(blocks, &tiering_manager);
+    state.SetIterationTime(static_cast<double>(elapsed_ms) / 1000.0);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>((num_blocks_ - num_blocks_ / 5) * state.iterations()));  // NOLINT
+}
+
+// Scan a dataset larger than the memory budget after spilling, so that most blocks fault back in from disk
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(BlockTieringBenchmark, ScanSpilled)(benchmark::State &state) {
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    storage::BlockTieringManager tiering_manager("tiering_benchmark", memory_budget_);
+    storage::BlockCompactor compactor(&tiering_manager);
+    std::vector<storage::RawBlock *> blocks = FreezeBlocks(&compactor);
+    tiering_manager.ProcessBlocks();
+    uint64_t elapsed_ms;
+    {
+      common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
+      benchmark::DoNotOptimize(Scan(blocks));
+    }
+    ReleaseBlocks(blocks, &tiering_manager);
+    state.SetIterationTime(static_cast<double>(elapsed_ms) / 1000.0);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(num_blocks_ * state.iterations()));  // NOLINT
+}
+
+// Scan the same dataset with every block in memory, for comparison
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(BlockTieringBenchmark, ScanResident)(benchmark::State &state) {
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    storage::BlockCompactor compactor;
+    std::vector<storage::RawBlock *> blocks = FreezeBlocks(&compactor);
+    uint64_t elapsed_ms;
+    {
+      common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
+      benchmark::DoNotOptimize(Scan(blocks));
+    }
+    ReleaseBlocks(blocks);
+    state.SetIterationTime(static_cast<double>(elapsed_ms) / 1000.0);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(num_blocks_ * state.iterations()));  // NOLINT
+}
+
+BENCHMARK_REGISTER_F(BlockTieringBenchmark, Spill)->Unit(benchmark::kMillisecond)->UseManualTime();
+
+BENCHMARK_REGISTER_F(BlockTieringBenchmark, ScanSpilled)->Unit(benchmark::kMillisecond)->UseManualTime();
+
+BENCHMARK_REGISTER_F(BlockTieringBenchmark, ScanResident)->Unit(benchmark::kMillisecond)->UseManualTime();
+}  // namespace terrier
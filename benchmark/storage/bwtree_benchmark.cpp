@@ -1,10 +1,18 @@
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "benchmark/benchmark.h"
+#include "catalog/index_schema.h"
 #include "common/scoped_timer.h"
+#include "ips4o/ips4o.hpp"
+#include "parser/expression/constant_value_expression.h"
+#include "storage/index/generic_key.h"
+#include "storage/index/index_metadata.h"
 #include "util/bwtree_test_util.h"
 #include "util/multithread_test_util.h"
+#include "util/storage_test_util.h"
 
 namespace terrier {
 
@@ -261,8 +269,34 @@ BENCHMARK_DEFINE_F(BwTreeBenchmark, SequentialInsertSequentialRead)(benchmark::S
   state.SetItemsProcessed(state.iterations() * num_keys_);
 }
 
+// Sort the same keys as RandomInsert and build the tree from them bottom-up, like an index created on a filled table
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(BwTreeBenchmark, RandomBulkLoad)(benchmark::State &state) {
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    auto *const tree = BwTreeTestUtil::GetEmptyTree();
+    std::vector<std::pair<int64_t, int64_t>> items;
+    items.reserve(num_keys_);
+    for (uint32_t i = 0; i < num_keys_; i++) items.emplace_back(key_permutation_[i], key_permutation_[i]);
+
+    uint64_t elapsed_ms;
+    {
+      common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
+      ips4o::sort(items.begin(), items.end(),
+                  [](const std::pair<int64_t, int64_t> &lhs, const std::pair<int64_t, int64_t> &rhs) {
+                    return lhs.first < rhs.first;
+                  });
+      tree->BulkLoad(items);
+    }
+    delete tree;
+    state.SetIterationTime(static_cast<double>(elapsed_ms) / 1000.0);
+  }
+  state.SetItemsProcessed(state.iterations() * num_keys_);
+}
+
 BENCHMARK_REGISTER_F(BwTreeBenchmark, RandomInsert)->Unit(benchmark::kMillisecond)->UseManualTime()->MinTime(3);
 BENCHMARK_REGISTER_F(BwTreeBenchmark, SequentialInsert)->Unit(benchmark::kMillisecond)->UseManualTime()->MinTime(3);
+BENCHMARK_REGISTER_F(BwTreeBenchmark, RandomBulkLoad)->Unit(benchmark::kMillisecond)->UseManualTime()->MinTime(3);
 BENCHMARK_REGISTER_F(BwTreeBenchmark, RandomInsertRandomRead)
     ->Unit(benchmark::kMillisecond)
     ->UseManualTime()
@@ -279,4 +313,179 @@ BENCHMARK_REGISTER_F(BwTreeBenchmark, SequentialInsertSequentialRead)
     ->Unit(benchmark::kMillisecond)
     ->UseManualTime()
     ->MinTime(3);
+
+// Composite keys of an INTEGER, a VARCHAR and a BIGINT, like a (district, customer name, order) index. The trees either
+// hold NormalizedGenericKeys, which compare through their normalized prefixes, or GenericKeys, which compare attribute
+// by attribute. The benchmarks take 0 for GenericKey and 1 for NormalizedGenericKey as their argument.
+class BwTreeCompositeKeyBenchmark : public benchmark::Fixture {
+ public:
+  using KeyType = storage::index::NormalizedGenericKey<128>;
+
+  using NormalizedTreeType = third_party::bwtree::BwTree<KeyType, storage::TupleSlot>;
+  // Inserting a NormalizedGenericKey into this tree slices it down to its GenericKey
+  using AttributeTreeType = third_party::bwtree::BwTree<storage::index::GenericKey<128>, storage::TupleSlot>;
+
+  void SetUp(const benchmark::State &state) final {
+    std::vector<catalog::IndexSchema::Column> key_cols;
+    key_cols.emplace_back("", type::TypeId::INTEGER, false,
+                          parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type::TypeId::INTEGER)));
+    StorageTestUtil::ForceOid(&(key_cols.back()), catalog::indexkeycol_oid_t(1));
+    key_cols.emplace_back("", type::TypeId::VARCHAR, 24, false,
+                          parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type::TypeId::VARCHAR)));
+    StorageTestUtil::ForceOid(&(key_cols.back()), catalog::indexkeycol_oid_t(2));
+    key_cols.emplace_back("", type::TypeId::BIGINT, false,
+                          parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type::TypeId::BIGINT)));
+    StorageTestUtil::ForceOid(&(key_cols.back()), catalog::indexkeycol_oid_t(3));
+    metadata_ = std::make_unique<storage::index::IndexMetadata>(
+        catalog::IndexSchema(key_cols, storage::index::IndexType::BWTREE, false, false, false, true));
+
+    const auto &initializer = metadata_->GetProjectedRowInitializer();
+    const auto &key_oid_to_offset = metadata_->GetKeyOidToOffsetMap();
+    auto *const pr_buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedRowSize());
+    auto *const pr = initializer.InitializeRow(pr_buffer);
+
+    // Few districts and names that only differ after a shared prefix, so that comparisons get past the first attribute
+    std::uniform_int_distribution<int32_t> district_dist(1, 10);
+    keys_.resize(num_keys_);
+    for (uint32_t i = 0; i < num_keys_; i++) {
+      const std::string name = "CUSTOMER#" + std::to_string(generator_() % (num_keys_ / 10));
+      *reinterpret_cast<int32_t *>(pr->AccessForceNotNull(key_oid_to_offset.at(catalog::indexkeycol_oid_t(1)))) =
+          district_dist(generator_);
+      const auto *const content = reinterpret_cast<const byte *>(name.data());
+      const auto size = static_cast<uint32_t>(name.size());
+      *reinterpret_cast<storage::VarlenEntry *>(
+          pr->AccessForceNotNull(key_oid_to_offset.at(catalog::indexkeycol_oid_t(2)))) =
+          size <= storage::VarlenEntry::InlineThreshold() ? storage::VarlenEntry::CreateInline(content, size)
+                                                          : storage::VarlenEntry::Create(content, size, false);
+      *reinterpret_cast<int64_t *>(pr->AccessForceNotNull(key_oid_to_offset.at(catalog::indexkeycol_oid_t(3)))) = i;
+      keys_[i].SetFromProjectedRow(*pr, *metadata_);
+    }
+    delete[] pr_buffer;
+  }
+
+  void TearDown(const benchmark::State &state) final {
+    keys_.clear();
+    metadata_.reset();
+  }
+
+  template <class TreeType>
+  void RandomInsert(benchmark::State *const state) {
+    common::WorkerPool thread_pool(num_threads_, {});
+    // NOLINTNEXTLINE
+    for (auto _ : *state) {
+      auto *const tree = new TreeType(false);
+
+      auto workload = [&](uint32_t id) {
+        const uint32_t gcid = id + 1;
+        tree->AssignGCID(gcid);
+
+        uint32_t start_key = num_keys_ / num_threads_ * id;
+        uint32_t end_key = start_key + num_keys_ / num_threads_;
+
+        for (uint32_t i = start_key; i < end_key; i++) {
+          tree->Insert(keys_[i], Slot(i));
+        }
+        tree->UnregisterThread(gcid);
+      };
+
+      uint64_t elapsed_ms;
+      tree->UpdateThreadLocal(num_threads_ + 1);
+      {
+        common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
+        MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads_, workload);
+      }
+      tree->UpdateThreadLocal(1);
+      delete tree;
+      state->SetIterationTime(static_cast<double>(elapsed_ms) / 1000.0);
+    }
+    state->SetItemsProcessed(state->iterations() * num_keys_);
+  }
+
+  template <class TreeType>
+  void RandomRead(benchmark::State *const state) {
+    common::WorkerPool thread_pool(num_threads_, {});
+    auto *const tree = new TreeType(false);
+    for (uint32_t i = 0; i < num_keys_; i++) {
+      tree->Insert(keys_[i], Slot(i));
+    }
+
+    // NOLINTNEXTLINE
+    for (auto _ : *state) {
+      auto workload = [&](uint32_t id) {
+        const uint32_t gcid = id + 1;
+        tree->AssignGCID(gcid);
+
+        uint32_t start_key = num_keys_ / num_threads_ * id;
+        uint32_t end_key = start_key + num_keys_ / num_threads_;
+
+        std::vector<storage::TupleSlot> values;
+        values.reserve(1);
+
+        for (uint32_t i = start_key; i < end_key; i++) {
+          tree->GetValue(keys_[i], values);
+          values.clear();
+        }
+        tree->UnregisterThread(gcid);
+      };
+
+      uint64_t elapsed_ms;
+      tree->UpdateThreadLocal(num_threads_ + 1);
+      {
+        common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
+        MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads_, workload);
+      }
+      tree->UpdateThreadLocal(1);
+      state->SetIterationTime(static_cast<double>(elapsed_ms) / 1000.0);
+    }
+
+    delete tree;
+    state->SetItemsProcessed(state->iterations() * num_keys_);
+  }
+
+  // Only compared for equality, never dereferenced
+  static storage::TupleSlot Slot(const uint32_t i) {
+    return storage::TupleSlot(reinterpret_cast<storage::RawBlock *>(static_cast<uintptr_t>(i / 1024 + 1) << 20U),
+                              i % 1024);
+  }
+
+  // Workload
+  const uint32_t num_keys_ = 1000000;
+  const uint32_t num_threads_ = 4;
+
+  // Test infrastructure
+  std::default_random_engine generator_;
+  std::unique_ptr<storage::index::IndexMetadata> metadata_;
+  std::vector<KeyType> keys_;
+};
+
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(BwTreeCompositeKeyBenchmark, RandomInsert)(benchmark::State &state) {
+  if (state.range(0) == 0) {
+    RandomInsert<AttributeTreeType>(&state);
+  } else {
+    RandomInsert<NormalizedTreeType>(&state);
+  }
+}
+
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(BwTreeCompositeKeyBenchmark, RandomRead)(benchmark::State &state) {
+  if (state.range(0) == 0) {
+    RandomRead<AttributeTreeType>(&state);
+  } else {
+    RandomRead<NormalizedTreeType>(&state);
+  }
+}
+
+BENCHMARK_REGISTER_F(BwTreeCompositeKeyBenchmark, RandomInsert)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime()
+    ->MinTime(3);
+BENCHMARK_REGISTER_F(BwTreeCompositeKeyBenchmark, RandomRead)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime()
+    ->MinTime(3);
 }  // namespace terrier
@@ -30,6 +30,13 @@ class DataTableBenchmark : public benchmark::Fixture {
     read_buffer_ = common::AllocationUtil::AllocateAligned(initializer_.ProjectedRowSize());
     read_ = initializer_.InitializeRow(read_buffer_);
 
+    // generate a ProjectedColumns buffer for each thread to Scan into
+    for (uint32_t i = 0; i < num_threads_; ++i) {
+      byte *scan_buffer = common::AllocationUtil::AllocateAligned(column_initializer_.ProjectedColumnsSize());
+      scan_buffers_.emplace_back(scan_buffer);
+      scans_.emplace_back(column_initializer_.Initialize(scan_buffer));
+    }
+
     // generate a vector of ProjectedRow buffers for concurrent reads
     for (uint32_t i = 0; i < num_threads_; ++i) {
       // Create read buffer
@@ -44,9 +51,12 @@ class DataTableBenchmark : public benchmark::Fixture {
     delete[] redo_buffer_;
     delete[] read_buffer_;
     for (uint32_t i = 0; i < num_threads_; ++i) delete[] read_buffers_[i];
+    for (uint32_t i = 0; i < num_threads_; ++i) delete[] scan_buffers_[i];
     // google benchmark might run benchmark several iterations. We need to clear vectors.
     read_buffers_.clear();
     reads_.clear();
+    scan_buffers_.clear();
+    scans_.clear();
   }
 
   // Tuple layout
@@ -56,6 +66,8 @@ class DataTableBenchmark : public benchmark::Fixture {
   // Tuple properties
   const storage::ProjectedRowInitializer initializer_ =
       storage::ProjectedRowInitializer::Create(layout_, StorageTestUtil::ProjectionListAllColumns(layout_));
+  const storage::ProjectedColumnsInitializer column_initializer_{
+      layout_, StorageTestUtil::ProjectionListAllColumns(layout_), common::Constants::K_DEFAULT_VECTOR_SIZE};
 
   // Workload
   const uint32_t num_inserts_ = 10000000;
@@ -66,6 +78,8 @@ class DataTableBenchmark : public benchmark::Fixture {
   // Test infrastructure
   std::default_random_engine generator_;
   storage::BlockStore block_store_{1000, 1000};
+  // Carves blocks out of pre-faulted 64 MB regions backed by 2 MB huge pages, local to the inserting thread's node
+  storage::BlockStore region_block_store_{1000, 1000, 64, 2, true, true};
   storage::RecordBufferSegmentPool buffer_pool_{num_inserts_, buffer_pool_reuse_limit_};
 
   // Insert buffer pointers
@@ -79,6 +93,24 @@ class DataTableBenchmark : public benchmark::Fixture {
   // Read buffers pointers for concurrent reads
   std::vector<byte *> read_buffers_;
   std::vector<storage::ProjectedRow *> reads_;
+
+  // Scan buffers pointers for concurrent scans
+  std::vector<byte *> scan_buffers_;
+  std::vector<storage::ProjectedColumns *> scans_;
+
+  // Scan the whole table once into the given buffer, returning the number of tuples seen
+  uint64_t ScanTable(const storage::DataTable &table, storage::ProjectedColumns *const buffer) {
+    // We can use dummy timestamps here since we're not invoking concurrency control
+    transaction::TransactionContext txn(transaction::timestamp_t(0), transaction::timestamp_t(0), &buffer_pool_,
+                                        DISABLED);
+    uint64_t num_scanned = 0;
+    auto it = table.begin();
+    while (it != table.end()) {
+      table.Scan(&txn, &it, buffer);
+      num_scanned += buffer->NumTuples();
+    }
+    return num_scanned;
+  }
 };
 
 // Insert the num_inserts_ of tuples into a DataTable in a single thread
@@ -106,6 +138,7 @@ BENCHMARK_DEFINE_F(DataTableBenchmark, SimpleInsert)(benchmark::State &state) {
 // Insert the num_inserts_ of tuples into a DataTable concurrently
 // NOLINTNEXTLINE
 BENCHMARK_DEFINE_F(DataTableBenchmark, ConcurrentInsert)(benchmark::State &state) {
+  const auto num_threads = static_cast<uint32_t>(state.range(0));
   // NOLINTNEXTLINE
   for (auto _ : state) {
     storage::DataTable table(&block_store_, layout_, storage::layout_version_t(0));
@@ -113,13 +146,41 @@ BENCHMARK_DEFINE_F(DataTableBenchmark, ConcurrentInsert)(benchmark::State &state
       // We can use dummy timestamps here since we're not invoking concurrency control
       transaction::TransactionContext txn(transaction::timestamp_t(0), transaction::timestamp_t(0), &buffer_pool_,
                                           DISABLED);
-      for (uint32_t i = 0; i < num_inserts_ / num_threads_; i++) table.Insert(&txn, *redo_);
+      for (uint32_t i = 0; i < num_inserts_ / num_threads; i++) table.Insert(&txn, *redo_);
     };
-    common::WorkerPool thread_pool(num_threads_, {});
+    common::WorkerPool thread_pool(num_threads, {});
     uint64_t elapsed_ms;
     {
       common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
-      for (uint32_t j = 0; j < num_threads_; j++) {
+      for (uint32_t j = 0; j < num_threads; j++) {
+        thread_pool.SubmitTask([j, &workload] { workload(j); });
+      }
+      thread_pool.WaitUntilAllFinished();
+    }
+    state.SetIterationTime(static_cast<double>(elapsed_ms) / 1000.0);
+  }
+  state.SetItemsProcessed(state.iterations() * num_inserts_);
+}
+
+// Insert the num_inserts_ of tuples into a DataTable concurrently, with blocks carved out of large memory regions
+// instead of being allocated one by one
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(DataTableBenchmark, ConcurrentInsertRegionAllocator)(benchmark::State &state) {
+  const auto num_threads = static_cast<uint32_t>(state.range(0));
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    storage::DataTable table(&region_block_store_, layout_, storage::layout_version_t(0));
+    auto workload = [&](uint32_t id) {
+      // We can use dummy timestamps here since we're not invoking concurrency control
+      transaction::TransactionContext txn(transaction::timestamp_t(0), transaction::timestamp_t(0), &buffer_pool_,
+                                          DISABLED);
+      for (uint32_t i = 0; i < num_inserts_ / num_threads; i++) table.Insert(&txn, *redo_);
+    };
+    common::WorkerPool thread_pool(num_threads, {});
+    uint64_t elapsed_ms;
+    {
+      common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
+      for (uint32_t j = 0; j < num_threads; j++) {
         thread_pool.SubmitTask([j, &workload] { workload(j); });
       }
       thread_pool.WaitUntilAllFinished();
@@ -220,12 +281,110 @@ BENCHMARK_DEFINE_F(DataTableBenchmark, ConcurrentRandomRead)(benchmark::State &s
   state.SetItemsProcessed(state.iterations() * num_reads_);
 }
 
+// Scan the num_reads_ of tuples sequentially from a DataTable in a single thread
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(DataTableBenchmark, Scan)(benchmark::State &state) {
+  storage::DataTable read_table(&block_store_, layout_, storage::layout_version_t(0));
+  // Populate read_table by inserting tuples
+  // We can use dummy timestamps here since we're not invoking concurrency control
+  transaction::TransactionContext txn(transaction::timestamp_t(0), transaction::timestamp_t(0), &buffer_pool_,
+                                      DISABLED);
+  for (uint32_t i = 0; i < num_reads_; ++i) {
+    read_table.Insert(&txn, *redo_);
+  }
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    ScanTable(read_table, scans_[0]);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_reads_);
+}
+
+// Scan the num_reads_ of tuples from a DataTable with every thread scanning the whole table concurrently
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(DataTableBenchmark, ConcurrentScan)(benchmark::State &state) {
+  storage::DataTable read_table(&block_store_, layout_, storage::layout_version_t(0));
+  // Populate read_table by inserting tuples
+  // We can use dummy timestamps here since we're not invoking concurrency control
+  transaction::TransactionContext txn(transaction::timestamp_t(0), transaction::timestamp_t(0), &buffer_pool_,
+                                      DISABLED);
+  for (uint32_t i = 0; i < num_reads_; ++i) {
+    read_table.Insert(&txn, *redo_);
+  }
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    auto workload = [&](uint32_t id) { ScanTable(read_table, scans_[id]); };
+    common::WorkerPool thread_pool(num_threads_, {});
+    uint64_t elapsed_ms;
+    {
+      common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
+      for (uint32_t j = 0; j < num_threads_; j++) {
+        thread_pool.SubmitTask([j, &workload] { workload(j); });
+      }
+      thread_pool.WaitUntilAllFinished();
+    }
+    state.SetIterationTime(static_cast<double>(elapsed_ms) / 1000.0);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_reads_ * num_threads_);
+}
+
+// Scan the num_reads_ of tuples from a DataTable with half of the threads, while the other half keep inserting into the
+// same table. Only the initially loaded tuples are counted per scanner, so this shows how much concurrent inserts slow
+// down scans.
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(DataTableBenchmark, ConcurrentScanInsert)(benchmark::State &state) {
+  const uint32_t num_scanners = num_threads_ / 2;
+  const uint32_t num_inserters = num_threads_ - num_scanners;
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    storage::DataTable table(&block_store_, layout_, storage::layout_version_t(0));
+    // Populate table by inserting tuples
+    // We can use dummy timestamps here since we're not invoking concurrency control
+    transaction::TransactionContext txn(transaction::timestamp_t(0), transaction::timestamp_t(0), &buffer_pool_,
+                                        DISABLED);
+    for (uint32_t i = 0; i < num_reads_; ++i) {
+      table.Insert(&txn, *redo_);
+    }
+    auto workload = [&](uint32_t id) {
+      if (id < num_scanners) {
+        ScanTable(table, scans_[id]);
+      } else {
+        transaction::TransactionContext insert_txn(transaction::timestamp_t(0), transaction::timestamp_t(0),
+                                                   &buffer_pool_, DISABLED);
+        for (uint32_t i = 0; i < num_inserts_ / num_inserters; i++) table.Insert(&insert_txn, *redo_);
+      }
+    };
+    common::WorkerPool thread_pool(num_threads_, {});
+    uint64_t elapsed_ms;
+    {
+      common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
+      for (uint32_t j = 0; j < num_threads_; j++) {
+        thread_pool.SubmitTask([j, &workload] { workload(j); });
+      }
+      thread_pool.WaitUntilAllFinished();
+    }
+    state.SetIterationTime(static_cast<double>(elapsed_ms) / 1000.0);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_reads_ * num_scanners);
+}
+
 BENCHMARK_REGISTER_F(DataTableBenchmark, SimpleInsert)->Unit(benchmark::kMillisecond)->UseManualTime();
 
 BENCHMARK_REGISTER_F(DataTableBenchmark, ConcurrentInsert)
     ->Unit(benchmark::kMillisecond)
     ->UseRealTime()
-    ->UseManualTime();
+    ->UseManualTime()
+    ->RangeMultiplier(2)
+    ->Range(1, 64);
+
+BENCHMARK_REGISTER_F(DataTableBenchmark, ConcurrentInsertRegionAllocator)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->UseManualTime()
+    ->RangeMultiplier(2)
+    ->Range(1, 64);
 
 BENCHMARK_REGISTER_F(DataTableBenchmark, SequentialRead)->Unit(benchmark::kMillisecond);
 
@@ -235,4 +394,16 @@ BENCHMARK_REGISTER_F(DataTableBenchmark, ConcurrentRandomRead)
     ->Unit(benchmark::kMillisecond)
     ->UseRealTime()
     ->UseManualTime();
+
+BENCHMARK_REGISTER_F(DataTableBenchmark, Scan)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_REGISTER_F(DataTableBenchmark, ConcurrentScan)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->UseManualTime();
+
+BENCHMARK_REGISTER_F(DataTableBenchmark, ConcurrentScanInsert)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->UseManualTime();
 }  // namespace terrier
@@ -51,15 +51,17 @@ class GarbageCollectorBenchmark : public benchmark::Fixture {
 };
 
 // Create a table with 100,000 tuples, then run 100,000 txns running update statements. Then run GC and profile how long
-// the unlinking stage takes for those txns
+// the unlinking stage takes for those txns with the given number of GC threads
 // NOLINTNEXTLINE
 BENCHMARK_DEFINE_F(GarbageCollectorBenchmark, UnlinkTime)(benchmark::State &state) {
+  const auto num_gc_threads = static_cast<uint32_t>(state.range(0));
   // NOLINTNEXTLINE
   for (auto _ : state) {
     // generate our table and instantiate GC
     LargeDataTableBenchmarkObject tested({8, 8, 8}, initial_table_size_, txn_length_, update_select_ratio_,
                                          &block_store_, &buffer_pool_, &generator_, true);
-    gc_ = new storage::GarbageCollector(tested.GetTimestampManager(), DISABLED, tested.GetTxnManager(), DISABLED);
+    gc_ = new storage::GarbageCollector(tested.GetTimestampManager(), DISABLED, tested.GetTxnManager(), DISABLED,
+                                        num_gc_threads);
 
     // clean up insert txn
     gc_->PerformGarbageCollection();
@@ -90,15 +92,17 @@ BENCHMARK_DEFINE_F(GarbageCollectorBenchmark, UnlinkTime)(benchmark::State &stat
 }
 
 // Create a table with 100,000 tuples, then run 100,000 txns running update statements. Then run GC and profile how long
-// the deallocation stage takes for those txns
+// the deallocation stage takes for those txns with the given number of GC threads
 // NOLINTNEXTLINE
 BENCHMARK_DEFINE_F(GarbageCollectorBenchmark, ReclaimTime)(benchmark::State &state) {
+  const auto num_gc_threads = static_cast<uint32_t>(state.range(0));
   // NOLINTNEXTLINE
   for (auto _ : state) {
     // generate our table and instantiate GC
     LargeDataTableBenchmarkObject tested({8, 8, 8}, initial_table_size_, txn_length_, update_select_ratio_,
                                          &block_store_, &buffer_pool_, &generator_, true);
-    gc_ = new storage::GarbageCollector(tested.GetTimestampManager(), DISABLED, tested.GetTxnManager(), DISABLED);
+    gc_ = new storage::GarbageCollector(tested.GetTimestampManager(), DISABLED, tested.GetTxnManager(), DISABLED,
+                                        num_gc_threads);
 
     // clean up insert txn
     gc_->PerformGarbageCollection();
@@ -151,11 +155,18 @@ BENCHMARK_DEFINE_F(GarbageCollectorBenchmark, HighContention)(benchmark::State &
   state.SetItemsProcessed(state.iterations() * num_txns_ - lag_count);
 }
 
-BENCHMARK_REGISTER_F(GarbageCollectorBenchmark, UnlinkTime)->Unit(benchmark::kMillisecond)->UseManualTime()->MinTime(1);
+BENCHMARK_REGISTER_F(GarbageCollectorBenchmark, UnlinkTime)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime()
+    ->MinTime(1)
+    ->RangeMultiplier(2)
+    ->Range(1, 16);
 BENCHMARK_REGISTER_F(GarbageCollectorBenchmark, ReclaimTime)
     ->Unit(benchmark::kMillisecond)
     ->UseManualTime()
-    ->MinTime(1);
+    ->MinTime(1)
+    ->RangeMultiplier(2)
+    ->Range(1, 16);
 BENCHMARK_REGISTER_F(GarbageCollectorBenchmark, HighContention)
     ->Unit(benchmark::kMillisecond)
     ->UseManualTime()
@@ -1,10 +1,14 @@
+#include <algorithm>
 #include <vector>
 #include "benchmark/benchmark.h"
 #include "common/scoped_timer.h"
+#include "common/worker_pool.h"
 #include "storage/garbage_collector_thread.h"
 #include "storage/storage_defs.h"
 #include "storage/write_ahead_log/log_manager.h"
+#include "util/catalog_test_util.h"
 #include "util/data_table_benchmark_util.h"
+#include "util/multithread_test_util.h"
 
 #define LOG_FILE_NAME "/mnt/ramdisk/benchmark.txt"
 
@@ -30,8 +34,23 @@ class LoggingBenchmark : public benchmark::Fixture {
   // Settings for log manager
   const uint64_t num_log_buffers_ = 100;
   const std::chrono::microseconds log_serialization_interval_{5};
+  const uint64_t num_log_serializer_threads_ = 1;
   const std::chrono::milliseconds log_persist_interval_{10};
   const uint64_t log_persist_threshold_ = (1U << 20U);  // 1MB
+  const bool log_group_commit_ = false;
+
+  // Remembers when a transaction asked to commit, so that its commit callback can tell how long the commit took
+  struct CommitLatencySample {
+    std::chrono::high_resolution_clock::time_point commit_start_;
+    uint64_t latency_us_;
+  };
+
+  static void RecordCommitLatency(void *arg) {
+    auto *sample = reinterpret_cast<CommitLatencySample *>(arg);
+    sample->latency_us_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                                    std::chrono::high_resolution_clock::now() - sample->commit_start_)
+                                                    .count());
+  }
 };
 
 /**
@@ -46,7 +65,8 @@ BENCHMARK_DEFINE_F(LoggingBenchmark, TPCCish)(benchmark::State &state) {
   for (auto _ : state) {
     unlink(LOG_FILE_NAME);
     log_manager_ = new storage::LogManager(LOG_FILE_NAME, num_log_buffers_, log_serialization_interval_,
-                                           log_persist_interval_, log_persist_threshold_, &buffer_pool_,
+                                           num_log_serializer_threads_, log_persist_interval_, log_persist_threshold_,
+                                           log_group_commit_, &buffer_pool_,
                                            common::ManagedPointer<common::DedicatedThreadRegistry>(&thread_registry_));
     log_manager_->Start();
     LargeDataTableBenchmarkObject tested(attr_sizes_, initial_table_size_, txn_length, insert_update_select_ratio,
@@ -85,7 +105,8 @@ BENCHMARK_DEFINE_F(LoggingBenchmark, HighAbortRate)(benchmark::State &state) {
     unlink(LOG_FILE_NAME);
     // use a smaller table to make aborts more likely
     log_manager_ = new storage::LogManager(LOG_FILE_NAME, num_log_buffers_, log_serialization_interval_,
-                                           log_persist_interval_, log_persist_threshold_, &buffer_pool_,
+                                           num_log_serializer_threads_, log_persist_interval_, log_persist_threshold_,
+                                           log_group_commit_, &buffer_pool_,
                                            common::ManagedPointer<common::DedicatedThreadRegistry>(&thread_registry_));
     log_manager_->Start();
     LargeDataTableBenchmarkObject tested(attr_sizes_, 1000, txn_length, insert_update_select_ratio, &block_store_,
@@ -123,7 +144,8 @@ BENCHMARK_DEFINE_F(LoggingBenchmark, SingleStatementInsert)(benchmark::State &st
   for (auto _ : state) {
     unlink(LOG_FILE_NAME);
     log_manager_ = new storage::LogManager(LOG_FILE_NAME, num_log_buffers_, log_serialization_interval_,
-                                           log_persist_interval_, log_persist_threshold_, &buffer_pool_,
+                                           num_log_serializer_threads_, log_persist_interval_, log_persist_threshold_,
+                                           log_group_commit_, &buffer_pool_,
                                            common::ManagedPointer<common::DedicatedThreadRegistry>(&thread_registry_));
     log_manager_->Start();
     LargeDataTableBenchmarkObject tested(attr_sizes_, 0, txn_length, insert_update_select_ratio, &block_store_,
@@ -161,7 +183,8 @@ BENCHMARK_DEFINE_F(LoggingBenchmark, SingleStatementUpdate)(benchmark::State &st
   for (auto _ : state) {
     unlink(LOG_FILE_NAME);
     log_manager_ = new storage::LogManager(LOG_FILE_NAME, num_log_buffers_, log_serialization_interval_,
-                                           log_persist_interval_, log_persist_threshold_, &buffer_pool_,
+                                           num_log_serializer_threads_, log_persist_interval_, log_persist_threshold_,
+                                           log_group_commit_, &buffer_pool_,
                                            common::ManagedPointer<common::DedicatedThreadRegistry>(&thread_registry_));
     log_manager_->Start();
     LargeDataTableBenchmarkObject tested(attr_sizes_, initial_table_size_, txn_length, insert_update_select_ratio,
@@ -199,7 +222,8 @@ BENCHMARK_DEFINE_F(LoggingBenchmark, SingleStatementSelect)(benchmark::State &st
   for (auto _ : state) {
     unlink(LOG_FILE_NAME);
     log_manager_ = new storage::LogManager(LOG_FILE_NAME, num_log_buffers_, log_serialization_interval_,
-                                           log_persist_interval_, log_persist_threshold_, &buffer_pool_,
+                                           num_log_serializer_threads_, log_persist_interval_, log_persist_threshold_,
+                                           log_group_commit_, &buffer_pool_,
                                            common::ManagedPointer<common::DedicatedThreadRegistry>(&thread_registry_));
     log_manager_->Start();
     LargeDataTableBenchmarkObject tested(attr_sizes_, initial_table_size_, txn_length, insert_update_select_ratio,
@@ -225,6 +249,76 @@ BENCHMARK_DEFINE_F(LoggingBenchmark, SingleStatementSelect)(benchmark::State &st
   state.SetItemsProcessed(state.iterations() * num_txns_ - abort_count);
 }
 
+/**
+ * Single statement insert transactions, reporting percentiles of the latency from asking to commit until the commit
+ * callback is invoked (i.e. the commit record is persisted). The argument selects the log I/O backend: 0 writes buffers
+ * out one by one and persists periodically, 1 does group commit.
+ */
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(LoggingBenchmark, CommitLatency)(benchmark::State &state) {
+  const bool group_commit = state.range(0) != 0;
+  const uint32_t txns_per_thread = num_txns_ / num_concurrent_txns_;
+  const storage::BlockLayout layout(attr_sizes_);
+  const storage::ProjectedRowInitializer initializer =
+      storage::ProjectedRowInitializer::Create(layout, StorageTestUtil::ProjectionListAllColumns(layout));
+  common::WorkerPool thread_pool(num_concurrent_txns_, {});
+  std::vector<uint64_t> latencies_us;
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    unlink(LOG_FILE_NAME);
+    log_manager_ = new storage::LogManager(LOG_FILE_NAME, num_log_buffers_, log_serialization_interval_,
+                                           num_log_serializer_threads_, log_persist_interval_, log_persist_threshold_,
+                                           group_commit, &buffer_pool_,
+                                           common::ManagedPointer<common::DedicatedThreadRegistry>(&thread_registry_));
+    log_manager_->Start();
+    {
+      storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+      transaction::TimestampManager timestamp_manager;
+      transaction::TransactionManager txn_manager(&timestamp_manager, DISABLED, &buffer_pool_, true, log_manager_);
+      gc_ = new storage::GarbageCollector(&timestamp_manager, DISABLED, &txn_manager, DISABLED);
+      gc_thread_ = new storage::GarbageCollectorThread(gc_, gc_period_);
+      std::vector<CommitLatencySample> samples(txns_per_thread * num_concurrent_txns_);
+
+      auto workload = [&](uint32_t id) {
+        std::default_random_engine thread_generator(id);
+        for (uint32_t i = 0; i < txns_per_thread; i++) {
+          auto *txn = txn_manager.BeginTransaction();
+          auto *redo = txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, initializer);
+          StorageTestUtil::PopulateRandomRow(redo->Delta(), layout, 0.0, &thread_generator);
+          redo->SetTupleSlot(table.Insert(txn, *(redo->Delta())));
+          CommitLatencySample *sample = &samples[id * txns_per_thread + i];
+          sample->commit_start_ = std::chrono::high_resolution_clock::now();
+          txn_manager.Commit(txn, RecordCommitLatency, sample);
+        }
+      };
+
+      uint64_t elapsed_ms;
+      {
+        common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
+        MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_concurrent_txns_, workload);
+        log_manager_->ForceFlush();
+      }
+      state.SetIterationTime(static_cast<double>(elapsed_ms) / 1000.0);
+      log_manager_->PersistAndStop();
+      delete log_manager_;
+      delete gc_thread_;
+      delete gc_;
+      for (const auto &sample : samples) latencies_us.push_back(sample.latency_us_);
+    }
+    unlink(LOG_FILE_NAME);
+  }
+
+  std::sort(latencies_us.begin(), latencies_us.end());
+  auto percentile = [&](double p) {
+    return static_cast<double>(latencies_us[static_cast<size_t>(p * static_cast<double>(latencies_us.size() - 1))]);
+  };
+  state.counters["p50_us"] = percentile(0.5);
+  state.counters["p99_us"] = percentile(0.99);
+  state.counters["p999_us"] = percentile(0.999);
+  state.counters["max_us"] = percentile(1.0);
+  state.SetItemsProcessed(state.iterations() * txns_per_thread * num_concurrent_txns_);
+}
+
 BENCHMARK_REGISTER_F(LoggingBenchmark, TPCCish)->Unit(benchmark::kMillisecond)->UseManualTime()->MinTime(3);
 
 BENCHMARK_REGISTER_F(LoggingBenchmark, HighAbortRate)->Unit(benchmark::kMillisecond)->UseManualTime()->MinTime(10);
@@ -243,4 +337,11 @@ BENCHMARK_REGISTER_F(LoggingBenchmark, SingleStatementSelect)
     ->Unit(benchmark::kMillisecond)
     ->UseManualTime()
     ->MinTime(1);
+
+BENCHMARK_REGISTER_F(LoggingBenchmark, CommitLatency)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime()
+    ->MinTime(3)
+    ->Arg(0)
+    ->Arg(1);
 }  // namespace terrier
@@ -0,0 +1,69 @@
+#include <vector>
+#include "benchmark/benchmark.h"
+#include "common/scoped_timer.h"
+#include "common/worker_pool.h"
+#include "storage/record_buffer.h"
+#include "storage/storage_defs.h"
+#include "util/multithread_test_util.h"
+
+namespace terrier {
+
+class ObjectPoolBenchmark : public benchmark::Fixture {
+ protected:
+  // Number of objects every thread holds on to at once, about as many buffer segments as a small transaction uses
+  const uint32_t batch_size_ = 4;
+  const uint32_t num_ops_ = 10000000;
+
+  // Gets and releases objects from a varying number of threads, each holding on to a few objects at a time
+  template <class Pool>
+  // NOLINTNEXTLINE
+  void RunGetRelease(benchmark::State &state, Pool *pool) {
+    const auto num_threads = static_cast<uint32_t>(state.range(0));
+    const uint32_t rounds_per_thread = num_ops_ / batch_size_ / num_threads;
+    common::WorkerPool thread_pool(num_threads, {});
+    auto workload = [&](uint32_t /*unused*/) {
+      std::vector<decltype(pool->Get())> objects(batch_size_);
+      for (uint32_t round = 0; round < rounds_per_thread; round++) {
+        for (auto &object : objects) object = pool->Get();
+        for (auto &object : objects) pool->Release(object);
+      }
+    };
+    // NOLINTNEXTLINE
+    for (auto _ : state) {
+      uint64_t elapsed_ms;
+      {
+        common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
+        MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, workload);
+      }
+      state.SetIterationTime(static_cast<double>(elapsed_ms) / 1000.0);
+    }
+    state.SetItemsProcessed(state.iterations() * rounds_per_thread * batch_size_ * num_threads);
+  }
+};
+
+// Get and release undo and redo buffer segments
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(ObjectPoolBenchmark, RecordBufferSegmentPool)(benchmark::State &state) {
+  storage::RecordBufferSegmentPool buffer_pool(1000000, 1000000);
+  RunGetRelease(state, &buffer_pool);
+}
+
+// Get and release blocks
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(ObjectPoolBenchmark, BlockStore)(benchmark::State &state) {
+  storage::BlockStore block_store(1000, 1000);
+  RunGetRelease(state, &block_store);
+}
+
+BENCHMARK_REGISTER_F(ObjectPoolBenchmark, RecordBufferSegmentPool)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime()
+    ->RangeMultiplier(2)
+    ->Range(1, 64);
+
+BENCHMARK_REGISTER_F(ObjectPoolBenchmark, BlockStore)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime()
+    ->RangeMultiplier(2)
+    ->Range(1, 64);
+}  // namespace terrier
@@ -31,11 +31,13 @@ class RecoveryBenchmark : public benchmark::Fixture {
   // Settings for log manager
   const uint64_t num_log_buffers_ = 100;
   const std::chrono::microseconds log_serialization_interval_{5};
+  const uint64_t num_log_serializer_threads_ = 1;
   const std::chrono::milliseconds log_persist_interval_{10};
   const uint64_t log_persist_threshold_ = (1u << 20u);  // 1MB
+  const bool log_group_commit_ = false;
 
   /**
-   * Runs the recovery benchmark with the provided config
+   * Runs the recovery benchmark with the provided config. The benchmark argument is the number of replay threads.
    * @param state benchmark state
    * @param config config to use for test object
    */
@@ -46,8 +48,8 @@ class RecoveryBenchmark : public benchmark::Fixture {
       unlink(LOG_FILE_NAME);
       // Initialize table and run workload with logging enabled
       storage::LogManager log_manager(LOG_FILE_NAME, num_log_buffers_, log_serialization_interval_,
-                                      log_persist_interval_, log_persist_threshold_, &buffer_pool_,
-                                      common::ManagedPointer(&thread_registry_));
+                                      num_log_serializer_threads_, log_persist_interval_, log_persist_threshold_,
+                                      log_group_commit_, &buffer_pool_, common::ManagedPointer(&thread_registry_));
       log_manager.Start();
 
       transaction::TimestampManager timestamp_manager;
@@ -77,9 +79,10 @@ class RecoveryBenchmark : public benchmark::Fixture {
 
       // Instantiate recovery manager, and recover the tables.
       storage::DiskLogProvider log_provider(LOG_FILE_NAME);
-      storage::RecoveryManager recovery_manager(&log_provider, common::ManagedPointer(&recovered_catalog),
-                                                &recovery_txn_manager, &recovery_deferred_action_manager,
-                                                common::ManagedPointer(&thread_registry_), &block_store_);
+      storage::RecoveryManager recovery_manager(
+          &log_provider, common::ManagedPointer(&recovered_catalog), &recovery_txn_manager,
+          &recovery_deferred_action_manager, common::ManagedPointer(&thread_registry_), &block_store_,
+          static_cast<uint32_t>(state->range(0)));
 
       uint64_t elapsed_ms;
       {
@@ -144,7 +147,7 @@ BENCHMARK_DEFINE_F(RecoveryBenchmark, HighStress)(benchmark::State &state) {
 
 /**
  * Similar to high-stress workload, blast a narrow table with inserts (1 statements per txn, 100% inserts), but also
- * recovery indexes built on the table
+ * recovery indexes built on the table. The indexes are unique, so parallel replay applies the table on a single worker.
  */
 // NOLINTNEXTLINE
 BENCHMARK_DEFINE_F(RecoveryBenchmark, IndexRecovery)(benchmark::State &state) {
@@ -158,8 +161,9 @@ BENCHMARK_DEFINE_F(RecoveryBenchmark, IndexRecovery)(benchmark::State &state) {
     // Blow away log file after every benchmark iteration
     unlink(LOG_FILE_NAME);
     // Initialize table and run workload with logging enabled
-    storage::LogManager log_manager(LOG_FILE_NAME, num_log_buffers_, log_serialization_interval_, log_persist_interval_,
-                                    log_persist_threshold_, &buffer_pool_, common::ManagedPointer(&thread_registry_));
+    storage::LogManager log_manager(LOG_FILE_NAME, num_log_buffers_, log_serialization_interval_,
+                                    num_log_serializer_threads_, log_persist_interval_, log_persist_threshold_,
+                                    log_group_commit_, &buffer_pool_, common::ManagedPointer(&thread_registry_));
     log_manager.Start();
 
     transaction::TimestampManager timestamp_manager;
@@ -234,7 +238,8 @@ BENCHMARK_DEFINE_F(RecoveryBenchmark, IndexRecovery)(benchmark::State &state) {
     storage::DiskLogProvider log_provider(LOG_FILE_NAME);
     storage::RecoveryManager recovery_manager(&log_provider, common::ManagedPointer(&recovered_catalog),
                                               &recovery_txn_manager, &recovery_deferred_action_manager,
-                                              common::ManagedPointer(&thread_registry_), &block_store_);
+                                              common::ManagedPointer(&thread_registry_), &block_store_,
+                                              static_cast<uint32_t>(state.range(0)));
 
     uint64_t elapsed_ms;
     {
@@ -259,10 +264,25 @@ BENCHMARK_DEFINE_F(RecoveryBenchmark, IndexRecovery)(benchmark::State &state) {
   state.SetItemsProcessed(num_txns_ * state.iterations());
 }
 
-BENCHMARK_REGISTER_F(RecoveryBenchmark, ReadWriteWorkload)->Unit(benchmark::kMillisecond)->UseManualTime()->MinTime(4);
-
-BENCHMARK_REGISTER_F(RecoveryBenchmark, HighStress)->Unit(benchmark::kMillisecond)->UseManualTime()->MinTime(4);
-
-BENCHMARK_REGISTER_F(RecoveryBenchmark, IndexRecovery)->Unit(benchmark::kMillisecond)->UseManualTime()->MinTime(4);
+BENCHMARK_REGISTER_F(RecoveryBenchmark, ReadWriteWorkload)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime()
+    ->MinTime(4)
+    ->RangeMultiplier(2)
+    ->Range(1, 8);
+
+BENCHMARK_REGISTER_F(RecoveryBenchmark, HighStress)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime()
+    ->MinTime(4)
+    ->RangeMultiplier(2)
+    ->Range(1, 8);
+
+BENCHMARK_REGISTER_F(RecoveryBenchmark, IndexRecovery)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime()
+    ->MinTime(4)
+    ->RangeMultiplier(2)
+    ->Range(1, 8);
 
 }  // namespace terrier
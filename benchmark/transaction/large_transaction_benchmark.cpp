@@ -1,8 +1,12 @@
 #include <vector>
 #include "benchmark/benchmark.h"
 #include "common/scoped_timer.h"
+#include "common/worker_pool.h"
 #include "storage/garbage_collector_thread.h"
+#include "transaction/deferred_action_manager.h"
+#include "transaction/transaction_util.h"
 #include "util/data_table_benchmark_util.h"
+#include "util/multithread_test_util.h"
 
 namespace terrier {
 
@@ -153,6 +157,43 @@ BENCHMARK_DEFINE_F(LargeTransactionBenchmark, SingleStatementSelect)(benchmark::
   state.SetItemsProcessed(state.iterations() * num_txns_ - abort_count);
 }
 
+/**
+ * Begin and commit empty transactions from a varying number of threads to measure how the begin/commit path scales.
+ * Nothing but transaction bookkeeping (the running txn set and the GC's completed txn queues) is exercised.
+ */
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(LargeTransactionBenchmark, BeginCommitScalability)(benchmark::State &state) {
+  const auto num_threads = static_cast<uint32_t>(state.range(0));
+  const uint32_t txns_per_thread = 1000000 / num_threads;
+  common::WorkerPool thread_pool(num_threads, {});
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    transaction::TimestampManager timestamp_manager;
+    transaction::DeferredActionManager deferred_action_manager(&timestamp_manager);
+    transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                                DISABLED);
+    gc_ = new storage::GarbageCollector(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+    gc_thread_ = new storage::GarbageCollectorThread(gc_, gc_period_);
+
+    auto workload = [&](uint32_t /*unused*/) {
+      for (uint32_t i = 0; i < txns_per_thread; i++) {
+        auto *txn = txn_manager.BeginTransaction();
+        txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+      }
+    };
+
+    uint64_t elapsed_ms;
+    {
+      common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
+      MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, workload);
+    }
+    state.SetIterationTime(static_cast<double>(elapsed_ms) / 1000.0);
+    delete gc_thread_;
+    delete gc_;
+  }
+  state.SetItemsProcessed(state.iterations() * txns_per_thread * num_threads);
+}
+
 BENCHMARK_REGISTER_F(LargeTransactionBenchmark, TPCCish)->Unit(benchmark::kMillisecond)->UseManualTime()->MinTime(3);
 
 BENCHMARK_REGISTER_F(LargeTransactionBenchmark, HighAbortRate)
@@ -174,4 +215,11 @@ BENCHMARK_REGISTER_F(LargeTransactionBenchmark, SingleStatementSelect)
     ->Unit(benchmark::kMillisecond)
     ->UseManualTime()
     ->MinTime(1);
+
+BENCHMARK_REGISTER_F(LargeTransactionBenchmark, BeginCommitScalability)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime()
+    ->MinTime(1)
+    ->RangeMultiplier(2)
+    ->Range(1, 64);
 }  // namespace terrier
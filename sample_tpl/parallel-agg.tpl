@@ -1,5 +1,4 @@
 // Perform parallel aggregation
-// This will be supported after the parallel scans are added
 
 struct State {
   table: AggregationHashTable
@@ -130,7 +129,10 @@ fun main(execCtx: *ExecutionContext) -> int {
   @tlsReset(&tls, @sizeOf(ThreadState_1), p1_worker_initThreadState, p1_worker_tearDownThreadState, execCtx)
 
   // Parallel Scan
-  @iterateTableParallel("test_1", &state, &tls, p1_worker)
+  var oids: [2]uint32
+  oids[0] = 1 // colA
+  oids[1] = 2 // colB
+  @iterateTableParallel("test_1", oids, &state, execCtx, &tls, p1_worker)
 
   // ---- Pipeline 1 End ---- // 
 
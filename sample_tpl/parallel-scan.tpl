@@ -1,5 +1,4 @@
 // Perform parallel scan
-// This is not yet supported with the current SQL table API.
 
 struct State {
 }
@@ -51,6 +50,8 @@ fun _1_pipelineWorker(query_state: *State, state: *ThreadState_1, tvi: *TableVec
 }
 
 fun main(execCtx: *ExecutionContext) -> int {
+  var state: State
+
   // Pipeline 1 - parallel scan table
 
   // First the thread state container
@@ -59,7 +60,9 @@ fun main(execCtx: *ExecutionContext) -> int {
   @tlsReset(&tls, @sizeOf(ThreadState_1), _1_pipelineWorker_InitThreadState, _1_pipelineWorker_TearDownThreadState, execCtx)
 
   // Now scan
-  @iterateTableParallel("test_1", &state, &tls, _1_pipelineWorker)
+  var oids: [1]uint32
+  oids[0] = 1 // colA
+  @iterateTableParallel("test_1", oids, &state, execCtx, &tls, _1_pipelineWorker)
 
   // Pipeline 2
 
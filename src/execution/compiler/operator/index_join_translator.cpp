@@ -124,6 +124,8 @@ void IndexJoinTranslator::FillKey(FunctionBuilder *builder) {
 
 void IndexJoinTranslator::GenForLoop(FunctionBuilder *builder) {
   // for (@indexIteratorScanKey(&index_iter); @indexIteratorAdvance(&index_iter);)
+  // TODO: The pipeline hands over one outer tuple at a time, so the index is probed one key at a time. Probing the keys
+  // of a whole outer vector through Index::ScanKeyBatch needs the translator to see the outer vector first.
   // Loop Initialization
   ast::Expr *scan_call = codegen_->IndexIteratorScanKey(index_iter_);
   ast::Stmt *loop_init = codegen_->MakeStmt(scan_call);
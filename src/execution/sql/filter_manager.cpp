@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <numeric>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -57,6 +58,41 @@ void FilterManager::InsertClauseFlavor(const FilterManager::MatchFn flavor) {
   clauses_.back().flavors_.push_back(flavor);
 }
 
+void FilterManager::InsertClausePredicate(const uint32_t col_idx, const type::TypeId type,
+                                          const ColumnPredicate::Op op, const int64_t val) {
+  TERRIER_ASSERT(!finalized_, "Cannot modify filter manager after finalization");
+  TERRIER_ASSERT(!clauses_.empty(), "Inserting predicate without clause");
+  // Zone maps hold values sign-extended from the width of the column, so the constant has to be as well
+  int64_t column_val;
+  switch (type) {
+    case type::TypeId::TINYINT:
+      column_val = static_cast<int8_t>(val);
+      break;
+    case type::TypeId::SMALLINT:
+      column_val = static_cast<int16_t>(val);
+      break;
+    case type::TypeId::INTEGER:
+    case type::TypeId::DATE:
+      column_val = static_cast<int32_t>(val);
+      break;
+    case type::TypeId::BIGINT:
+    case type::TypeId::TIMESTAMP:
+      column_val = val;
+      break;
+    default:
+      throw std::runtime_error("Predicate push down not supported on type");
+  }
+  clauses_.back().predicates_.push_back({col_idx, type, op, column_val});
+}
+
+std::vector<FilterManager::ColumnPredicate> FilterManager::GetPredicates() const {
+  // Clauses are conjunctive, so every tuple passing the filter satisfies the predicates of every clause
+  std::vector<ColumnPredicate> result;
+  for (const auto &clause : clauses_)
+    result.insert(result.end(), clause.predicates_.begin(), clause.predicates_.end());
+  return result;
+}
+
 void FilterManager::Finalize() {
   if (finalized_) {
     return;
@@ -1,4 +1,8 @@
 #include "execution/sql/projected_columns_iterator.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include "execution/util/bit_util.h"
 #include "execution/util/vector_util.h"
 #include "storage/projected_columns.h"
 #include "type/type_id.h"
@@ -15,7 +19,16 @@ ProjectedColumnsIterator::ProjectedColumnsIterator(storage::ProjectedColumns *pr
 }
 
 void ProjectedColumnsIterator::SetProjectedColumn(storage::ProjectedColumns *projected_column) {
+  const uint16_t num_cols = projected_column->NumColumns();
+  col_data_.resize(num_cols);
+  col_null_bitmaps_.resize(num_cols);
+  col_arrow_infos_.assign(num_cols, nullptr);
+  for (uint16_t col_idx = 0; col_idx < num_cols; col_idx++) {
+    col_data_[col_idx] = projected_column->ColumnStart(col_idx);
+    col_null_bitmaps_[col_idx] = projected_column->ColumnNullBitmap(col_idx);
+  }
   projected_column_ = projected_column;
+  in_place_ = false;
   num_selected_ = projected_column_->NumTuples();
   curr_idx_ = 0;
   selection_vector_[0] = K_INVALID_POS;
@@ -23,11 +36,29 @@ void ProjectedColumnsIterator::SetProjectedColumn(storage::ProjectedColumns *pro
   selection_vector_write_idx_ = 0;
 }
 
+void ProjectedColumnsIterator::SetInPlaceTuples(const uint32_t num_tuples, const uint16_t num_cols,
+                                                const uint32_t block_offset) {
+  TERRIER_ASSERT(num_tuples <= common::Constants::K_DEFAULT_VECTOR_SIZE, "Vector does not fit the selection vector");
+  // The column pointers are filled in by the caller through SetInPlaceColumn
+  col_data_.resize(num_cols);
+  col_null_bitmaps_.resize(num_cols);
+  col_arrow_infos_.resize(num_cols);
+  projected_column_ = nullptr;
+  in_place_ = true;
+  num_in_place_tuples_ = num_tuples;
+  in_place_block_offset_ = block_offset;
+  num_selected_ = num_tuples;
+  curr_idx_ = 0;
+  selection_vector_[0] = K_INVALID_POS;
+  selection_vector_read_idx_ = 0;
+  selection_vector_write_idx_ = 0;
+}
+
 template <typename T, template <typename> typename Op>
 uint32_t ProjectedColumnsIterator::FilterColByColImpl(const uint32_t col_idx_1, const uint32_t col_idx_2) {
   // Get the input column's data
-  const auto *input_1 = reinterpret_cast<const T *>(projected_column_->ColumnStart(static_cast<uint16_t>(col_idx_1)));
-  const auto *input_2 = reinterpret_cast<const T *>(projected_column_->ColumnStart(static_cast<uint16_t>(col_idx_2)));
+  const auto *input_1 = reinterpret_cast<const T *>(col_data_[col_idx_1]);
+  const auto *input_2 = reinterpret_cast<const T *>(col_data_[col_idx_2]);
 
   // Use the existing selection vector if this PCI has been filtered
   const uint32_t *sel_vec = (IsFiltered() ? selection_vector_ : nullptr);
@@ -51,7 +82,7 @@ uint32_t ProjectedColumnsIterator::FilterColByColImpl(const uint32_t col_idx_1,
 template <typename T, template <typename> typename Op>
 uint32_t ProjectedColumnsIterator::FilterColByValImpl(uint32_t col_idx, T val) {
   // Get the input column's data
-  const auto *input = reinterpret_cast<const T *>(projected_column_->ColumnStart(static_cast<uint16_t>(col_idx)));
+  const auto *input = reinterpret_cast<const T *>(col_data_[col_idx]);
 
   // Use the existing selection vector if this PCI has been filtered
   const uint32_t *sel_vec = (IsFiltered() ? selection_vector_ : nullptr);
@@ -111,6 +142,144 @@ uint32_t ProjectedColumnsIterator::FilterColByCol(const uint32_t col_idx_1, type
   }
 }
 
+namespace {
+// Compares two strings the same way the block compactor orders dictionary words (see storage::VarlenContentCompare),
+// returning a negative number, zero, or a positive number if lhs is smaller than, equal to, or greater than rhs
+int CompareStrings(const byte *const lhs, const uint32_t lhs_size, const byte *const rhs, const uint32_t rhs_size) {
+  const int res = std::memcmp(lhs, rhs, std::min(lhs_size, rhs_size));
+  if (res != 0) return res;
+  return lhs_size < rhs_size ? -1 : (lhs_size > rhs_size ? 1 : 0);
+}
+
+// Returns the range [lower, upper) of the codes in the sorted dictionary whose word equals val. If val is not in the
+// dictionary, the range is empty and lower is where val would be inserted.
+std::pair<uint32_t, uint32_t> FindDictionaryWord(const storage::ArrowVarlenColumn &dictionary,
+                                                 const storage::VarlenEntry &val) {
+  const uint32_t *const offsets = dictionary.Offsets();
+  const uint32_t num_words = dictionary.OffsetsLength() - 1;
+  // The code of the first word that is not smaller than val
+  uint32_t lo = 0, hi = num_words;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    const int cmp = CompareStrings(dictionary.Values() + offsets[mid], offsets[mid + 1] - offsets[mid], val.Content(),
+                                   val.Size());
+    if (cmp < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  // Dictionary words are unique, so at most one word can be equal to val
+  const bool found = lo < num_words && CompareStrings(dictionary.Values() + offsets[lo], offsets[lo + 1] - offsets[lo],
+                                                      val.Content(), val.Size()) == 0;
+  return {lo, found ? lo + 1 : lo};
+}
+}  // namespace
+
+uint32_t ProjectedColumnsIterator::FilterDictionaryCodes(const uint32_t col_idx, const uint32_t lo, const uint32_t hi,
+                                                         const uint32_t *const code_set) {
+  // The dictionary code of every tuple in the vector
+  const uint32_t *const codes = col_arrow_infos_[col_idx]->Indices() + in_place_block_offset_;
+
+  // The codes of NULLs mean nothing and may lie outside the code set, so NULLs are dropped before looking at codes
+  const common::RawBitmap *const null_bitmap = col_null_bitmaps_[col_idx];
+  const bool filtered = IsFiltered();
+  uint32_t num_present = 0;
+  for (uint32_t i = 0; i < num_selected_; i++) {
+    const uint32_t idx = filtered ? selection_vector_[i] : i;
+    selection_vector_[num_present] = idx;
+    num_present += static_cast<uint32_t>(null_bitmap->Test(idx));
+  }
+
+  // Filter on the codes!
+  selection_vector_write_idx_ =
+      code_set == nullptr
+          ? util::VectorUtil::FilterVectorByRange<uint32_t>(codes, num_present, lo, hi, selection_vector_,
+                                                            selection_vector_)
+          : util::VectorUtil::FilterVectorByCodeSet(codes, num_present, code_set, selection_vector_, selection_vector_);
+
+  ResetFiltered();
+  return NumSelected();
+}
+
+template <typename P>
+uint32_t ProjectedColumnsIterator::FilterStringValues(const uint32_t col_idx, const P &pred) {
+  const auto *const values = reinterpret_cast<const storage::VarlenEntry *>(col_data_[col_idx]);
+  const common::RawBitmap *const null_bitmap = col_null_bitmaps_[col_idx];
+
+  // Use the existing selection vector if this PCI has been filtered
+  const bool filtered = IsFiltered();
+
+  selection_vector_write_idx_ = 0;
+  for (uint32_t i = 0; i < num_selected_; i++) {
+    const uint32_t idx = filtered ? selection_vector_[i] : i;
+    const bool valid = null_bitmap->Test(idx) && pred(values[idx]);
+    selection_vector_[selection_vector_write_idx_] = idx;
+    selection_vector_write_idx_ += static_cast<uint32_t>(valid);
+  }
+
+  ResetFiltered();
+  return NumSelected();
+}
+
+template <template <typename> typename Op>
+uint32_t ProjectedColumnsIterator::FilterColByString(const uint32_t col_idx, const storage::VarlenEntry &val) {
+  if (!IsDictionaryCompressed(col_idx)) {
+    return FilterStringValues(col_idx, [&](const storage::VarlenEntry &entry) {
+      return Op<int>()(CompareStrings(entry.Content(), entry.Size(), val.Content(), val.Size()), 0);
+    });
+  }
+
+  // The dictionary is sorted, so the words satisfying the predicate form a range of codes around val's position.
+  storage::ArrowVarlenColumn &dictionary = col_arrow_infos_[col_idx]->VarlenColumn();
+  const uint32_t num_words = dictionary.OffsetsLength() - 1;
+  const auto [lower, upper] = FindDictionaryWord(dictionary, val);
+  if constexpr (std::is_same_v<Op<int>, std::equal_to<int>>) {
+    return FilterDictionaryCodes(col_idx, lower, upper, nullptr);
+  } else if constexpr (std::is_same_v<Op<int>, std::less<int>>) {  // NOLINT
+    return FilterDictionaryCodes(col_idx, 0, lower, nullptr);
+  } else if constexpr (std::is_same_v<Op<int>, std::less_equal<int>>) {  // NOLINT
+    return FilterDictionaryCodes(col_idx, 0, upper, nullptr);
+  } else if constexpr (std::is_same_v<Op<int>, std::greater<int>>) {  // NOLINT
+    return FilterDictionaryCodes(col_idx, upper, num_words, nullptr);
+  } else if constexpr (std::is_same_v<Op<int>, std::greater_equal<int>>) {  // NOLINT
+    return FilterDictionaryCodes(col_idx, lower, num_words, nullptr);
+  } else {  // NOLINT
+    static_assert(std::is_same_v<Op<int>, std::not_equal_to<int>>, "Unsupported string filter");
+    // Every code but val's
+    if (lower == upper) return FilterDictionaryCodes(col_idx, 0, num_words, nullptr);
+    std::unique_ptr<uint32_t[]> code_set(new uint32_t[util::BitUtil::Num32BitWordsFor(num_words)]);
+    util::BitUtil::Clear(code_set.get(), num_words);
+    for (uint32_t code = 0; code < num_words; code++) {
+      if (code != lower) util::BitUtil::Set(code_set.get(), code);
+    }
+    return FilterDictionaryCodes(col_idx, 0, 0, code_set.get());
+  }
+}
+
+uint32_t ProjectedColumnsIterator::FilterColInStrings(const uint32_t col_idx, const storage::VarlenEntry *const vals,
+                                                      const uint32_t num_vals) {
+  if (!IsDictionaryCompressed(col_idx)) {
+    return FilterStringValues(col_idx, [&](const storage::VarlenEntry &entry) {
+      for (uint32_t i = 0; i < num_vals; i++) {
+        if (CompareStrings(entry.Content(), entry.Size(), vals[i].Content(), vals[i].Size()) == 0) return true;
+      }
+      return false;
+    });
+  }
+
+  // Look up the code of every value in the list once, and then select the tuples carrying any of these codes
+  storage::ArrowVarlenColumn &dictionary = col_arrow_infos_[col_idx]->VarlenColumn();
+  const uint32_t num_words = dictionary.OffsetsLength() - 1;
+  std::unique_ptr<uint32_t[]> code_set(new uint32_t[util::BitUtil::Num32BitWordsFor(num_words)]);
+  util::BitUtil::Clear(code_set.get(), num_words);
+  for (uint32_t i = 0; i < num_vals; i++) {
+    const auto [lower, upper] = FindDictionaryWord(dictionary, vals[i]);
+    if (lower != upper) util::BitUtil::Set(code_set.get(), lower);
+  }
+  return FilterDictionaryCodes(col_idx, 0, 0, code_set.get());
+}
+
 template uint32_t ProjectedColumnsIterator::FilterColByVal<std::equal_to>(uint32_t, type::TypeId, FilterVal);
 template uint32_t ProjectedColumnsIterator::FilterColByVal<std::greater>(uint32_t, type::TypeId, FilterVal);
 template uint32_t ProjectedColumnsIterator::FilterColByVal<std::greater_equal>(uint32_t, type::TypeId, FilterVal);
@@ -128,5 +297,13 @@ template uint32_t ProjectedColumnsIterator::FilterColByCol<std::less_equal>(uint
                                                                             type::TypeId);
 template uint32_t ProjectedColumnsIterator::FilterColByCol<std::not_equal_to>(uint32_t, type::TypeId, uint32_t,
                                                                               type::TypeId);
+template uint32_t ProjectedColumnsIterator::FilterColByString<std::equal_to>(uint32_t, const storage::VarlenEntry &);
+template uint32_t ProjectedColumnsIterator::FilterColByString<std::greater>(uint32_t, const storage::VarlenEntry &);
+template uint32_t ProjectedColumnsIterator::FilterColByString<std::greater_equal>(uint32_t,
+                                                                                  const storage::VarlenEntry &);
+template uint32_t ProjectedColumnsIterator::FilterColByString<std::less>(uint32_t, const storage::VarlenEntry &);
+template uint32_t ProjectedColumnsIterator::FilterColByString<std::less_equal>(uint32_t, const storage::VarlenEntry &);
+template uint32_t ProjectedColumnsIterator::FilterColByString<std::not_equal_to>(uint32_t,
+                                                                                 const storage::VarlenEntry &);
 
 }  // namespace terrier::execution::sql
@@ -1,9 +1,12 @@
+#include <algorithm>
 #include <memory>
 #include <vector>
 
 #include "execution/exec/execution_context.h"
 #include "execution/sql/table_vector_iterator.h"
+#include "execution/sql/thread_state_container.h"
 #include "execution/util/timer.h"
+#include "loggers/execution_logger.h"
 #include "tbb/blocked_range.h"
 #include "tbb/parallel_for.h"
 #include "tbb/task_scheduler_init.h"
@@ -13,8 +16,17 @@ TableVectorIterator::TableVectorIterator(exec::ExecutionContext *exec_ctx, uint3
                                          uint32_t num_oids)
     : exec_ctx_(exec_ctx), table_oid_(table_oid), col_oids_(col_oids, col_oids + num_oids) {}
 
+TableVectorIterator::TableVectorIterator(exec::ExecutionContext *exec_ctx, uint32_t table_oid, uint32_t *col_oids,
+                                         uint32_t num_oids, uint32_t start_block_idx, uint32_t end_block_idx)
+    : exec_ctx_(exec_ctx),
+      table_oid_(table_oid),
+      col_oids_(col_oids, col_oids + num_oids),
+      start_block_idx_(start_block_idx),
+      end_block_idx_(end_block_idx) {}
+
 TableVectorIterator::~TableVectorIterator() {
-  exec_ctx_->GetMemoryPool()->Deallocate(buffer_, projected_columns_->Size());
+  ReleaseInPlaceBlock();
+  if (buffer_ != nullptr) exec_ctx_->GetMemoryPool()->Deallocate(buffer_, projected_columns_->Size());
 }
 
 bool TableVectorIterator::Init() {
@@ -30,32 +42,169 @@ bool TableVectorIterator::Init() {
   initialized_ = true;
 
   // Begin iterating
-  iter_ = std::make_unique<storage::DataTable::SlotIterator>(table_->begin());
+  Reset();
   return true;
 }
 
 bool TableVectorIterator::Advance() {
   if (!initialized_) return false;
-  // First check if the iterator ended.
-  if (*iter_ == table_->end()) {
-    return false;
+  // Keep handing out the frozen block being read in place until it is exhausted.
+  if (in_place_block_ != nullptr) {
+    if (AdvanceInPlace()) return true;
+    ReleaseInPlaceBlock();
+    *iter_ = table_->NextBlock(*iter_);
+  }
+
+  const storage::DataTable::SlotIterator end = end_iter_ == nullptr ? table_->end() : *end_iter_;
+  while (*iter_ != end) {
+    // Materialize the rest of the current block unless it is frozen and we are at its start. A vector never spans
+    // blocks, so that a following frozen block always starts a fresh vector and can be read in place.
+    storage::RawBlock *const block = (*iter_)->GetBlock();
+    if ((*iter_)->GetOffset() != 0 || !table_->TryAcquireInPlaceRead(block)) {
+      const storage::DataTable::SlotIterator block_end = end->GetBlock() == block ? end : table_->NextBlock(*iter_);
+      table_->RangeScan(exec_ctx_->GetTxn(), iter_.get(), block_end, projected_columns_);
+      pci_.SetProjectedColumn(projected_columns_);
+      return true;
+    }
+
+    // Otherwise, point the vectors straight at the block instead of copying its tuples out
+    if (!CanSkipInPlaceBlock(block)) {
+      in_place_block_ = block;
+      in_place_offset_ = 0;
+      in_place_num_records_ = table_->InPlaceNumRecords(block);
+      return Advance();
+    }
+
+    // None of the block's tuples can pass the filter, move on without looking at any of them
+    table_->ReleaseInPlaceRead(block);
+    *iter_ = table_->NextBlock(*iter_);
   }
-  // Scan the table to set the projected column.
-  table_->Scan(exec_ctx_->GetTxn(), iter_.get(), projected_columns_);
-  pci_.SetProjectedColumn(projected_columns_);
+  return false;
+}
+
+bool TableVectorIterator::AdvanceInPlace() {
+  if (in_place_offset_ == in_place_num_records_) return false;
+  // Vectors start at multiples of the vector size, so every column's null bitmap starts at a byte boundary.
+  const auto num_tuples = std::min(common::Constants::K_DEFAULT_VECTOR_SIZE, in_place_num_records_ - in_place_offset_);
+  const uint16_t num_cols = projected_columns_->NumColumns();
+  pci_.SetInPlaceTuples(num_tuples, num_cols, in_place_offset_);
+  for (uint16_t col_idx = 0; col_idx < num_cols; col_idx++) {
+    const storage::col_id_t col_id = projected_columns_->ColumnIds()[col_idx];
+    pci_.SetInPlaceColumn(col_idx, table_->InPlaceColumnValues(in_place_block_, col_id, in_place_offset_),
+                          table_->InPlaceColumnNullBitmap(in_place_block_, col_id, in_place_offset_),
+                          table_->InPlaceArrowColumnInfo(in_place_block_, col_id));
+  }
+  in_place_offset_ += num_tuples;
   return true;
 }
 
+void TableVectorIterator::PushDownFilter(const FilterManager &filter) {
+  const std::vector<FilterManager::ColumnPredicate> predicates = filter.GetPredicates();
+  pushed_down_predicates_.insert(pushed_down_predicates_.end(), predicates.begin(), predicates.end());
+}
+
+bool TableVectorIterator::CanSkipInPlaceBlock(storage::RawBlock *const block) const {
+  const uint32_t num_records = table_->InPlaceNumRecords(block);
+  for (const auto &predicate : pushed_down_predicates_) {
+    const storage::col_id_t col_id = projected_columns_->ColumnIds()[predicate.col_idx_];
+    // NULLs never pass a comparison, and the zone map of a column without any other value means nothing
+    if (table_->InPlaceNullCount(block, col_id) == num_records) return true;
+    const storage::ZoneMap &zone_map = table_->InPlaceArrowColumnInfo(block, col_id)->GetZoneMap();
+    if (!predicate.MayMatch(zone_map.min_, zone_map.max_)) return true;
+  }
+  return false;
+}
+
+void TableVectorIterator::ReleaseInPlaceBlock() {
+  if (in_place_block_ == nullptr) return;
+  table_->ReleaseInPlaceRead(in_place_block_);
+  in_place_block_ = nullptr;
+}
+
 void TableVectorIterator::Reset() {
   if (!initialized_) return;
-  iter_ = std::make_unique<storage::DataTable::SlotIterator>(table_->begin());
+  ReleaseInPlaceBlock();
+  iter_ = std::make_unique<storage::DataTable::SlotIterator>(table_->beginAt(start_block_idx_));
+  if (end_block_idx_ != K_END_OF_TABLE) {
+    end_iter_ = std::make_unique<storage::DataTable::SlotIterator>(table_->beginAt(end_block_idx_));
+  }
 }
 
-bool TableVectorIterator::ParallelScan(uint32_t db_oid, uint32_t table_oid, void *const query_state,
+namespace {
+
+/**
+ * A scan task over a morsel (range of blocks) of a table. Every invocation creates an iterator over its block range
+ * and hands it to the scan function along with the thread-local state of the thread running the task.
+ */
+class ScanTask {
+ public:
+  ScanTask(uint32_t table_oid, uint32_t *col_oids, uint32_t num_oids, void *const query_state,
+           exec::ExecutionContext *exec_ctx, ThreadStateContainer *const thread_states,
+           TableVectorIterator::ScanFn scanner)
+      : table_oid_(table_oid),
+        col_oids_(col_oids),
+        num_oids_(num_oids),
+        query_state_(query_state),
+        exec_ctx_(exec_ctx),
+        thread_states_(thread_states),
+        scanner_(scanner) {}
+
+  void operator()(const tbb::blocked_range<uint32_t> &block_range) const {
+    // Create the iterator over the specified block range
+    TableVectorIterator iter(exec_ctx_, table_oid_, col_oids_, num_oids_, block_range.begin(), block_range.end());
+
+    // Initialize it
+    if (!iter.Init()) {
+      return;
+    }
+
+    // Pull out the thread-local state
+    byte *const thread_state = thread_states_->AccessThreadStateOfCurrentThread();
+
+    // Call scanning function
+    scanner_(query_state_, thread_state, &iter);
+  }
+
+ private:
+  uint32_t table_oid_;
+  uint32_t *col_oids_;
+  uint32_t num_oids_;
+  void *const query_state_;
+  exec::ExecutionContext *exec_ctx_;
+  ThreadStateContainer *const thread_states_;
+  TableVectorIterator::ScanFn scanner_;
+};
+
+}  // namespace
+
+bool TableVectorIterator::ParallelScan(uint32_t table_oid, uint32_t *col_oids, uint32_t num_oids,
+                                       void *const query_state, exec::ExecutionContext *exec_ctx,
                                        ThreadStateContainer *const thread_states, const ScanFn scan_fn,
                                        const uint32_t min_grain_size) {
-  // TODO(Amadou): Implement Me!!
-  return false;
+  // Lookup table
+  const auto table = exec_ctx->GetAccessor()->GetTable(catalog::table_oid_t{table_oid});
+  if (table == nullptr) {
+    return false;
+  }
+
+  // Time
+  util::Timer<std::milli> timer;
+  timer.Start();
+
+  // Execute parallel scan. Blocks inserted after this point are not visible to the calling transaction anyway, so
+  // it is safe to only partition the blocks present now.
+  const uint32_t num_blocks = table->GetNumBlocks();
+  tbb::task_scheduler_init scan_scheduler;
+  tbb::blocked_range<uint32_t> block_range(0, num_blocks, min_grain_size);
+  tbb::parallel_for(block_range,
+                    ScanTask(table_oid, col_oids, num_oids, query_state, exec_ctx, thread_states, scan_fn));
+
+  timer.Stop();
+
+  double bps = num_blocks / (timer.Elapsed() / 1000.0);
+  EXECUTION_LOG_DEBUG("Scanned {} blocks ({} ms) @ {:.2f} blocks/sec", num_blocks, timer.Elapsed(), bps);
+
+  return true;
 }
 
 }  // namespace terrier::execution::sql
@@ -559,7 +559,25 @@ void BytecodeGenerator::VisitBuiltinTableIterCall(ast::CallExpr *call, ast::Buil
 }
 
 void BytecodeGenerator::VisitBuiltinTableIterParallelCall(ast::CallExpr *call) {
-  UNREACHABLE("Parallel scan is not implemented yet!");
+  // The first argument is the table name
+  ast::Identifier table_name = call->Arguments()[0]->As<ast::LitExpr>()->RawStringVal();
+  auto ns_oid = exec_ctx_->GetAccessor()->GetDefaultNamespace();
+  auto table_oid = exec_ctx_->GetAccessor()->GetTableOid(ns_oid, table_name.Data());
+  TERRIER_ASSERT(table_oid != terrier::catalog::INVALID_TABLE_OID, "Table does not exists");
+  // The second argument is the array of oids
+  auto *arr_type = call->Arguments()[1]->GetType()->As<ast::ArrayType>();
+  LocalVar col_oids = VisitExpressionForLValue(call->Arguments()[1]);
+  // The third argument is the opaque query state
+  LocalVar query_state = VisitExpressionForRValue(call->Arguments()[2]);
+  // The fourth argument is the execution context
+  LocalVar exec_ctx = VisitExpressionForRValue(call->Arguments()[3]);
+  // The fifth argument is the thread state container
+  LocalVar thread_states = VisitExpressionForRValue(call->Arguments()[4]);
+  // The sixth argument is the scan function as an identifier
+  FunctionId scan_fn = LookupFuncIdByName(call->Arguments()[5]->As<ast::IdentifierExpr>()->Name().Data());
+  // Emit the scan
+  Emitter()->EmitParallelTableScan(!table_oid, col_oids, static_cast<uint32_t>(arr_type->Length()), query_state,
+                                   exec_ctx, thread_states, scan_fn);
 }
 
 void BytecodeGenerator::VisitBuiltinPCICall(ast::CallExpr *call, ast::Builtin builtin) {
@@ -346,6 +346,7 @@ class DatabaseCatalog {
 
   friend class Catalog;
   friend class postgres::Builder;
+  friend class storage::CheckpointManager;
   friend class storage::RecoveryManager;
 
   /**
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <queue>
 #include <string>
 #include <utility>
 #include "common/allocator.h"
+#include "common/constants.h"
 #include "common/container/concurrent_queue.h"
 #include "common/spin_latch.h"
 #include "common/strong_typedef.h"
@@ -60,6 +64,14 @@ class AllocatorFailureException : public std::exception {
  *         control over. The returned pointer will be eventually freed with the
  *         supplied Delete method, but its memory location will potentially be
  *         handed out multiple times before that happens.
+ *
+ * Reusable objects are kept in a shared queue behind a latch, and in front of it in small per-thread caches
+ * (magazines). Threads get and release objects from their own magazine, and only go to the shared queue to refill an
+ * empty magazine or hand back half of a full one, a batch of objects at a time. Only the shared queue is held to the
+ * reuse limit, so that getting and releasing objects through a magazine touches nothing other threads write to. To
+ * bound the objects cached on top of the limit, a magazine holds at most reuse_limit / NUM_MAGAZINES objects, which
+ * means the pool keeps at most twice as many reusable objects as the reuse limit. A thread that would hit the size
+ * limit takes the objects cached in the magazines of other threads first.
  */
 template <typename T, class Allocator = ByteAlignedAllocator<T>>
 class ObjectPool {
@@ -74,7 +86,25 @@ class ObjectPool {
    * @param reuse_limit the maximum number of reusable objects
    */
   BOOST_DI_INJECT(ObjectPool, (named = SIZE_LIMIT) uint64_t size_limit, (named = REUSE_LIMIT) uint64_t reuse_limit)
-      : size_limit_(size_limit), reuse_limit_(reuse_limit), current_size_(0) {}
+      : magazine_capacity_(MagazineCapacity(reuse_limit)),
+        reuse_limit_(reuse_limit),
+        size_limit_(size_limit),
+        current_size_(0) {}
+
+  /**
+   * Initializes a new object pool with the supplied limits, whose allocator is constructed from the given arguments.
+   *
+   * @param size_limit the maximum number of objects the object pool controls
+   * @param reuse_limit the maximum number of reusable objects
+   * @param allocator_args arguments to construct the allocator with
+   */
+  template <typename... AllocatorArgs>
+  ObjectPool(uint64_t size_limit, uint64_t reuse_limit, AllocatorArgs &&... allocator_args)
+      : alloc_(std::forward<AllocatorArgs>(allocator_args)...),
+        magazine_capacity_(MagazineCapacity(reuse_limit)),
+        reuse_limit_(reuse_limit),
+        size_limit_(size_limit),
+        current_size_(0) {}
 
   /**
    * Destructs the memory pool. Frees any memory it holds.
@@ -89,6 +119,8 @@ class ObjectPool {
       alloc_.Delete(result);
       reuse_queue_.pop();
     }
+    for (Magazine &magazine : magazines_)
+      for (uint32_t i = 0; i < magazine.size_; i++) alloc_.Delete(magazine.objects_[i]);
   }
 
   /**
@@ -98,21 +130,35 @@ class ObjectPool {
    * @return pointer to memory that can hold T
    */
   T *Get() {
+    Magazine &magazine = magazines_[ThreadMagazine()];
+    {
+      SpinLatch::ScopedSpinLatch guard(&magazine.latch_);
+      if (magazine.size_ > 0) return Reuse(magazine.objects_[--magazine.size_]);
+    }
     SpinLatch::ScopedSpinLatch guard(&latch_);
-    if (reuse_queue_.empty() && current_size_ >= size_limit_) throw NoMoreObjectException(size_limit_);
-    T *result = nullptr;
+    // Objects cached by other threads are still reusable, so take them before giving up
+    if (reuse_queue_.empty() && current_size_ >= size_limit_) DrainMagazines();
     if (reuse_queue_.empty()) {
-      result = alloc_.New();  // result could be null because the allocator may not find enough memory space
-      if (result != nullptr) current_size_++;
-    } else {
-      result = reuse_queue_.front();
-      reuse_queue_.pop();
-      alloc_.Reuse(result);
+      if (current_size_ >= size_limit_) throw NoMoreObjectException(size_limit_);
+      T *result = alloc_.New();  // result could be null because the allocator may not find enough memory space
+      // If result is nullptr. The call to alloc_.New() failed (i.e. can't allocate more memory from the system).
+      if (result == nullptr) throw AllocatorFailureException();
+      current_size_++;
+      TERRIER_ASSERT(current_size_ <= size_limit_, "Object pool has exceeded its size limit.");
+      return result;
+    }
+    T *result = reuse_queue_.front();
+    reuse_queue_.pop();
+    // Refill the magazine halfway, so that the next few calls from this thread do not have to come back here
+    {
+      SpinLatch::ScopedSpinLatch magazine_guard(&magazine.latch_);
+      const uint32_t refill_size = magazine_capacity_.load(std::memory_order_relaxed) / 2;
+      while (magazine.size_ < refill_size && !reuse_queue_.empty()) {
+        magazine.objects_[magazine.size_++] = reuse_queue_.front();
+        reuse_queue_.pop();
+      }
     }
-    // If result is nullptr. The call to alloc_.New() failed (i.e. can't allocate more memory from the system).
-    if (result == nullptr) throw AllocatorFailureException();
-    TERRIER_ASSERT(current_size_ <= size_limit_, "Object pool has exceeded its size limit.");
-    return result;
+    return Reuse(result);
   }
 
   /**
@@ -153,8 +199,11 @@ class ObjectPool {
   void SetReuseLimit(uint64_t new_reuse_limit) {
     SpinLatch::ScopedSpinLatch guard(&latch_);
     reuse_limit_ = new_reuse_limit;
+    // Magazines are emptied after their capacity changes, so none of them holds more than the new capacity afterwards
+    magazine_capacity_.store(MagazineCapacity(new_reuse_limit), std::memory_order_relaxed);
+    DrainMagazines();
     T *obj = nullptr;
-    while (reuse_queue_.size() > reuse_limit_) {
+    while (reuse_queue_.size() > new_reuse_limit) {
       obj = reuse_queue_.front();
       alloc_.Delete(obj);
       reuse_queue_.pop();
@@ -171,12 +220,36 @@ class ObjectPool {
    */
   void Release(T *obj) {
     TERRIER_ASSERT(obj != nullptr, "releasing a null pointer");
+    Magazine &magazine = magazines_[ThreadMagazine()];
+    std::array<T *, MAGAZINE_CAPACITY + 1> overflow;
+    uint32_t num_overflow = 0;
+    {
+      SpinLatch::ScopedSpinLatch guard(&magazine.latch_);
+      const uint32_t capacity = magazine_capacity_.load(std::memory_order_relaxed);
+      if (magazine.size_ < capacity) {
+        magazine.objects_[magazine.size_++] = obj;
+        return;
+      }
+      // Hand the least recently released half back to the shared queue for other threads to reuse
+      num_overflow = (magazine.size_ + 1) / 2;
+      std::copy(magazine.objects_.begin(), magazine.objects_.begin() + num_overflow, overflow.begin());
+      std::copy(magazine.objects_.begin() + num_overflow, magazine.objects_.begin() + magazine.size_,
+                magazine.objects_.begin());
+      magazine.size_ -= num_overflow;
+      // Without magazines, the object goes straight to the shared queue
+      if (magazine.size_ < capacity)
+        magazine.objects_[magazine.size_++] = obj;
+      else
+        overflow[num_overflow++] = obj;
+    }
     SpinLatch::ScopedSpinLatch guard(&latch_);
-    if (reuse_queue_.size() >= reuse_limit_) {
-      alloc_.Delete(obj);
-      current_size_--;
-    } else {
-      reuse_queue_.push(obj);
+    for (uint32_t i = 0; i < num_overflow; i++) {
+      if (reuse_queue_.size() < reuse_limit_) {
+        reuse_queue_.push(overflow[i]);
+      } else {
+        alloc_.Delete(overflow[i]);
+        current_size_--;
+      }
     }
   }
 
@@ -186,15 +259,55 @@ class ObjectPool {
   uint64_t GetSizeLimit() const { return size_limit_; }
 
  private:
+  // Number of objects a magazine holds at most. A magazine trades half of that with the shared queue at a time.
+  static constexpr uint32_t MAGAZINE_CAPACITY = 32;
+  // Number of magazines per pool. Threads share a magazine only if there are more of them than magazines.
+  static constexpr uint32_t NUM_MAGAZINES = 64;
+
+  struct alignas(Constants::CACHELINE_SIZE) Magazine {
+    SpinLatch latch_;
+    uint32_t size_ = 0;
+    std::array<T *, MAGAZINE_CAPACITY> objects_;
+  };
+
+  static uint32_t ThreadMagazine() {
+    static std::atomic<uint32_t> next_magazine{0};
+    thread_local const uint32_t magazine = next_magazine.fetch_add(1) % NUM_MAGAZINES;
+    return magazine;
+  }
+
+  // Capacity of every magazine for the given reuse limit, so that all magazines together hold at most that many objects
+  static uint32_t MagazineCapacity(const uint64_t reuse_limit) {
+    return static_cast<uint32_t>(std::min<uint64_t>(MAGAZINE_CAPACITY, reuse_limit / NUM_MAGAZINES));
+  }
+
+  T *Reuse(T *const obj) {
+    alloc_.Reuse(obj);
+    return obj;
+  }
+
+  // Moves the objects cached in every magazine to the shared queue. Must hold latch_.
+  void DrainMagazines() {
+    for (Magazine &magazine : magazines_) {
+      SpinLatch::ScopedSpinLatch guard(&magazine.latch_);
+      for (uint32_t i = 0; i < magazine.size_; i++) reuse_queue_.push(magazine.objects_[i]);
+      magazine.size_ = 0;
+    }
+  }
+
   Allocator alloc_;
+  std::array<Magazine, NUM_MAGAZINES> magazines_;
+  // the number of objects a magazine may hold, only changed by SetReuseLimit
+  std::atomic<uint32_t> magazine_capacity_;
+  // Protects the members below
   SpinLatch latch_;
+  uint64_t reuse_limit_;  // the maximum number of reusable objects in reuse_queue_
   // TODO(yangjuns): We don't need to reuse objects in a FIFO pattern. We could potentially pass a second template
   // parameter to define the backing container for the std::queue. That way we can measure each backing container.
   std::queue<T *> reuse_queue_;
-  uint64_t size_limit_;   // the maximum number of objects a object pool can have
-  uint64_t reuse_limit_;  // the maximum number of reusable objects in reuse_queue
+  uint64_t size_limit_;  // the maximum number of objects a object pool can have
   // current_size_ represents the number of objects the object pool has allocated,
-  // including objects that have been given out to callers and those reside in reuse_queue
+  // including objects that have been given out to callers and those reside in reuse_queue or magazines
   uint64_t current_size_;
 };
 }  // namespace terrier::common
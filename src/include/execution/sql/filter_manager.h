@@ -7,6 +7,7 @@
 #include "common/macros.h"
 #include "execution/bandit/policy.h"
 #include "execution/util/execution_common.h"
+#include "type/type_id.h"
 
 namespace terrier::execution::sql {
 
@@ -24,6 +25,56 @@ class EXPORT FilterManager {
    */
   using MatchFn = uint32_t (*)(ProjectedColumnsIterator *);
 
+  /**
+   * A comparison between a column of the scanned table and a constant. A clause can promise that every tuple it lets
+   * through satisfies such comparisons, which lets scans skip frozen blocks whose zone maps rule out a match.
+   */
+  struct ColumnPredicate {
+    /**
+     * Comparison operators
+     */
+    enum class Op : uint8_t { Equal, GreaterThan, GreaterThanEqual, LessThan, LessThanEqual };
+
+    /**
+     * index of the column in the scan's projection
+     */
+    uint32_t col_idx_;
+    /**
+     * type of the column, an integer, date or timestamp type
+     */
+    type::TypeId type_;
+    /**
+     * how the column is compared to the constant
+     */
+    Op op_;
+    /**
+     * the constant, truncated to the width of the column's type
+     */
+    int64_t val_;
+
+    /**
+     * @param min smallest non-NULL value of the column in some set of tuples
+     * @param max largest non-NULL value of the column in the same set of tuples
+     * @return false if no value in [min, max] can satisfy the predicate
+     */
+    bool MayMatch(const int64_t min, const int64_t max) const {
+      switch (op_) {
+        case Op::Equal:
+          return min <= val_ && val_ <= max;
+        case Op::GreaterThan:
+          return max > val_;
+        case Op::GreaterThanEqual:
+          return max >= val_;
+        case Op::LessThan:
+          return min < val_;
+        case Op::LessThanEqual:
+          return min <= val_;
+        default:
+          UNREACHABLE("Impossible comparison operator");
+      }
+    }
+  };
+
   /**
    * A clause in a multi-clause filter. Clauses come in multiple flavors.
    * Flavors are logically equivalent, but may differ in implementation, and
@@ -35,6 +86,11 @@ class EXPORT FilterManager {
      */
     std::vector<MatchFn> flavors_;
 
+    /**
+     * comparisons every tuple passing the clause satisfies, if any are known
+     */
+    std::vector<ColumnPredicate> predicates_;
+
     /**
      * Return the number of flavors
      */
@@ -68,6 +124,21 @@ class EXPORT FilterManager {
    */
   void InsertClauseFlavor(FilterManager::MatchFn flavor);
 
+  /**
+   * Promise that every tuple passing the current clause satisfies the comparison of the column at index
+   * @em col_idx against @em val. Scans the filter is pushed down to use this to skip blocks that cannot match.
+   * @param col_idx The index of the column in the projection.
+   * @param type The type of the column.
+   * @param op The comparison operator.
+   * @param val The constant the column is compared against.
+   */
+  void InsertClausePredicate(uint32_t col_idx, type::TypeId type, ColumnPredicate::Op op, int64_t val);
+
+  /**
+   * @return the comparisons that every tuple passing the whole filter satisfies
+   */
+  std::vector<ColumnPredicate> GetPredicates() const;
+
   /**
    * Make the manager immutable.
    */
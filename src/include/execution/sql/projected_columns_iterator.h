@@ -2,6 +2,8 @@
 
 #include <limits>
 #include <type_traits>
+#include <vector>
+#include "storage/arrow_block_metadata.h"
 #include "storage/projected_columns.h"
 
 #include "common/macros.h"
@@ -50,6 +52,44 @@ class EXPORT ProjectedColumnsIterator {
    */
   void SetProjectedColumn(storage::ProjectedColumns *projected_column);
 
+  /**
+   * Reset this iterator to begin iteration over @em num_tuples tuples that are read in place out of a frozen block
+   * instead of from a materialized projection. Every one of the @em num_cols columns must then be pointed at the block
+   * through SetInPlaceColumn before the iterator is used.
+   * @param num_tuples The number of tuples in the vector
+   * @param num_cols The number of columns in the vector
+   * @param block_offset The slot of the vector's first tuple in the block
+   */
+  void SetInPlaceTuples(uint32_t num_tuples, uint16_t num_cols, uint32_t block_offset);
+
+  /**
+   * Point the column at index @em col_idx directly at block memory.
+   * @param col_idx The index of the column in the projection
+   * @param col_data The column's first value in the block
+   * @param null_bitmap The column's null bitmap, starting at the column's first value
+   * @param arrow_info The Arrow metadata of the column in the block
+   */
+  void SetInPlaceColumn(uint16_t col_idx, const byte *col_data, const common::RawBitmap *null_bitmap,
+                        storage::ArrowColumnInfo *arrow_info) {
+    col_data_[col_idx] = col_data;
+    col_null_bitmaps_[col_idx] = null_bitmap;
+    col_arrow_infos_[col_idx] = arrow_info;
+  }
+
+  /**
+   * @return True if the current vector is read in place out of a frozen block; false if it is materialized
+   */
+  bool IsInPlace() const { return in_place_; }
+
+  /**
+   * @param col_idx The index of the column in the projection
+   * @return The Arrow metadata (e.g. gathered varlen or dictionary buffers) of the column if the current vector is
+   *         read in place; nullptr otherwise
+   */
+  storage::ArrowColumnInfo *GetArrowColumnInfo(uint32_t col_idx) const {
+    return in_place_ ? col_arrow_infos_[col_idx] : nullptr;
+  }
+
   // -------------------------------------------------------
   // Tuple-at-a-time API
   // -------------------------------------------------------
@@ -208,6 +248,30 @@ class EXPORT ProjectedColumnsIterator {
   template <template <typename> typename Op>
   uint32_t FilterColByCol(uint32_t col_idx_1, type::TypeId type_1, uint32_t col_idx_2, type::TypeId type_2);
 
+  /**
+   * Filter the string column at index @em col_idx by the given constant string @em val. NULLs never pass. If the
+   * vector is read in place and the column is dictionary compressed, the predicate is evaluated once against the
+   * block's sorted dictionary, and the resulting range of dictionary codes is selected with SIMD over the column's
+   * dictionary indices. Otherwise every value is compared.
+   * @tparam Op The filtering operator.
+   * @param col_idx The index of the column in the projection to filter.
+   * @param val The value to filter on.
+   * @return The number of selected elements.
+   */
+  template <template <typename> typename Op>
+  uint32_t FilterColByString(uint32_t col_idx, const storage::VarlenEntry &val);
+
+  /**
+   * Filter the string column at index @em col_idx, keeping only the tuples whose value is one of the given @em vals
+   * (i.e., an IN list). NULLs never pass. Dictionary compressed columns read in place are filtered on their
+   * dictionary codes.
+   * @param col_idx The index of the column in the projection to filter.
+   * @param vals The values to filter on.
+   * @param num_vals The number of values.
+   * @return The number of selected elements.
+   */
+  uint32_t FilterColInStrings(uint32_t col_idx, const storage::VarlenEntry *vals, uint32_t num_vals);
+
   /**
    * Return the number of selected tuples after any filters have been applied
    */
@@ -222,13 +286,44 @@ class EXPORT ProjectedColumnsIterator {
   template <typename T, template <typename> typename Op>
   uint32_t FilterColByColImpl(uint32_t col_idx_1, uint32_t col_idx_2);
 
+  // Is the column at the given index a dictionary compressed column of a vector read in place?
+  bool IsDictionaryCompressed(uint32_t col_idx) const {
+    return in_place_ && col_arrow_infos_[col_idx] != nullptr &&
+           col_arrow_infos_[col_idx]->Type() == storage::ArrowColumnType::DICTIONARY_COMPRESSED;
+  }
+
+  // Filter a dictionary compressed column by the dictionary codes in [lo, hi), or by the codes in the given code set
+  // if it is not null
+  uint32_t FilterDictionaryCodes(uint32_t col_idx, uint32_t lo, uint32_t hi, const uint32_t *code_set);
+
+  // Filter a string column by a predicate on every non-NULL value
+  template <typename P>
+  uint32_t FilterStringValues(uint32_t col_idx, const P &pred);
+
  private:
   // The selection vector used to filter the ProjectedColumns
   alignas(common::Constants::CACHELINE_SIZE) uint32_t selection_vector_[common::Constants::K_DEFAULT_VECTOR_SIZE];
 
-  // The projected column we are iterating over.
+  // The projected column we are iterating over, if the vector is materialized
   storage::ProjectedColumns *projected_column_{nullptr};
 
+  // The number of tuples in the vector, if it is read in place
+  uint32_t num_in_place_tuples_{0};
+
+  // The start of each column's values and null bitmap in the vector we are iterating over. These either point into a
+  // materialized ProjectedColumns, or directly into block memory when the vector is read in place.
+  std::vector<const byte *> col_data_;
+  std::vector<const common::RawBitmap *> col_null_bitmaps_;
+
+  // The Arrow metadata of each column, only meaningful when the vector is read in place
+  std::vector<storage::ArrowColumnInfo *> col_arrow_infos_;
+
+  // Whether the vector is read in place out of a frozen block
+  bool in_place_{false};
+
+  // The slot of the vector's first tuple in the block, if it is read in place
+  uint32_t in_place_block_offset_{0};
+
   // The current raw position in the ProjectedColumns we're pointing to
   uint32_t curr_idx_{0};
 
@@ -256,9 +351,9 @@ inline const T *ProjectedColumnsIterator::Get(uint32_t col_idx, bool *null) cons
   // NOLINTNEXTLINE: bugprone-suspicious-semicolon: seems like a false positive because of constexpr
   if constexpr (Nullable) {
     TERRIER_ASSERT(null != nullptr, "Missing output variable for NULL indicator");
-    *null = !projected_column_->ColumnNullBitmap(static_cast<uint16_t>(col_idx))->Test(curr_idx_);
+    *null = !col_null_bitmaps_[col_idx]->Test(curr_idx_);
   }
-  const T *col_data = reinterpret_cast<T *>(projected_column_->ColumnStart(static_cast<uint16_t>(col_idx)));
+  const T *col_data = reinterpret_cast<const T *>(col_data_[col_idx]);
   return &col_data[curr_idx_];
 }
 
@@ -284,7 +379,9 @@ inline void ProjectedColumnsIterator::Match(bool matched) {
   selection_vector_write_idx_ += matched ? 1 : 0;
 }
 
-inline bool ProjectedColumnsIterator::HasNext() const { return curr_idx_ < projected_column_->NumTuples(); }
+inline bool ProjectedColumnsIterator::HasNext() const {
+  return curr_idx_ < (in_place_ ? num_in_place_tuples_ : projected_column_->NumTuples());
+}
 
 inline bool ProjectedColumnsIterator::HasNextFiltered() const { return selection_vector_read_idx_ < NumSelected(); }
 
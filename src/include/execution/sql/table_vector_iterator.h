@@ -1,9 +1,11 @@
 #pragma once
 
+#include <limits>
 #include <memory>
 #include <vector>
 #include "catalog/catalog.h"
 #include "execution/exec/execution_context.h"
+#include "execution/sql/filter_manager.h"
 #include "execution/sql/projected_columns_iterator.h"
 #include "storage/sql_table.h"
 
@@ -11,8 +13,10 @@ namespace terrier::execution::sql {
 class ThreadStateContainer;
 
 /**
- * An iterator over a table's data in vector-wise fashion.
- * TODO(Amadou): Add a Reset() method to avoid reconstructing the object in NL joins.
+ * An iterator over a table's data in vector-wise fashion. Blocks that the block compactor has frozen are read in
+ * place, with the vectors pointing straight into block memory; all other blocks are materialized transactionally.
+ * Frozen blocks whose zone maps show that none of their tuples can pass the filters pushed down to the iterator are
+ * skipped entirely.
  */
 class EXPORT TableVectorIterator {
  public:
@@ -31,6 +35,18 @@ class EXPORT TableVectorIterator {
   explicit TableVectorIterator(exec::ExecutionContext *exec_ctx, uint32_t table_oid, uint32_t *col_oids,
                                uint32_t num_oids);
 
+  /**
+   * Create a new vectorized iterator over the blocks [start_block_idx, end_block_idx) of the given table
+   * @param exec_ctx execution context of the query
+   * @param table_oid oid of the table
+   * @param col_oids array column oids to scan
+   * @param num_oids length of the array
+   * @param start_block_idx index of the first block to scan
+   * @param end_block_idx index of one past the last block to scan
+   */
+  TableVectorIterator(exec::ExecutionContext *exec_ctx, uint32_t table_oid, uint32_t *col_oids, uint32_t num_oids,
+                      uint32_t start_block_idx, uint32_t end_block_idx);
+
   /**
    * Destructor
    */
@@ -47,6 +63,13 @@ class EXPORT TableVectorIterator {
    */
   bool Init();
 
+  /**
+   * Push the column predicates of a filter down to the iterator, so it can skip frozen blocks that cannot match. The
+   * filter itself still has to be run over every vector the iterator hands out.
+   * @param filter the filter that is run over the vectors of this iterator
+   */
+  void PushDownFilter(const FilterManager &filter);
+
   /**
    * Advance the iterator by a vector of input
    * @return True if there is more data in the iterator; false otherwise
@@ -78,15 +101,30 @@ class EXPORT TableVectorIterator {
    * callback function @em scanner on each input vector projection from the
    * source table. This call is blocking, meaning that it only returns after
    * the whole table has been scanned. Iteration order is non-deterministic.
-   * @param db_oid The ID of the database containing the table
+   * The table's blocks are split into morsels of at least @em min_grain_size
+   * blocks each. Each morsel is scanned by its own iterator, and the callback
+   * is handed the thread-local state of whichever thread runs the morsel.
    * @param table_oid The ID of the table
+   * @param col_oids array column oids to scan
+   * @param num_oids length of the array
    * @param query_state the query state
+   * @param exec_ctx execution context of the query
    * @param thread_states the thread state container
    * @param scan_fn The callback function invoked for vectors of table input
    * @param min_grain_size The minimum number of blocks to give a scan task
+   * @return True if the scan ran; false if the table could not be found
    */
-  static bool ParallelScan(uint32_t db_oid, uint32_t table_oid, void *query_state, ThreadStateContainer *thread_states,
-                           ScanFn scan_fn, uint32_t min_grain_size = K_MIN_BLOCK_RANGE_SIZE);
+  static bool ParallelScan(uint32_t table_oid, uint32_t *col_oids, uint32_t num_oids, void *query_state,
+                           exec::ExecutionContext *exec_ctx, ThreadStateContainer *thread_states, ScanFn scan_fn,
+                           uint32_t min_grain_size = K_MIN_BLOCK_RANGE_SIZE);
+
+ private:
+  // Hand out the next vector of the frozen block being read in place, if there is any left
+  bool AdvanceInPlace();
+  // Stop reading the current block in place, letting writers at it again
+  void ReleaseInPlaceBlock();
+  // Whether the zone maps of a block the iterator has in-place access to rule out a match for the pushed down filter
+  bool CanSkipInPlaceBlock(storage::RawBlock *block) const;
 
  private:
   exec::ExecutionContext *exec_ctx_;
@@ -101,6 +139,18 @@ class EXPORT TableVectorIterator {
   storage::ProjectedColumns *projected_columns_ = nullptr;
   // Iterator of the slots in the PC
   std::unique_ptr<storage::DataTable::SlotIterator> iter_ = nullptr;
+  // The range of blocks to scan. An end index of K_END_OF_TABLE means scan until the end of the table.
+  static constexpr uint32_t K_END_OF_TABLE = std::numeric_limits<uint32_t>::max();
+  uint32_t start_block_idx_ = 0;
+  uint32_t end_block_idx_ = K_END_OF_TABLE;
+  // One past the last slot to scan when scanning a fixed range of blocks
+  std::unique_ptr<storage::DataTable::SlotIterator> end_iter_ = nullptr;
+  // The frozen block iter_ points to if it is being read in place, and the next slot of it to hand out
+  storage::RawBlock *in_place_block_ = nullptr;
+  uint32_t in_place_offset_ = 0;
+  uint32_t in_place_num_records_ = 0;
+  // Predicates every tuple handed out has to satisfy, checked against the zone maps of frozen blocks
+  std::vector<FilterManager::ColumnPredicate> pushed_down_predicates_;
 
   bool initialized_ = false;
 };
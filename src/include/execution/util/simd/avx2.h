@@ -960,4 +960,34 @@ static inline uint32_t FilterVectorByVector(const T *RESTRICT in_1, const T *RES
   return out_pos;
 }
 
+template <typename T>
+static inline uint32_t FilterVectorByRange(const T *RESTRICT in, uint32_t in_count, T lo, T hi, uint32_t *RESTRICT out,
+                                           const uint32_t *RESTRICT sel, uint32_t *RESTRICT in_pos) {
+  using Vec = typename FilterVecSizer<T>::Vec;
+  using VecMask = typename FilterVecSizer<T>::VecMask;
+
+  const Vec xlo(lo), xhi(hi);
+
+  uint32_t out_pos = 0;
+
+  if (sel == nullptr) {
+    Vec in_vec;
+    for (*in_pos = 0; *in_pos + Vec::Size() < in_count; *in_pos += Vec::Size()) {
+      in_vec.Load(in + *in_pos);
+      VecMask mask = (in_vec >= xlo) & (in_vec < xhi);
+      out_pos += mask.ToPositions(out + out_pos, *in_pos);
+    }
+  } else {
+    Vec in_vec, sel_vec;
+    for (*in_pos = 0; *in_pos + Vec::Size() < in_count; *in_pos += Vec::Size()) {
+      sel_vec.Load(sel + *in_pos);
+      in_vec.Gather(in, sel_vec);
+      VecMask mask = (in_vec >= xlo) & (in_vec < xhi);
+      out_pos += mask.ToPositions(out + out_pos, sel_vec);
+    }
+  }
+
+  return out_pos;
+}
+
 }  // namespace terrier::execution::util::simd
@@ -2,6 +2,7 @@
 
 #include <functional>
 
+#include "execution/util/bit_util.h"
 #include "execution/util/execution_common.h"
 #include "execution/util/simd.h"
 
@@ -104,6 +105,77 @@ class VectorUtil {
     return out_pos;
   }
 
+  /**
+   * Filter an input vector by the half-open range of values [@em lo, @em hi) and store the indexes of valid elements
+   * in the output vector. If a selection vector is provided, only vector elements from the selection vector will be
+   * read. The vectorized implementation compares signed lanes, so all values must be representable as signed T.
+   * @tparam T The data type of the elements stored in the input vector.
+   * @param in The input vector.
+   * @param in_count The number of elements in the input (or selection) vector.
+   * @param lo The smallest valid value.
+   * @param hi One past the largest valid value.
+   * @param[out] out The vector storing indexes of valid input elements.
+   * @param sel The selection vector used to read input values.
+   * @return The number of elements that pass the filter.
+   */
+  template <typename T>
+  static uint32_t FilterVectorByRange(const T *RESTRICT in, const uint32_t in_count, const T lo, const T hi,
+                                      uint32_t *RESTRICT out, const uint32_t *RESTRICT sel) {
+    uint32_t in_pos = 0;
+#if defined(__AVX2__) || defined(__AVX512F__)
+    uint32_t out_pos = simd::FilterVectorByRange<T>(in, in_count, lo, hi, out, sel, &in_pos);
+#else
+    uint32_t out_pos = 0;
+#endif
+
+    if (sel == nullptr) {
+      for (; in_pos < in_count; in_pos++) {
+        bool cmp = (in[in_pos] >= lo) & (in[in_pos] < hi);
+        out[out_pos] = in_pos;
+        out_pos += static_cast<uint32_t>(cmp);
+      }
+    } else {
+      for (; in_pos < in_count; in_pos++) {
+        bool cmp = (in[sel[in_pos]] >= lo) & (in[sel[in_pos]] < hi);
+        out[out_pos] = sel[in_pos];
+        out_pos += static_cast<uint32_t>(cmp);
+      }
+    }
+
+    return out_pos;
+  }
+
+  /**
+   * Filter an input vector of small non-negative integer codes by membership in a set of codes, and store the indexes
+   * of valid elements in the output vector. If a selection vector is provided, only vector elements from the
+   * selection vector will be read.
+   * @param in The input vector of codes.
+   * @param in_count The number of elements in the input (or selection) vector.
+   * @param code_set Bit vector with a set bit for every valid code. Must cover every code in the input vector.
+   * @param[out] out The vector storing indexes of valid input elements.
+   * @param sel The selection vector used to read input values.
+   * @return The number of elements that pass the filter.
+   */
+  static uint32_t FilterVectorByCodeSet(const uint32_t *RESTRICT in, const uint32_t in_count,
+                                        const uint32_t *RESTRICT code_set, uint32_t *RESTRICT out,
+                                        const uint32_t *RESTRICT sel) {
+    uint32_t out_pos = 0;
+    if (sel == nullptr) {
+      for (uint32_t in_pos = 0; in_pos < in_count; in_pos++) {
+        bool cmp = BitUtil::Test(code_set, in[in_pos]);
+        out[out_pos] = in_pos;
+        out_pos += static_cast<uint32_t>(cmp);
+      }
+    } else {
+      for (uint32_t in_pos = 0; in_pos < in_count; in_pos++) {
+        bool cmp = BitUtil::Test(code_set, in[sel[in_pos]]);
+        out[out_pos] = sel[in_pos];
+        out_pos += static_cast<uint32_t>(cmp);
+      }
+    }
+    return out_pos;
+  }
+
   /**
    * Gather potentially non-contiguous indexes from an input vector and store
    * them into an output vector. Only elements whose indexes are stored in the
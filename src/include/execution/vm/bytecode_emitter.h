@@ -321,9 +321,16 @@ class BytecodeEmitter {
 
   /**
    * Emit a parallel table scan
+   * @param table_oid oid of the table
+   * @param col_oids array of column oids to scan
+   * @param num_oids length of the array
+   * @param query_state opaque query state handed to the scan function
+   * @param exec_ctx the execution context
+   * @param thread_states the thread state container
+   * @param scan_fn the function invoked on every morsel of the table
    */
-  void EmitParallelTableScan(uint32_t db_oid, uint32_t table_oid, LocalVar ctx, LocalVar thread_states,
-                             FunctionId scan_fn);
+  void EmitParallelTableScan(uint32_t table_oid, LocalVar col_oids, uint32_t num_oids, LocalVar query_state,
+                             LocalVar exec_ctx, LocalVar thread_states, FunctionId scan_fn);
 
   // Reading integer values from an iterator
   /**
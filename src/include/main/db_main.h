@@ -9,6 +9,8 @@
 #include "network/terrier_server.h"
 #include "settings/settings_manager.h"
 #include "settings/settings_param.h"
+#include "storage/block_compactor_thread.h"
+#include "storage/block_tiering_thread.h"
 #include "storage/garbage_collector_thread.h"
 #include "transaction/transaction_manager.h"
 
@@ -44,6 +46,8 @@ class DBMain {
    *    Buffer segment pools
    *    Transaction manager
    *    Garbage collector thread
+   *    Block compactor threads, if enabled
+   *    Block tiering thread, if enabled along with compaction
    *    Catalog
    *    Settings manager
    *    Log manager
@@ -56,8 +60,15 @@ class DBMain {
     ForceShutdown();
     // TODO(Matt): might as well make these std::unique_ptr, but then will need to refactor other classes to take
     // ManagedPointers unless we want a bunch of .get()s, which sounds like a future PR
+    // Compaction goes first, the GC's final runs still process its deferred actions
+    delete compactor_thread_;
+    delete tiering_thread_;
     delete gc_thread_;
     delete garbage_collector_;
+    delete access_observer_;
+    delete block_compactor_;
+    delete block_tiering_manager_;
+    delete deferred_action_manager_;
     delete settings_manager_;
     delete txn_manager_;
     delete timestamp_manager_;
@@ -98,6 +109,14 @@ class DBMain {
   storage::LogManager *log_manager_;
   storage::GarbageCollector *garbage_collector_;
   storage::GarbageCollectorThread *gc_thread_;
+  // Only created if block compaction is enabled
+  transaction::DeferredActionManager *deferred_action_manager_ = nullptr;
+  storage::BlockCompactor *block_compactor_ = nullptr;
+  storage::AccessObserver *access_observer_ = nullptr;
+  storage::BlockCompactorThread *compactor_thread_ = nullptr;
+  // Only created if block tiering is enabled along with compaction
+  storage::BlockTieringManager *block_tiering_manager_ = nullptr;
+  storage::BlockTieringThread *tiering_thread_ = nullptr;
   network::TerrierServer *server_;
   storage::RecordBufferSegmentPool *buffer_segment_pool_;
   common::WorkerPool *thread_pool_;
@@ -44,6 +44,121 @@ SETTING_int(
     terrier::settings::Callbacks::NoOp
 )
 
+// Number of garbage collector threads
+SETTING_int(
+    num_gc_threads,
+    "The number of threads unlinking and deallocating transactions in every garbage collection (default: 1)",
+    1,
+    1,
+    64,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Block compaction
+SETTING_bool(
+    compaction_enable,
+    "Freeze cold blocks into the Arrow format in the background (default: false)",
+    false,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Number of block compaction threads
+SETTING_int(
+    num_compaction_threads,
+    "The number of threads freezing cold blocks (default: 1)",
+    1,
+    1,
+    64,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Block compaction thread interval
+SETTING_int(
+    compaction_interval,
+    "Block compaction thread interval (ms) (default: 10)",
+    10,
+    1,
+    10000,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Blocks processed per compaction round
+SETTING_int(
+    compaction_blocks_per_round,
+    "The maximum number of blocks a compaction thread processes every interval (default: 16)",
+    16,
+    1,
+    1000000,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Cold block detection epoch threshold
+SETTING_int(
+    compaction_cold_epoch_threshold,
+    "The number of garbage collections a block has to stay idle for before it is frozen (default: 10)",
+    10,
+    1,
+    1000000,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Cold block detection access threshold
+SETTING_int(
+    compaction_cold_access_threshold,
+    "The number of sampled accesses a block can see between garbage collections and still be idle (default: 0)",
+    0,
+    0,
+    65535,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Block tiering
+SETTING_bool(
+    tiering_enable,
+    "Spill cold frozen blocks to local disk when they exceed the memory budget, needs compaction (default: false)",
+    false,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Directory spilled blocks are written to
+SETTING_string(
+    tiering_directory,
+    "The directory cold frozen blocks are spilled to (default: tiered_blocks)",
+    "tiered_blocks",
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Memory budget for frozen blocks
+SETTING_int(
+    tiering_memory_budget,
+    "The amount of memory (MB) frozen blocks can take up before cold ones are spilled to disk (default: 1024)",
+    1024,
+    0,
+    1048576,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Block tiering thread interval
+SETTING_int(
+    tiering_interval,
+    "Block tiering thread interval (ms) (default: 1000)",
+    1000,
+    1,
+    1000000,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
 // Number of worker pool threads
 SETTING_int(
     num_worker_threads,
@@ -86,6 +201,17 @@ SETTING_int(
     terrier::settings::Callbacks::NoOp
 )
 
+// Number of log serialization threads
+SETTING_int(
+    num_log_serializer_threads,
+    "The number of threads serializing logs concurrently (default: 1)",
+    1,
+    1,
+    64,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
 // Log file persisting interval
 SETTING_int(
     log_persist_interval,
@@ -107,3 +233,12 @@ SETTING_int(
     false,
     terrier::settings::Callbacks::NoOp
 )
+
+// Log file group commit
+SETTING_bool(
+    log_group_commit,
+    "Persist the log file with fdatasync as soon as commits are written out, instead of periodically (default: false)",
+    false,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
@@ -22,6 +22,12 @@ class BlockCompactor;
  * when relavent events fire. It is then free to make a decision whether to send a block into the compactor's queue
  * to freeze asynchronously.
  *
+ * Full blocks start being watched once the garbage collector sees a write to them. From then on, the observer also
+ * looks at the sampled access count in the header of each watched block, which DataTable bumps on reads as well as
+ * writes, so blocks that are still read a lot are not frozen just because they stopped being written to. A block is
+ * considered cold once it has gone a configurable number of GC invocations with no more than a configurable number of
+ * sampled accesses in any of them.
+ *
  * Notice that although the observation step is light weight, it does happen on the garbage collection thread and thus
  * has some minor performance impact on GC and consequently the rest of the system. Care should be taken to not do
  * any computationally-intensive work here to figure out whether a block is cold. The entire hot-cold mechanism is
@@ -33,7 +39,25 @@ class AccessObserver {
    * Constructs a new AccessObserver that will send its observations to the given block compactor
    * @param compactor the compactor to use after identifying a cold block
    */
-  explicit AccessObserver(BlockCompactor *compactor) : compactor_(compactor) {}
+  explicit AccessObserver(BlockCompactor *compactor)
+      : AccessObserver(compactor, COLD_DATA_EPOCH_THRESHOLD, DEFAULT_COLD_ACCESS_THRESHOLD) {}
+
+  /**
+   * Constructs a new AccessObserver that will send its observations to the given block compactor
+   * @param compactor the compactor to use after identifying a cold block
+   * @param cold_epoch_threshold number of GC invocations a block has to stay idle for before it is considered cold
+   * @param cold_access_threshold maximum number of sampled accesses a block can see between two GC invocations and
+   *                              still count as idle
+   */
+  AccessObserver(BlockCompactor *compactor, uint64_t cold_epoch_threshold, uint16_t cold_access_threshold)
+      : compactor_(compactor),
+        cold_epoch_threshold_(cold_epoch_threshold),
+        cold_access_threshold_(cold_access_threshold) {}
+
+  /**
+   * By default, any sampled access keeps a block hot
+   */
+  static constexpr uint16_t DEFAULT_COLD_ACCESS_THRESHOLD = 0;
 
   /**
    * Signals to the AccessObserver that a new GC run has begun. This is useful as a measurement of time to the
@@ -50,11 +74,21 @@ class AccessObserver {
   void ObserveWrite(RawBlock *block);
 
  private:
+  // What the observer remembers about a block it is watching
+  struct BlockAccessInfo {
+    // GC epoch the block was last seen being accessed in
+    uint64_t last_touched_;
+    // Sampled access count of the block as of the last GC invocation
+    uint16_t last_access_count_;
+  };
+
   uint64_t gc_epoch_ = 0;  // estimate time using the number of times GC has run
   // Here RawBlock * should suffice as a unique identifier of the block. Although a block can be
   // reused, that process should only be triggered through compaction, which happens only if the
   // reference to said block is identified as cold and leaves the table.
-  std::unordered_map<RawBlock *, uint64_t> last_touched_;
+  std::unordered_map<RawBlock *, BlockAccessInfo> watched_blocks_;
   BlockCompactor *compactor_;
+  const uint64_t cold_epoch_threshold_;
+  const uint16_t cold_access_threshold_;
 };
 }  // namespace terrier::storage
@@ -115,13 +115,29 @@ class ArrowVarlenColumn {
   uint32_t *offsets_ = nullptr;
 };
 
+/**
+ * Smallest and largest non-NULL value of a fixed-length column of a frozen block, read as signed integers of the
+ * column's attribute size. Together with the column's null count, this lets a scan skip blocks in which no tuple can
+ * satisfy a predicate on the column. Only meaningful if the column has at least one non-NULL value.
+ */
+struct ZoneMap {
+  /**
+   * smallest non-NULL value in the column
+   */
+  int64_t min_;
+  /**
+   * largest non-NULL value in the column
+   */
+  int64_t max_;
+};
+
 /**
  * An ArrowColumnInfo object contains everything needed to reason about Arrow storage of a column in the block.
  *
  * All columns has a type associated with it. Gathered varlen columns has an ArrowVarlenColumn. If the column
  * is dictionary-compressed, it has an ArrowVarlenColumn that is the dictionary, and an indices array that encodes
  * the values. Notice here that the meaning of the ArrowVarlenColumn is different for dictionary-encoded columns
- * and simple gathered columns.
+ * and simple gathered columns. Every fixed-length column has a zone map instead.
  */
 class ArrowColumnInfo {
  public:
@@ -181,9 +197,18 @@ class ArrowColumnInfo {
   }
 
   /**
-   * Deallocates all associated buffers in the ArrowVarlenColumn
+   * Returns the zone map of the column. This is only meaningful for fixed-length columns, as it takes up the space of
+   * the ArrowVarlenColumn.
+   * @return the zone map
+   */
+  ZoneMap &GetZoneMap() { return zone_map_; }
+
+  /**
+   * Deallocates all associated buffers in the ArrowVarlenColumn. A fixed-length column has none, and holds its zone map
+   * in their place.
    */
   void Deallocate() {
+    if (type_ == ArrowColumnType::FIXED_LENGTH) return;
     delete[] indices_;
     varlen_column_.Deallocate();
   }
@@ -193,7 +218,12 @@ class ArrowColumnInfo {
    * type of this Arrow column
    */
   ArrowColumnType type_;
-  ArrowVarlenColumn varlen_column_;  // For varlen and dictionary
+  // Every column gets one of these in the block header, so a fixed-length column keeps its zone map where a varlen
+  // column keeps its buffers. The widest layouts would not fit a single tuple into a block otherwise.
+  union {
+    ArrowVarlenColumn varlen_column_{};  // For varlen and dictionary
+    ZoneMap zone_map_;                   // for fixed-length
+  };
   // TODO(Tianyu): Add null bitmap
   uint32_t *indices_ = nullptr;  // for dictionary
 };
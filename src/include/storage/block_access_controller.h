@@ -118,6 +118,7 @@ class BlockAccessController {
 
  private:
   friend class BlockCompactor;
+  friend class BlockTieringManager;
   // we are breaking this down to two fields, (| BlockState (32-bits) | Reader Count (32-bits) |)
   // but may need to compare and swap on the two together sometimes
   byte bytes_[sizeof(uint64_t)];
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <map>
+#include <vector>
+#include "common/macros.h"
+#include "common/spin_latch.h"
+#include "common/strong_typedef.h"
+
+namespace terrier::storage {
+class RawBlock;
+
+/**
+ * Allocator that allocates a block
+ *
+ * By default, every block is allocated on its own from the heap. When given a region size, blocks are instead carved
+ * out of large memory regions mapped from the OS, which cuts down on page faults and TLB misses when tables grow
+ * quickly. Regions can be backed by huge pages and pre-faulted when they are mapped. When NUMA-aware, every NUMA node
+ * has its own regions and free blocks, and threads get blocks from the node they run on, so blocks are local to the
+ * threads that fill them. Deleted blocks go on a free list, and unless their region is backed by reserved huge pages,
+ * their memory is returned to the OS until they are handed out again.
+ *
+ * No setting configures regions yet. DBMain creates no tables, and the TPL runner builds its BlockStore with the
+ * defaults, so regions are only used where a BlockStore is constructed with these options, e.g. in
+ * data_table_benchmark.
+ */
+class BlockAllocator {
+ public:
+  /**
+   * Constructs an allocator that allocates every block on its own from the heap
+   */
+  BlockAllocator() = default;
+
+  /**
+   * Constructs an allocator that carves blocks out of larger memory regions
+   * @param region_size number of blocks to map from the OS at a time. 0 to allocate every block on its own, in which
+   * case the other options are ignored
+   * @param huge_page_size size in MB of the huge pages to back regions with: 0 for regular pages, 2 or 1024. If no
+   * huge pages of that size are reserved on the system, regions fall back to regular pages, and to transparent huge
+   * pages where available.
+   * @param prefault true to fault in the pages of a region when it is mapped, instead of on first access
+   * @param numa_aware true to keep separate regions and free blocks for every NUMA node
+   */
+  BlockAllocator(uint32_t region_size, uint32_t huge_page_size, bool prefault, bool numa_aware);
+
+  /**
+   * Returns all regions to the OS. Blocks that were never deleted are freed with them.
+   */
+  ~BlockAllocator();
+
+  DISALLOW_COPY_AND_MOVE(BlockAllocator)
+
+  /**
+   * Allocates a new block
+   * @return a pointer to the allocated block, or nullptr if the OS is out of memory
+   */
+  RawBlock *New();
+
+  /**
+   * Reuse a reused chunk of memory to be handed out again
+   * @param reused memory location, possibly filled with junk bytes
+   */
+  void Reuse(RawBlock *const reused) { /* no operation required */
+  }
+
+  /**
+   * Deletes a block allocated by this allocator. Blocks carved out of a region are kept for reuse, but their pages are
+   * released to the OS.
+   * @param ptr a pointer to the block to be deleted.
+   */
+  void Delete(RawBlock *ptr);
+
+ private:
+  // Maximum number of NUMA nodes with their own arena. Nodes past that share arenas.
+  static constexpr uint32_t MAX_NUMA_NODES = 8;
+
+  // Free blocks and the remaining space in the latest region of a NUMA node
+  struct Arena {
+    common::SpinLatch latch_;
+    std::vector<RawBlock *> free_blocks_;
+    byte *next_ = nullptr;
+    byte *end_ = nullptr;
+  };
+
+  // A region mapped from the OS
+  struct Region {
+    uint64_t size_;
+    uint32_t arena_;
+    // Whether the region is backed by explicitly reserved huge pages, as opposed to regular or transparent huge pages
+    bool huge_pages_;
+  };
+
+  const uint32_t region_size_ = 0;
+  const uint32_t huge_page_size_ = 0;
+  const bool prefault_ = false;
+  const bool numa_aware_ = false;
+
+  std::array<Arena, MAX_NUMA_NODES> arenas_;
+  // Latch used to protect regions_
+  common::SpinLatch regions_latch_;
+  // All regions, by start address
+  std::map<byte *, Region> regions_;
+
+  // Returns the arena of the NUMA node the calling thread runs on
+  uint32_t CurrentArena() const;
+
+  // Maps a new region from the OS and makes it the region blocks of the given arena are carved out of. Returns false
+  // if the OS is out of memory. Must be called while holding the arena's latch.
+  bool MapRegion(uint32_t arena_id);
+};
+}  // namespace terrier::storage
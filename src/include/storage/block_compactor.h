@@ -1,9 +1,12 @@
 #pragma once
 #include <queue>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
+#include "common/spin_latch.h"
 #include "storage/arrow_block_metadata.h"
+#include "storage/block_tiering_manager.h"
 #include "storage/data_table.h"
 #include "storage/storage_defs.h"
 #include "transaction/transaction_manager.h"
@@ -49,23 +52,55 @@ class BlockCompactor {
   };
 
  public:
+  /**
+   * Constructs a block compactor that leaves frozen blocks in memory
+   */
+  BlockCompactor() = default;
+
+  /**
+   * Constructs a block compactor that hands blocks to a tiering manager once they are frozen
+   * @param tiering_manager the tiering manager to spill frozen blocks to disk with, or nullptr to keep them in memory
+   */
+  explicit BlockCompactor(BlockTieringManager *tiering_manager) : tiering_manager_(tiering_manager) {}
+
   FAKED_IN_TEST ~BlockCompactor() = default;
 
   /**
    * Processes the compaction queue and mark processed blocks as cold if successful. The compaction can fail due
    * to live versions or contention. There will be a brief window where user transactions writing to the block
    * can be aborted, but no readers would be blocked.
+   *
+   * Safe to call from several threads at once, in which case each call takes its own blocks off the queue. Blocks
+   * enqueued while a call is running are left for the next call.
+   * @param deferred_action_manager the deferred action manager to clean up after compaction with
+   * @param txn_manager the transaction manager to run compaction transactions with
+   * @param max_blocks maximum number of blocks to take off the queue, to bound how long a call takes
+   * @return number of blocks taken off the queue
    */
-  void ProcessCompactionQueue(transaction::DeferredActionManager *deferred_action_manager,
-                              transaction::TransactionManager *txn_manager);
+  uint32_t ProcessCompactionQueue(transaction::DeferredActionManager *deferred_action_manager,
+                                  transaction::TransactionManager *txn_manager, uint32_t max_blocks = UINT32_MAX);
 
   /**
    * Adds a block associated with a data table to the compaction to be processed in the future.
    * @param block the block that needs to be processed by the compactor
    */
-  FAKED_IN_TEST void PutInQueue(RawBlock *block) { compaction_queue_.push(block); }
+  FAKED_IN_TEST void PutInQueue(RawBlock *block) {
+    common::SpinLatch::ScopedSpinLatch guard(&queue_latch_);
+    compaction_queue_.emplace(block, false);
+  }
 
  private:
+  // Puts a cooling block back in the queue. If a writer thaws the block before it comes up again, the entry is dropped
+  // and the block has to go through cold detection again.
+  void RequeueCooling(RawBlock *block) {
+    common::SpinLatch::ScopedSpinLatch guard(&queue_latch_);
+    compaction_queue_.emplace(block, true);
+  }
+
+  // Moves the block one step closer to frozen, or puts it back in the queue if it is not ready for that yet
+  void ProcessBlock(RawBlock *block, transaction::DeferredActionManager *deferred_action_manager,
+                    transaction::TransactionManager *txn_manager);
+
   bool EliminateGaps(CompactionGroup *cg);
 
   bool CheckForVersionsAndGaps(const TupleAccessStrategy &accessor, RawBlock *block);
@@ -75,6 +110,10 @@ class BlockCompactor {
 
   void GatherVarlens(std::vector<const byte *> *loose_ptrs, RawBlock *block, DataTable *table);
 
+  // Records the smallest and largest non-NULL value of a fixed-length column, for scans to prune the block with
+  void ComputeZoneMap(ArrowBlockMetadata *metadata, col_id_t col_id, common::RawConcurrentBitmap *column_bitmap,
+                      RawBlock *block, DataTable *table);
+
   void CopyToArrowVarlen(std::vector<const byte *> *loose_ptrs, ArrowBlockMetadata *metadata, col_id_t col_id,
                          common::RawConcurrentBitmap *column_bitmap, ArrowColumnInfo *col, VarlenEntry *values);
 
@@ -94,6 +133,13 @@ class BlockCompactor {
     }
   }
 
-  std::queue<RawBlock *> compaction_queue_;
+  // Latch used to protect compaction_queue_ and in_progress_
+  common::SpinLatch queue_latch_;
+  // Each block together with whether the compactor put it back while it was cooling
+  std::queue<std::pair<RawBlock *, bool>> compaction_queue_;
+  // Blocks being processed right now. A block can be in the queue more than once, and two threads must not work on the
+  // same block at the same time.
+  std::unordered_set<RawBlock *> in_progress_;
+  BlockTieringManager *tiering_manager_ = nullptr;
 };
 }  // namespace terrier::storage
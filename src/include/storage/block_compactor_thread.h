@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>  //NOLINT
+#include <thread>  //NOLINT
+#include <vector>
+#include "storage/block_compactor.h"
+#include "transaction/deferred_action_manager.h"
+#include "transaction/transaction_manager.h"
+
+namespace terrier::storage {
+
+/**
+ * Class for spinning off threads that freeze cold blocks at a fixed interval, so that compaction does not hold up the
+ * garbage collector or the transactions that run on it.
+ *
+ * Compaction competes with foreground transactions for CPU, memory bandwidth and, briefly, for the blocks themselves.
+ * To keep that from showing up in foreground latency, every thread only takes a bounded number of blocks off the
+ * compactor's queue per interval. Blocks that do not get processed stay in the queue for the next interval.
+ */
+class BlockCompactorThread {
+ public:
+  /**
+   * @param compactor pointer to the block compactor to be run on these threads
+   * @param deferred_action_manager the deferred action manager the compactor cleans up with. Has to be processed by
+   *                                the garbage collector for frozen blocks to release their old varlens.
+   * @param txn_manager the transaction manager compaction transactions are run with
+   * @param num_threads number of threads compacting blocks
+   * @param compaction_period sleep time between compaction rounds of a thread
+   * @param blocks_per_round maximum number of blocks a thread processes in a round
+   */
+  BlockCompactorThread(BlockCompactor *compactor, transaction::DeferredActionManager *deferred_action_manager,
+                       transaction::TransactionManager *txn_manager, uint32_t num_threads,
+                       std::chrono::milliseconds compaction_period, uint32_t blocks_per_round);
+
+  ~BlockCompactorThread() {
+    run_compaction_ = false;
+    for (auto &thread : compaction_threads_) thread.join();
+  }
+
+  /**
+   * Pause compaction, typically for use in tests when the state of tables need to be fixed.
+   */
+  void PauseCompaction() {
+    TERRIER_ASSERT(!compaction_paused_, "Compaction should not already be paused.");
+    compaction_paused_ = true;
+  }
+
+  /**
+   * Resume compaction after being paused.
+   */
+  void ResumeCompaction() {
+    TERRIER_ASSERT(compaction_paused_, "Compaction should already be paused.");
+    compaction_paused_ = false;
+  }
+
+  /**
+   * @return the underlying block compactor
+   */
+  BlockCompactor &GetBlockCompactor() { return *compactor_; }
+
+ private:
+  BlockCompactor *compactor_;
+  transaction::DeferredActionManager *deferred_action_manager_;
+  transaction::TransactionManager *txn_manager_;
+  volatile bool run_compaction_;
+  volatile bool compaction_paused_;
+  std::chrono::milliseconds compaction_period_;
+  uint32_t blocks_per_round_;
+  std::vector<std::thread> compaction_threads_;
+
+  void CompactionThreadLoop() {
+    while (run_compaction_) {
+      std::this_thread::sleep_for(compaction_period_);
+      if (!compaction_paused_)
+        compactor_->ProcessCompactionQueue(deferred_action_manager_, txn_manager_, blocks_per_round_);
+    }
+  }
+};
+
+}  // namespace terrier::storage
@@ -0,0 +1,111 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <thread>  // NOLINT
+#include "common/macros.h"
+#include "storage/storage_defs.h"
+
+namespace terrier::storage {
+
+/**
+ * An append-only directory of the blocks of a DataTable, giving every block a stable index in the order the blocks
+ * were added to the table.
+ *
+ * Blocks are stored in chunks that double in size, so looking up a block by its index is a constant-time computation
+ * and entries never move once written. Readers never take a latch: Size() is a snapshot of the number of blocks that
+ * can be safely looked up, and concurrent appends only ever add blocks past it. Appends do not take a latch either.
+ * An appender reserves an index with an atomic increment, and then waits for the appenders that reserved earlier
+ * indexes to publish theirs, so that every index below Size() is always filled. Blocks are only appended when a table
+ * runs out of space, so this wait is short and rare.
+ */
+class BlockDirectory {
+ public:
+  /**
+   * Constructs an empty block directory
+   */
+  BlockDirectory() {
+    for (auto &chunk : chunks_) chunk.store(nullptr);
+  }
+
+  /**
+   * Frees the chunks of the directory. The blocks themselves are owned by the DataTable.
+   */
+  ~BlockDirectory() {
+    for (auto &chunk : chunks_) delete[] chunk.load();
+  }
+
+  DISALLOW_COPY_AND_MOVE(BlockDirectory)
+
+  /**
+   * Adds a block to the end of the directory. Safe to call concurrently with other appends and with reads.
+   * @param block the block to add
+   * @return index of the block in the directory
+   */
+  uint32_t Append(RawBlock *const block) {
+    const uint32_t index = reserved_.fetch_add(1);
+    const uint32_t chunk_index = ChunkIndex(index);
+    TERRIER_ASSERT(chunk_index < MAX_CHUNKS, "block directory is full");
+    RawBlock **chunk = chunks_[chunk_index].load();
+    if (chunk == nullptr) {
+      // Several appenders may race to allocate the same chunk, only one of them gets to install it
+      auto *const new_chunk = new RawBlock *[ChunkSize(chunk_index)];
+      if (chunks_[chunk_index].compare_exchange_strong(chunk, new_chunk))
+        chunk = new_chunk;
+      else
+        delete[] new_chunk;
+    }
+    chunk[OffsetInChunk(index, chunk_index)] = block;
+    // Publish in index order, so that Size() never covers an entry that has not been written yet. An earlier appender
+    // may have been descheduled between reserving and publishing, so give up the CPU instead of spinning on it.
+    while (size_.load() != index) std::this_thread::yield();
+    size_.store(index + 1);
+    return index;
+  }
+
+  /**
+   * @param index index of the block, must be smaller than a value previously returned by Size()
+   * @return the block at the given index
+   */
+  RawBlock *operator[](const uint32_t index) const {
+    TERRIER_ASSERT(index < size_.load(), "block index out of bounds");
+    const uint32_t chunk_index = ChunkIndex(index);
+    return chunks_[chunk_index].load()[OffsetInChunk(index, chunk_index)];
+  }
+
+  /**
+   * @return the number of blocks in the directory. Blocks appended concurrently may not be included yet, but every
+   *         index below the returned value can be looked up.
+   */
+  uint32_t Size() const { return size_.load(); }
+
+  /**
+   * @return true if the directory holds no blocks
+   */
+  bool Empty() const { return Size() == 0; }
+
+ private:
+  // Number of blocks in the first chunk, as a power of two. Every following chunk is twice as large as the previous
+  static constexpr uint32_t FIRST_CHUNK_SIZE_LOG = 6;
+  // Enough chunks to address every uint32_t index but the last few
+  static constexpr uint32_t MAX_CHUNKS = 32 - FIRST_CHUNK_SIZE_LOG;
+
+  // Number of indexes reserved by appenders. Can run ahead of size_ while appends are in flight
+  std::atomic<uint32_t> reserved_{0};
+  // Number of blocks that have been published and can be looked up
+  std::atomic<uint32_t> size_{0};
+  std::array<std::atomic<RawBlock **>, MAX_CHUNKS> chunks_;
+
+  static uint32_t ChunkSize(const uint32_t chunk_index) { return 1U << (chunk_index + FIRST_CHUNK_SIZE_LOG); }
+
+  // Chunk k holds the indexes in [2^(k + FIRST_CHUNK_SIZE_LOG), 2^(k + FIRST_CHUNK_SIZE_LOG + 1)) after shifting all
+  // indexes up by the size of the first chunk, so the chunk is given by the highest set bit of the shifted index
+  static uint32_t ChunkIndex(const uint32_t index) {
+    const uint64_t shifted = static_cast<uint64_t>(index) + (1U << FIRST_CHUNK_SIZE_LOG);
+    return 63 - __builtin_clzll(shifted) - FIRST_CHUNK_SIZE_LOG;
+  }
+
+  static uint32_t OffsetInChunk(const uint32_t index, const uint32_t chunk_index) {
+    return static_cast<uint32_t>(static_cast<uint64_t>(index) + (1U << FIRST_CHUNK_SIZE_LOG) - ChunkSize(chunk_index));
+  }
+};
+}  // namespace terrier::storage
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include "common/macros.h"
+#include "common/spin_latch.h"
+#include "storage/block_layout.h"
+#include "storage/storage_defs.h"
+
+namespace terrier::storage {
+
+/**
+ * The block tiering manager keeps the memory taken up by frozen blocks under a budget by spilling the least recently
+ * accessed ones to files on local disk. Frozen blocks are handed to it by the block compactor as they freeze.
+ *
+ * To spill a block, the manager takes an in-place read on it, so that writers have to wait in
+ * BlockAccessController::WaitUntilHot until it is done, and writes the block out to its own file. It then maps the
+ * file privately over the block's memory, which returns the block's pages to the OS. The first page of the block stays
+ * in memory, because the block header in it (access controller, sampled access count, insert head) keeps changing
+ * while the block is frozen. Readers do not need to know whether a block was spilled: its pages fault back in from the
+ * file when they are touched, and the kernel is free to drop them again under memory pressure. Writers thaw a tracked
+ * block through Thaw, which copies a spilled block back into anonymous memory and deletes its file before anybody
+ * writes to it. The same happens when a table is dropped, so the block store never gets a block backed by a file.
+ *
+ * The file is self-describing so that tools can read it without the catalog. It starts with a FileHeader followed by
+ * one ColumnDescriptor per column (excluding the reserved version column), padded up to a page. Then comes the image
+ * of the block, and the gathered varlen and dictionary buffers of the block's varlen columns. Every descriptor points
+ * at the column's buffers in the file in the Arrow columnar format: the validity bitmap and the values of fixed-length
+ * columns live in the block image, and varlen columns have 32-bit offsets, values and, if dictionary compressed,
+ * 32-bit indices appended after the block image. The in-memory varlen buffers are not spilled, because the VarlenEntry
+ * objects in the block point into them.
+ *
+ * Access recency is tracked from the sampled access count in the block header, with calls to ProcessBlocks serving
+ * as the clock, the same way the access observer detects cold blocks with garbage collections. Spilling only works for
+ * blocks backed by regular pages, as huge pages cannot be partially remapped.
+ */
+class BlockTieringManager {
+ public:
+  /**
+   * Identifies a spilled block file, "TBLOCK" followed by two zero bytes
+   */
+  static constexpr uint64_t FILE_MAGIC = 0x00004B434F4C4254;
+
+  /**
+   * Version of the file layout
+   */
+  static constexpr uint32_t FILE_VERSION = 1;
+
+  /**
+   * Header at the start of every spilled block file
+   */
+  struct FileHeader {
+    /**
+     * always FILE_MAGIC
+     */
+    uint64_t magic_;
+    /**
+     * always FILE_VERSION
+     */
+    uint32_t version_;
+    /**
+     * number of column descriptors following the header
+     */
+    uint16_t num_columns_;
+    /**
+     * layout version of the block
+     */
+    uint16_t layout_version_;
+    /**
+     * number of slots in the block, which is also the length of every column
+     */
+    uint32_t num_slots_;
+    /**
+     * number of records in the block, as recorded in its Arrow metadata
+     */
+    uint32_t num_records_;
+    /**
+     * offset of the block image in the file, page-aligned
+     */
+    uint64_t block_offset_;
+    /**
+     * size of the block image
+     */
+    uint64_t block_size_;
+    /**
+     * size of the whole file
+     */
+    uint64_t file_size_;
+  };
+
+  /**
+   * Describes where the Arrow buffers of a column are in the file. Offsets are from the start of the file.
+   */
+  struct ColumnDescriptor {
+    /**
+     * how the column is stored, an ArrowColumnType
+     */
+    uint8_t arrow_type_;
+    /**
+     * attribute size of the column in the block, with the varlen bit if the column is varlen
+     */
+    uint8_t attr_size_;
+    /**
+     * unused
+     */
+    uint16_t padding_;
+    /**
+     * number of NULLs in the column
+     */
+    uint32_t null_count_;
+    /**
+     * validity bitmap, one bit per slot, least significant bit first
+     */
+    uint64_t validity_offset_;
+    /**
+     * values of a fixed-length column, or the bytes of a varlen column
+     */
+    uint64_t values_offset_;
+    /**
+     * length of the values in bytes
+     */
+    uint64_t values_length_;
+    /**
+     * 32-bit offsets into the values of a varlen column, 0 for fixed-length columns
+     */
+    uint64_t offsets_offset_;
+    /**
+     * 32-bit dictionary indices of a dictionary compressed column, 0 otherwise
+     */
+    uint64_t indices_offset_;
+  };
+
+  /**
+   * @param directory directory to spill blocks to, created if it does not exist
+   * @param memory_budget number of bytes frozen blocks may take up in memory before some of them are spilled
+   *
+   * The manager has to outlive the tables whose blocks it tracks.
+   */
+  BlockTieringManager(std::string directory, uint64_t memory_budget);
+
+  /**
+   * Copies all spilled blocks back into memory and deletes their files.
+   */
+  ~BlockTieringManager();
+
+  DISALLOW_COPY_AND_MOVE(BlockTieringManager)
+
+  /**
+   * Starts tracking a block that was just frozen. The block counts as resident, even if it was spilled before and
+   * its pages have not been touched since.
+   * @param block the block that was just frozen
+   */
+  void AddFrozenBlock(RawBlock *block);
+
+  /**
+   * Stops tracking a block. A spilled block is copied back into memory and its file deleted. Waits for the block to be
+   * written out if it is being spilled at the moment. Tables call this on each of their blocks before they
+   * release them, once the manager has started tracking one.
+   * @param block the block to forget about
+   */
+  void Untrack(RawBlock *block);
+
+  /**
+   * Thaws a frozen block the manager tracks, so that it can be written to. A spilled block is copied back into memory
+   * and its file deleted. Writers call this before BlockAccessController::WaitUntilHot, which waits for the thaw to
+   * finish if another writer got to it first. Does nothing if the block is not tracked or no longer frozen.
+   * @param block the block to thaw
+   */
+  void Thaw(RawBlock *block);
+
+  /**
+   * Advances the recency clock, stops tracking blocks that have thawed, and spills the least recently accessed frozen
+   * blocks until the resident ones fit in the memory budget. Must not be called from more than one thread at a time.
+   * @return number of blocks spilled
+   */
+  uint32_t ProcessBlocks();
+
+  /**
+   * @return number of bytes taken up by tracked frozen blocks that are not spilled
+   */
+  uint64_t ResidentBytes() {
+    common::SpinLatch::ScopedSpinLatch guard(&latch_);
+    return (blocks_.size() - num_spilled_) * common::Constants::BLOCK_SIZE;
+  }
+
+  /**
+   * @return number of tracked blocks that are spilled
+   */
+  uint32_t NumSpilledBlocks() {
+    common::SpinLatch::ScopedSpinLatch guard(&latch_);
+    return num_spilled_;
+  }
+
+  /**
+   * @param block the block to look up
+   * @return path to the file the block is spilled to, or an empty string if it is not spilled
+   */
+  std::string SpilledFile(RawBlock *block);
+
+ private:
+  // What the manager remembers about a frozen block
+  struct BlockInfo {
+    // ProcessBlocks invocation the block was last seen being accessed in
+    uint64_t last_touched_;
+    // Sampled access count of the block as of the last ProcessBlocks invocation
+    uint16_t last_access_count_;
+    // Id of the file the block is spilled to, 0 if it is resident
+    uint64_t file_id_;
+  };
+
+  // Writes the block out to a new file and maps the file over it. Returns false if the block is no longer frozen or
+  // something went wrong, in which case the block is left as it was.
+  bool Spill(RawBlock *block, uint64_t file_id);
+
+  bool WriteBlockFile(RawBlock *block, int fd);
+
+  // Replaces the file mapping of a spilled block with anonymous memory holding the same contents. Nobody may write to
+  // the block or read it in place meanwhile.
+  void Unmap(RawBlock *block) const;
+
+  // Offset of the block image in a file, right after the header and the column descriptors
+  uint64_t BlockOffset(const BlockLayout &layout) const;
+
+  std::string FilePath(uint64_t file_id) const;
+
+  void DeleteFile(uint64_t file_id) const;
+
+  const std::string directory_;
+  const uint64_t memory_budget_;
+  const uint64_t page_size_;
+  // Protects everything below
+  common::SpinLatch latch_;
+  // Here RawBlock * suffices as an identifier of the block for the same reasons it does for the access observer
+  std::unordered_map<RawBlock *, BlockInfo> blocks_;
+  uint32_t num_spilled_ = 0;
+  // Block ProcessBlocks is spilling at the moment, which Untrack has to wait for
+  RawBlock *spilling_ = nullptr;
+  uint64_t epoch_ = 0;
+  uint64_t next_file_id_ = 1;
+};
+}  // namespace terrier::storage
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>  //NOLINT
+#include <thread>  //NOLINT
+#include "storage/block_tiering_manager.h"
+
+namespace terrier::storage {
+
+/**
+ * Class for spinning off a thread that spills cold frozen blocks to disk at a fixed interval. The interval is also the
+ * granularity at which the tiering manager tells recently accessed blocks apart from the rest.
+ */
+class BlockTieringThread {
+ public:
+  /**
+   * @param tiering_manager pointer to the block tiering manager to be run on this thread
+   * @param tiering_period sleep time between tiering rounds
+   */
+  BlockTieringThread(BlockTieringManager *tiering_manager, std::chrono::milliseconds tiering_period);
+
+  ~BlockTieringThread() {
+    run_tiering_ = false;
+    tiering_thread_.join();
+  }
+
+  /**
+   * Pause tiering, typically for use in tests when the state of blocks need to be fixed.
+   */
+  void PauseTiering() {
+    TERRIER_ASSERT(!tiering_paused_, "Tiering should not already be paused.");
+    tiering_paused_ = true;
+  }
+
+  /**
+   * Resume tiering after being paused.
+   */
+  void ResumeTiering() {
+    TERRIER_ASSERT(tiering_paused_, "Tiering should already be paused.");
+    tiering_paused_ = false;
+  }
+
+  /**
+   * @return the underlying block tiering manager
+   */
+  BlockTieringManager &GetBlockTieringManager() { return *tiering_manager_; }
+
+ private:
+  BlockTieringManager *tiering_manager_;
+  volatile bool run_tiering_;
+  volatile bool tiering_paused_;
+  std::chrono::milliseconds tiering_period_;
+  std::thread tiering_thread_;
+
+  void TieringThreadLoop() {
+    while (run_tiering_) {
+      std::this_thread::sleep_for(tiering_period_);
+      if (!tiering_paused_) tiering_manager_->ProcessBlocks();
+    }
+  }
+};
+
+}  // namespace terrier::storage
@@ -1,8 +1,10 @@
 #pragma once
-#include <list>
+#include <array>
+#include <atomic>
 #include <unordered_map>
 #include <vector>
 #include "common/performance_counter.h"
+#include "storage/block_directory.h"
 #include "storage/projected_columns.h"
 #include "storage/storage_defs.h"
 #include "storage/tuple_access_strategy.h"
@@ -15,12 +17,16 @@ class TransactionManager;
 
 namespace terrier::storage {
 
+class BlockTieringManager;
+
 namespace index {
 class Index;
 template <typename KeyType>
 class BwTreeIndex;
 template <typename KeyType>
 class HashIndex;
+template <typename KeyType>
+class ArtIndex;
 }  // namespace index
 
 // clang-format off
@@ -43,6 +49,7 @@ class DataTable {
  public:
   /**
    * Iterator for all the slots, claimed or otherwise, in the data table. This is useful for sequential scans.
+   * Advancing the iterator is latch-free; the block directory is only consulted at block boundaries.
    */
   class SlotIterator {
    public:
@@ -91,18 +98,17 @@ class DataTable {
 
    private:
     friend class DataTable;
-    /**
-     * @warning MUST BE CALLED ONLY WHEN CALLER HOLDS LOCK TO THE LIST OF RAW BLOCKS IN THE DATA TABLE
-     */
-    SlotIterator(const DataTable *table, std::list<RawBlock *>::const_iterator block, uint32_t offset_in_block)
-        : table_(table), block_(block) {
-      current_slot_ = {block == table->blocks_.end() ? nullptr : *block, offset_in_block};
+    SlotIterator(const DataTable *table, uint32_t block_index, uint32_t offset_in_block)
+        : table_(table), block_index_(block_index) {
+      // Cannot look up a block past the end of the directory, so just use nullptr to denote
+      current_slot_ = {block_index < table->blocks_.Size() ? table->blocks_[block_index] : nullptr, offset_in_block};
     }
 
     // TODO(Tianyu): Can potentially collapse this information into the RawBlock so we don't have to hold a pointer to
     // the table anymore. Right now we need the table to know how many slots there are in the block
     const DataTable *table_;
-    std::list<RawBlock *>::const_iterator block_;
+    // Index of the block in the table's block directory
+    uint32_t block_index_;
     TupleSlot current_slot_;
   };
   /**
@@ -150,13 +156,23 @@ class DataTable {
    */
   void Scan(transaction::TransactionContext *txn, SlotIterator *start_pos, ProjectedColumns *out_buffer) const;
 
+  /**
+   * Same as Scan, but stops at the given end position (exclusive) instead of the end of the table. This is used to
+   * scan a sub-range of the table's blocks, e.g. a morsel in a parallel scan.
+   *
+   * @param txn the calling transaction
+   * @param start_pos iterator to the starting location for the sequential scan
+   * @param end_pos iterator to one slot past the last slot to scan
+   * @param out_buffer output buffer. The object should already contain projection list information. This buffer is
+   *                   always cleared of old values.
+   */
+  void RangeScan(transaction::TransactionContext *txn, SlotIterator *start_pos, const SlotIterator &end_pos,
+                 ProjectedColumns *out_buffer) const;
+
   /**
    * @return the first tuple slot contained in the data table
    */
-  SlotIterator begin() const {  // NOLINT for STL name compability
-    common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
-    return {this, blocks_.begin(), 0};
-  }
+  SlotIterator begin() const { return {this, 0, 0}; }  // NOLINT for STL name compability
 
   /**
    * Returns one past the last tuple slot contained in the data table. Note that this is not an accurate number when
@@ -167,6 +183,102 @@ class DataTable {
    */
   SlotIterator end() const;  // NOLINT for STL name compability
 
+  /**
+   * Returns an iterator to the first slot of the block at the given index in the block directory. If the index is not
+   * smaller than the number of blocks, this is equivalent to end(). Together, beginAt(i) and beginAt(j) delimit the
+   * slots of blocks [i, j). This takes constant time, so a parallel scan can cheaply split the table into morsels.
+   *
+   * @param block_index index of the block in the data table's block directory
+   * @return iterator to the first slot of the given block
+   */
+  SlotIterator beginAt(uint32_t block_index) const;  // NOLINT for STL name compability
+
+  /**
+   * @return the number of blocks currently in the data table. Like end(), this is only a snapshot under concurrent
+   *         inserts.
+   */
+  uint32_t GetNumBlocks() const { return blocks_.Size(); }
+
+  /**
+   * @param pos iterator to any slot in the table
+   * @return iterator to the first slot of the block following the one the given iterator points into
+   */
+  SlotIterator NextBlock(const SlotIterator &pos) const;
+
+  /**
+   * Attempts to get in-place read access to the given block, so its tuples can be read directly out of block memory
+   * instead of being materialized. This only succeeds if the block is FROZEN, in which case the first
+   * InPlaceNumRecords() slots of the block are contiguous, unversioned, and visible to every running transaction.
+   * Writers to the block wait until access is released, so the caller must call ReleaseInPlaceRead as soon as it no
+   * longer references the block's memory.
+   *
+   * @param block the block to read in place
+   * @return true if in-place access is granted, false if the block has to be read transactionally
+   */
+  bool TryAcquireInPlaceRead(RawBlock *block) const {
+    if (!block->controller_.TryAcquireInPlaceRead()) return false;
+    // A scan reads the whole block through one in-place read, and taking it already writes to the block header, so
+    // every one counts towards the block's accesses instead of a sample of them
+    block->access_count_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /**
+   * Releases in-place read access to a block obtained through TryAcquireInPlaceRead.
+   * @param block the block to release
+   */
+  void ReleaseInPlaceRead(RawBlock *block) const { block->controller_.ReleaseInPlaceRead(); }
+
+  /**
+   * @param block a block the caller has in-place read access to
+   * @return the number of tuples in the block, all stored contiguously starting at slot 0
+   */
+  uint32_t InPlaceNumRecords(RawBlock *block) const { return accessor_.GetArrowBlockMetadata(block).NumRecords(); }
+
+  /**
+   * @param block a block the caller has in-place read access to
+   * @param col_id the column of interest
+   * @param offset the slot to start reading at
+   * @return pointer to the value of the given column at the given slot in block memory. Subsequent slots follow
+   *         contiguously.
+   */
+  const byte *InPlaceColumnValues(RawBlock *block, const col_id_t col_id, const uint32_t offset) const {
+    return accessor_.ColumnStart(block, col_id) + accessor_.GetBlockLayout().AttrSize(col_id) * offset;
+  }
+
+  /**
+   * @param block a block the caller has in-place read access to
+   * @param col_id the column of interest
+   * @param offset the slot to start reading at. Must be a multiple of 8.
+   * @return null bitmap of the given column, starting at the given slot. A set bit means the value is present.
+   */
+  const common::RawBitmap *InPlaceColumnNullBitmap(RawBlock *block, const col_id_t col_id,
+                                                   const uint32_t offset) const {
+    TERRIER_ASSERT(offset % BYTE_SIZE == 0, "in-place null bitmaps can only start at a byte boundary");
+    // A frozen block is not modified while it is being read in place, so the bitmap does not need atomic accesses
+    return reinterpret_cast<const common::RawBitmap *>(
+        reinterpret_cast<const uint8_t *>(accessor_.ColumnNullBitmap(block, col_id)) + offset / BYTE_SIZE);
+  }
+
+  /**
+   * @param block a block the caller has in-place read access to
+   * @param col_id the column of interest
+   * @return the number of NULLs in the given column of the block
+   */
+  uint32_t InPlaceNullCount(RawBlock *block, const col_id_t col_id) const {
+    return accessor_.GetArrowBlockMetadata(block).NullCount(col_id);
+  }
+
+  /**
+   * @param block a block the caller has in-place read access to
+   * @param col_id the column of interest
+   * @return Arrow metadata of the given column in the block, e.g. its gathered varlen or dictionary buffers,
+   *         or its zone map
+   */
+  ArrowColumnInfo *InPlaceArrowColumnInfo(RawBlock *block, const col_id_t col_id) const {
+    return &accessor_.GetArrowBlockMetadata(block).GetColumnInfo(accessor_.GetBlockLayout(), col_id);
+  }
+
   /**
    * Update the tuple according to the redo buffer given, and update the version chain to link to an
    * undo record that is allocated in the txn. The undo record is populated with a before-image of the tuple in the
@@ -202,6 +314,26 @@ class DataTable {
    */
   bool Delete(transaction::TransactionContext *txn, TupleSlot slot);
 
+  /**
+   * Number of insertion lanes. Inserting threads are spread over the lanes, and each lane keeps inserting into one
+   * block until it is full, so threads do not all start from the insertion head and compete for the same block.
+   */
+  static constexpr uint32_t NUM_INSERTION_LANES = 64;
+
+  /**
+   * Mask of the lane index in the tag an insertion lane claims blocks with. The rest of the tag is the generation of
+   * the lane, which tells claims of the thread holding the lane now apart from those of earlier threads.
+   */
+  static constexpr uint64_t LANE_INDEX_MASK = 0xFFFFFFFF;
+
+  /**
+   * Hot tuples can build up long version chains between GC runs, which every reader then has to walk. A reader that
+   * walks at least this many versions to reconstruct a tuple cuts off the versions below the ones it read that no
+   * running transaction can see anymore, instead of waiting for the GC. Writers do the same below the version they
+   * install. Either only looks this many versions further down, so that pruning stays cheap.
+   */
+  static constexpr uint32_t VERSION_CHAIN_PRUNE_THRESHOLD = 8;
+
   /**
    * Return a pointer to the performance counter for the data table.
    * @return pointer to the performance counter
@@ -224,9 +356,13 @@ class DataTable {
   friend class index::BwTreeIndex;
   template <typename KeyType>
   friend class index::HashIndex;
+  template <typename KeyType>
+  friend class index::ArtIndex;
   // The block compactor elides transactional protection in the gather/compression phase and
   // needs raw access to the underlying table.
   friend class BlockCompactor;
+  // The block tiering manager registers itself with the tables whose blocks it tracks
+  friend class BlockTieringManager;
 
   BlockStore *const block_store_;
   const layout_version_t layout_version_;
@@ -235,27 +371,66 @@ class DataTable {
   // TODO(Tianyu): For now, on insertion, we simply sequentially go through a block and allocate a
   // new one when the current one is full. Needless to say, we will need to revisit this when extending GC to handle
   // deleted tuples and recycle slots
-  // TODO(Tianyu): Now that we are switching to a linked list, there probably isn't a reason for it
-  // to be latched. Could just easily write a lock-free one if there's performance gain(probably not). vector->list has
-  // negligible difference in insert performance (within margin of error) when benchmarked.
-  // We also might need our own implementation because we need to handle GC of an unlinked block, as a sequential scan
+  // TODO(Tianyu): We might need to handle GC of an unlinked block once blocks can be removed, as a sequential scan
   // might be on it
-  std::list<RawBlock *> blocks_;
-  // latch used to protect block list
-  mutable common::SpinLatch blocks_latch_;
-  // latch used to protect insertion_head_
+  BlockDirectory blocks_;
+  // latch used to serialize moves of insertion_head_
   mutable common::SpinLatch header_latch_;
-  std::list<RawBlock *>::iterator insertion_head_;
+  // Index of the first block that may have free tuple slots
+  std::atomic<uint32_t> insertion_head_{0};
+  // Block each insertion lane last inserted into, or nullptr if the lane has to look for one from insertion_head_
+  // first. The lane only keeps inserting into the block while the block header still carries its tag.
+  std::array<std::atomic<RawBlock *>, NUM_INSERTION_LANES> insertion_blocks_;
+  // Tiering manager that tracks frozen blocks of this table, if any. It has to let go of them before they are released.
+  std::atomic<BlockTieringManager *> tiering_manager_{nullptr};
   // Check if we need to advance the insertion_head_
   // This function uses header_latch_ to ensure correctness
-  void CheckMoveHead(std::list<RawBlock *>::iterator block);
+  void CheckMoveHead(uint32_t block_index);
+
+  // Whether the block is claimed by the live insertion lane of another thread than the one with the given lane tag. New
+  // blocks for a lane are only looked for among the blocks no other lane inserts into, so that concurrent inserters end
+  // up in different blocks. The claim is read from the block header, so this does not depend on the number of lanes.
+  static bool ClaimedByOtherLane(const RawBlock *block, uint64_t lane_tag);
+
+  /**
+   * The calling thread holds an insertion lane from its first insert until it exits, after which the lane is free for
+   * the next thread to take. If all lanes are held, the thread inserts without a lane of its own.
+   * @return the tag the calling thread claims blocks for its insertion lane with, or 0 if it has no lane
+   */
+  static uint64_t ThreadInsertionLaneTag();
+
   mutable DataTableCounter data_table_counter_;
 
+  // Only every ACCESS_SAMPLE_INTERVAL-th access of a thread is counted in the header of the block it touches, which the
+  // AccessObserver uses to tell hot blocks from cold ones. Counting every access would make the header of a hot block a
+  // contended cache line.
+  static constexpr uint32_t ACCESS_SAMPLE_INTERVAL = 64;
+  static void SampleAccess(RawBlock *const block) {
+    thread_local uint32_t num_accesses = 0;
+    if (++num_accesses % ACCESS_SAMPLE_INTERVAL == 0) block->access_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Waits for in-place readers to leave the block and makes sure it is hot, so that it can be written to
+  void WaitUntilHot(RawBlock *block) const;
+
   // A templatized version for select, so that we can use the same code for both row and column access.
   // the method is explicitly instantiated for ProjectedRow and ProjectedColumns::RowView
   template <class RowType>
   bool SelectIntoBuffer(transaction::TransactionContext *txn, TupleSlot slot, RowType *out_buffer) const;
 
+  // Materializes the visible tuples among num_slots consecutive slots of the block, starting at start_offset, into
+  // out_buffer starting at row out_start. Slots without a version chain are copied a column range at a time, and only
+  // slots with versions are reconstructed tuple-at-a-time. Returns the number of rows written. The caller needs to
+  // make sure that there is room for num_slots rows in the buffer.
+  uint32_t SelectBlockRangeIntoBuffer(transaction::TransactionContext *txn, RawBlock *block, uint32_t start_offset,
+                                      uint32_t num_slots, ProjectedColumns *out_buffer, uint32_t out_start) const;
+
+  // Copies a run of consecutive slots that had no version chain and were visible into out_buffer starting at row
+  // out_start, then checks that this is still the case. Falls back to SelectIntoBuffer for the run otherwise. Returns
+  // the number of rows written.
+  uint32_t CopyCleanRunIntoBuffer(transaction::TransactionContext *txn, RawBlock *block, uint32_t start_offset,
+                                  uint32_t num_slots, ProjectedColumns *out_buffer, uint32_t out_start) const;
+
   void InsertInto(transaction::TransactionContext *txn, const ProjectedRow &redo, TupleSlot dest);
   // Atomically read out the version pointer value.
   UndoRecord *AtomicallyReadVersionPtr(TupleSlot slot, const TupleAccessStrategy &accessor) const;
@@ -264,6 +439,12 @@ class DataTable {
   // contention
   void AtomicallyWriteVersionPtr(TupleSlot slot, const TupleAccessStrategy &accessor, UndoRecord *desired);
 
+  // Cuts off the versions below the given record in its version chain that are older than the oldest running txn, as
+  // of the TimestampManager's cached value, looking at most VERSION_CHAIN_PRUNE_THRESHOLD versions down. Returns
+  // whether any were cut off. Never changes the version pointer and never frees a record, both are left to the GC, so
+  // this is safe to call concurrently with other readers and writers, and with the GC.
+  bool PruneVersionChain(const transaction::TransactionContext &txn, UndoRecord *from) const;
+
   // Checks for Snapshot Isolation conflicts, used by Update
   bool HasConflict(const transaction::TransactionContext &txn, UndoRecord *version_ptr) const;
 
@@ -293,5 +474,11 @@ class DataTable {
    * @return true if tuple is visible to this txn, false otherwise
    */
   bool IsVisible(const transaction::TransactionContext &txn, TupleSlot slot) const;
+
+  // Hints the CPU to load the version pointer of the slot, which IsVisible reads first. Lets indexes overlap the cache
+  // misses of the visibility checks on a batch of results.
+  void PrefetchVersionPtr(const TupleSlot slot) const {
+    __builtin_prefetch(accessor_.AccessWithoutNullCheck(slot, VERSION_POINTER_COLUMN_ID));
+  }
 };
 }  // namespace terrier::storage
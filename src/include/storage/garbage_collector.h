@@ -1,9 +1,13 @@
 #pragma once
 
+#include <memory>
 #include <queue>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 #include "common/shared_latch.h"
+#include "common/worker_pool.h"
+#include "di/di_help.h"
 #include "storage/access_observer.h"
 #include "storage/index/index.h"
 #include "transaction/transaction_context.h"
@@ -20,6 +24,7 @@ namespace terrier::storage {
  */
 class GarbageCollector {
  public:
+  DECLARE_ANNOTATION(NUM_GC_THREADS)
   /**
    * Constructor for the Garbage Collector that requires a pointer to the TransactionManager. This is necessary for the
    * GC to invoke the TM's function for handing off the completed transactions queue.
@@ -30,20 +35,28 @@ class GarbageCollector {
    *                 it is not null. The observer can then gain insight invoke other components to perform actions.
    *                 The observer's function implementation needs to be lightweight because it is called on the GC
    *                 thread.
+   * @param num_gc_threads number of workers unlinking and deallocating completed transactions. Version chains are
+   *                       partitioned between the workers by block, so every chain is truncated by exactly one of them.
+   *                       With 1, all work is done on the thread invoking the GC.
    */
   // TODO(Tianyu): Eventually the GC will be re-written to be purely on the deferred action manager. which will
   //  eliminate this perceived redundancy of taking in a transaction manager.
+  BOOST_DI_INJECT(GarbageCollector, transaction::TimestampManager *timestamp_manager,
+                  transaction::DeferredActionManager *deferred_action_manager,
+                  transaction::TransactionManager *txn_manager, AccessObserver *observer,
+                  (named = NUM_GC_THREADS) uint32_t num_gc_threads);
+
+  /**
+   * Constructs a Garbage Collector that does all work on the thread invoking it.
+   * @param timestamp_manager source of timestamps in the system
+   * @param deferred_action_manager pointer to deferred action manager of the system
+   * @param txn_manager pointer to the TransactionManager
+   * @param observer the access observer attached to this GC, can be null
+   */
   GarbageCollector(transaction::TimestampManager *timestamp_manager,
                    transaction::DeferredActionManager *deferred_action_manager,
                    transaction::TransactionManager *txn_manager, AccessObserver *observer)
-      : timestamp_manager_(timestamp_manager),
-        deferred_action_manager_(deferred_action_manager),
-        txn_manager_(txn_manager),
-        observer_(observer),
-        last_unlinked_{0} {
-    TERRIER_ASSERT(txn_manager_->GCEnabled(),
-                   "The TransactionManager needs to be instantiated with gc_enabled true for GC to work!");
-  }
+      : GarbageCollector(timestamp_manager, deferred_action_manager, txn_manager, observer, 1) {}
 
   ~GarbageCollector() {
     TERRIER_ASSERT(txns_to_deallocate_.empty(), "Not all txns have been deallocated");
@@ -93,7 +106,26 @@ class GarbageCollector {
 
   void ReclaimSlotIfDeleted(UndoRecord *undo_record) const;
 
-  void ReclaimBufferIfVarlen(transaction::TransactionContext *txn, UndoRecord *undo_record) const;
+  /**
+   * Truncates the version chains and reclaims the slots and varlens of all records of the given txns that belong to
+   * one partition. Partitions can be processed concurrently.
+   * @param txns txns that are safe to unlink
+   * @param oldest_txn start time of the oldest running txn
+   * @param partition the partition to process
+   */
+  void UnlinkPartition(const std::vector<transaction::TransactionContext *> &txns, transaction::timestamp_t oldest_txn,
+                       uint32_t partition);
+
+  /**
+   * @param block a block
+   * @return the partition the version chains of the block belong to
+   */
+  uint32_t PartitionOf(const RawBlock *block) const {
+    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(block) / common::Constants::BLOCK_SIZE % num_gc_threads_);
+  }
+
+  void ReclaimBufferIfVarlen(transaction::TransactionContext *txn, UndoRecord *undo_record,
+                             std::vector<std::pair<transaction::TransactionContext *, const byte *>> *loose_ptrs) const;
 
   void TruncateVersionChain(DataTable *table, TupleSlot slot, transaction::timestamp_t oldest) const;
 
@@ -110,6 +142,24 @@ class GarbageCollector {
   // queue of txns that need to be unlinked
   transaction::TransactionQueue txns_to_unlink_;
 
+  // Work of one partition of an unlink pass, kept around to reuse its allocations across GC invocations
+  struct GCPartition {
+    // It is sufficient to truncate each version chain once in a GC invocation because we only read the maximal safe
+    // timestamp once, and the version chain is sorted by timestamp. Here we keep a set of slots to truncate to avoid
+    // wasteful traversals of the version chain.
+    std::unordered_set<TupleSlot> visited_slots_;
+    // Varlen buffers to free along with the txn that made them unreachable. Txns span partitions, so these are only
+    // handed to the txns once all partitions are done.
+    std::vector<std::pair<transaction::TransactionContext *, const byte *>> loose_ptrs_;
+    // Blocks written by the unlinked records, reported to the observer once all partitions are done
+    std::unordered_set<RawBlock *> written_blocks_;
+  };
+
+  const uint32_t num_gc_threads_;
+  std::vector<GCPartition> partitions_;
+  // Workers processing the partitions, only present with more than one GC thread
+  std::unique_ptr<common::WorkerPool> gc_pool_;
+
   std::unordered_set<index::Index *> indexes_;
   common::SharedLatch indexes_latch_;
 };
@@ -0,0 +1,1182 @@
+#pragma once
+
+#include <immintrin.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "common/macros.h"
+#include "common/spin_latch.h"
+#include "storage/storage_defs.h"
+
+namespace terrier::storage::index {
+
+/**
+ * A concurrent Adaptive Radix Tree (Leis et al., ICDE 2013) that maps binary-comparable keys to TupleSlots. A key can
+ * hold several values, for non-unique indexes.
+ *
+ * Inner nodes come in four sizes (4, 16, 48 and 256 children) and store their compressed path in full, so that range
+ * scans can compare it against their bounds. They are synchronized with optimistic lock coupling (Leis et al., DaMoN
+ * 2016): every node has a version, readers validate it after reading the node instead of locking, and writers lock only
+ * the node they modify and, when that node has to be replaced, its parent. The version of a parent is validated again
+ * after the version of its child has been read, so that nobody enters a node whose compressed path was changed after
+ * the parent was checked. Leaves hold the full key and are latched
+ * while their values are read or modified. Replaced nodes and removed leaves are reclaimed through epochs, which
+ * advance on PerformGarbageCollection.
+ *
+ * Keys are compared with std::memcmp semantics and must be prefix-free, i.e. no key may be a proper prefix of another
+ * one. Fixed-length keys satisfy this, and so do the binary-comparable encodings of GenericKey.
+ */
+class AdaptiveRadixTree {
+ public:
+  AdaptiveRadixTree() : root_(NewNode<Node256>(nullptr, 0)) {}
+
+  /**
+   * Frees all nodes, leaves and garbage. No other thread may access the tree anymore.
+   */
+  ~AdaptiveRadixTree() {
+    FreeSubtree(root_);
+    for (const auto &garbage : garbage_) FreeChild(garbage.child_);
+  }
+
+  DISALLOW_COPY_AND_MOVE(AdaptiveRadixTree)
+
+  /**
+   * Adds a value to a key.
+   * @param key binary-comparable key
+   * @param key_size size of the key in bytes
+   * @param value value to add
+   * @return false if the key already holds the value, true otherwise
+   */
+  bool Insert(const byte *const key, const uint16_t key_size, const TupleSlot value) {
+    bool predicate_satisfied = false;
+    return InsertInternal(key, key_size, value, nullptr, &predicate_satisfied);
+  }
+
+  /**
+   * Adds a value to a key unless the predicate holds for one of the values the key already has. The predicate is
+   * evaluated while the key's values cannot change.
+   * @param key binary-comparable key
+   * @param key_size size of the key in bytes
+   * @param value value to add
+   * @param predicate evaluated on the existing values of the key
+   * @param[out] predicate_satisfied whether the predicate held for one of the existing values
+   * @return true if the value was added, false if the predicate held or the key already holds the value
+   */
+  bool ConditionalInsert(const byte *const key, const uint16_t key_size, const TupleSlot value,
+                         const std::function<bool(TupleSlot)> &predicate, bool *const predicate_satisfied) {
+    return InsertInternal(key, key_size, value, &predicate, predicate_satisfied);
+  }
+
+  /**
+   * Removes a value from a key, and the key from the tree if it has no values left.
+   * @param key binary-comparable key
+   * @param key_size size of the key in bytes
+   * @param value value to remove
+   * @return true if the key held the value, false otherwise
+   */
+  bool Delete(const byte *const key, const uint16_t key_size, const TupleSlot value) {
+    EpochGuard guard(this);
+    bool deleted = false, emptied = false;
+    while (!TryDeleteValue(key, key_size, value, &deleted, &emptied)) {
+    }
+    if (emptied) {
+      while (!TryRemoveLeaf(key, key_size)) {
+      }
+    }
+    return deleted;
+  }
+
+  /**
+   * Finds the values of a key.
+   * @param key binary-comparable key
+   * @param key_size size of the key in bytes
+   * @param[out] values the values of the key are appended to it
+   */
+  void GetValue(const byte *const key, const uint16_t key_size, std::vector<TupleSlot> *const values) const {
+    EpochGuard guard(this);
+    const auto num_values = values->size();
+    while (!TryGetValue(key, key_size, values)) values->resize(num_values);
+  }
+
+  /**
+   * Finds the values of a batch of keys. Up to BATCH_LOOKUPS lookups are in flight at once: every round advances each
+   * of them by one node and prefetches the node it moves to, so that the cache misses of different keys overlap.
+   * @tparam KeyAt callable taking the number of a key and returning the binary-comparable key and its size in bytes
+   * @param num_keys number of keys
+   * @param key_at gives access to the keys
+   * @param[out] values the values of the keys are appended to it, key by key
+   * @param[out] offsets offsets[i] is set to the size of values before the values of key i were appended, and
+   *                     offsets[num_keys] to the size of values at the end
+   */
+  template <typename KeyAt>
+  void GetValues(const uint32_t num_keys, KeyAt key_at, std::vector<TupleSlot> *const values,
+                 uint32_t *const offsets) const {
+    EpochGuard guard(this);
+
+    // Lookups finish out of order, so they only find the leaf each key would be in. The leaves stay allocated until
+    // the guard is released.
+    std::vector<const Leaf *> leaves(num_keys);
+    BatchLookup lookups[BATCH_LOOKUPS];
+    uint32_t num_lookups = 0;
+    uint32_t next_key = 0;
+    while (num_lookups > 0 || next_key < num_keys) {
+      while (num_lookups < BATCH_LOOKUPS && next_key < num_keys)
+        lookups[num_lookups++] = {next_key++, root_, 0, nullptr, 0};
+      for (uint32_t i = 0; i < num_lookups;) {
+        BatchLookup *const lookup = &lookups[i];
+        const std::pair<const byte *, uint16_t> key = key_at(lookup->key_);
+        if (StepLookup(key.first, key.second, lookup, &leaves[lookup->key_]))
+          *lookup = lookups[--num_lookups];
+        else
+          i++;
+      }
+    }
+
+    // The leaves were prefetched when they were found, the values are read in key order
+    for (uint32_t i = 0; i < num_keys; i++) {
+      const auto num_values = values->size();
+      offsets[i] = static_cast<uint32_t>(num_values);
+      const Leaf *const leaf = leaves[i];
+      const std::pair<const byte *, uint16_t> key = key_at(i);
+      if (leaf == nullptr || !KeyEquals(leaf, key.first, key.second)) continue;
+      bool removed;
+      {
+        common::SpinLatch::ScopedSpinLatch latch(&leaf->latch_);
+        removed = leaf->removed_;
+        if (!removed)
+          for (uint32_t j = 0; j < leaf->num_values_; j++) values->push_back(leaf->Value(j));
+      }
+      // The leaf was unlinked in the meantime, so the key is looked up again on its own
+      if (removed) {
+        while (!TryGetValue(key.first, key.second, values)) values->resize(num_values);
+      }
+    }
+    offsets[num_keys] = static_cast<uint32_t>(values->size());
+  }
+
+  /**
+   * Visits the values of all keys between the given bounds in ascending key order. The scan is not atomic: it sees
+   * every key that was in the tree when it started and was not removed before it got there, and may or may not see
+   * keys that are added concurrently.
+   * @tparam Consumer callable taking a TupleSlot and returning whether the scan should go on
+   * @param low_key inclusive lower bound
+   * @param low_key_size size of the lower bound in bytes
+   * @param high_key inclusive upper bound
+   * @param high_key_size size of the upper bound in bytes
+   * @param consumer invoked with every value, the values of a key in no particular order
+   */
+  template <typename Consumer>
+  void ScanAscending(const byte *const low_key, const uint16_t low_key_size, const byte *const high_key,
+                     const uint16_t high_key_size, Consumer consumer) const {
+    EpochGuard guard(this);
+    const ScanBounds bounds{low_key, low_key_size, high_key, high_key_size, false, false};
+    Scan<true>(bounds, &consumer);
+  }
+
+  /**
+   * Visits the values of all keys between the given bounds in descending key order, see ScanAscending.
+   * @tparam Consumer callable taking a TupleSlot and returning whether the scan should go on
+   * @param low_key inclusive lower bound
+   * @param low_key_size size of the lower bound in bytes
+   * @param high_key inclusive upper bound
+   * @param high_key_size size of the upper bound in bytes
+   * @param consumer invoked with every value, the values of a key in no particular order
+   */
+  template <typename Consumer>
+  void ScanDescending(const byte *const low_key, const uint16_t low_key_size, const byte *const high_key,
+                      const uint16_t high_key_size, Consumer consumer) const {
+    EpochGuard guard(this);
+    const ScanBounds bounds{low_key, low_key_size, high_key, high_key_size, false, false};
+    Scan<false>(bounds, &consumer);
+  }
+
+  /**
+   * Frees the nodes and leaves that were unlinked before the current epoch, if no thread can still be reading them, and
+   * starts a new epoch. Reclamation therefore lags two calls behind unlinking.
+   */
+  void PerformGarbageCollection() {
+    common::SpinLatch::ScopedSpinLatch guard(&garbage_latch_);
+    const uint64_t epoch = epoch_.load();
+    // Threads that entered in the previous epoch share their counters with the next one, so the epoch can only advance
+    // once all of them have left
+    for (const auto &stripe : stripes_)
+      if (stripe.active_[(epoch + 1) % 2].load() != 0) return;
+    // Every thread still inside entered during the current epoch, after everything retired before it was unlinked
+    auto first_alive = std::partition(garbage_.begin(), garbage_.end(),
+                                      [=](const Garbage &garbage) { return garbage.epoch_ < epoch; });
+    for (auto it = garbage_.begin(); it != first_alive; ++it) FreeChild(it->child_);
+    garbage_.erase(garbage_.begin(), first_alive);
+    epoch_.store(epoch + 1);
+  }
+
+ private:
+  // Low bits of a node's version
+  static constexpr uint64_t OBSOLETE = 1;
+  static constexpr uint64_t LOCKED = 2;
+  // Marks a free slot in the child index of a Node48
+  static constexpr uint8_t EMPTY_SLOT = 48;
+  // Number of cache lines the epoch counters are spread over to keep threads from contending on them
+  static constexpr uint32_t NUM_STRIPES = 64;
+  // Number of lookups GetValues keeps in flight
+  static constexpr uint32_t BATCH_LOOKUPS = 16;
+
+  enum class NodeType : uint8_t { N4, N16, N48, N256 };
+
+  // Outcome of scanning a subtree. RESTART means that a node changed underneath the scan.
+  enum class ScanResult : uint8_t { CONTINUE, STOP, RESTART };
+
+  // The compressed path of a node is stored after the node's children. Its size only shrinks while the node is alive,
+  // so that optimistic readers never read past the allocation.
+  struct Node {
+    explicit Node(const NodeType type) : type_(type) {}
+    std::atomic<uint64_t> version_{0};
+    const NodeType type_;
+    uint16_t num_children_ = 0;
+    uint32_t prefix_size_ = 0;
+  };
+
+  // Children are sorted by key byte
+  struct Node4 : Node {
+    Node4() : Node(NodeType::N4) {}
+    uint8_t keys_[4];
+    Node *children_[4];
+  };
+
+  // Children are sorted by key byte
+  struct Node16 : Node {
+    Node16() : Node(NodeType::N16) {}
+    uint8_t keys_[16];
+    Node *children_[16];
+  };
+
+  // Key bytes index into the children, free children are nullptr
+  struct Node48 : Node {
+    Node48() : Node(NodeType::N48) {
+      std::memset(child_index_, EMPTY_SLOT, sizeof(child_index_));
+      std::fill(children_, children_ + 48, nullptr);
+    }
+    uint8_t child_index_[256];
+    Node *children_[48];
+  };
+
+  struct Node256 : Node {
+    Node256() : Node(NodeType::N256) { std::fill(children_, children_ + 256, nullptr); }
+    Node *children_[256];
+  };
+
+  // Children pointing at leaves are tagged in their lowest bit. The key is stored after the leaf. A leaf without values
+  // is about to be removed from the tree, and removed_ is set once it has been unlinked.
+  struct Leaf {
+    explicit Leaf(const uint16_t key_size) : key_size_(key_size) {}
+    mutable common::SpinLatch latch_;
+    bool removed_ = false;
+    const uint16_t key_size_;
+    uint32_t num_values_ = 0;
+    TupleSlot first_value_;
+    std::vector<TupleSlot> more_values_;
+
+    const byte *Key() const { return reinterpret_cast<const byte *>(this + 1); }
+    TupleSlot Value(const uint32_t i) const { return i == 0 ? first_value_ : more_values_[i - 1]; }
+
+    void AddValue(const TupleSlot value) {
+      if (num_values_++ == 0)
+        first_value_ = value;
+      else
+        more_values_.push_back(value);
+    }
+
+    void RemoveValue(const uint32_t i) {
+      if (num_values_-- == 1) return;
+      const TupleSlot last = more_values_.back();
+      more_values_.pop_back();
+      if (i == 0)
+        first_value_ = last;
+      else if (i - 1 < more_values_.size())
+        more_values_[i - 1] = last;
+    }
+  };
+
+  struct Garbage {
+    Node *child_;
+    uint64_t epoch_;
+  };
+
+  struct alignas(64) EpochStripe {
+    std::atomic<uint64_t> active_[2] = {};
+  };
+
+  // A scan that restarts resumes after the last key it visited, which then becomes an exclusive bound
+  struct ScanBounds {
+    const byte *low_key_;
+    uint16_t low_key_size_;
+    const byte *high_key_;
+    uint16_t high_key_size_;
+    bool low_exclusive_ = false;
+    bool high_exclusive_ = false;
+  };
+
+  // State of a lookup of GetValues between two steps. The node has been prefetched but not read yet, the version of its
+  // parent is validated once the version of the node has been read.
+  struct BatchLookup {
+    uint32_t key_;
+    const Node *node_;
+    uint32_t depth_;
+    const Node *parent_;
+    uint64_t parent_version_;
+  };
+
+  // Keeps the calling thread in the current epoch for the duration of an operation
+  class EpochGuard {
+   public:
+    explicit EpochGuard(const AdaptiveRadixTree *const tree)
+        : stripe_(&tree->stripes_[std::hash<std::thread::id>()(std::this_thread::get_id()) % NUM_STRIPES]) {
+      while (true) {
+        epoch_ = tree->epoch_.load();
+        stripe_->active_[epoch_ % 2].fetch_add(1);
+        if (tree->epoch_.load() == epoch_) break;
+        stripe_->active_[epoch_ % 2].fetch_sub(1);
+      }
+    }
+    ~EpochGuard() { stripe_->active_[epoch_ % 2].fetch_sub(1); }
+    DISALLOW_COPY_AND_MOVE(EpochGuard)
+
+   private:
+    EpochStripe *const stripe_;
+    uint64_t epoch_;
+  };
+
+  Node *const root_;
+  std::atomic<uint64_t> epoch_{0};
+  mutable EpochStripe stripes_[NUM_STRIPES];
+  common::SpinLatch garbage_latch_;
+  std::vector<Garbage> garbage_;
+
+  static bool IsLeaf(const Node *const child) { return (reinterpret_cast<uintptr_t>(child) & 1) != 0; }
+
+  static Leaf *AsLeaf(const Node *const child) {
+    return reinterpret_cast<Leaf *>(reinterpret_cast<uintptr_t>(child) & ~static_cast<uintptr_t>(1));
+  }
+
+  static Node *AsChild(Leaf *const leaf) { return reinterpret_cast<Node *>(reinterpret_cast<uintptr_t>(leaf) | 1); }
+
+  static uint32_t NodeSize(const NodeType type) {
+    switch (type) {
+      case NodeType::N4:
+        return sizeof(Node4);
+      case NodeType::N16:
+        return sizeof(Node16);
+      case NodeType::N48:
+        return sizeof(Node48);
+      default:
+        return sizeof(Node256);
+    }
+  }
+
+  static byte *Prefix(Node *const node) { return reinterpret_cast<byte *>(node) + NodeSize(node->type_); }
+
+  static const byte *Prefix(const Node *const node) {
+    return reinterpret_cast<const byte *>(node) + NodeSize(node->type_);
+  }
+
+  template <typename NodeClass>
+  static NodeClass *NewNode(const byte *const prefix, const uint32_t prefix_size) {
+    auto *const node = new (::operator new(sizeof(NodeClass) + prefix_size)) NodeClass();
+    node->prefix_size_ = prefix_size;
+    if (prefix_size > 0) std::memcpy(Prefix(node), prefix, prefix_size);
+    return node;
+  }
+
+  static Node *NewLeaf(const byte *const key, const uint16_t key_size, const TupleSlot value) {
+    auto *const leaf = new (::operator new(sizeof(Leaf) + key_size)) Leaf(key_size);
+    std::memcpy(const_cast<byte *>(leaf->Key()), key, key_size);
+    leaf->AddValue(value);
+    return AsChild(leaf);
+  }
+
+  static void FreeChild(Node *const child) {
+    if (IsLeaf(child)) {
+      Leaf *const leaf = AsLeaf(child);
+      leaf->~Leaf();
+      ::operator delete(leaf);
+    } else {
+      ::operator delete(child);
+    }
+  }
+
+  static void FreeSubtree(Node *const child) {
+    if (!IsLeaf(child)) {
+      uint8_t key_byte;
+      Node *grandchild;
+      for (int32_t from = 0; from <= UINT8_MAX && NextChild(child, from, &key_byte, &grandchild); from = key_byte + 1)
+        FreeSubtree(grandchild);
+    }
+    FreeChild(child);
+  }
+
+  void Retire(Node *const child) {
+    common::SpinLatch::ScopedSpinLatch guard(&garbage_latch_);
+    garbage_.push_back({child, epoch_.load()});
+  }
+
+  // Optimistic lock coupling. A version is stable when the node is not locked. Readers and writers restart from the
+  // root when they reach an obsolete node, or when the parent of a node changed before the version of the node was
+  // read.
+
+  static uint64_t StableVersion(const Node *const node) {
+    uint64_t version = node->version_.load();
+    while ((version & LOCKED) != 0) {
+      _mm_pause();
+      version = node->version_.load();
+    }
+    return version;
+  }
+
+  static uint64_t ReadLock(const Node *const node, bool *const restart) {
+    const uint64_t version = StableVersion(node);
+    if ((version & OBSOLETE) != 0) *restart = true;
+    return version;
+  }
+
+  static void Validate(const Node *const node, const uint64_t version, bool *const restart) {
+    // Keeps the reads of the node from moving past the version check
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (node->version_.load() != version) *restart = true;
+  }
+
+  static void Upgrade(Node *const node, uint64_t version, bool *const restart) {
+    if (!node->version_.compare_exchange_strong(version, version + LOCKED)) *restart = true;
+  }
+
+  static void WriteUnlock(Node *const node) { node->version_.fetch_add(LOCKED); }
+
+  static void WriteUnlockObsolete(Node *const node) { node->version_.fetch_add(LOCKED + OBSOLETE); }
+
+  // Locks a node that cannot become obsolete, because its parent is locked
+  static void WriteLock(Node *const node) {
+    while (true) {
+      bool restart = false;
+      Upgrade(node, StableVersion(node), &restart);
+      if (!restart) return;
+    }
+  }
+
+  // Node operations. Reads are also performed optimistically, so they never leave the bounds of the node even if it
+  // changes underneath them.
+
+  static Node *FindChild(const Node *const node, const uint8_t key_byte) {
+    switch (node->type_) {
+      case NodeType::N4: {
+        const auto *const n = static_cast<const Node4 *>(node);
+        const uint16_t num_children = std::min<uint16_t>(n->num_children_, 4);
+        for (uint16_t i = 0; i < num_children; i++)
+          if (n->keys_[i] == key_byte) return n->children_[i];
+        return nullptr;
+      }
+      case NodeType::N16: {
+        const auto *const n = static_cast<const Node16 *>(node);
+        const __m128i matches = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(key_byte)),
+                                               _mm_loadu_si128(reinterpret_cast<const __m128i *>(n->keys_)));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(matches)) &
+                              ((1U << std::min<uint16_t>(n->num_children_, 16)) - 1);
+        return mask != 0 ? n->children_[__builtin_ctz(mask)] : nullptr;
+      }
+      case NodeType::N48: {
+        const auto *const n = static_cast<const Node48 *>(node);
+        const uint8_t slot = n->child_index_[key_byte];
+        return slot != EMPTY_SLOT ? n->children_[slot] : nullptr;
+      }
+      default:
+        return static_cast<const Node256 *>(node)->children_[key_byte];
+    }
+  }
+
+  // Finds the child with the smallest key byte not smaller than from, with from in [0, 255]
+  static bool NextChild(const Node *const node, const int32_t from, uint8_t *const key_byte, Node **const child) {
+    switch (node->type_) {
+      case NodeType::N4:
+      case NodeType::N16: {
+        const auto *const keys = node->type_ == NodeType::N4 ? static_cast<const Node4 *>(node)->keys_
+                                                             : static_cast<const Node16 *>(node)->keys_;
+        Node *const *const children = node->type_ == NodeType::N4 ? static_cast<const Node4 *>(node)->children_
+                                                                  : static_cast<const Node16 *>(node)->children_;
+        const uint16_t num_children =
+            std::min<uint16_t>(node->num_children_, node->type_ == NodeType::N4 ? 4 : 16);
+        for (uint16_t i = 0; i < num_children; i++) {
+          if (keys[i] >= from) {
+            *key_byte = keys[i];
+            *child = children[i];
+            return true;
+          }
+        }
+        return false;
+      }
+      case NodeType::N48: {
+        const auto *const n = static_cast<const Node48 *>(node);
+        for (int32_t i = from; i <= UINT8_MAX; i++) {
+          const uint8_t slot = n->child_index_[i];
+          if (slot != EMPTY_SLOT && n->children_[slot] != nullptr) {
+            *key_byte = static_cast<uint8_t>(i);
+            *child = n->children_[slot];
+            return true;
+          }
+        }
+        return false;
+      }
+      default: {
+        const auto *const n = static_cast<const Node256 *>(node);
+        for (int32_t i = from; i <= UINT8_MAX; i++) {
+          if (n->children_[i] != nullptr) {
+            *key_byte = static_cast<uint8_t>(i);
+            *child = n->children_[i];
+            return true;
+          }
+        }
+        return false;
+      }
+    }
+  }
+
+  // Finds the child with the largest key byte not larger than from, with from in [0, 255]
+  static bool PrevChild(const Node *const node, const int32_t from, uint8_t *const key_byte, Node **const child) {
+    switch (node->type_) {
+      case NodeType::N4:
+      case NodeType::N16: {
+        const auto *const keys = node->type_ == NodeType::N4 ? static_cast<const Node4 *>(node)->keys_
+                                                             : static_cast<const Node16 *>(node)->keys_;
+        Node *const *const children = node->type_ == NodeType::N4 ? static_cast<const Node4 *>(node)->children_
+                                                                  : static_cast<const Node16 *>(node)->children_;
+        const uint16_t num_children =
+            std::min<uint16_t>(node->num_children_, node->type_ == NodeType::N4 ? 4 : 16);
+        for (int32_t i = num_children - 1; i >= 0; i--) {
+          if (keys[i] <= from) {
+            *key_byte = keys[i];
+            *child = children[i];
+            return true;
+          }
+        }
+        return false;
+      }
+      case NodeType::N48: {
+        const auto *const n = static_cast<const Node48 *>(node);
+        for (int32_t i = from; i >= 0; i--) {
+          const uint8_t slot = n->child_index_[i];
+          if (slot != EMPTY_SLOT && n->children_[slot] != nullptr) {
+            *key_byte = static_cast<uint8_t>(i);
+            *child = n->children_[slot];
+            return true;
+          }
+        }
+        return false;
+      }
+      default: {
+        const auto *const n = static_cast<const Node256 *>(node);
+        for (int32_t i = from; i >= 0; i--) {
+          if (n->children_[i] != nullptr) {
+            *key_byte = static_cast<uint8_t>(i);
+            *child = n->children_[i];
+            return true;
+          }
+        }
+        return false;
+      }
+    }
+  }
+
+  static bool IsFull(const Node *const node) {
+    switch (node->type_) {
+      case NodeType::N4:
+        return node->num_children_ == 4;
+      case NodeType::N16:
+        return node->num_children_ == 16;
+      case NodeType::N48:
+        return node->num_children_ == 48;
+      default:
+        return false;
+    }
+  }
+
+  // Whether the node has to be replaced by a smaller one when it loses a child. A Node4 is merged with its last child.
+  static bool ShrinksOnRemove(const Node *const node) {
+    switch (node->type_) {
+      case NodeType::N4:
+        return node->num_children_ <= 2;
+      case NodeType::N16:
+        return node->num_children_ <= 4;
+      case NodeType::N48:
+        return node->num_children_ <= 13;
+      default:
+        return node->num_children_ <= 38;
+    }
+  }
+
+  // Requires the node to not be full
+  static void AddChild(Node *const node, const uint8_t key_byte, Node *const child) {
+    switch (node->type_) {
+      case NodeType::N4:
+      case NodeType::N16: {
+        auto *const keys =
+            node->type_ == NodeType::N4 ? static_cast<Node4 *>(node)->keys_ : static_cast<Node16 *>(node)->keys_;
+        auto *const children = node->type_ == NodeType::N4 ? static_cast<Node4 *>(node)->children_
+                                                           : static_cast<Node16 *>(node)->children_;
+        uint16_t pos = node->num_children_;
+        for (; pos > 0 && keys[pos - 1] > key_byte; pos--) {
+          keys[pos] = keys[pos - 1];
+          children[pos] = children[pos - 1];
+        }
+        keys[pos] = key_byte;
+        children[pos] = child;
+        break;
+      }
+      case NodeType::N48: {
+        auto *const n = static_cast<Node48 *>(node);
+        uint8_t slot = 0;
+        while (n->children_[slot] != nullptr) slot++;
+        n->children_[slot] = child;
+        n->child_index_[key_byte] = slot;
+        break;
+      }
+      default:
+        static_cast<Node256 *>(node)->children_[key_byte] = child;
+        break;
+    }
+    node->num_children_++;
+  }
+
+  // Requires the node to have a child for the key byte
+  static void ReplaceChild(Node *const node, const uint8_t key_byte, Node *const child) {
+    switch (node->type_) {
+      case NodeType::N4:
+      case NodeType::N16: {
+        const auto *const keys =
+            node->type_ == NodeType::N4 ? static_cast<Node4 *>(node)->keys_ : static_cast<Node16 *>(node)->keys_;
+        auto *const children = node->type_ == NodeType::N4 ? static_cast<Node4 *>(node)->children_
+                                                           : static_cast<Node16 *>(node)->children_;
+        for (uint16_t i = 0; i < node->num_children_; i++)
+          if (keys[i] == key_byte) children[i] = child;
+        break;
+      }
+      case NodeType::N48: {
+        auto *const n = static_cast<Node48 *>(node);
+        n->children_[n->child_index_[key_byte]] = child;
+        break;
+      }
+      default:
+        static_cast<Node256 *>(node)->children_[key_byte] = child;
+        break;
+    }
+  }
+
+  // Requires the node to have a child for the key byte
+  static void RemoveChild(Node *const node, const uint8_t key_byte) {
+    switch (node->type_) {
+      case NodeType::N4:
+      case NodeType::N16: {
+        auto *const keys =
+            node->type_ == NodeType::N4 ? static_cast<Node4 *>(node)->keys_ : static_cast<Node16 *>(node)->keys_;
+        auto *const children = node->type_ == NodeType::N4 ? static_cast<Node4 *>(node)->children_
+                                                           : static_cast<Node16 *>(node)->children_;
+        uint16_t pos = 0;
+        while (keys[pos] != key_byte) pos++;
+        for (; pos + 1 < node->num_children_; pos++) {
+          keys[pos] = keys[pos + 1];
+          children[pos] = children[pos + 1];
+        }
+        break;
+      }
+      case NodeType::N48: {
+        auto *const n = static_cast<Node48 *>(node);
+        n->children_[n->child_index_[key_byte]] = nullptr;
+        n->child_index_[key_byte] = EMPTY_SLOT;
+        break;
+      }
+      default:
+        static_cast<Node256 *>(node)->children_[key_byte] = nullptr;
+        break;
+    }
+    node->num_children_--;
+  }
+
+  // Creates a node of the given type with the children of the node and the given compressed path
+  static Node *CopyNode(const Node *const node, const NodeType type, const byte *const prefix,
+                        const uint32_t prefix_size) {
+    Node *copy;
+    switch (type) {
+      case NodeType::N4:
+        copy = NewNode<Node4>(prefix, prefix_size);
+        break;
+      case NodeType::N16:
+        copy = NewNode<Node16>(prefix, prefix_size);
+        break;
+      case NodeType::N48:
+        copy = NewNode<Node48>(prefix, prefix_size);
+        break;
+      default:
+        copy = NewNode<Node256>(prefix, prefix_size);
+        break;
+    }
+    uint8_t key_byte;
+    Node *child;
+    for (int32_t from = 0; from <= UINT8_MAX && NextChild(node, from, &key_byte, &child); from = key_byte + 1)
+      AddChild(copy, key_byte, child);
+    return copy;
+  }
+
+  static Node *Grow(const Node *const node) {
+    const auto type = static_cast<NodeType>(static_cast<uint8_t>(node->type_) + 1);
+    return CopyNode(node, type, Prefix(node), node->prefix_size_);
+  }
+
+  static Node *Shrink(const Node *const node) {
+    const auto type = static_cast<NodeType>(static_cast<uint8_t>(node->type_) - 1);
+    return CopyNode(node, type, Prefix(node), node->prefix_size_);
+  }
+
+  static bool KeyEquals(const Leaf *const leaf, const byte *const key, const uint16_t key_size) {
+    return leaf->key_size_ == key_size && std::memcmp(leaf->Key(), key, key_size) == 0;
+  }
+
+  static int CompareKeys(const byte *const lhs, const uint16_t lhs_size, const byte *const rhs,
+                         const uint16_t rhs_size) {
+    const int result = std::memcmp(lhs, rhs, std::min(lhs_size, rhs_size));
+    if (result != 0) return result;
+    return static_cast<int>(lhs_size) - static_cast<int>(rhs_size);
+  }
+
+  // Compares a compressed path at the given depth with the same part of a bound. Keys below the path are longer than
+  // it, so if the bound ends inside the path they are all larger than the bound.
+  static int ComparePath(const byte *const path, const uint32_t path_size, const uint32_t depth,
+                         const byte *const bound, const uint16_t bound_size) {
+    for (uint32_t i = 0; i < path_size; i++) {
+      if (depth + i >= bound_size) return 1;
+      if (path[i] != bound[depth + i])
+        return static_cast<uint8_t>(path[i]) < static_cast<uint8_t>(bound[depth + i]) ? -1 : 1;
+    }
+    return 0;
+  }
+
+  bool InsertInternal(const byte *const key, const uint16_t key_size, const TupleSlot value,
+                      const std::function<bool(TupleSlot)> *const predicate, bool *const predicate_satisfied) {
+    EpochGuard guard(this);
+    bool inserted = false;
+    *predicate_satisfied = false;
+    while (!TryInsert(key, key_size, value, predicate, predicate_satisfied, &inserted)) {
+    }
+    return inserted;
+  }
+
+  // Returns false if the insert has to restart from the root
+  bool TryInsert(const byte *const key, const uint16_t key_size, const TupleSlot value,
+                 const std::function<bool(TupleSlot)> *const predicate, bool *const predicate_satisfied,
+                 bool *const inserted) {
+    bool restart = false;
+    Node *parent = nullptr;
+    uint64_t parent_version = 0;
+    uint8_t parent_byte = 0;
+    Node *node = root_;
+    uint64_t version = ReadLock(node, &restart);
+    if (restart) return false;
+    uint32_t depth = 0;
+
+    while (true) {
+      const uint32_t prefix_size = node->prefix_size_;
+      const byte *const prefix = Prefix(node);
+      uint32_t matched = 0;
+      while (matched < prefix_size && depth + matched < key_size && prefix[matched] == key[depth + matched]) matched++;
+
+      if (matched < prefix_size) {
+        // The key leaves the compressed path of the node: put a new node with the common part of the path in between.
+        // The root has no compressed path, so there is a parent.
+        Upgrade(parent, parent_version, &restart);
+        if (restart) return false;
+        Upgrade(node, version, &restart);
+        if (restart) {
+          WriteUnlock(parent);
+          return false;
+        }
+        TERRIER_ASSERT(depth + matched < key_size, "Keys must be prefix-free.");
+        Node *const split = NewNode<Node4>(prefix, matched);
+        AddChild(split, static_cast<uint8_t>(prefix[matched]), node);
+        AddChild(split, static_cast<uint8_t>(key[depth + matched]), NewLeaf(key, key_size, value));
+        // The node keeps the part of its path after the new node
+        std::memmove(Prefix(node), prefix + matched + 1, prefix_size - matched - 1);
+        node->prefix_size_ = prefix_size - matched - 1;
+        ReplaceChild(parent, parent_byte, split);
+        WriteUnlock(node);
+        WriteUnlock(parent);
+        *inserted = true;
+        return true;
+      }
+
+      depth += prefix_size;
+      if (depth >= key_size) {
+        Validate(node, version, &restart);
+        TERRIER_ASSERT(restart, "Keys must be prefix-free.");
+        return false;
+      }
+      const auto key_byte = static_cast<uint8_t>(key[depth]);
+      Node *const child = FindChild(node, key_byte);
+      Validate(node, version, &restart);
+      if (restart) return false;
+
+      if (child == nullptr) {
+        if (!IsFull(node)) {
+          Upgrade(node, version, &restart);
+          if (restart) return false;
+          AddChild(node, key_byte, NewLeaf(key, key_size, value));
+          WriteUnlock(node);
+        } else {
+          // The root never fills up, so there is a parent
+          Upgrade(parent, parent_version, &restart);
+          if (restart) return false;
+          Upgrade(node, version, &restart);
+          if (restart) {
+            WriteUnlock(parent);
+            return false;
+          }
+          Node *const grown = Grow(node);
+          AddChild(grown, key_byte, NewLeaf(key, key_size, value));
+          ReplaceChild(parent, parent_byte, grown);
+          WriteUnlockObsolete(node);
+          Retire(node);
+          WriteUnlock(parent);
+        }
+        *inserted = true;
+        return true;
+      }
+
+      if (IsLeaf(child)) {
+        Leaf *const leaf = AsLeaf(child);
+        if (KeyEquals(leaf, key, key_size)) {
+          common::SpinLatch::ScopedSpinLatch latch(&leaf->latch_);
+          // The leaf was emptied and unlinked in the meantime
+          if (leaf->removed_) return false;
+          for (uint32_t i = 0; i < leaf->num_values_; i++) {
+            if (leaf->Value(i) == value) return true;
+          }
+          if (predicate != nullptr) {
+            for (uint32_t i = 0; i < leaf->num_values_; i++) {
+              if ((*predicate)(leaf->Value(i))) {
+                *predicate_satisfied = true;
+                return true;
+              }
+            }
+          }
+          leaf->AddValue(value);
+          *inserted = true;
+          return true;
+        }
+
+        // Another key ends here: put a node with the common part of both keys in its place
+        Upgrade(node, version, &restart);
+        if (restart) return false;
+        const byte *const leaf_key = leaf->Key();
+        const uint32_t start = depth + 1;
+        uint32_t common = 0;
+        while (start + common < key_size && start + common < leaf->key_size_ &&
+               key[start + common] == leaf_key[start + common])
+          common++;
+        TERRIER_ASSERT(start + common < key_size && start + common < leaf->key_size_, "Keys must be prefix-free.");
+        Node *const inner = NewNode<Node4>(key + start, common);
+        AddChild(inner, static_cast<uint8_t>(leaf_key[start + common]), child);
+        AddChild(inner, static_cast<uint8_t>(key[start + common]), NewLeaf(key, key_size, value));
+        ReplaceChild(node, key_byte, inner);
+        WriteUnlock(node);
+        *inserted = true;
+        return true;
+      }
+
+      parent = node;
+      parent_version = version;
+      parent_byte = key_byte;
+      node = child;
+      version = ReadLock(node, &restart);
+      if (restart) return false;
+      Validate(parent, parent_version, &restart);
+      if (restart) return false;
+      depth++;
+    }
+  }
+
+  // Finds the leaf of the key and passes it to the function, or nullptr if the key is not in the tree. Returns false if
+  // the lookup has to restart from the root.
+  template <typename Function>
+  bool FindLeaf(const byte *const key, const uint16_t key_size, Function function) const {
+    bool restart = false;
+    const Node *node = root_;
+    uint64_t version = ReadLock(node, &restart);
+    uint32_t depth = 0;
+    while (true) {
+      const uint32_t prefix_size = node->prefix_size_;
+      Node *child = nullptr;
+      if (depth + prefix_size < key_size && std::memcmp(Prefix(node), key + depth, prefix_size) == 0) {
+        depth += prefix_size;
+        child = FindChild(node, static_cast<uint8_t>(key[depth]));
+      }
+      Validate(node, version, &restart);
+      if (restart) return false;
+      if (child == nullptr) return function(nullptr);
+      if (IsLeaf(child)) return function(KeyEquals(AsLeaf(child), key, key_size) ? AsLeaf(child) : nullptr);
+      const Node *const parent = node;
+      const uint64_t parent_version = version;
+      node = child;
+      version = ReadLock(node, &restart);
+      Validate(parent, parent_version, &restart);
+      if (restart) return false;
+      depth++;
+    }
+  }
+
+  // Advances a lookup of GetValues by one node, in the same way as FindLeaf, and prefetches whatever it moves to.
+  // Returns true once the leaf the key would be in is known, or that there is none.
+  bool StepLookup(const byte *const key, const uint16_t key_size, BatchLookup *const lookup,
+                  const Leaf **const leaf) const {
+    const Node *const node = lookup->node_;
+    bool restart = false;
+    const uint64_t version = ReadLock(node, &restart);
+    if (lookup->parent_ != nullptr) Validate(lookup->parent_, lookup->parent_version_, &restart);
+    uint32_t depth = lookup->depth_;
+    const uint32_t prefix_size = node->prefix_size_;
+    Node *child = nullptr;
+    if (depth + prefix_size < key_size && std::memcmp(Prefix(node), key + depth, prefix_size) == 0) {
+      depth += prefix_size;
+      child = FindChild(node, static_cast<uint8_t>(key[depth]));
+    }
+    Validate(node, version, &restart);
+    if (restart) {
+      *lookup = {lookup->key_, root_, 0, nullptr, 0};
+      return false;
+    }
+    if (child == nullptr) {
+      *leaf = nullptr;
+      return true;
+    }
+    if (IsLeaf(child)) {
+      *leaf = AsLeaf(child);
+      __builtin_prefetch(*leaf);
+      return true;
+    }
+    __builtin_prefetch(child);
+    *lookup = {lookup->key_, child, depth + 1, node, version};
+    return false;
+  }
+
+  bool TryGetValue(const byte *const key, const uint16_t key_size, std::vector<TupleSlot> *const values) const {
+    return FindLeaf(key, key_size, [=](Leaf *const leaf) {
+      if (leaf == nullptr) return true;
+      common::SpinLatch::ScopedSpinLatch latch(&leaf->latch_);
+      if (leaf->removed_) return false;
+      for (uint32_t i = 0; i < leaf->num_values_; i++) values->push_back(leaf->Value(i));
+      return true;
+    });
+  }
+
+  bool TryDeleteValue(const byte *const key, const uint16_t key_size, const TupleSlot value, bool *const deleted,
+                      bool *const emptied) {
+    return FindLeaf(key, key_size, [=](Leaf *const leaf) {
+      if (leaf == nullptr) return true;
+      common::SpinLatch::ScopedSpinLatch latch(&leaf->latch_);
+      if (leaf->removed_) return false;
+      for (uint32_t i = 0; i < leaf->num_values_; i++) {
+        if (leaf->Value(i) == value) {
+          leaf->RemoveValue(i);
+          *deleted = true;
+          *emptied = leaf->num_values_ == 0;
+          break;
+        }
+      }
+      return true;
+    });
+  }
+
+  // Unlinks the leaf of the key if it still has no values, and shrinks its node if needed. Returns false if it has to
+  // restart from the root.
+  bool TryRemoveLeaf(const byte *const key, const uint16_t key_size) {
+    bool restart = false;
+    Node *parent = nullptr;
+    uint64_t parent_version = 0;
+    uint8_t parent_byte = 0;
+    Node *node = root_;
+    uint64_t version = ReadLock(node, &restart);
+    if (restart) return false;
+    uint32_t depth = 0;
+
+    while (true) {
+      const uint32_t prefix_size = node->prefix_size_;
+      Node *child = nullptr;
+      if (depth + prefix_size < key_size && std::memcmp(Prefix(node), key + depth, prefix_size) == 0) {
+        depth += prefix_size;
+        child = FindChild(node, static_cast<uint8_t>(key[depth]));
+      }
+      Validate(node, version, &restart);
+      if (restart) return false;
+      if (child == nullptr) return true;
+      const auto key_byte = static_cast<uint8_t>(key[depth]);
+
+      if (IsLeaf(child)) {
+        Leaf *const leaf = AsLeaf(child);
+        if (!KeyEquals(leaf, key, key_size)) return true;
+        const bool shrink = node != root_ && ShrinksOnRemove(node);
+        if (shrink) {
+          Upgrade(parent, parent_version, &restart);
+          if (restart) return false;
+        }
+        Upgrade(node, version, &restart);
+        if (restart) {
+          if (shrink) WriteUnlock(parent);
+          return false;
+        }
+        {
+          common::SpinLatch::ScopedSpinLatch latch(&leaf->latch_);
+          // Values were added again in the meantime
+          if (leaf->num_values_ != 0) {
+            WriteUnlock(node);
+            if (shrink) WriteUnlock(parent);
+            return true;
+          }
+          leaf->removed_ = true;
+        }
+        RemoveChild(node, key_byte);
+        Retire(child);
+        if (!shrink) {
+          WriteUnlock(node);
+          return true;
+        }
+
+        Node *replacement;
+        if (node->type_ != NodeType::N4) {
+          replacement = Shrink(node);
+        } else {
+          // Merge the node with its last child, which takes over the compressed path of the node
+          uint8_t last_byte;
+          Node *last;
+          NextChild(node, 0, &last_byte, &last);
+          if (IsLeaf(last)) {
+            replacement = last;
+          } else {
+            WriteLock(last);
+            std::vector<byte> path(Prefix(node), Prefix(node) + node->prefix_size_);
+            path.push_back(static_cast<byte>(last_byte));
+            path.insert(path.end(), Prefix(last), Prefix(last) + last->prefix_size_);
+            replacement = CopyNode(last, last->type_, path.data(), static_cast<uint32_t>(path.size()));
+            WriteUnlockObsolete(last);
+            Retire(last);
+          }
+        }
+        ReplaceChild(parent, parent_byte, replacement);
+        WriteUnlockObsolete(node);
+        Retire(node);
+        WriteUnlock(parent);
+        return true;
+      }
+
+      parent = node;
+      parent_version = version;
+      parent_byte = key_byte;
+      node = child;
+      version = ReadLock(node, &restart);
+      if (restart) return false;
+      Validate(parent, parent_version, &restart);
+      if (restart) return false;
+      depth++;
+    }
+  }
+
+  // Scans the tree from the root, and again after the last key it visited whenever a node changed underneath it
+  template <bool ASCENDING, typename Consumer>
+  void Scan(ScanBounds bounds, Consumer *const consumer) const {
+    std::vector<TupleSlot> buffer;
+    const Leaf *last_leaf = nullptr;
+    while (true) {
+      bool restart = false;
+      const uint64_t version = ReadLock(root_, &restart);
+      if (ScanNode<ASCENDING>(root_, version, 0, bounds, true, true, &buffer, consumer, &last_leaf) !=
+          ScanResult::RESTART)
+        return;
+      if (last_leaf == nullptr) continue;
+      // The leaf stays allocated until the scan's epoch guard is released
+      if (ASCENDING) {
+        bounds.low_key_ = last_leaf->Key();
+        bounds.low_key_size_ = last_leaf->key_size_;
+        bounds.low_exclusive_ = true;
+      } else {
+        bounds.high_key_ = last_leaf->Key();
+        bounds.high_key_size_ = last_leaf->key_size_;
+        bounds.high_exclusive_ = true;
+      }
+    }
+  }
+
+  // Visits the values of the keys below the node that lie within the bounds, in ascending or descending order. The
+  // version of the node was read while its parent was validated. The path to the node equals the lower and upper bound
+  // up to the given depth if low_tight and high_tight are set, otherwise it lies strictly between them. last_leaf is
+  // set to every leaf whose values were passed to the consumer.
+  template <bool ASCENDING, typename Consumer>
+  ScanResult ScanNode(const Node *const node, const uint64_t version, uint32_t depth, const ScanBounds &bounds,
+                      bool low_tight, bool high_tight, std::vector<TupleSlot> *const buffer, Consumer *const consumer,
+                      const Leaf **const last_leaf) const {
+    bool restart = false;
+    const uint32_t prefix_size = node->prefix_size_;
+    const int low_cmp =
+        low_tight ? ComparePath(Prefix(node), prefix_size, depth, bounds.low_key_, bounds.low_key_size_) : 1;
+    const int high_cmp =
+        high_tight ? ComparePath(Prefix(node), prefix_size, depth, bounds.high_key_, bounds.high_key_size_) : -1;
+    Validate(node, version, &restart);
+    if (restart) return ScanResult::RESTART;
+    if (low_cmp < 0 || high_cmp > 0) return ScanResult::CONTINUE;
+    depth += prefix_size;
+    low_tight = low_cmp == 0 && depth < bounds.low_key_size_;
+    high_tight = high_cmp == 0;
+    // Everything below is longer than the upper bound, with the bound as prefix
+    if (high_tight && depth >= bounds.high_key_size_) return ScanResult::CONTINUE;
+    const int32_t first = low_tight ? static_cast<uint8_t>(bounds.low_key_[depth]) : 0;
+    const int32_t last = high_tight ? static_cast<uint8_t>(bounds.high_key_[depth]) : UINT8_MAX;
+
+    for (int32_t from = ASCENDING ? first : last; ASCENDING ? from <= last : from >= first;) {
+      uint8_t key_byte;
+      Node *child;
+      const bool found =
+          ASCENDING ? NextChild(node, from, &key_byte, &child) : PrevChild(node, from, &key_byte, &child);
+      uint64_t child_version = 0;
+      if (found && !IsLeaf(child)) child_version = ReadLock(child, &restart);
+      Validate(node, version, &restart);
+      if (restart) return ScanResult::RESTART;
+      if (!found || (ASCENDING ? key_byte > last : key_byte < first)) break;
+      from = ASCENDING ? key_byte + 1 : key_byte - 1;
+
+      const bool child_low_tight = low_tight && key_byte == first;
+      const bool child_high_tight = high_tight && key_byte == last;
+      if (!IsLeaf(child)) {
+        const ScanResult result = ScanNode<ASCENDING>(child, child_version, depth + 1, bounds, child_low_tight,
+                                                      child_high_tight, buffer, consumer, last_leaf);
+        if (result != ScanResult::CONTINUE) return result;
+        continue;
+      }
+
+      Leaf *const leaf = AsLeaf(child);
+      if (child_low_tight) {
+        const int cmp = CompareKeys(leaf->Key(), leaf->key_size_, bounds.low_key_, bounds.low_key_size_);
+        if (cmp < 0 || (cmp == 0 && bounds.low_exclusive_)) continue;
+      }
+      if (child_high_tight) {
+        const int cmp = CompareKeys(leaf->Key(), leaf->key_size_, bounds.high_key_, bounds.high_key_size_);
+        if (cmp > 0 || (cmp == 0 && bounds.high_exclusive_)) continue;
+      }
+      buffer->clear();
+      {
+        common::SpinLatch::ScopedSpinLatch latch(&leaf->latch_);
+        for (uint32_t i = 0; i < leaf->num_values_; i++) buffer->push_back(leaf->Value(i));
+      }
+      *last_leaf = leaf;
+      for (const auto value : *buffer)
+        if (!(*consumer)(value)) return ScanResult::STOP;
+    }
+    return ScanResult::CONTINUE;
+  }
+};
+
+}  // namespace terrier::storage::index
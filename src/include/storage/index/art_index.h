@@ -0,0 +1,223 @@
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "storage/index/adaptive_radix_tree.h"
+#include "storage/index/compact_ints_key.h"
+#include "storage/index/generic_key.h"
+#include "storage/index/index.h"
+#include "storage/index/index_defs.h"
+#include "transaction/deferred_action_manager.h"
+#include "transaction/transaction_context.h"
+#include "transaction/transaction_manager.h"
+
+namespace terrier::storage::index {
+
+/**
+ * Wrapper around AdaptiveRadixTree. Keys are built as KeyType and stored in their binary-comparable encoding: the
+ * bytes of a CompactIntsKey as they are, a GenericKey through GenericKey::ToBinaryComparable.
+ * @tparam KeyType the type of keys the encodings are built from
+ */
+template <typename KeyType>
+class ArtIndex final : public Index {
+  friend class IndexBuilder;
+
+ private:
+  explicit ArtIndex(IndexMetadata metadata) : Index(std::move(metadata)), art_{new AdaptiveRadixTree} {}
+
+  // Both key types encode into at most twice their size
+  struct EncodedKey {
+    byte data_[2 * sizeof(KeyType)];
+    uint16_t size_;
+  };
+
+  template <uint8_t KeySize>
+  static uint16_t Encode(const CompactIntsKey<KeySize> &key, byte *const to) {
+    std::memcpy(to, key.KeyData(), KeySize);
+    return KeySize;
+  }
+
+  template <uint16_t KeySize>
+  static uint16_t Encode(const GenericKey<KeySize> &key, byte *const to) {
+    static_assert(GenericKey<KeySize>::MaxBinaryComparableSize() <= 2 * sizeof(KeyType));
+    return key.ToBinaryComparable(to);
+  }
+
+  EncodedKey EncodeKey(const ProjectedRow &tuple) const {
+    KeyType index_key;
+    index_key.SetFromProjectedRow(tuple, metadata_);
+    EncodedKey encoded_key;
+    encoded_key.size_ = Encode(index_key, encoded_key.data_);
+    return encoded_key;
+  }
+
+  const std::unique_ptr<AdaptiveRadixTree> art_;
+
+ public:
+  IndexType Type() const final { return IndexType::ART; }
+
+  void PerformGarbageCollection() final { art_->PerformGarbageCollection(); }
+
+  bool Insert(transaction::TransactionContext *const txn, const ProjectedRow &tuple, const TupleSlot location) final {
+    TERRIER_ASSERT(!(metadata_.GetSchema().Unique()),
+                   "This Insert is designed for secondary indexes with no uniqueness constraints.");
+    const EncodedKey index_key = EncodeKey(tuple);
+    const bool result = art_->Insert(index_key.data_, index_key.size_, location);
+
+    TERRIER_ASSERT(result, "non-unique index shouldn't fail to insert. If it did, the TupleSlot was inserted twice.");
+    // Register an abort action with the txn context in case of rollback
+    txn->RegisterAbortAction([=]() {
+      const bool UNUSED_ATTRIBUTE result = art_->Delete(index_key.data_, index_key.size_, location);
+      TERRIER_ASSERT(result, "Delete on the index failed.");
+    });
+    return result;
+  }
+
+  bool InsertUnique(transaction::TransactionContext *const txn, const ProjectedRow &tuple,
+                    const TupleSlot location) final {
+    TERRIER_ASSERT(metadata_.GetSchema().Unique(), "This Insert is designed for indexes with uniqueness constraints.");
+    const EncodedKey index_key = EncodeKey(tuple);
+    bool predicate_satisfied = false;
+
+    // The predicate checks if any matching keys have write-write conflicts or are still visible to the calling txn.
+    auto predicate = [txn](const TupleSlot slot) -> bool {
+      const auto *const data_table = slot.GetBlock()->data_table_;
+      const auto has_conflict = data_table->HasConflict(*txn, slot);
+      const auto is_visible = data_table->IsVisible(*txn, slot);
+      return has_conflict || is_visible;
+    };
+
+    const bool result =
+        art_->ConditionalInsert(index_key.data_, index_key.size_, location, predicate, &predicate_satisfied);
+
+    TERRIER_ASSERT(predicate_satisfied != result, "If predicate is not satisfied then insertion should succeed.");
+
+    if (result) {
+      // Register an abort action with the txn context in case of rollback
+      txn->RegisterAbortAction([=]() {
+        const bool UNUSED_ATTRIBUTE result = art_->Delete(index_key.data_, index_key.size_, location);
+        TERRIER_ASSERT(result, "Delete on the index failed.");
+      });
+    } else {
+      // The index found a constraint violation after the DataTable was already modified, so for MVCC correctness this
+      // txn must now abort. See BwTreeIndex::InsertUnique.
+      txn->MustAbort();
+    }
+
+    return result;
+  }
+
+  void Delete(transaction::TransactionContext *const txn, const ProjectedRow &tuple, const TupleSlot location) final {
+    const EncodedKey index_key = EncodeKey(tuple);
+
+    TERRIER_ASSERT(!(location.GetBlock()->data_table_->HasConflict(*txn, location)) &&
+                       !(location.GetBlock()->data_table_->IsVisible(*txn, location)),
+                   "Called index delete on a TupleSlot that has a conflict with this txn or is still visible.");
+
+    // Register a deferred action for the GC with txn manager. See base function comment.
+    txn->RegisterCommitAction([=](transaction::DeferredActionManager *deferred_action_manager) {
+      deferred_action_manager->RegisterDeferredAction([=]() {
+        const bool UNUSED_ATTRIBUTE result = art_->Delete(index_key.data_, index_key.size_, location);
+        TERRIER_ASSERT(result, "Deferred delete on the index failed.");
+      });
+    });
+  }
+
+  void ScanKey(const transaction::TransactionContext &txn, const ProjectedRow &key,
+               std::vector<TupleSlot> *value_list) final {
+    TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
+
+    std::vector<TupleSlot> results;
+    const EncodedKey index_key = EncodeKey(key);
+    art_->GetValue(index_key.data_, index_key.size_, &results);
+
+    // Avoid resizing our value_list, even if it means over-provisioning
+    value_list->reserve(results.size());
+
+    // Perform visibility check on result
+    for (const auto &result : results) {
+      if (IsVisible(txn, result)) value_list->emplace_back(result);
+    }
+
+    TERRIER_ASSERT(!(metadata_.GetSchema().Unique()) || (metadata_.GetSchema().Unique() && value_list->size() <= 1),
+                   "Invalid number of results for unique index.");
+  }
+
+  void ScanKeyBatch(const transaction::TransactionContext &txn, const std::vector<const ProjectedRow *> &keys,
+                    std::vector<TupleSlot> *value_list, std::vector<uint32_t> *offsets) final {
+    TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
+    const auto num_keys = static_cast<uint32_t>(keys.size());
+    offsets->resize(num_keys + 1);
+
+    std::vector<EncodedKey> index_keys(num_keys);
+    for (uint32_t i = 0; i < num_keys; i++) index_keys[i] = EncodeKey(*keys[i]);
+
+    // The tree interleaves the lookups, the visibility checks are done in one pass afterwards
+    art_->GetValues(
+        num_keys,
+        [&](const uint32_t i) { return std::pair<const byte *, uint16_t>(index_keys[i].data_, index_keys[i].size_); },
+        value_list, offsets->data());
+    RemoveInvisible(txn, value_list, offsets);
+  }
+
+  void ScanAscending(const transaction::TransactionContext &txn, const ProjectedRow &low_key,
+                     const ProjectedRow &high_key, std::vector<TupleSlot> *value_list) final {
+    TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
+
+    const EncodedKey index_low_key = EncodeKey(low_key), index_high_key = EncodeKey(high_key);
+    art_->ScanAscending(index_low_key.data_, index_low_key.size_, index_high_key.data_, index_high_key.size_,
+                        [&](const TupleSlot slot) {
+                          // Perform visibility check on result
+                          if (IsVisible(txn, slot)) value_list->emplace_back(slot);
+                          return true;
+                        });
+  }
+
+  void ScanDescending(const transaction::TransactionContext &txn, const ProjectedRow &low_key,
+                      const ProjectedRow &high_key, std::vector<TupleSlot> *value_list) final {
+    TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
+
+    // Unlike the BwTree, the tree is walked backwards directly, so there is no need to step back from the high key
+    const EncodedKey index_low_key = EncodeKey(low_key), index_high_key = EncodeKey(high_key);
+    art_->ScanDescending(index_low_key.data_, index_low_key.size_, index_high_key.data_, index_high_key.size_,
+                         [&](const TupleSlot slot) {
+                           // Perform visibility check on result
+                           if (IsVisible(txn, slot)) value_list->emplace_back(slot);
+                           return true;
+                         });
+  }
+
+  void ScanLimitAscending(const transaction::TransactionContext &txn, const ProjectedRow &low_key,
+                          const ProjectedRow &high_key, std::vector<TupleSlot> *value_list,
+                          const uint32_t limit) final {
+    TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
+    TERRIER_ASSERT(limit > 0, "Limit must be greater than 0.");
+
+    const EncodedKey index_low_key = EncodeKey(low_key), index_high_key = EncodeKey(high_key);
+    art_->ScanAscending(index_low_key.data_, index_low_key.size_, index_high_key.data_, index_high_key.size_,
+                        [&](const TupleSlot slot) {
+                          // Perform visibility check on result
+                          if (IsVisible(txn, slot)) value_list->emplace_back(slot);
+                          return value_list->size() < limit;
+                        });
+  }
+
+  void ScanLimitDescending(const transaction::TransactionContext &txn, const ProjectedRow &low_key,
+                           const ProjectedRow &high_key, std::vector<TupleSlot> *value_list,
+                           const uint32_t limit) final {
+    TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
+    TERRIER_ASSERT(limit > 0, "Limit must be greater than 0.");
+
+    const EncodedKey index_low_key = EncodeKey(low_key), index_high_key = EncodeKey(high_key);
+    art_->ScanDescending(index_low_key.data_, index_low_key.size_, index_high_key.data_, index_high_key.size_,
+                         [&](const TupleSlot slot) {
+                           // Perform visibility check on result
+                           if (IsVisible(txn, slot)) value_list->emplace_back(slot);
+                           return value_list->size() < limit;
+                         });
+  }
+};
+
+}  // namespace terrier::storage::index
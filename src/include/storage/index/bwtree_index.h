@@ -1,10 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <utility>
 #include <vector>
 #include "bwtree/bwtree.h"
+#include "common/worker_pool.h"
+#include "ips4o/ips4o.hpp"
 #include "storage/index/index.h"
 #include "storage/index/index_defs.h"
 #include "transaction/deferred_action_manager.h"
@@ -27,6 +30,41 @@ class BwTreeIndex final : public Index {
 
   const std::unique_ptr<third_party::bwtree::BwTree<KeyType, TupleSlot>> bwtree_;
 
+  // Below this many keys a bulk load sorts on the calling thread, as handing out the work costs more than it saves
+  static constexpr size_t PARALLEL_SORT_THRESHOLD = 1 << 16;
+
+  // Sorts the items by key. With a pool, each worker sorts an equal share of the items and the sorted runs are then
+  // merged pairwise in rounds, the merges of a round running in parallel.
+  void SortByKey(std::vector<std::pair<KeyType, TupleSlot>> *const items, common::WorkerPool *const sort_pool) const {
+    auto key_less = [this](const std::pair<KeyType, TupleSlot> &lhs, const std::pair<KeyType, TupleSlot> &rhs) {
+      return bwtree_->KeyCmpLess(lhs.first, rhs.first);
+    };
+    if (sort_pool == nullptr || sort_pool->NumWorkers() <= 1 || items->size() < PARALLEL_SORT_THRESHOLD) {
+      ips4o::sort(items->begin(), items->end(), key_less);
+      return;
+    }
+
+    const size_t num_runs = sort_pool->NumWorkers();
+    std::vector<size_t> run_starts;
+    for (size_t i = 0; i <= num_runs; i++) run_starts.push_back(i * items->size() / num_runs);
+    for (size_t i = 0; i < num_runs; i++) {
+      sort_pool->SubmitTask([&, i] {
+        ips4o::sort(items->begin() + run_starts[i], items->begin() + run_starts[i + 1], key_less);
+      });
+    }
+    sort_pool->WaitUntilAllFinished();
+
+    for (size_t width = 1; width < num_runs; width *= 2) {
+      for (size_t i = 0; i + width < num_runs; i += 2 * width) {
+        sort_pool->SubmitTask([&, i, width] {
+          std::inplace_merge(items->begin() + run_starts[i], items->begin() + run_starts[i + width],
+                             items->begin() + run_starts[std::min(i + 2 * width, num_runs)], key_less);
+        });
+      }
+      sort_pool->WaitUntilAllFinished();
+    }
+  }
+
  public:
   IndexType Type() const final { return IndexType::BWTREE; }
 
@@ -85,6 +123,34 @@ class BwTreeIndex final : public Index {
     return result;
   }
 
+  bool BulkLoad(transaction::TransactionContext *const txn, const common::ManagedPointer<SqlTable> table,
+                common::WorkerPool *const sort_pool) final {
+    std::vector<std::pair<KeyType, TupleSlot>> items;
+    ScanKeys(txn, table, [&](const ProjectedRow &key, const TupleSlot slot) {
+      items.emplace_back(KeyType(), slot);
+      items.back().first.SetFromProjectedRow(key, metadata_);
+    });
+    SortByKey(&items, sort_pool);
+
+    if (metadata_.GetSchema().Unique()) {
+      const auto duplicate = std::adjacent_find(
+          items.cbegin(), items.cend(),
+          [this](const std::pair<KeyType, TupleSlot> &lhs, const std::pair<KeyType, TupleSlot> &rhs) {
+            return bwtree_->KeyCmpEqual(lhs.first, rhs.first);
+          });
+      if (duplicate != items.cend()) {
+        // The visible tuples of the table violate the constraint, so the calling txn cannot create the index
+        txn->MustAbort();
+        return false;
+      }
+    }
+
+    // No other txn can use the index before the calling txn commits, so unlike Insert there is nothing to roll back
+    // on abort. The whole index is discarded instead.
+    bwtree_->BulkLoad(items);
+    return true;
+  }
+
   void Delete(transaction::TransactionContext *const txn, const ProjectedRow &tuple, const TupleSlot location) final {
     KeyType index_key;
     index_key.SetFromProjectedRow(tuple, metadata_);
@@ -127,6 +193,24 @@ class BwTreeIndex final : public Index {
                    "Invalid number of results for unique index.");
   }
 
+  void ScanKeyBatch(const transaction::TransactionContext &txn, const std::vector<const ProjectedRow *> &keys,
+                    std::vector<TupleSlot> *value_list, std::vector<uint32_t> *offsets) final {
+    TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
+    offsets->resize(keys.size() + 1);
+
+    // The BwTree appends to the list it is given, so all keys share the result set and are checked for visibility in
+    // one pass afterwards
+    KeyType index_key;
+    for (uint32_t i = 0; i < keys.size(); i++) {
+      (*offsets)[i] = static_cast<uint32_t>(value_list->size());
+      index_key.SetFromProjectedRow(*keys[i], metadata_);
+      bwtree_->GetValue(index_key, *value_list);
+    }
+    offsets->back() = static_cast<uint32_t>(value_list->size());
+
+    RemoveInvisible(txn, value_list, offsets);
+  }
+
   void ScanAscending(const transaction::TransactionContext &txn, const ProjectedRow &low_key,
                      const ProjectedRow &high_key, std::vector<TupleSlot> *value_list) final {
     TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
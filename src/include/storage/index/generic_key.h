@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "common/hash_util.h"
+#include "portable_endian/portable_endian.h"
 #include "storage/index/index_metadata.h"
 #include "storage/projected_row.h"
 #include "storage/storage_defs.h"
@@ -17,6 +18,10 @@ namespace terrier::storage::index {
 // be increased if 256 bytes is too small for future workloads.
 constexpr uint16_t GENERICKEY_MAX_SIZE = 256;
 
+// Number of bytes of its binary-comparable encoding that a NormalizedGenericKey keeps next to its ProjectedRow, so that
+// most comparisons are decided by comparing a few words instead of the attributes. Must be a multiple of 8 bytes.
+constexpr uint16_t NORMALIZED_PREFIX_SIZE = 24;
+
 /**
  * GenericKey is a slower key type than CompactIntsKey for use when the constraints of CompactIntsKey make it
  * unsuitable. For example, GenericKey supports VARLEN and NULLable attributes.
@@ -100,6 +105,124 @@ class GenericKey {
     return *metadata_;
   }
 
+  /**
+   * Writes an order-preserving encoding of the key: std::memcmp on the encodings of two keys of the same index orders
+   * them the same way std::less does, with the shorter encoding first on a tie, and no encoding is a proper prefix of
+   * another one. Every attribute starts with a byte that orders NULL first. Integers follow in big-endian with their
+   * sign bit flipped, decimals with their sign bit flipped or all bits inverted if negative, and varlens with every
+   * zero byte escaped as 0x00 0xFF and two zero bytes at the end.
+   * @param[out] to buffer of at least MaxBinaryComparableSize() bytes
+   * @return size of the encoding in bytes
+   */
+  uint16_t ToBinaryComparable(byte *const to) const {
+    bool UNUSED_ATTRIBUTE complete;
+    const uint16_t size = WriteBinaryComparable(to, MaxBinaryComparableSize(), &complete);
+    TERRIER_ASSERT(complete, "Encoding exceeds its bound.");
+    return size;
+  }
+
+  /**
+   * Every attribute takes up at most twice its inlined size in the encoding, see ToBinaryComparable
+   * @return upper bound on the size of the binary-comparable encoding of a key
+   */
+  static constexpr uint16_t MaxBinaryComparableSize() { return 2 * KeySize; }
+
+  /**
+   * Compares two keys of the same index attribute by attribute, which is how std::less orders them.
+   * NormalizedGenericKey falls back to this when the normalized prefixes cannot decide.
+   * @param lhs first key to be compared
+   * @param rhs second key to be compared
+   * @return true if first key is less than the second key
+   */
+  static bool LessThanByAttributes(const GenericKey &lhs, const GenericKey &rhs) {
+    const auto &key_schema = lhs.GetIndexMetadata().GetSchema();
+
+    const auto &key_cols = key_schema.GetColumns();
+    for (uint16_t i = 0; i < key_cols.size(); i++) {
+      const auto *const lhs_pr = lhs.GetProjectedRow();
+      const auto *const rhs_pr = rhs.GetProjectedRow();
+
+      const auto offset = static_cast<uint16_t>(lhs_pr->ColumnIds()[i]);
+      TERRIER_ASSERT(lhs_pr->ColumnIds()[i] == rhs_pr->ColumnIds()[i], "Comparison orders should be the same.");
+
+      const byte *const lhs_attr = lhs_pr->AccessWithNullCheck(offset);
+      const byte *const rhs_attr = rhs_pr->AccessWithNullCheck(offset);
+
+      if (lhs_attr == nullptr) {
+        if (rhs_attr == nullptr) {
+          // attributes are both NULL (equal), continue
+          continue;
+        }
+        // lhs is NULL, rhs is non-NULL, lhs is less than
+        return true;
+      }
+
+      if (rhs_attr == nullptr) {
+        // lhs is non-NULL, rhs is NULL, lhs is greater than
+        return false;
+      }
+
+      const type::TypeId type_id = key_schema.GetColumns()[i].Type();
+
+      if (TypeComparators::CompareLessThan(type_id, lhs_attr, rhs_attr)) return true;
+      if (TypeComparators::CompareGreaterThan(type_id, lhs_attr, rhs_attr)) return false;
+
+      // attributes are equal, continue
+    }
+
+    // keys are equal
+    return false;
+  }
+
+  /**
+   * Compares two keys of the same index attribute by attribute, which is how std::equal_to compares them.
+   * NormalizedGenericKey falls back to this when the normalized prefixes cannot decide.
+   * @param lhs first key to be compared
+   * @param rhs second key to be compared
+   * @return true if first key is equal to the second key
+   */
+  static bool EqualByAttributes(const GenericKey &lhs, const GenericKey &rhs) {
+    const auto &key_schema = lhs.GetIndexMetadata().GetSchema();
+
+    const auto &key_cols = key_schema.GetColumns();
+    for (uint16_t i = 0; i < key_cols.size(); i++) {
+      const auto *const lhs_pr = lhs.GetProjectedRow();
+      const auto *const rhs_pr = rhs.GetProjectedRow();
+
+      const auto offset = static_cast<uint16_t>(lhs_pr->ColumnIds()[i]);
+      TERRIER_ASSERT(lhs_pr->ColumnIds()[i] == rhs_pr->ColumnIds()[i], "Comparison orders should be the same.");
+
+      const byte *const lhs_attr = lhs_pr->AccessWithNullCheck(offset);
+      const byte *const rhs_attr = rhs_pr->AccessWithNullCheck(offset);
+
+      if (lhs_attr == nullptr) {
+        if (rhs_attr == nullptr) {
+          // attributes are both NULL (equal), continue
+          continue;
+        }
+        // lhs is NULL, rhs is non-NULL, return non-equal
+        return false;
+      }
+
+      if (rhs_attr == nullptr) {
+        // lhs is non-NULL, rhs is NULL, return non-equal
+        return false;
+      }
+
+      const type::TypeId type_id = key_schema.GetColumns()[i].Type();
+
+      if (!TypeComparators::CompareEquals(type_id, lhs_attr, rhs_attr)) {
+        // one of the attrs didn't match, return non-equal
+        return false;
+      }
+
+      // attributes are equal, continue
+    }
+
+    // keys are equal
+    return true;
+  }
+
   /**
    * Utility class to evaluate comparisons of embedded types within a ProjectedRow. This is not exposed somewhere like
    * type/type_util.h becauase these do not enforce SQL comparison semantics (i.e. NULL comparisons evaluate to NULL).
@@ -190,6 +313,93 @@ class GenericKey {
     }
   };
 
+ protected:
+  // Writes the binary-comparable encoding of the key, see ToBinaryComparable, but no more than limit bytes of it
+  uint16_t WriteBinaryComparable(byte *const to, const uint16_t limit, bool *const complete) const {
+    const auto &key_cols = GetIndexMetadata().GetSchema().GetColumns();
+    const auto *const pr = GetProjectedRow();
+    uint16_t size = 0;
+    // Appends as many of the bytes as fit below the limit and returns whether all of them did
+    const auto append = [&](const void *const bytes, const uint16_t num_bytes) {
+      const auto num_fitting = std::min<uint16_t>(num_bytes, limit - size);
+      std::memcpy(to + size, bytes, num_fitting);
+      size = static_cast<uint16_t>(size + num_fitting);
+      return num_fitting == num_bytes;
+    };
+    const uint8_t null_byte = 0, not_null_byte = 1;
+
+    bool fits = true;
+    for (uint16_t i = 0; fits && i < key_cols.size(); i++) {
+      const byte *const attr = pr->AccessWithNullCheck(static_cast<uint16_t>(pr->ColumnIds()[i]));
+      if (attr == nullptr) {
+        fits = append(&null_byte, sizeof(null_byte));
+        continue;
+      }
+      fits = append(&not_null_byte, sizeof(not_null_byte));
+      if (!fits) break;
+      switch (key_cols[i].Type()) {
+        case type::TypeId::BOOLEAN:
+        case type::TypeId::TINYINT: {
+          const auto value = static_cast<uint8_t>(*reinterpret_cast<const uint8_t *>(attr) ^ 0x80U);
+          fits = append(&value, sizeof(value));
+          break;
+        }
+        case type::TypeId::SMALLINT: {
+          const uint16_t value = htobe16(static_cast<uint16_t>(*reinterpret_cast<const uint16_t *>(attr) ^ 0x8000U));
+          fits = append(&value, sizeof(value));
+          break;
+        }
+        case type::TypeId::INTEGER: {
+          const uint32_t value = htobe32(*reinterpret_cast<const uint32_t *>(attr) ^ 0x80000000U);
+          fits = append(&value, sizeof(value));
+          break;
+        }
+        case type::TypeId::DATE: {
+          const uint32_t value = htobe32(*reinterpret_cast<const uint32_t *>(attr));
+          fits = append(&value, sizeof(value));
+          break;
+        }
+        case type::TypeId::BIGINT: {
+          const uint64_t value = htobe64(*reinterpret_cast<const uint64_t *>(attr) ^ (UINT64_C(1) << 63U));
+          fits = append(&value, sizeof(value));
+          break;
+        }
+        case type::TypeId::TIMESTAMP: {
+          const uint64_t value = htobe64(*reinterpret_cast<const uint64_t *>(attr));
+          fits = append(&value, sizeof(value));
+          break;
+        }
+        case type::TypeId::DECIMAL: {
+          double decimal = *reinterpret_cast<const double *>(attr);
+          // -0.0 and 0.0 compare equal, so they must be encoded the same way
+          if (decimal == 0.0) decimal = 0.0;
+          uint64_t bits;
+          std::memcpy(&bits, &decimal, sizeof(bits));
+          const uint64_t value = htobe64((bits >> 63U) != 0 ? ~bits : bits ^ (UINT64_C(1) << 63U));
+          fits = append(&value, sizeof(value));
+          break;
+        }
+        case type::TypeId::VARCHAR:
+        case type::TypeId::VARBINARY: {
+          // Both the inlined varlens and the inlined VarlenEntry objects start with the size, followed by the content
+          const uint32_t varlen_size = *reinterpret_cast<const uint32_t *>(attr);
+          const byte *const content = attr + sizeof(uint32_t);
+          const uint8_t escaped_zero[2] = {0, UINT8_MAX}, terminator[2] = {0, 0};
+          for (uint32_t j = 0; fits && j < varlen_size; j++) {
+            fits = content[j] == static_cast<byte>(0) ? append(escaped_zero, sizeof(escaped_zero))
+                                                      : append(content + j, sizeof(byte));
+          }
+          if (fits) fits = append(terminator, sizeof(terminator));
+          break;
+        }
+        default:
+          throw std::runtime_error("Unknown TypeId in terrier::storage::index::GenericKey::ToBinaryComparable.");
+      }
+    }
+    *complete = fits;
+    return size;
+  }
+
  private:
   ProjectedRow *GetProjectedRow() {
     auto *pr = reinterpret_cast<ProjectedRow *>(StorageUtil::AlignedPtr(sizeof(uint64_t), key_data_));
@@ -204,6 +414,65 @@ class GenericKey {
   const IndexMetadata *metadata_ = nullptr;
 };
 
+/**
+ * NormalizedGenericKey is a GenericKey that also keeps the first NORMALIZED_PREFIX_SIZE bytes of its binary-comparable
+ * encoding, see GenericKey::ToBinaryComparable. std::less and std::equal_to compare the prefixes first, and only
+ * compare the attributes when the prefixes are equal but incomplete. The prefix makes every key 32 bytes larger, so
+ * only indexes that compare keys all the time, like the BwTree, use this key type.
+ * @tparam KeySize number of bytes for the key's internal buffer
+ */
+template <uint16_t KeySize>
+class NormalizedGenericKey : public GenericKey<KeySize> {
+ public:
+  /**
+   * Set the key's data based on a ProjectedRow and associated index metadata, and cache its normalized prefix
+   * @param from ProjectedRow to generate GenericKey representation of
+   * @param metadata index information, key_schema used to interpret PR data correctly
+   */
+  void SetFromProjectedRow(const storage::ProjectedRow &from, const IndexMetadata &metadata) {
+    GenericKey<KeySize>::SetFromProjectedRow(from, metadata);
+    SetNormalizedPrefix();
+  }
+
+  /**
+   * Compares the normalized prefixes of two keys of the same index, i.e. the first NORMALIZED_PREFIX_SIZE bytes of
+   * their binary-comparable encodings. Prefixes that differ order the keys. Equal prefixes that are complete mean equal
+   * keys, as no encoding is a proper prefix of another one. Otherwise the attributes have to be compared.
+   * @param lhs first key to be compared
+   * @param rhs second key to be compared
+   * @return std::memcmp semantics on the prefixes
+   */
+  static int CompareNormalizedPrefixes(const NormalizedGenericKey &lhs, const NormalizedGenericKey &rhs) {
+    for (uint8_t i = 0; i < NORMALIZED_PREFIX_WORDS; i++) {
+      if (lhs.normalized_prefix_[i] != rhs.normalized_prefix_[i])
+        return lhs.normalized_prefix_[i] < rhs.normalized_prefix_[i] ? -1 : 1;
+    }
+    return 0;
+  }
+
+  /**
+   * @return whether the normalized prefix holds the key's whole binary-comparable encoding
+   */
+  bool NormalizedPrefixComplete() const { return normalized_prefix_complete_; }
+
+ private:
+  static constexpr uint8_t NORMALIZED_PREFIX_WORDS = NORMALIZED_PREFIX_SIZE / sizeof(uint64_t);
+
+  // Caches the first bytes of the encoding as big-endian words, zero-padded, so that comparing them compares the bytes
+  void SetNormalizedPrefix() {
+    byte prefix[NORMALIZED_PREFIX_SIZE] = {};
+    this->WriteBinaryComparable(prefix, NORMALIZED_PREFIX_SIZE, &normalized_prefix_complete_);
+    for (uint8_t i = 0; i < NORMALIZED_PREFIX_WORDS; i++) {
+      uint64_t word;
+      std::memcpy(&word, prefix + i * sizeof(uint64_t), sizeof(word));
+      normalized_prefix_[i] = be64toh(word);
+    }
+  }
+
+  uint64_t normalized_prefix_[NORMALIZED_PREFIX_WORDS];
+  bool normalized_prefix_complete_;
+};
+
 }  // namespace terrier::storage::index
 
 namespace std {
@@ -257,45 +526,7 @@ struct equal_to<terrier::storage::index::GenericKey<KeySize>> {
    */
   bool operator()(const terrier::storage::index::GenericKey<KeySize> &lhs,
                   const terrier::storage::index::GenericKey<KeySize> &rhs) const {
-    const auto &key_schema = lhs.GetIndexMetadata().GetSchema();
-
-    const auto &key_cols = key_schema.GetColumns();
-    for (uint16_t i = 0; i < key_cols.size(); i++) {
-      const auto *const lhs_pr = lhs.GetProjectedRow();
-      const auto *const rhs_pr = rhs.GetProjectedRow();
-
-      const auto offset = static_cast<uint16_t>(lhs_pr->ColumnIds()[i]);
-      TERRIER_ASSERT(lhs_pr->ColumnIds()[i] == rhs_pr->ColumnIds()[i], "Comparison orders should be the same.");
-
-      const byte *const lhs_attr = lhs_pr->AccessWithNullCheck(offset);
-      const byte *const rhs_attr = rhs_pr->AccessWithNullCheck(offset);
-
-      if (lhs_attr == nullptr) {
-        if (rhs_attr == nullptr) {
-          // attributes are both NULL (equal), continue
-          continue;
-        }
-        // lhs is NULL, rhs is non-NULL, return non-equal
-        return false;
-      }
-
-      if (rhs_attr == nullptr) {
-        // lhs is non-NULL, rhs is NULL, return non-equal
-        return false;
-      }
-
-      const terrier::type::TypeId type_id = key_schema.GetColumns()[i].Type();
-
-      if (!terrier::storage::index::GenericKey<KeySize>::TypeComparators::CompareEquals(type_id, lhs_attr, rhs_attr)) {
-        // one of the attrs didn't match, return non-equal
-        return false;
-      }
-
-      // attributes are equal, continue
-    }
-
-    // keys are equal
-    return true;
+    return terrier::storage::index::GenericKey<KeySize>::EqualByAttributes(lhs, rhs);
   }
 };
 
@@ -312,46 +543,66 @@ struct less<terrier::storage::index::GenericKey<KeySize>> {
    */
   bool operator()(const terrier::storage::index::GenericKey<KeySize> &lhs,
                   const terrier::storage::index::GenericKey<KeySize> &rhs) const {
-    const auto &key_schema = lhs.GetIndexMetadata().GetSchema();
-
-    const auto &key_cols = key_schema.GetColumns();
-    for (uint16_t i = 0; i < key_cols.size(); i++) {
-      const auto *const lhs_pr = lhs.GetProjectedRow();
-      const auto *const rhs_pr = rhs.GetProjectedRow();
-
-      const auto offset = static_cast<uint16_t>(lhs_pr->ColumnIds()[i]);
-      TERRIER_ASSERT(lhs_pr->ColumnIds()[i] == rhs_pr->ColumnIds()[i], "Comparison orders should be the same.");
-
-      const byte *const lhs_attr = lhs_pr->AccessWithNullCheck(offset);
-      const byte *const rhs_attr = rhs_pr->AccessWithNullCheck(offset);
-
-      if (lhs_attr == nullptr) {
-        if (rhs_attr == nullptr) {
-          // attributes are both NULL (equal), continue
-          continue;
-        }
-        // lhs is NULL, rhs is non-NULL, lhs is less than
-        return true;
-      }
-
-      if (rhs_attr == nullptr) {
-        // lhs is non-NULL, rhs is NULL, lhs is greater than
-        return false;
-      }
-
-      const terrier::type::TypeId type_id = key_schema.GetColumns()[i].Type();
+    return terrier::storage::index::GenericKey<KeySize>::LessThanByAttributes(lhs, rhs);
+  }
+};
 
-      if (terrier::storage::index::GenericKey<KeySize>::TypeComparators::CompareLessThan(type_id, lhs_attr, rhs_attr))
-        return true;
-      if (terrier::storage::index::GenericKey<KeySize>::TypeComparators::CompareGreaterThan(type_id, lhs_attr,
-                                                                                            rhs_attr))
-        return false;
+/**
+ * Implements std::hash for NormalizedGenericKey, which hashes the same way as GenericKey.
+ * @tparam KeySize number of bytes for the key's internal buffer
+ */
+template <uint16_t KeySize>
+struct hash<terrier::storage::index::NormalizedGenericKey<KeySize>> {
+ public:
+  /**
+   * @param key key to be hashed
+   * @return hash of the key's underlying data
+   */
+  size_t operator()(terrier::storage::index::NormalizedGenericKey<KeySize> const &key) const {
+    return hash<terrier::storage::index::GenericKey<KeySize>>()(key);
+  }
+};
 
-      // attributes are equal, continue
-    }
+/**
+ * Implements std::equal_to for NormalizedGenericKey through the normalized prefixes, and the attributes if those
+ * cannot decide.
+ * @tparam KeySize number of bytes for the key's internal buffer
+ */
+template <uint16_t KeySize>
+struct equal_to<terrier::storage::index::NormalizedGenericKey<KeySize>> {
+  /**
+   * @param lhs first key to be compared
+   * @param rhs second key to be compared
+   * @return true if first key is equal to the second key
+   */
+  bool operator()(const terrier::storage::index::NormalizedGenericKey<KeySize> &lhs,
+                  const terrier::storage::index::NormalizedGenericKey<KeySize> &rhs) const {
+    using NormalizedGenericKey = terrier::storage::index::NormalizedGenericKey<KeySize>;
+    if (NormalizedGenericKey::CompareNormalizedPrefixes(lhs, rhs) != 0) return false;
+    if (lhs.NormalizedPrefixComplete()) return true;
+    return NormalizedGenericKey::EqualByAttributes(lhs, rhs);
+  }
+};
 
-    // keys are equal
-    return false;
+/**
+ * Implements std::less for NormalizedGenericKey through the normalized prefixes, and the attributes if those cannot
+ * decide.
+ * @tparam KeySize number of bytes for the key's internal buffer
+ */
+template <uint16_t KeySize>
+struct less<terrier::storage::index::NormalizedGenericKey<KeySize>> {
+  /**
+   * @param lhs first key to be compared
+   * @param rhs second key to be compared
+   * @return true if first key is less than the second key
+   */
+  bool operator()(const terrier::storage::index::NormalizedGenericKey<KeySize> &lhs,
+                  const terrier::storage::index::NormalizedGenericKey<KeySize> &rhs) const {
+    using NormalizedGenericKey = terrier::storage::index::NormalizedGenericKey<KeySize>;
+    const int prefix_result = NormalizedGenericKey::CompareNormalizedPrefixes(lhs, rhs);
+    if (prefix_result != 0) return prefix_result < 0;
+    if (lhs.NormalizedPrefixComplete()) return false;
+    return NormalizedGenericKey::LessThanByAttributes(lhs, rhs);
   }
 };
 }  // namespace std
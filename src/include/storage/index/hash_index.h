@@ -3,17 +3,16 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
-#include <unordered_set>
 #include <utility>
-#include <variant>  // NOLINT (Matt): lint thinks this C++17 header is a C header because it only knows C++11
 #include <vector>
+#include "common/container/concurrent_queue.h"
 #include "libcuckoo/cuckoohash_map.hh"
+#include "storage/index/hash_index_values.h"
 #include "storage/index/index.h"
 #include "storage/index/index_defs.h"
 #include "transaction/deferred_action_manager.h"
 #include "transaction/transaction_context.h"
 #include "transaction/transaction_manager.h"
-#include "xxHash/xxh3.h"
 
 namespace terrier::storage::index {
 
@@ -24,8 +23,8 @@ constexpr uint16_t INITIAL_CUCKOOHASH_MAP_SIZE = 256;
 /**
  * Wrapper around libcuckoo's hash map. The MVCC is logic is similar to our reference index (BwTreeIndex). Much of the
  * logic here is related to the cuckoohash_map not being a multimap. We get around this by making the value type a
- * std::variant that can either be a TupleSlot if there's only a single value for a given key, or a std::unordered_set
- * of TupleSlots if a single key needs to map to multiple TupleSlots.
+ * HashIndexValues, which holds the few TupleSlots of most keys inline and the TupleSlots of keys with many values in a
+ * contiguous array. Arrays that deletes left mostly empty are shrunk by PerformGarbageCollection.
  * @tparam KeyType the type of keys stored in the map
  */
 template <typename KeyType>
@@ -33,19 +32,14 @@ class HashIndex final : public Index {
   friend class IndexBuilder;
 
  private:
-  struct TupleSlotHash {
-    std::size_t operator()(const TupleSlot &slot) const {
-      return XXH3_64bits(reinterpret_cast<const void *>(&slot), sizeof(TupleSlot));
-    }
-  };
-
-  using ValueMap = std::unordered_set<TupleSlot, TupleSlotHash>;
-  using ValueType = std::variant<TupleSlot, ValueMap>;
+  using ValueType = HashIndexValues;
 
   explicit HashIndex(IndexMetadata metadata)
       : Index(std::move(metadata)), hash_map_{new cuckoohash_map<KeyType, ValueType>(INITIAL_CUCKOOHASH_MAP_SIZE)} {}
 
   const std::unique_ptr<cuckoohash_map<KeyType, ValueType>> hash_map_;
+  // Keys whose values were removed until their array became mostly empty, to be shrunk on the next GC run
+  common::ConcurrentQueue<KeyType> shrink_queue_;
 
   /**
    * The lambda below is used for aborted inserts as well as committed deletes to perform the erase logic. Macros are
@@ -53,36 +47,48 @@ class HashIndex final : public Index {
    */
 #define ERASE_KEY_ACTION                                                                                               \
   [=]() {                                                                                                              \
+    bool needs_shrink = false;                                                                                         \
     /* See the underlying container's API for more details, but the lambda below is invoked when the key is found. */  \
-    auto key_found_fn = [location](ValueType &value) -> bool {                                                         \
-      if (std::holds_alternative<TupleSlot>(value)) {                                                                  \
-        /* It's just a TupleSlot, functor should return true for cuckoohash_map's uprase_fn to erase key/value pair */ \
+    auto key_found_fn = [location, &needs_shrink](ValueType &value) -> bool {                                          \
+      if (value.Size() == 1) {                                                                                         \
+        /* It's the key's last value, functor should return true for cuckoohash_map's erase_fn to erase key/value */   \
+        TERRIER_ASSERT(value.Contains(location), "The key should have the value.");                                    \
         return true;                                                                                                   \
       }                                                                                                                \
-      auto &value_map = std::get<ValueMap>(value);                                                                     \
-      if (value_map.size() == 2) {                                                                                     \
-        /* functor should replace the ValueMap with a TupleSlot for the other location */                              \
-        for (const auto i : value_map) {                                                                               \
-          if (i != location) {                                                                                         \
-            value = i; /* Assigning TupleSlot type will change the std::variant to TupleSlot and free the ValueMap */  \
-            TERRIER_ASSERT(std::holds_alternative<TupleSlot>(value), "value should now be a TupleSlot.");              \
-            return false; /* Return false so cuckoohash_map's uprase_fn doesn't erase key/value pair */                \
-          }                                                                                                            \
-        }                                                                                                              \
-      }                                                                                                                \
-      /* ValueMap contains more than 2 elements, erase location from the ValueMap */                                   \
-      const auto UNUSED_ATTRIBUTE erase_result = value_map.erase(location);                                            \
-      TERRIER_ASSERT(erase_result == 1, "Erasing from the ValueMap should not fail.");                                 \
-      TERRIER_ASSERT(value_map.size() > 1, "ValueMap should not have fewer than 2 elements.");                         \
-      return false; /* Return false so cuckoohash_map's uprase_fn doesn't erase key/value pair */                      \
+      /* erase location from the values, the GC shrinks the array if that left it mostly empty */                      \
+      const bool UNUSED_ATTRIBUTE remove_result = value.Remove(location);                                              \
+      TERRIER_ASSERT(remove_result, "Erasing from the values should not fail.");                                       \
+      needs_shrink = value.NeedsShrink();                                                                              \
+      return false; /* Return false so cuckoohash_map's erase_fn doesn't erase key/value pair */                       \
     };                                                                                                                 \
-    const bool UNUSED_ATTRIBUTE uprase_result = hash_map_->uprase_fn(index_key, key_found_fn);                         \
-    TERRIER_ASSERT(!uprase_result, "This operation should NOT insert a new key into the cuckoohash_map.");             \
+    const bool UNUSED_ATTRIBUTE erase_result = hash_map_->erase_fn(index_key, key_found_fn);                           \
+    TERRIER_ASSERT(erase_result, "The key should be in the cuckoohash_map.");                                          \
+    if (needs_shrink) shrink_queue_.Enqueue(index_key);                                                                \
   }
 
  public:
   IndexType Type() const final { return IndexType::HASHMAP; }
 
+  void PerformGarbageCollection() final {
+    // Keys may have been queued more than once, or have lost all values since, both are harmless
+    KeyType index_key;
+    while (shrink_queue_.Dequeue(&index_key)) {
+      hash_map_->update_fn(index_key, [](ValueType &value) { value.ShrinkToFit(); });
+    }
+  }
+
+  /**
+   * Counts the memory used by the index: the slots of the hash map, whether they are occupied or not, and the values
+   * stored outside of them. Locks the whole map while the values are visited.
+   * @return size of the index in bytes
+   */
+  uint64_t GetHeapUsage() const {
+    uint64_t heap_usage = hash_map_->capacity() * sizeof(typename cuckoohash_map<KeyType, ValueType>::value_type);
+    const auto locked_table = hash_map_->lock_table();
+    for (const auto &entry : locked_table) heap_usage += entry.second.HeapUsage();
+    return heap_usage;
+  }
+
   bool Insert(transaction::TransactionContext *const txn, const ProjectedRow &tuple, const TupleSlot location) final {
     TERRIER_ASSERT(!(metadata_.GetSchema().Unique()),
                    "This Insert is designed for secondary indexes with no uniqueness constraints.");
@@ -105,16 +111,9 @@ class HashIndex final : public Index {
      * return true if cuckoohash_map's uprase_fn should delete the key/value pair. For inserts we always return false.
      */
     auto key_found_fn = [location, &insert_result](ValueType &value) -> bool {
-      if (std::holds_alternative<TupleSlot>(value)) {
-        // replace the TupleSlot with a ValueMap containing both the old and new inserted value
-        const auto existing_location = std::get<TupleSlot>(value);
-        value = ValueMap({{location}, {existing_location}}, 2);
-        insert_result = true;
-      } else {
-        // insert the location to the cuckoohash_map
-        auto &value_map = std::get<ValueMap>(value);
-        insert_result = value_map.emplace(location).second;
-      }
+      // add the location to the key's values
+      value.Add(location);
+      insert_result = true;
       return false;
     };
 
@@ -164,26 +163,15 @@ class HashIndex final : public Index {
      * return true if cuckoohash_map's uprase_fn should delete the key/value pair. For inserts we always return false.
      */
     auto key_found_fn = [location, &insert_result, &predicate_satisfied, predicate](ValueType &value) -> bool {
-      if (std::holds_alternative<TupleSlot>(value)) {
-        const auto existing_location = std::get<TupleSlot>(value);
-        predicate_satisfied = predicate(existing_location);
-        if (!predicate_satisfied) {
-          // replace the TupleSlot with a ValueMap containing both the old and new inserted value
-          value = ValueMap({{location}, {existing_location}}, 2);
-          insert_result = true;
-        }
-      } else {
-        auto &value_map = std::get<ValueMap>(value);
-
-        predicate_satisfied = std::any_of(value_map.cbegin(), value_map.cend(), predicate);
-
-        if (!predicate_satisfied) {
-          // insert the location to the cuckoohash_map
-          insert_result = value_map.emplace(location).second;
-          TERRIER_ASSERT(insert_result,
-                         " index shouldn't fail to insert after predicate check. If it did, something went wrong deep "
-                         "inside the hash map itself.");
-        }
+      predicate_satisfied = std::any_of(value.begin(), value.end(), predicate);
+
+      if (!predicate_satisfied) {
+        // add the location to the key's values
+        TERRIER_ASSERT(!value.Contains(location),
+                       " index shouldn't fail to insert after predicate check. If it did, something went wrong deep "
+                       "inside the hash map itself.");
+        value.Add(location);
+        insert_result = true;
       }
       return false;
     };
@@ -243,15 +231,8 @@ class HashIndex final : public Index {
      * key_found_fn)
      */
     auto key_found_fn = [value_list, &txn](const ValueType &value) -> void {
-      if (std::holds_alternative<TupleSlot>(value)) {
-        const auto existing_location = std::get<TupleSlot>(value);
-        if (IsVisible(txn, existing_location)) value_list->emplace_back(existing_location);
-      } else {
-        const auto &value_map = std::get<ValueMap>(value);
-
-        for (const auto i : value_map) {
-          if (IsVisible(txn, i)) value_list->emplace_back(i);
-        }
+      for (const auto i : value) {
+        if (IsVisible(txn, i)) value_list->emplace_back(i);
       }
     };
 
@@ -261,6 +242,28 @@ class HashIndex final : public Index {
                    "Invalid number of results for unique index.");
   }
 
+  void ScanKeyBatch(const transaction::TransactionContext &txn, const std::vector<const ProjectedRow *> &keys,
+                    std::vector<TupleSlot> *value_list, std::vector<uint32_t> *offsets) final {
+    TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
+    const auto num_keys = static_cast<uint32_t>(keys.size());
+    offsets->resize(num_keys + 1);
+
+    // Collect the values without visibility checks, those are done in one pass afterwards
+    auto key_found_fn = [value_list](const ValueType &value) -> void {
+      value_list->insert(value_list->end(), value.begin(), value.end());
+    };
+
+    KeyType index_key;
+    for (uint32_t i = 0; i < num_keys; i++) {
+      index_key.SetFromProjectedRow(*keys[i], metadata_);
+      (*offsets)[i] = static_cast<uint32_t>(value_list->size());
+      hash_map_->find_fn(index_key, key_found_fn);
+    }
+    offsets->back() = static_cast<uint32_t>(value_list->size());
+
+    RemoveInvisible(txn, value_list, offsets);
+  }
+
 #undef ERASE_KEY_ACTION
 };
 
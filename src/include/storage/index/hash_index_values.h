@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include "common/macros.h"
+#include "storage/storage_defs.h"
+
+namespace terrier::storage::index {
+
+/**
+ * The values of one key in a HashIndex. Up to INLINE_VALUES values are stored in the object itself, so a key with few
+ * values needs no allocation and its entry in the hash map stays small. Beyond that the values move to a contiguous
+ * array on the heap, which doubles whenever it is full. Removing values never shrinks the array: the index's garbage
+ * collection does that through ShrinkToFit, for the keys that NeedsShrink reported. Values are kept in no particular
+ * order.
+ *
+ * Finding a value scans the array. That is fine for most keys, but removing all values of a hot key one by one takes
+ * quadratic time. Arrays of at least INDEXED_CAPACITY values are therefore followed, in the same allocation, by a
+ * linear probing table of the positions of the values in the array. The table has at least twice as many 4-byte entries
+ * as the array has values, so it about doubles the memory of such a key.
+ */
+class HashIndexValues {
+ public:
+  /**
+   * Number of values stored without an allocation
+   */
+  static constexpr uint32_t INLINE_VALUES = 2;
+
+  /**
+   * Smallest array that values are looked up in through a table of their positions instead of by scanning it
+   */
+  static constexpr uint32_t INDEXED_CAPACITY = 64;
+
+  /**
+   * Creates the values of a new key.
+   * @param value the first value of the key
+   */
+  explicit HashIndexValues(const TupleSlot value) : size_(1), capacity_(INLINE_VALUES) { inline_values_[0] = value; }
+
+  /**
+   * Copies the values of another key.
+   * @param other values to copy
+   */
+  HashIndexValues(const HashIndexValues &other) : size_(other.size_), capacity_(INLINE_VALUES) {
+    if (size_ > INLINE_VALUES) {
+      capacity_ = size_;
+      heap_values_ = AllocateHeapValues();
+    }
+    std::memcpy(Values(), other.Values(), size_ * sizeof(TupleSlot));
+    if (Indexed()) BuildPositions();
+  }
+
+  /**
+   * Takes over the values of another key, which is left without values.
+   * @param other values to take over
+   */
+  HashIndexValues(HashIndexValues &&other) noexcept : size_(other.size_), capacity_(other.capacity_) {
+    std::memcpy(static_cast<void *>(inline_values_), other.inline_values_, sizeof(inline_values_));
+    other.size_ = 0;
+    other.capacity_ = INLINE_VALUES;
+  }
+
+  /**
+   * Copies the values of another key.
+   * @param other values to copy
+   * @return self-reference
+   */
+  HashIndexValues &operator=(const HashIndexValues &other) {
+    if (this != &other) {
+      HashIndexValues copy(other);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  /**
+   * Takes over the values of another key, which is left without values.
+   * @param other values to take over
+   * @return self-reference
+   */
+  HashIndexValues &operator=(HashIndexValues &&other) noexcept {
+    if (this != &other) {
+      if (Overflowed()) delete[] heap_values_;
+      size_ = other.size_;
+      capacity_ = other.capacity_;
+      std::memcpy(static_cast<void *>(inline_values_), other.inline_values_, sizeof(inline_values_));
+      other.size_ = 0;
+      other.capacity_ = INLINE_VALUES;
+    }
+    return *this;
+  }
+
+  ~HashIndexValues() {
+    if (Overflowed()) delete[] heap_values_;
+  }
+
+  /**
+   * @return number of values
+   */
+  uint32_t Size() const { return size_; }
+
+  /**
+   * @return first value
+   */
+  const TupleSlot *begin() const { return Values(); }
+
+  /**
+   * @return one past the last value
+   */
+  const TupleSlot *end() const { return Values() + size_; }
+
+  /**
+   * @param value value to look for
+   * @return true if the key has the value, false otherwise
+   */
+  bool Contains(const TupleSlot value) const {
+    return Indexed() ? FindPosition(value) != NO_POSITION : std::find(begin(), end(), value) != end();
+  }
+
+  /**
+   * Adds a value, which the key must not have yet.
+   * @param value value to add
+   */
+  void Add(const TupleSlot value) {
+    TERRIER_ASSERT(!Contains(value), "The key already has this value.");
+    if (size_ == capacity_) Reallocate(2 * capacity_);
+    Values()[size_] = value;
+    if (Indexed()) AddPosition(size_);
+    size_++;
+  }
+
+  /**
+   * Removes a value. The last value takes its place, and the array is left as big as it is.
+   * @param value value to remove
+   * @return true if the key had the value, false otherwise
+   */
+  bool Remove(const TupleSlot value) {
+    TupleSlot *const values = Values();
+    if (!Indexed()) {
+      TupleSlot *const found = std::find(values, values + size_, value);
+      if (found == values + size_) return false;
+      *found = values[--size_];
+      return true;
+    }
+
+    const uint32_t entry = FindPosition(value);
+    if (entry == NO_POSITION) return false;
+    const uint32_t position = Positions()[entry] - 1, last = size_ - 1;
+    RemovePosition(entry);
+    if (position != last) {
+      Positions()[FindPosition(values[last])] = position + 1;
+      values[position] = values[last];
+    }
+    size_--;
+    return true;
+  }
+
+  /**
+   * @return true if the last Remove made the array worth shrinking, i.e. the values just started to fit into the object
+   *         itself or into a quarter of the array. Reported once per crossing, so that each key is shrunk only once.
+   */
+  bool NeedsShrink() const { return Overflowed() && (size_ == INLINE_VALUES || size_ == capacity_ / 4); }
+
+  /**
+   * Moves the values back into the object if they fit, or into an array of their size otherwise.
+   */
+  void ShrinkToFit() {
+    if (Overflowed() && size_ < capacity_) Reallocate(std::max(size_, INLINE_VALUES));
+  }
+
+  /**
+   * @return bytes allocated outside of the object
+   */
+  uint64_t HeapUsage() const {
+    if (!Overflowed()) return 0;
+    return capacity_ * sizeof(TupleSlot) + (Indexed() ? PositionsSize() * sizeof(uint32_t) : 0);
+  }
+
+ private:
+  uint32_t size_;
+  uint32_t capacity_;
+  union {
+    TupleSlot inline_values_[INLINE_VALUES];
+    TupleSlot *heap_values_;
+  };
+
+  // Marks an entry of the positions table that was not found
+  static constexpr uint32_t NO_POSITION = UINT32_MAX;
+
+  bool Overflowed() const { return capacity_ > INLINE_VALUES; }
+
+  bool Indexed() const { return capacity_ >= INDEXED_CAPACITY; }
+
+  // Number of entries of the positions table, the smallest power of two that is at least twice the capacity, so that
+  // the table is at most half full. Every entry is the position of a value in the array plus one, or 0 if it is empty.
+  uint32_t PositionsSize() const {
+    uint32_t size = 1;
+    while (size < 2 * capacity_) size *= 2;
+    return size;
+  }
+
+  uint32_t *Positions() { return reinterpret_cast<uint32_t *>(heap_values_ + capacity_); }
+
+  const uint32_t *Positions() const { return reinterpret_cast<const uint32_t *>(heap_values_ + capacity_); }
+
+  // Entry of the positions table at which the probe for the value starts
+  uint32_t HomeEntry(const TupleSlot value) const {
+    // TupleSlots of the same block only differ in their low bits, so mix all of them into the ones the mask keeps
+    const uint64_t hash = std::hash<TupleSlot>()(value) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<uint32_t>(hash >> 32) & (PositionsSize() - 1);
+  }
+
+  // Entry of the positions table that holds the position of the value, or NO_POSITION if the key does not have it
+  uint32_t FindPosition(const TupleSlot value) const {
+    const uint32_t *const positions = Positions();
+    const uint32_t mask = PositionsSize() - 1;
+    for (uint32_t entry = HomeEntry(value); positions[entry] != 0; entry = (entry + 1) & mask)
+      if (heap_values_[positions[entry] - 1] == value) return entry;
+    return NO_POSITION;
+  }
+
+  void AddPosition(const uint32_t position) {
+    uint32_t *const positions = Positions();
+    const uint32_t mask = PositionsSize() - 1;
+    uint32_t entry = HomeEntry(heap_values_[position]);
+    while (positions[entry] != 0) entry = (entry + 1) & mask;
+    positions[entry] = position + 1;
+  }
+
+  // Empties the entry, and moves later entries of the same probe sequence back into the hole so that none of them
+  // becomes unreachable
+  void RemovePosition(uint32_t hole) {
+    uint32_t *const positions = Positions();
+    const uint32_t mask = PositionsSize() - 1;
+    for (uint32_t entry = (hole + 1) & mask; positions[entry] != 0; entry = (entry + 1) & mask) {
+      const uint32_t home = HomeEntry(heap_values_[positions[entry] - 1]);
+      // The entry may only move if the hole lies between its home and itself
+      if (((entry - home) & mask) >= ((entry - hole) & mask)) {
+        positions[hole] = positions[entry];
+        hole = entry;
+      }
+    }
+    positions[hole] = 0;
+  }
+
+  void BuildPositions() {
+    std::memset(Positions(), 0, PositionsSize() * sizeof(uint32_t));
+    for (uint32_t position = 0; position < size_; position++) AddPosition(position);
+  }
+
+  // Allocates the array for the current capacity, followed by the positions table if it needs one
+  TupleSlot *AllocateHeapValues() const {
+    const uint32_t positions_size = Indexed() ? PositionsSize() : 0;
+    return new TupleSlot[capacity_ + positions_size * sizeof(uint32_t) / sizeof(TupleSlot)];
+  }
+
+  TupleSlot *Values() { return Overflowed() ? heap_values_ : inline_values_; }
+
+  const TupleSlot *Values() const { return Overflowed() ? heap_values_ : inline_values_; }
+
+  void Reallocate(const uint32_t capacity) {
+    TERRIER_ASSERT(capacity >= size_ && capacity >= INLINE_VALUES, "Values must fit into the new array.");
+    TupleSlot *const old_values = Overflowed() ? heap_values_ : nullptr;
+    TupleSlot moved[INLINE_VALUES];
+    std::memcpy(static_cast<void *>(moved), inline_values_, sizeof(inline_values_));
+    const TupleSlot *const from = old_values != nullptr ? old_values : moved;
+    capacity_ = capacity;
+    if (Overflowed()) heap_values_ = AllocateHeapValues();
+    std::memcpy(static_cast<void *>(Values()), from, size_ * sizeof(TupleSlot));
+    if (Indexed()) BuildPositions();
+    delete[] old_values;
+  }
+};
+
+}  // namespace terrier::storage::index
@@ -1,13 +1,21 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 #include "catalog/catalog_defs.h"
+#include "common/allocator.h"
+#include "common/constants.h"
+#include "common/managed_pointer.h"
 #include "common/performance_counter.h"
+#include "common/worker_pool.h"
 #include "storage/data_table.h"
 #include "storage/index/index_defs.h"
 #include "storage/index/index_metadata.h"
+#include "storage/sql_table.h"
 #include "storage/storage_defs.h"
 #include "transaction/transaction_context.h"
 
@@ -44,6 +52,87 @@ class Index {
     return data_table->IsVisible(txn, slot);
   }
 
+  /**
+   * Removes the values that are not visible to the calling txn from the results of a batched key scan, and moves the
+   * offsets of the keys along. The version pointers of the values a few positions ahead are prefetched while a value is
+   * checked, so that the cache misses of the checks overlap.
+   * @param txn the calling transaction
+   * @param[in,out] value_list the values of all keys, key by key
+   * @param[in,out] offsets the position in value_list where the values of each key start, followed by the size of
+   *                        value_list
+   */
+  static void RemoveInvisible(const transaction::TransactionContext &txn, std::vector<TupleSlot> *const value_list,
+                              std::vector<uint32_t> *const offsets) {
+    constexpr uint32_t prefetch_distance = 8;
+    auto &values = *value_list;
+    auto &key_offsets = *offsets;
+    const auto num_values = static_cast<uint32_t>(values.size());
+    uint32_t num_visible = 0;
+    uint32_t key = 0;
+    for (uint32_t i = 0; i < num_values; i++) {
+      if (i + prefetch_distance < num_values) {
+        const TupleSlot ahead = values[i + prefetch_distance];
+        ahead.GetBlock()->data_table_->PrefetchVersionPtr(ahead);
+      }
+      // Keys without values share their offset with the next key
+      while (key_offsets[key] == i) key_offsets[key++] = num_visible;
+      if (IsVisible(txn, values[i])) values[num_visible++] = values[i];
+    }
+    while (key < key_offsets.size()) key_offsets[key++] = num_visible;
+    values.resize(num_visible);
+  }
+
+  /**
+   * Scans the table and builds the key of every tuple visible to the calling txn, in the same way recovery builds index
+   * keys from the table's projected rows.
+   * @param txn the calling transaction
+   * @param table the table this index is defined on
+   * @param consumer invoked with the key and the slot of every visible tuple. The key is only valid during the call.
+   */
+  void ScanKeys(transaction::TransactionContext *const txn, const common::ManagedPointer<SqlTable> table,
+                const std::function<void(const ProjectedRow &, TupleSlot)> &consumer) const {
+    const auto &schema = metadata_.GetSchema();
+    const auto &indexed_attributes = schema.GetIndexedColOids();
+    const auto num_index_cols = schema.GetColumns().size();
+    TERRIER_ASSERT(num_index_cols == indexed_attributes.size(), "Only support index keys that are a single column oid");
+
+    // A table column could appear in more than one key column, but only once in the projection
+    std::vector<catalog::col_oid_t> col_oids(indexed_attributes);
+    std::sort(col_oids.begin(), col_oids.end());
+    col_oids.erase(std::unique(col_oids.begin(), col_oids.end()), col_oids.end());
+    const auto pc_init = table->InitializerForProjectedColumns(col_oids, common::Constants::K_DEFAULT_VECTOR_SIZE);
+    auto pc_map = table->ProjectionMapForOids(col_oids);
+    auto *const pc_buffer = common::AllocationUtil::AllocateAligned(pc_init.ProjectedColumnsSize());
+    auto *const pc = pc_init.Initialize(pc_buffer);
+
+    const auto &key_oid_to_offset = GetKeyOidToOffsetMap();
+    auto *const key_buffer = common::AllocationUtil::AllocateAligned(GetProjectedRowInitializer().ProjectedRowSize());
+    auto *const key = GetProjectedRowInitializer().InitializeRow(key_buffer);
+
+    auto table_iter = table->begin();
+    while (table_iter != table->end()) {
+      table->Scan(txn, &table_iter, pc);
+      for (uint32_t i = 0; i < pc->NumTuples(); i++) {
+        const auto row = pc->InterpretAsRow(i);
+        for (uint32_t col_idx = 0; col_idx < num_index_cols; col_idx++) {
+          const auto &col = schema.GetColumn(col_idx);
+          const uint16_t key_offset = key_oid_to_offset.at(col.Oid());
+          const uint16_t pc_offset = pc_map[indexed_attributes[col_idx]];
+          if (row.IsNull(pc_offset)) {
+            key->SetNull(key_offset);
+          } else {
+            std::memcpy(key->AccessForceNotNull(key_offset), row.AccessWithNullCheck(pc_offset),
+                        col.AttrSize() & INT8_MAX);
+          }
+        }
+        consumer(*key, pc->TupleSlots()[i]);
+      }
+    }
+
+    delete[] key_buffer;
+    delete[] pc_buffer;
+  }
+
   /**
    * Creates a new index wrapper.
    * @param metadata index description
@@ -83,6 +172,26 @@ class Index {
    */
   virtual bool InsertUnique(transaction::TransactionContext *txn, const ProjectedRow &tuple, TupleSlot location) = 0;
 
+  /**
+   * Fills an empty index with the keys of all tuples in the table that are visible to the calling txn, e.g. when the
+   * index is created on an existing table or rebuilt after recovery. Indexes that can construct their structure from
+   * sorted keys override this, by default the keys are inserted one at a time.
+   * @param txn txn context for the calling txn, used for visibility and to register abort actions
+   * @param table the table this index is defined on. No other txn may modify the index until this call returns.
+   * @param sort_pool workers to sort the keys with, nullptr to sort on the calling thread
+   * @return true if all keys were loaded, false if they violate the uniqueness of the index. In that case the txn
+   *         must abort.
+   */
+  virtual bool BulkLoad(transaction::TransactionContext *const txn, const common::ManagedPointer<SqlTable> table,
+                        common::WorkerPool *const sort_pool) {
+    const bool unique = metadata_.GetSchema().Unique();
+    bool result = true;
+    ScanKeys(txn, table, [&](const ProjectedRow &key, const TupleSlot slot) {
+      if (result) result = unique ? InsertUnique(txn, key, slot) : Insert(txn, key, slot);
+    });
+    return result;
+  }
+
   /**
    * Doesn't immediately call delete on the index. Registers a commit action in the txn that will eventually register a
    * deferred action for the GC to safely call delete on the index when no more transactions need to access the key.
@@ -101,6 +210,30 @@ class Index {
   virtual void ScanKey(const transaction::TransactionContext &txn, const ProjectedRow &key,
                        std::vector<TupleSlot> *value_list) = 0;
 
+  /**
+   * Finds all the values associated with each of the given keys, e.g. the join keys of a batch of outer tuples.
+   * Indexes that can overlap the lookups of different keys override this, by default the keys are looked up one at a
+   * time.
+   * @param txn txn context for the calling txn, used for visibility checks
+   * @param keys the keys to look for
+   * @param[out] value_list the values associated with the keys, key by key
+   * @param[out] offsets resized to one entry more than there are keys. The values of keys[i] are the ones from
+   *                     value_list[offsets[i]] up to, but not including, value_list[offsets[i + 1]].
+   */
+  virtual void ScanKeyBatch(const transaction::TransactionContext &txn, const std::vector<const ProjectedRow *> &keys,
+                            std::vector<TupleSlot> *value_list, std::vector<uint32_t> *offsets) {
+    TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
+    offsets->resize(keys.size() + 1);
+    std::vector<TupleSlot> key_values;
+    for (uint32_t i = 0; i < keys.size(); i++) {
+      (*offsets)[i] = static_cast<uint32_t>(value_list->size());
+      key_values.clear();
+      ScanKey(txn, *keys[i], &key_values);
+      value_list->insert(value_list->end(), key_values.cbegin(), key_values.cend());
+    }
+    offsets->back() = static_cast<uint32_t>(value_list->size());
+  }
+
   /**
    * Finds all the values between the given keys in our index, sorted in ascending order.
    * @param txn txn context for the calling txn, used for visibility checks
@@ -4,6 +4,7 @@
 #include <vector>
 #include "catalog/catalog_defs.h"
 #include "catalog/index_schema.h"
+#include "storage/index/art_index.h"
 #include "storage/index/bwtree_index.h"
 #include "storage/index/compact_ints_key.h"
 #include "storage/index/generic_key.h"
@@ -53,11 +54,34 @@ class IndexBuilder {
         if (simple_key && metadata.KeySize() <= HASHKEY_MAX_SIZE) return BuildHashIntsKey(std::move(metadata));
         return BuildHashGenericKey(std::move(metadata));
       }
+      case IndexType::ART: {
+        if (simple_key && metadata.KeySize() <= COMPACTINTSKEY_MAX_SIZE) return BuildArtIntsKey(std::move(metadata));
+        return BuildArtGenericKey(std::move(metadata));
+      }
       default:
         return nullptr;
     }
   }
 
+  /**
+   * Builds the best-possible index for the current parameters on an existing table and fills it with the keys of all
+   * tuples visible to the calling txn through Index::BulkLoad
+   * @param txn txn context for the calling txn
+   * @param table the table the key schema is defined on
+   * @param sort_pool workers to sort the keys with, nullptr to sort on the calling thread
+   * @return the filled index, nullptr if it failed to construct a valid index or if the tuples violate the uniqueness
+   *         of the key. In the latter case the txn must abort.
+   */
+  Index *BuildAndLoad(transaction::TransactionContext *const txn, const common::ManagedPointer<SqlTable> table,
+                      common::WorkerPool *const sort_pool) const {
+    Index *const index = Build();
+    if (index != nullptr && !index->BulkLoad(txn, table, sort_pool)) {
+      delete index;
+      return nullptr;
+    }
+    return index;
+  }
+
   /**
    * @param key_schema the index key schema
    * @return the builder object
@@ -96,12 +120,52 @@ class IndexBuilder {
         sizeof(uintptr_t);  // account for potential padding of the PR and the size of the pointer for metadata
     TERRIER_ASSERT(key_size <= GENERICKEY_MAX_SIZE, "Key size exceeds maximum for this key type.");
 
+    // The BwTree compares keys at every step down the tree, which is worth the bytes of a normalized prefix
+    if (key_size <= 64) {
+      index = new BwTreeIndex<NormalizedGenericKey<64>>(std::move(metadata));
+    } else if (key_size <= 128) {
+      index = new BwTreeIndex<NormalizedGenericKey<128>>(std::move(metadata));
+    } else if (key_size <= 256) {
+      index = new BwTreeIndex<NormalizedGenericKey<256>>(std::move(metadata));
+    }
+    TERRIER_ASSERT(index != nullptr, "Failed to create an GenericKey index.");
+    return index;
+  }
+
+  Index *BuildArtIntsKey(IndexMetadata metadata) const {
+    metadata.SetKeyKind(IndexKeyKind::COMPACTINTSKEY);
+    const auto key_size = metadata.KeySize();
+    TERRIER_ASSERT(key_size <= COMPACTINTSKEY_MAX_SIZE, "Key size exceeds maximum for this key type.");
+    Index *index = nullptr;
+    if (key_size <= 8) {
+      index = new ArtIndex<CompactIntsKey<8>>(std::move(metadata));
+    } else if (key_size <= 16) {
+      index = new ArtIndex<CompactIntsKey<16>>(std::move(metadata));
+    } else if (key_size <= 24) {
+      index = new ArtIndex<CompactIntsKey<24>>(std::move(metadata));
+    } else if (key_size <= 32) {
+      index = new ArtIndex<CompactIntsKey<32>>(std::move(metadata));
+    }
+    TERRIER_ASSERT(index != nullptr, "Failed to create an IntsKey index.");
+    return index;
+  }
+
+  Index *BuildArtGenericKey(IndexMetadata metadata) const {
+    metadata.SetKeyKind(IndexKeyKind::GENERICKEY);
+    const auto pr_size = metadata.GetInlinedPRInitializer().ProjectedRowSize();
+    Index *index = nullptr;
+
+    const auto key_size =
+        (pr_size + 8) +
+        sizeof(uintptr_t);  // account for potential padding of the PR and the size of the pointer for metadata
+    TERRIER_ASSERT(key_size <= GENERICKEY_MAX_SIZE, "Key size exceeds maximum for this key type.");
+
     if (key_size <= 64) {
-      index = new BwTreeIndex<GenericKey<64>>(std::move(metadata));
+      index = new ArtIndex<GenericKey<64>>(std::move(metadata));
     } else if (key_size <= 128) {
-      index = new BwTreeIndex<GenericKey<128>>(std::move(metadata));
+      index = new ArtIndex<GenericKey<128>>(std::move(metadata));
     } else if (key_size <= 256) {
-      index = new BwTreeIndex<GenericKey<256>>(std::move(metadata));
+      index = new ArtIndex<GenericKey<256>>(std::move(metadata));
     }
     TERRIER_ASSERT(index != nullptr, "Failed to create an GenericKey index.");
     return index;
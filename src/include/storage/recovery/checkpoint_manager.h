@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <chrono>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "catalog/catalog_defs.h"
+#include "storage/sql_table.h"
+#include "storage/write_ahead_log/log_io.h"
+#include "storage/write_ahead_log/log_manager.h"
+#include "storage/write_ahead_log/log_record.h"
+#include "transaction/timestamp_manager.h"
+#include "transaction/transaction_manager.h"
+
+namespace terrier::storage {
+
+/**
+ * @brief Takes fuzzy checkpoints of all databases, so recovery only has to replay the log written after them.
+ *
+ * A checkpoint is the state of every table seen by a snapshot txn, written in the log format: one txn per
+ * database that inserts its pg_database row and all its catalog rows, followed by txns that insert the tuples of its
+ * user tables. All records carry the tuple slots of the original tuples, so the log written after the checkpoint can
+ * be replayed on top of it. The recovery manager reads a checkpoint back through a DiskCheckpointProvider.
+ *
+ * Checkpoints never block txns. The snapshot is taken once every txn that may have written into the log so far has
+ * finished, so the whole log before that point is covered by the checkpoint. Logged txns that committed before the
+ * snapshot began are skipped when replaying the log after the checkpoint.
+ */
+class CheckpointManager {
+ public:
+  /**
+   * @param checkpoint_file_path path to write checkpoints to. The file is atomically replaced by every checkpoint
+   * @param catalog catalog to checkpoint
+   * @param txn_manager txn manager to begin the snapshot txn with
+   * @param timestamp_manager timestamp manager of txn_manager, used to wait for txns older than the checkpoint
+   * @param log_manager log manager of txn_manager, used to find where replay has to start after the checkpoint and to
+   * truncate the log before that point. Can be DISABLED
+   */
+  CheckpointManager(std::string checkpoint_file_path, common::ManagedPointer<catalog::Catalog> catalog,
+                    transaction::TransactionManager *txn_manager, transaction::TimestampManager *timestamp_manager,
+                    LogManager *log_manager)
+      : checkpoint_file_path_(std::move(checkpoint_file_path)),
+        catalog_(catalog),
+        txn_manager_(txn_manager),
+        timestamp_manager_(timestamp_manager),
+        log_manager_(log_manager) {}
+
+  /**
+   * Takes a checkpoint and truncates the log up to the point covered by it. Concurrent txns keep running while the
+   * checkpoint is written.
+   * @warning Not thread-safe, only one checkpoint can be taken at a time
+   * @return start timestamp of the snapshot the checkpoint holds
+   */
+  transaction::timestamp_t TakeCheckpoint();
+
+ private:
+  // Maximum number of tuples of user tables inserted by a single checkpoint txn. Keeps the changes recovery has to
+  // buffer per txn bounded.
+  static constexpr uint32_t CHECKPOINT_TXN_SIZE = 1024;
+  // How long to sleep between checks for txns older than the checkpoint
+  static constexpr std::chrono::milliseconds WAIT_INTERVAL{1};
+
+  std::string checkpoint_file_path_;
+  common::ManagedPointer<catalog::Catalog> catalog_;
+  transaction::TransactionManager *txn_manager_;
+  transaction::TimestampManager *timestamp_manager_;
+  LogManager *log_manager_;
+
+  // Used while writing a checkpoint. Writer for the checkpoint file
+  BufferedLogWriter *out_ = nullptr;
+  // Used while writing a checkpoint. Records serialized but not handed to out_ yet
+  std::vector<byte> serialized_;
+  // Used while writing a checkpoint. Txn id of the checkpoint txn records are currently written for
+  transaction::timestamp_t checkpoint_txn_;
+  // Used while writing a checkpoint. Number of records written for the current checkpoint txn
+  uint32_t checkpoint_txn_records_;
+
+  /**
+   * Writes the catalog and all user tables of a database
+   * @param txn snapshot txn
+   * @param db_oid oid of the database
+   * @param db_slot tuple slot of the database's row in pg_database
+   */
+  void WriteDatabase(transaction::TransactionContext *txn, catalog::db_oid_t db_oid, TupleSlot db_slot);
+
+  /**
+   * Writes an insert record for every tuple of a table visible to the snapshot
+   * @param txn snapshot txn
+   * @param db_oid database oid of the table, as it is logged
+   * @param table_oid oid of the table
+   * @param table table to write
+   * @param col_oids all columns of the table
+   * @param split_txns true if the tuples can be spread over several checkpoint txns, false to write all of them in
+   * the current one
+   */
+  void WriteTable(transaction::TransactionContext *txn, catalog::db_oid_t db_oid, catalog::table_oid_t table_oid,
+                  SqlTable *table, const std::vector<catalog::col_oid_t> &col_oids, bool split_txns);
+
+  /**
+   * Writes the rows of a table in pg_database or a database's catalog table that are visible to the snapshot
+   * @param txn snapshot txn
+   * @param db_oid database oid of the table, as it is logged
+   * @param table_oid oid of the catalog table
+   * @param table catalog table to write
+   * @param col_oids all columns of the catalog table
+   */
+  template <size_t NumCols>
+  void WriteCatalogTable(transaction::TransactionContext *txn, catalog::db_oid_t db_oid,
+                         catalog::table_oid_t table_oid, SqlTable *table,
+                         const std::array<catalog::col_oid_t, NumCols> &col_oids) {
+    WriteTable(txn, db_oid, table_oid, table, std::vector<catalog::col_oid_t>(col_oids.cbegin(), col_oids.cend()),
+               false);
+  }
+
+  /**
+   * Writes an update of the pointer column for every table and index in pg_class. Recovery recreates a table or index
+   * when replaying these updates, like it does when a table or index is created.
+   * @param txn snapshot txn
+   * @param db_oid oid of the database
+   * @param classes the database's pg_class
+   * @return oids of the user tables of the database
+   */
+  std::vector<catalog::table_oid_t> WriteClassPointers(transaction::TransactionContext *txn, catalog::db_oid_t db_oid,
+                                                       SqlTable *classes);
+
+  /**
+   * Serializes a record of the current checkpoint txn
+   * @param record record to write
+   */
+  void WriteRecord(const LogRecord &record);
+
+  /**
+   * Writes the commit record of the current checkpoint txn and moves on to the next one
+   */
+  void CommitCheckpointTxn();
+
+  /**
+   * Hands all serialized records to out_
+   */
+  void FlushSerializedRecords();
+
+  /**
+   * Frees the disk space of the log up to the given offset. The log is not moved, so concurrent appends to it are not
+   * affected and offsets into it stay valid. Does nothing if the file system does not support it.
+   * @param log_offset offset in the log file up to which the log is covered by the latest checkpoint
+   */
+  void TruncateLog(uint64_t log_offset);
+};
+
+}  // namespace terrier::storage
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include "storage/recovery/abstract_log_provider.h"
+#include "storage/write_ahead_log/log_io.h"
+#include "transaction/transaction_defs.h"
+
+namespace terrier::storage {
+
+/**
+ * @brief Log provider for checkpoints stored on disk
+ * A checkpoint file starts with a header holding the timestamp of the snapshot it was taken at and the offset in the
+ * log file from which the log has to be replayed on top of it. The rest of the file is written in the log format, so it
+ * is provided to the recovery manager like a log. See CheckpointManager.
+ */
+class DiskCheckpointProvider : public AbstractLogProvider {
+ public:
+  /**
+   * Reads in the checkpoint header
+   * @param checkpoint_file_path path to checkpoint file to read records from
+   */
+  explicit DiskCheckpointProvider(const std::string &checkpoint_file_path)
+      : in_(BufferedLogReader(checkpoint_file_path.c_str())) {
+    if (!in_.Read(&checkpoint_timestamp_, sizeof(checkpoint_timestamp_)) ||
+        !in_.Read(&log_file_offset_, sizeof(log_file_offset_)))
+      throw std::runtime_error("Checkpoint file " + checkpoint_file_path + " has no valid header");
+  }
+
+  /**
+   * @return start timestamp of the snapshot the checkpoint holds. Logged txns that committed before it are already
+   * contained in the checkpoint.
+   */
+  transaction::timestamp_t CheckpointTimestamp() const { return checkpoint_timestamp_; }
+
+  /**
+   * @return byte offset in the log file at which to start replaying the log after the checkpoint
+   */
+  uint64_t LogFileOffset() const { return log_file_offset_; }
+
+ private:
+  // Buffered checkpoint file reader
+  storage::BufferedLogReader in_;
+  transaction::timestamp_t checkpoint_timestamp_;
+  uint64_t log_file_offset_;
+
+  /**
+   * @return true if checkpoint file contains more records, false otherwise
+   */
+  bool HasMoreRecords() override { return in_.HasMore(); }
+
+  /**
+   * Read data from the checkpoint file into the destination provided
+   * @param dest pointer to location to read into
+   * @param size number of bytes to read
+   * @return true if we read the given number of bytes
+   */
+  bool Read(void *dest, uint32_t size) override { return in_.Read(dest, size); }
+};
+
+}  // namespace terrier::storage
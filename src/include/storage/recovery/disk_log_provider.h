@@ -15,8 +15,10 @@ class DiskLogProvider : public AbstractLogProvider {
  public:
   /**
    * @param log_file_path path to log file to read logs from
+   * @param offset byte offset in the log file to start reading at, e.g. the log offset of the checkpoint recovered from
    */
-  explicit DiskLogProvider(const std::string &log_file_path) : in_(BufferedLogReader(log_file_path.c_str())) {}
+  explicit DiskLogProvider(const std::string &log_file_path, uint64_t offset = 0)
+      : in_(BufferedLogReader(log_file_path.c_str(), offset)) {}
 
  private:
   // Buffered log file reader
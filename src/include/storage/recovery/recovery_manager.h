@@ -1,7 +1,10 @@
 #pragma once
 
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -14,8 +17,11 @@
 #include "catalog/postgres/pg_database.h"
 #include "catalog/postgres/pg_index.h"
 #include "catalog/postgres/pg_namespace.h"
+#include "common/container/concurrent_map.h"
 #include "common/dedicated_thread_owner.h"
+#include "common/worker_pool.h"
 #include "storage/recovery/abstract_log_provider.h"
+#include "storage/recovery/disk_checkpoint_provider.h"
 #include "storage/sql_table.h"
 #include "transaction/transaction_manager.h"
 
@@ -30,6 +36,12 @@ namespace terrier::storage {
  * TODO(Gus): Add more documentation when API is finalized
  */
 class RecoveryManager : public common::DedicatedThreadOwner {
+  /**
+   * Unit of work for parallel replay: (database, table, tuple slot partition). Tables with a unique index always use
+   * partition 0, so all of their changes are applied by one worker in commit order.
+   */
+  using ReplayPartition = std::tuple<catalog::db_oid_t, catalog::table_oid_t, uint32_t>;
+
   /**
    * Task in charge of initializing recovery. This way recovery can be non-blocking in a background thread.
    */
@@ -63,19 +75,27 @@ class RecoveryManager : public common::DedicatedThreadOwner {
    * @param deferred_action_manager manager to use for deferred deletes
    * @param thread_registry thread registry to register tasks
    * @param store block store used for SQLTable creation during recovery
+   * @param num_replay_threads number of workers applying committed transactions. With 1, transactions are replayed
+   * serially on the recovery thread
+   * @param checkpoint_provider provider for the checkpoint to recover from before replaying the logs, or nullptr to
+   * replay the logs only. The log provider must then start at the checkpoint's log file offset
    */
   explicit RecoveryManager(AbstractLogProvider *log_provider, common::ManagedPointer<catalog::Catalog> catalog,
                            transaction::TransactionManager *txn_manager,
                            transaction::DeferredActionManager *deferred_action_manager,
                            common::ManagedPointer<terrier::common::DedicatedThreadRegistry> thread_registry,
-                           BlockStore *store)
+                           BlockStore *store, uint32_t num_replay_threads = 1,
+                           DiskCheckpointProvider *checkpoint_provider = nullptr)
       : DedicatedThreadOwner(thread_registry),
         log_provider_(log_provider),
+        checkpoint_provider_(checkpoint_provider),
         catalog_(catalog),
         txn_manager_(txn_manager),
         deferred_action_manager_(deferred_action_manager),
         block_store_(store),
+        num_replay_threads_(num_replay_threads),
         recovered_txns_(0) {
+    TERRIER_ASSERT(num_replay_threads_ > 0, "Recovery needs at least one replay thread");
     // Initialize catalog_table_schemas_ map
     catalog_table_schemas_[catalog::postgres::CLASS_TABLE_OID] = catalog::postgres::Builder::GetClassTableSchema();
     catalog_table_schemas_[catalog::postgres::NAMESPACE_TABLE_OID] =
@@ -107,6 +127,9 @@ class RecoveryManager : public common::DedicatedThreadOwner {
   }
 
  private:
+  // Number of committed transactions batched up before parallel replay applies them
+  static constexpr uint32_t REPLAY_BATCH_SIZE = 4096;
+
   FRIEND_TEST(RecoveryTests, DoubleRecoveryTest);
   friend class RecoveryTests;
   friend class terrier::RecoveryBenchmark;
@@ -114,6 +137,13 @@ class RecoveryManager : public common::DedicatedThreadOwner {
   // Log provider for reading in logs
   AbstractLogProvider *log_provider_;
 
+  // Provider for reading in the checkpoint to recover from, or nullptr
+  DiskCheckpointProvider *checkpoint_provider_;
+
+  // Start timestamp of the snapshot held by the checkpoint recovered from. Logged txns that committed before it are
+  // already contained in the checkpoint. 0 if not recovering from a checkpoint
+  transaction::timestamp_t checkpoint_timestamp_{0};
+
   // Catalog to fetch table pointers
   common::ManagedPointer<catalog::Catalog> catalog_;
 
@@ -128,10 +158,14 @@ class RecoveryManager : public common::DedicatedThreadOwner {
   // tables during recovery
   BlockStore *block_store_;
 
-  // Used during recovery from log. Maps old tuple slot to new tuple slot
+  // Number of workers applying committed transactions
+  uint32_t num_replay_threads_;
+
+  // Used during recovery from log. Maps old tuple slot to new tuple slot. Replay workers insert and look up mappings
+  // concurrently, so deleted tuples are only marked with an invalid slot and erased once no worker is running.
   // TODO(Gus): This map may get huge, benchmark whether this becomes a problem and if we need a more sophisticated data
   // structure
-  std::unordered_map<TupleSlot, TupleSlot> tuple_slot_map_;
+  common::ConcurrentMap<TupleSlot, TupleSlot, std::hash<TupleSlot>> tuple_slot_map_;
 
   // Used during recovery from log. Stores deferred transactions in sorted sorted order to be able to execute them in
   // serial order. Transactions are defered when there is an older active transaction at the time it committed. Even
@@ -144,6 +178,28 @@ class RecoveryManager : public common::DedicatedThreadOwner {
   std::unordered_map<transaction::timestamp_t, std::vector<std::pair<LogRecord *, std::vector<byte *>>>>
       buffered_changes_map_;
 
+  // Used during parallel replay. Changes of committed txns that only modify user tables and have not been applied yet.
+  // Each partition holds one list of records per txn, in the order the txns are replayed.
+  std::map<ReplayPartition, std::vector<std::vector<LogRecord *>>> batched_changes_;
+
+  // Used during parallel replay. Start timestamps of the txns in batched_changes_. Their records are freed once the
+  // batch has been applied.
+  std::vector<transaction::timestamp_t> batched_txns_;
+
+  // Used during parallel replay. Caches whether a table's changes can be split by tuple slot, i.e. the table has no
+  // unique index. Cleared whenever a catalog txn is replayed.
+  std::map<std::pair<catalog::db_oid_t, catalog::table_oid_t>, bool> slot_partitioned_tables_;
+
+  // Used during checkpoint replay. Set while index maintenance on user tables is deferred, since the checkpoint only
+  // holds inserts and the indexes can be bulk loaded once all tuples are in place.
+  bool defer_user_indexes_ = false;
+
+  // Used during checkpoint replay. User tables that tuples were inserted into while index maintenance was deferred
+  std::set<std::pair<catalog::db_oid_t, catalog::table_oid_t>> deferred_index_tables_;
+
+  // Workers for parallel replay, only present while recovering with more than one replay thread
+  std::unique_ptr<common::WorkerPool> replay_pool_;
+
   // Background recovery task
   common::ManagedPointer<RecoveryTask> recovery_task_ = nullptr;
 
@@ -155,23 +211,77 @@ class RecoveryManager : public common::DedicatedThreadOwner {
   uint32_t recovered_txns_;
 
   /**
-   * Recovers the databases using the provided log provider
-   * @return number of committed transactions replayed
+   * Recovers the databases from the checkpoint, if any, then from the logs
    */
-  void Recover() { RecoverFromLogs(); }
+  void Recover();
+
+  /**
+   * Recovers the databases from the checkpoint. The checkpoint is in the log format, so it is replayed like a log.
+   */
+  void RecoverFromCheckpoint();
 
   /**
    * Recovers the databases from the logs.
-   * @note this is a separate method so in the future, we can also have a RecoverFromCheckpoint method
    */
   void RecoverFromLogs();
 
   /**
-   * @brief Replay a committed transaction corresponding to txn_id.
+   * Replays all committed txns provided by a log provider
+   * @param log_provider provider to read records from
+   */
+  void ReplayLogs(AbstractLogProvider *log_provider);
+
+  /**
+   * @brief Replay a committed transaction corresponding to txn_id. With parallel replay, txns that only modify user
+   * tables are batched, and catalog txns act as a barrier that applies the batch before being replayed serially.
    * @param txn_id start timestamp for committed transaction
    */
   void ProcessCommittedTransaction(transaction::timestamp_t txn_id);
 
+  /**
+   * Replays the changes of a committed txn serially in a single recovery txn. Used for all txns when replaying on one
+   * thread, and for txns that modify the catalog otherwise.
+   * @param txn_id start timestamp for committed transaction
+   */
+  void ReplayCommittedTransaction(transaction::timestamp_t txn_id);
+
+  /**
+   * @param txn_id start timestamp for committed transaction
+   * @return true if any buffered change of the txn modifies a catalog table
+   */
+  bool ModifiesCatalog(transaction::timestamp_t txn_id);
+
+  /**
+   * Splits the changes of a committed txn by partition and adds them to the current batch
+   * @param txn_id start timestamp for committed transaction
+   */
+  void BatchCommittedTransaction(transaction::timestamp_t txn_id);
+
+  /**
+   * Applies all batched txns on the replay workers, one task per partition, and waits for them to finish. Cleans up
+   * the batched records and the tuple slot mappings of deleted tuples afterwards.
+   */
+  void ReplayBatchedTransactions();
+
+  /**
+   * Replays the txns batched for a single partition, one recovery txn per original txn. Called from replay workers.
+   * @param txns records of each txn for this partition, in replay order
+   * @param erased_slots output list of old tuple slots deleted by the replayed txns
+   */
+  void ReplayPartitionChanges(std::vector<std::vector<LogRecord *>> *txns, std::vector<TupleSlot> *erased_slots);
+
+  /**
+   * @param db_oid database oid for table
+   * @param table_oid oid of a user table
+   * @return true if the table has no unique index, so changes to different tuples may be applied in any order
+   */
+  bool IsSlotPartitioned(catalog::db_oid_t db_oid, catalog::table_oid_t table_oid);
+
+  /**
+   * Bulk loads every index on the tables in deferred_index_tables_, sorting the keys on the replay workers if any
+   */
+  void BulkLoadDeferredIndexes();
+
   /**
    * Defers log records deletes with the transaction manager
    * @param txn_id txn_id for txn who's records to delete
@@ -193,8 +303,30 @@ class RecoveryManager : public common::DedicatedThreadOwner {
    * @return new tuple slot
    */
   TupleSlot GetTupleSlotMapping(TupleSlot slot) {
-    TERRIER_ASSERT(tuple_slot_map_.find(slot) != tuple_slot_map_.end(), "No tuple slot mapping exists");
-    return tuple_slot_map_[slot];
+    auto it = tuple_slot_map_.Find(slot);
+    TERRIER_ASSERT(it != tuple_slot_map_.end() && it->second != TupleSlot(nullptr, 0), "No tuple slot mapping exists");
+    return it->second;
+  }
+
+  /**
+   * Maps an old tuple slot to a new tuple slot, overwriting any existing mapping. Safe to call concurrently for
+   * different old tuple slots.
+   * @param old_slot old tuple slot
+   * @param new_slot new tuple slot
+   */
+  void SetTupleSlotMapping(TupleSlot old_slot, TupleSlot new_slot) {
+    auto result = tuple_slot_map_.Insert(old_slot, new_slot);
+    if (!result.second) result.first->second = new_slot;
+  }
+
+  /**
+   * Erases the mapping of an old tuple slot if it was deleted and not reused since. Must not be called while replay
+   * workers are running.
+   * @param old_slot old tuple slot
+   */
+  void PurgeTupleSlotMapping(TupleSlot old_slot) {
+    auto it = tuple_slot_map_.Find(old_slot);
+    if (it != tuple_slot_map_.end() && it->second == TupleSlot(nullptr, 0)) tuple_slot_map_.UnsafeErase(old_slot);
   }
 
   /**
@@ -277,7 +409,8 @@ class RecoveryManager : public common::DedicatedThreadOwner {
    * @return true if record is an insert redo, false if it is an update redo
    */
   bool IsInsertRecord(const RedoRecord *record) const {
-    return tuple_slot_map_.find(record->GetTupleSlot()) == tuple_slot_map_.end();
+    auto it = tuple_slot_map_.Find(record->GetTupleSlot());
+    return it == tuple_slot_map_.cend() || it->second == TupleSlot(nullptr, 0);
   }
 
   /**
@@ -148,6 +148,20 @@ class SqlTable {
     return table_.data_table_->Scan(txn, start_pos, out_buffer);
   }
 
+  /**
+   * Same as Scan, but stops at the given end position (exclusive). @see DataTable::RangeScan
+   *
+   * @param txn the calling transaction
+   * @param start_pos iterator to the starting location for the sequential scan
+   * @param end_pos iterator to one slot past the last slot to scan
+   * @param out_buffer output buffer. The object should already contain projection list information. This buffer is
+   *                   always cleared of old values.
+   */
+  void RangeScan(transaction::TransactionContext *const txn, DataTable::SlotIterator *const start_pos,
+                 const DataTable::SlotIterator &end_pos, ProjectedColumns *const out_buffer) const {
+    return table_.data_table_->RangeScan(txn, start_pos, end_pos, out_buffer);
+  }
+
   /**
    * @return the first tuple slot contained in the underlying DataTable
    */
@@ -158,6 +172,85 @@ class SqlTable {
    */
   DataTable::SlotIterator end() const { return table_.data_table_->end(); }  // NOLINT for STL name compability
 
+  /**
+   * @param block_index index of the block in the underlying DataTable
+   * @return the first tuple slot of the given block in the underlying DataTable
+   */
+  DataTable::SlotIterator beginAt(uint32_t block_index) const {  // NOLINT for STL name compability
+    return table_.data_table_->beginAt(block_index);
+  }
+
+  /**
+   * @return the number of blocks in the underlying DataTable
+   */
+  uint32_t GetNumBlocks() const { return table_.data_table_->GetNumBlocks(); }
+
+  /**
+   * @param pos iterator to any slot in the underlying DataTable
+   * @return the first tuple slot of the next block in the underlying DataTable
+   */
+  DataTable::SlotIterator NextBlock(const DataTable::SlotIterator &pos) const {
+    return table_.data_table_->NextBlock(pos);
+  }
+
+  /**
+   * Attempts to get in-place read access to the given block. @see DataTable::TryAcquireInPlaceRead
+   * @param block the block to read in place
+   * @return true if in-place access is granted, false if the block has to be read transactionally
+   */
+  bool TryAcquireInPlaceRead(RawBlock *const block) const { return table_.data_table_->TryAcquireInPlaceRead(block); }
+
+  /**
+   * Releases in-place read access to a block obtained through TryAcquireInPlaceRead.
+   * @param block the block to release
+   */
+  void ReleaseInPlaceRead(RawBlock *const block) const { table_.data_table_->ReleaseInPlaceRead(block); }
+
+  /**
+   * @param block a block the caller has in-place read access to
+   * @return the number of tuples in the block, all stored contiguously starting at slot 0
+   */
+  uint32_t InPlaceNumRecords(RawBlock *const block) const { return table_.data_table_->InPlaceNumRecords(block); }
+
+  /**
+   * @param block a block the caller has in-place read access to
+   * @param col_id the column of interest
+   * @param offset the slot to start reading at
+   * @return pointer to the value of the given column at the given slot in block memory
+   */
+  const byte *InPlaceColumnValues(RawBlock *const block, const col_id_t col_id, const uint32_t offset) const {
+    return table_.data_table_->InPlaceColumnValues(block, col_id, offset);
+  }
+
+  /**
+   * @param block a block the caller has in-place read access to
+   * @param col_id the column of interest
+   * @param offset the slot to start reading at. Must be a multiple of 8.
+   * @return null bitmap of the given column, starting at the given slot
+   */
+  const common::RawBitmap *InPlaceColumnNullBitmap(RawBlock *const block, const col_id_t col_id,
+                                                   const uint32_t offset) const {
+    return table_.data_table_->InPlaceColumnNullBitmap(block, col_id, offset);
+  }
+
+  /**
+   * @param block a block the caller has in-place read access to
+   * @param col_id the column of interest
+   * @return the number of NULLs in the given column of the block
+   */
+  uint32_t InPlaceNullCount(RawBlock *const block, const col_id_t col_id) const {
+    return table_.data_table_->InPlaceNullCount(block, col_id);
+  }
+
+  /**
+   * @param block a block the caller has in-place read access to
+   * @param col_id the column of interest
+   * @return Arrow metadata of the given column in the block
+   */
+  ArrowColumnInfo *InPlaceArrowColumnInfo(RawBlock *const block, const col_id_t col_id) const {
+    return table_.data_table_->InPlaceArrowColumnInfo(block, col_id);
+  }
+
   /**
    * Generates an ProjectedColumnsInitializer for the execution layer to use. This performs the translation from col_oid
    * to col_id for the Initializer's constructor so that the execution layer doesn't need to know anything about col_id.
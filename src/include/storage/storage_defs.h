@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <ostream>
 #include <string_view>  // NOLINT
@@ -15,6 +16,7 @@
 #include "common/object_pool.h"
 #include "common/strong_typedef.h"
 #include "storage/block_access_controller.h"
+#include "storage/block_allocator.h"
 #include "storage/write_ahead_log/log_io.h"
 #include "transaction/transaction_defs.h"
 
@@ -52,10 +54,12 @@ class alignas(common::Constants::BLOCK_SIZE) RawBlock {
   DataTable *data_table_;
 
   /**
-   * Padding for flags or whatever we may want in the future. Determined by size of layout_version below. See
-   * tuple_access_strategy.h for more details on Block header layout.
+   * Sampled count of the reads and writes to this block, which the AccessObserver watches to tell if the block has gone
+   * cold. Only a fraction of accesses are counted, and the counter wraps around, so only changes to it are meaningful.
+   * Sized to fit in what used to be padding in front of layout_version below. See tuple_access_strategy.h for more
+   * details on Block header layout.
    */
-  uint16_t padding_;
+  std::atomic<uint16_t> access_count_;
 
   /**
    * Layout version.
@@ -76,11 +80,18 @@ class alignas(common::Constants::BLOCK_SIZE) RawBlock {
    */
   BlockAccessController controller_;
 
+  /**
+   * Tag of the insertion lane that keeps inserting into this block until it is full, or 0 if no lane does. The tag
+   * holds the lane's index and the generation of the lane when it was claimed, so a tag left behind by a thread that
+   * has since exited no longer counts. See DataTable::Insert.
+   */
+  std::atomic<uint64_t> insertion_lane_;
+
   /**
    * Contents of the raw block.
    */
   byte content_[common::Constants::BLOCK_SIZE - sizeof(uintptr_t) - sizeof(uint16_t) - sizeof(layout_version_t) -
-                sizeof(uint32_t) - sizeof(BlockAccessController)];
+                sizeof(uint32_t) - sizeof(BlockAccessController) - sizeof(uint64_t)];
   // A Block needs to always be aligned to 1 MB, so we can get free bytes to
   // store offsets within a block in one 8-byte word
 
@@ -160,31 +171,6 @@ class TupleSlot {
   uintptr_t bytes_;
 };
 
-/**
- * Allocator that allocates a block
- */
-class BlockAllocator {
- public:
-  /**
-   * Allocates a new object by calling its constructor.
-   * @return a pointer to the allocated object.
-   */
-  RawBlock *New() { return new RawBlock(); }
-
-  /**
-   * Reuse a reused chunk of memory to be handed out again
-   * @param reused memory location, possibly filled with junk bytes
-   */
-  void Reuse(RawBlock *const reused) { /* no operation required */
-  }
-
-  /**
-   * Deletes the object by calling its destructor.
-   * @param ptr a pointer to the object to be deleted.
-   */
-  void Delete(RawBlock *const ptr) { delete ptr; }
-};
-
 /**
  * A block store is essentially an object pool. However, all blocks should be
  * aligned, so we will need to use the default constructor instead of raw
@@ -44,7 +44,9 @@ class TupleAccessStrategy {
   /*
    * Block Header layout:
    * -----------------------------------------------------------------------------------------------------------------
-   * | data_table *(64) | padding (16) | layout_version (16) | insert_head (32) |        control_block (64)          |
+   * | data_table *(64) | access_count (16) | layout_version (16) | insert_head (32) | control_block (64) |
+   * -----------------------------------------------------------------------------------------------------------------
+   * | insertion_lane (64) |
    * -----------------------------------------------------------------------------------------------------------------
    * | ArrowBlockMetadata | attr_offsets[num_col] (32) | bitmap for slots (64-bit aligned) | data (64-bit aligned)   |
    * -----------------------------------------------------------------------------------------------------------------
@@ -19,18 +19,21 @@ class DiskLogConsumerTask : public common::DedicatedThreadTask {
    * Constructs a new DiskLogConsumerTask
    * @param persist_interval Interval time for when to persist log file
    * @param persist_threshold threshold of data written since the last persist to trigger another persist
+   * @param group_commit whether to write all filled buffers out with a single vectored write and persist them with
+   * fdatasync as soon as they carry commit records, instead of writing buffers one by one and persisting periodically
    * @param buffers pointer to list of all buffers used by log manager, used to persist log file
    * @param empty_buffer_queue pointer to queue to push empty buffers to
    * @param filled_buffer_queue pointer to queue to pop filled buffers from
    */
   explicit DiskLogConsumerTask(const std::chrono::milliseconds persist_interval, uint64_t persist_threshold,
-                               std::vector<BufferedLogWriter> *buffers,
+                               const bool group_commit, std::vector<BufferedLogWriter> *buffers,
                                common::ConcurrentBlockingQueue<BufferedLogWriter *> *empty_buffer_queue,
                                common::ConcurrentQueue<storage::SerializedLogs> *filled_buffer_queue)
       : run_task_(false),
         persist_interval_(persist_interval),
         persist_threshold_(persist_threshold),
         current_data_written_(0),
+        group_commit_(group_commit),
         buffers_(buffers),
         empty_buffer_queue_(empty_buffer_queue),
         filled_buffer_queue_(filled_buffer_queue) {}
@@ -58,6 +61,10 @@ class DiskLogConsumerTask : public common::DedicatedThreadTask {
   uint64_t persist_threshold_;
   // Amount of data written since last persist
   uint64_t current_data_written_;
+  // Whether filled buffers are written out together and persisted as soon as they carry commits
+  const bool group_commit_;
+  // Filled buffers dequeued for the vectored write currently being issued. Only used with group commit
+  std::vector<BufferedLogWriter *> buffers_in_flight_;
 
   // This stores a reference to all the buffers the log manager has created. Used for persisting
   std::vector<BufferedLogWriter> *buffers_;
@@ -83,13 +90,14 @@ class DiskLogConsumerTask : public common::DedicatedThreadTask {
   void DiskLogConsumerTaskLoop();
 
   /**
-   * Flush all buffers in the filled buffers queue to the log file
+   * Flush all buffers in the filled buffers queue to the log file. With group commit, all of them are written out with
+   * a single vectored write.
    */
   void WriteBuffersToLogFile();
 
   /*
-   * Persists the log file on disk by calling fsync, as well as calling callbacks for all committed transactions that
-   * were persisted
+   * Persists the log file on disk by calling fsync (fdatasync with group commit), as well as calling callbacks for all
+   * committed transactions that were persisted
    */
   void PersistLogFile();
 };
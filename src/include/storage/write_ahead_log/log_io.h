@@ -7,6 +7,7 @@
 #include <cerrno>
 #include <cstring>
 #include <string>
+#include <vector>
 #include "common/constants.h"
 #include "common/macros.h"
 #include "loggers/storage_logger.h"
@@ -68,6 +69,16 @@ struct PosixIoWrappers {
    * @throws runtime_error if the underlying posix call failed
    */
   static void WriteFully(int fd, const void *buf, size_t nbyte);
+
+  /**
+   * Wrapper around the posix writev call, where a single function call will always write all of the given buffers out.
+   * (unlike posix writev, which can write arbitrarily many bytes less than the given amount)
+   * @param fd posix fildes arg
+   * @param iov posix iov arg. Entries are modified to track partial writes, so contents are undefined upon return.
+   * @param iovcnt posix iovcnt arg
+   * @throws runtime_error if the underlying posix call failed
+   */
+  static void WritevFully(int fd, struct iovec *iov, int iovcnt);
 };
 // TODO(Tianyu):  we need control over when and what to flush as the log manager. Thus, we need to write our
 // own wrapper around lower level I/O functions. I could be wrong, and in that case we should
@@ -120,6 +131,14 @@ class BufferedLogWriter {
     if (fsync(out_) == -1) throw std::runtime_error("fsync failed with errno " + std::to_string(errno));
   }
 
+  /**
+   * Call fdatasync to make sure that all writes are consistent. Unlike Persist, metadata not needed to read the
+   * written data back (e.g. modification time) is not flushed, saving a journal write on most file systems.
+   */
+  void PersistData() {
+    if (fdatasync(out_) == -1) throw std::runtime_error("fdatasync failed with errno " + std::to_string(errno));
+  }
+
   /**
    * Flush any buffered writes.
    * @return amount of data flushed
@@ -131,6 +150,14 @@ class BufferedLogWriter {
     return size;
   }
 
+  /**
+   * Flush the buffered writes of several writers with as few vectored writes as possible, instead of one write per
+   * writer. The buffers are written out in the given order. All writers must write to the same log file.
+   * @param writers the writers whose buffered writes to flush
+   * @return amount of data flushed
+   */
+  static uint64_t FlushBuffers(const std::vector<BufferedLogWriter *> &writers);
+
   /**
    * @return if the buffer is full
    */
@@ -156,8 +183,10 @@ class BufferedLogReader {
   /**
    * Instantiates a new BufferedLogReader to read from the specified log file.
    * @param log_file_path path to the the log file to read from.
+   * @param offset byte offset in the log file to start reading at. Used to skip a log prefix already covered by a
+   * checkpoint.
    */
-  explicit BufferedLogReader(const char *log_file_path) : in_(PosixIoWrappers::Open(log_file_path, O_RDONLY)) {}
+  explicit BufferedLogReader(const char *log_file_path, uint64_t offset = 0);
 
   /**
    * Closes log file if it has not been closed already. While Read will close the file if it reaches the end, this will
@@ -28,7 +28,8 @@ namespace terrier::storage {
  *      1. The LogManager receives buffers containing records from transactions via the AddBufferToFlushQueue, and
  * adds them to the serializer task's flush queue (flush_queue_)
  *      2. The LogSerializerTask will periodically process and serialize buffers in its flush queue
- * and hand them over to the consumer queue (filled_buffer_queue_). The reason this is done in the background and not as
+ * and hand them over to the consumer queue (filled_buffer_queue_), helped by LogSerializerWorkerTasks if more than one
+ * serializer thread is configured. The reason this is done in the background and not as
  * soon as logs are received is to reduce the amount of time a transaction spends interacting with the log manager
  *      3. When a buffer of logs is handed over to a consumer, the consumer will wake up and process the logs. In the
  * case of the DiskLogConsumerTask, this means writing it to the log file.
@@ -44,8 +45,10 @@ class LogManager : public common::DedicatedThreadOwner {
   DECLARE_ANNOTATION(LOG_FILE_PATH)
   DECLARE_ANNOTATION(NUM_BUFFERS)
   DECLARE_ANNOTATION(SERIALIZATION_INTERVAL)
+  DECLARE_ANNOTATION(NUM_SERIALIZER_THREADS)
   DECLARE_ANNOTATION(PERSIST_INTERVAL)
   DECLARE_ANNOTATION(PERSIST_THRESHOLD)
+  DECLARE_ANNOTATION(GROUP_COMMIT)
 
   /**
    * Constructs a new LogManager, writing its logs out to the given file.
@@ -54,8 +57,11 @@ class LogManager : public common::DedicatedThreadOwner {
    *                      otherwise, changes are appended to the end of the file.
    * @param num_buffers Number of buffers to use for buffering logs
    * @param serialization_interval Interval time between log serializations
+   * @param num_serializer_threads Number of threads serializing logs concurrently
    * @param persist_interval Interval time between log flushing
    * @param persist_threshold data written threshold to trigger log file persist
+   * @param group_commit whether the disk log consumer writes filled buffers out together with vectored writes and
+   *                     persists them with fdatasync as soon as they carry commits, instead of every persist interval
    * @param buffer_pool the object pool to draw log buffers from. This must be the same pool transactions draw their
    *                    buffers from
    * @param thread_registry DedicatedThreadRegistry dependency injection
@@ -63,8 +69,10 @@ class LogManager : public common::DedicatedThreadOwner {
   BOOST_DI_INJECT(LogManager, (named = LOG_FILE_PATH) std::string log_file_path,
                   (named = NUM_BUFFERS) uint64_t num_buffers,
                   (named = SERIALIZATION_INTERVAL) std::chrono::microseconds serialization_interval,
+                  (named = NUM_SERIALIZER_THREADS) uint64_t num_serializer_threads,
                   (named = PERSIST_INTERVAL) std::chrono::milliseconds persist_interval,
-                  (named = PERSIST_THRESHOLD) uint64_t persist_threshold, RecordBufferSegmentPool *buffer_pool,
+                  (named = PERSIST_THRESHOLD) uint64_t persist_threshold, (named = GROUP_COMMIT) bool group_commit,
+                  RecordBufferSegmentPool *buffer_pool,
                   common::ManagedPointer<terrier::common::DedicatedThreadRegistry> thread_registry)
       : DedicatedThreadOwner(thread_registry),
         run_log_manager_(false),
@@ -72,14 +80,16 @@ class LogManager : public common::DedicatedThreadOwner {
         num_buffers_(num_buffers),
         buffer_pool_(buffer_pool),
         serialization_interval_(serialization_interval),
+        num_serializer_threads_(num_serializer_threads),
         persist_interval_(persist_interval),
-        persist_threshold_(persist_threshold) {}
+        persist_threshold_(persist_threshold),
+        group_commit_(group_commit) {}
 
   /**
    * Starts log manager. Does the following in order:
    *    1. Initialize buffers to pass serialized logs to log consumers
    *    2. Starts up DiskLogConsumerTask
-   *    3. Starts up LogSerializerTask
+   *    3. Starts up LogSerializerTask, and a LogSerializerWorkerTask for every additional serializer thread
    */
   void Start();
 
@@ -91,9 +101,20 @@ class LogManager : public common::DedicatedThreadOwner {
    */
   void ForceFlush();
 
+  /**
+   * @return offset in the log file right after the last record serialized so far. It always falls on a record boundary,
+   * so recovery can start reading the log there. The records before it may not be persistent yet, see ForceFlush.
+   */
+  uint64_t SerializedLogFileOffset();
+
+  /**
+   * @return system path for log file
+   */
+  const std::string &LogFilePath() const { return log_file_path_; }
+
   /**
    * Persists all unpersisted logs and stops the log manager. Does what Start() does in reverse order:
-   *    1. Stops LogSerializerTask
+   *    1. Stops LogSerializerWorkerTasks and LogSerializerTask
    *    2. Stops DiskLogConsumerTask
    *    3. Closes all open buffers
    * @note Start() can be called to run the log manager again, a new log manager does not need to be initialized.
@@ -141,6 +162,8 @@ class LogManager : public common::DedicatedThreadOwner {
 
   // System path for log file
   std::string log_file_path_;
+  // Size of the log file when the log manager was started. Everything serialized since is appended after it
+  uint64_t log_file_start_offset_ = 0;
 
   // Number of buffers to use for buffering and serializing logs
   uint64_t num_buffers_;
@@ -161,6 +184,10 @@ class LogManager : public common::DedicatedThreadOwner {
   common::ManagedPointer<LogSerializerTask> log_serializer_task_ = common::ManagedPointer<LogSerializerTask>(nullptr);
   // Interval used by log serialization task
   const std::chrono::microseconds serialization_interval_;
+  // Number of threads serializing logs, including the log serializer task's own
+  const uint64_t num_serializer_threads_;
+  // Additional threads serializing buffers from the log serializer task's flush queue
+  std::vector<common::ManagedPointer<LogSerializerWorkerTask>> log_serializer_workers_;
 
   // The log consumer task which flushes filled buffers to the disk
   common::ManagedPointer<DiskLogConsumerTask> disk_log_writer_task_ =
@@ -169,6 +196,8 @@ class LogManager : public common::DedicatedThreadOwner {
   const std::chrono::milliseconds persist_interval_;
   // Threshold used by disk consumer task
   uint64_t persist_threshold_;
+  // Whether the disk consumer task does group commit
+  const bool group_commit_;
 
   /**
    * If the central registry wants to removes our thread used for the disk log consumer task, we only allow removal if
@@ -286,6 +286,7 @@ class CommitRecord {
    * @param txn pointer to the committing transaction
    * @param timestamp_manager pointer to timestamp manager who provided timestamp to txn. Used to notify of
    * serialization
+   * @param timestamp_shard shard of the timestamp manager's running txn set that txn was registered into
    * @return pointer to the initialized log record, always equal in value to the given head
    */
   // TODO(Tianyu): txn should contain a lot of the information here. Maybe we can simplify the function.
@@ -294,7 +295,8 @@ class CommitRecord {
                                const transaction::timestamp_t txn_commit, transaction::callback_fn commit_callback,
                                void *commit_callback_arg, const transaction::timestamp_t oldest_active_txn,
                                const bool is_read_only, transaction::TransactionContext *const txn,
-                               transaction::TimestampManager *const timestamp_manager) {
+                               transaction::TimestampManager *const timestamp_manager,
+                               const uint32_t timestamp_shard) {
     auto *result = LogRecord::InitializeHeader(head, LogRecordType::COMMIT, Size(), txn_begin);
     auto *body = result->GetUnderlyingRecordBodyAs<CommitRecord>();
     body->txn_commit_ = txn_commit;
@@ -302,6 +304,7 @@ class CommitRecord {
     body->commit_callback_arg_ = commit_callback_arg;
     body->oldest_active_txn_ = oldest_active_txn;
     body->timestamp_manager_ = timestamp_manager;
+    body->timestamp_shard_ = timestamp_shard;
     body->txn_ = txn;
     body->is_read_only_ = is_read_only;
     return result;
@@ -327,6 +330,11 @@ class CommitRecord {
    */
   transaction::TimestampManager *TimestampManager() const { return timestamp_manager_; }
 
+  /**
+   * @return shard of the timestamp manager's running txn set that the committing txn was registered into
+   */
+  uint32_t TimestampShard() const { return timestamp_shard_; }
+
   /**
    * @return pointer to the committing transaction.
    */
@@ -351,6 +359,7 @@ class CommitRecord {
   // More specifically, commit timestamp and read_only can be inferred from looking inside the transaction context
   transaction::TransactionContext *txn_;
   transaction::TimestampManager *timestamp_manager_;
+  uint32_t timestamp_shard_;
   bool is_read_only_;
 };
 
@@ -382,14 +391,17 @@ class AbortRecord {
    * @param txn transaction that is aborted
    * @param timestamp_manager pointer to timestamp manager who provided timestamp to txn. Used to notify of
    * serialization
+   * @param timestamp_shard shard of the timestamp manager's running txn set that txn was registered into
    * @return pointer to the initialized log record, always equal in value to the given head
    */
   static LogRecord *Initialize(byte *const head, const transaction::timestamp_t txn_begin,
                                transaction::TransactionContext *txn,
-                               transaction::TimestampManager *const timestamp_manager) {
+                               transaction::TimestampManager *const timestamp_manager,
+                               const uint32_t timestamp_shard) {
     auto *result = LogRecord::InitializeHeader(head, LogRecordType::ABORT, Size(), txn_begin);
     auto *body = result->GetUnderlyingRecordBodyAs<AbortRecord>();
     body->timestamp_manager_ = timestamp_manager;
+    body->timestamp_shard_ = timestamp_shard;
     body->txn_ = txn;
     return result;
   }
@@ -404,8 +416,14 @@ class AbortRecord {
    */
   transaction::TimestampManager *TimestampManager() const { return timestamp_manager_; }
 
+  /**
+   * @return shard of the timestamp manager's running txn set that the aborting txn was registered into
+   */
+  uint32_t TimestampShard() const { return timestamp_shard_; }
+
  private:
   transaction::TimestampManager *timestamp_manager_;
+  uint32_t timestamp_shard_;
   transaction::TransactionContext *txn_;
 };
 }  // namespace terrier::storage
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
 #include <queue>
 #include <unordered_map>
 #include <utility>
@@ -14,6 +16,11 @@ namespace terrier::storage {
 /**
  * Task that processes buffers handed over by transactions and serializes them into consumer buffers.
  * Transactions will wait to be GC'd until their logs are
+ *
+ * Buffers can be serialized by several threads at once: LogSerializerWorkerTasks run the same loop as this task, on
+ * this task's flush queue. Each thread takes a batch of buffers off the flush queue at a time and serializes it on its
+ * own. Batches are numbered in the order they are taken off the queue, and handed over to the log consumers strictly in
+ * that order, so the log reads exactly as if a single thread had serialized it.
  */
 class LogSerializerTask : public common::DedicatedThreadTask {
  public:
@@ -42,7 +49,8 @@ class LogSerializerTask : public common::DedicatedThreadTask {
    */
   void RunTask() override {
     run_task_ = true;
-    LogSerializerTaskLoop();
+    LogSerializerTaskLoop(&run_task_);
+    TERRIER_ASSERT(flush_queue_.empty(), "Termination of LogSerializerTask should hand off all buffers to consumers");
   }
 
   /**
@@ -64,8 +72,40 @@ class LogSerializerTask : public common::DedicatedThreadTask {
     flush_queue_.push(buffer_segment);
   }
 
+  /**
+   * Serialize out the record in the log format. Checkpoints are written in the same format, so they can be replayed by
+   * the recovery manager like a log.
+   * @param record the record to serialize
+   * @param out the bytes to append the serialized record to
+   */
+  static void SerializeRecord(const LogRecord &record, std::vector<byte> *out);
+
+  /**
+   * Maximum number of buffers a thread takes off the flush queue at once. Bounding this lets the other serializing
+   * threads share the work when the queue is long.
+   */
+  static constexpr uint32_t MAX_BUFFERS_PER_BATCH = 32;
+
  private:
   friend class LogManager;
+  friend class LogSerializerWorkerTask;
+
+  // Buffers taken off the flush queue together, and what serializing them produced
+  struct SerializationBatch {
+    // Position of this batch in the order batches were taken off the flush queue
+    uint64_t id_;
+    std::vector<RecordBufferSegment *> buffers_;
+    // Serialized contents of the batch, waiting to be copied into consumer buffers
+    std::vector<byte> serialized_;
+    // Commit callbacks for commit records in the batch
+    std::vector<CommitCallback> commits_;
+    // We aggregate all transactions we serialize so we can bulk remove the from the timestamp manager
+    // TODO(Gus): If we guarantee there is only one TSManager in the system, this can just be a vector. We could also
+    // pass TS into the serializer instead of having a pointer for it in every commit/abort record
+    std::unordered_map<transaction::TimestampManager *, std::vector<std::pair<uint32_t, transaction::timestamp_t>>>
+        serialized_txns_;
+  };
+
   // Flag to signal task to run or stop
   bool run_task_;
   // Interval for serialization
@@ -74,9 +114,6 @@ class LogSerializerTask : public common::DedicatedThreadTask {
   // Used to release processed buffers
   RecordBufferSegmentPool *buffer_pool_;
 
-  // Ensures only one thread is serializing at a time.
-  common::SpinLatch serialization_latch_;
-
   // TODO(Tianyu): Might not be necessary, since commit on txn manager is already protected with a latch
   // TODO(Tianyu): benchmark for if these should be concurrent data structures, and if we should apply the same
   //  optimization we applied to the GC queue.
@@ -84,20 +121,22 @@ class LogSerializerTask : public common::DedicatedThreadTask {
   common::SpinLatch flush_queue_latch_;
   // Stores unserialized buffers handed off by transactions
   std::queue<RecordBufferSegment *> flush_queue_;
-
+  // Number of batches taken off the flush queue so far. Protected by flush_queue_latch_
+  uint64_t batches_dequeued_ = 0;
+
+  // Ensures serialized batches are copied into consumer buffers one at a time, in order. Protects everything below
+  std::mutex handoff_latch_;
+  // Signalled every time a batch is handed over
+  std::condition_variable handoff_cv_;
+  // Number of batches handed over to consumers so far, which is also the id of the next batch to hand over
+  uint64_t batches_handed_off_ = 0;
+  // Number of bytes handed over to consumers so far. Batches hold whole records, so this falls on a record boundary
+  uint64_t bytes_handed_off_ = 0;
   // Current buffer we are serializing logs to
   BufferedLogWriter *filled_buffer_;
   // Commit callbacks for commit records currently in filled_buffer
   std::vector<std::pair<transaction::callback_fn, void *>> commits_in_buffer_;
 
-  // Used by the serializer thread to store buffers it has grabbed from the log manager
-  std::queue<RecordBufferSegment *> temp_flush_queue_;
-
-  // We aggregate all transactions we serialize so we can bulk remove the from the timestamp manager
-  // TODO(Gus): If we guarantee there is only one TSManager in the system, this can just be a vector. We could also pass
-  // TS into the serializer instead of having a pointer for it in every commit/abort record
-  std::unordered_map<transaction::TimestampManager *, std::vector<transaction::timestamp_t>> serialized_txns_;
-
   // The queue containing empty buffers. Task will dequeue a buffer from this queue when it needs a new buffer
   common::ConcurrentBlockingQueue<BufferedLogWriter *> *empty_buffer_queue_;
   // The queue containing filled buffers. Task should push filled serialized buffers into this queue
@@ -109,55 +148,99 @@ class LogSerializerTask : public common::DedicatedThreadTask {
   /**
    * Main serialization loop. Calls Process every interval. Processes all the accumulated log records and
    * serializes them to log consumer tasks.
+   * @param run_task flag of the task running the loop, which is cleared to stop the loop
    */
-  void LogSerializerTaskLoop();
+  void LogSerializerTaskLoop(const bool *run_task);
 
   /**
    * Process all the accumulated log records and serialize them to log consumer tasks. It's important that we serialize
-   * the logs in order to ensure that a single transaction's logs are ordered. Only a single thread can serialize the
-   * logs (without more sophisticated ordering checks).
+   * the logs in order to ensure that a single transaction's logs are ordered. Several threads may process at once, as
+   * batches are handed over in the order they were taken off the flush queue. Upon return, all buffers that were in
+   * the flush queue when it was found empty have been handed over, including by other threads.
    * @return true if we processed new buffers, false otherwise
    */
   bool Process();
 
   /**
-   * Serialize out the task buffer to the current serialization buffer
+   * Serialize out the task buffer to the batch's serialized contents
    * @param buffer_to_serialize the iterator to the redo buffer to be serialized
+   * @param batch the batch the buffer belongs to
    */
-  void SerializeBuffer(IterableBufferSegment<LogRecord> *buffer_to_serialize);
+  void SerializeBuffer(IterableBufferSegment<LogRecord> *buffer_to_serialize, SerializationBatch *batch);
 
   /**
-   * Serialize out the record to the log
-   * @param record the redo record to serialise
-   */
-  void SerializeRecord(const LogRecord &record);
-
-  /**
-   * Serialize the data pointed to by val to current serialization buffer
+   * Serialize the data pointed to by val to the given serialized contents
    * @tparam T Type of the value
+   * @param out the serialized contents to append to
    * @param val The value to write to the buffer
    */
   template <class T>
-  void WriteValue(const T &val) {
-    WriteValue(&val, sizeof(T));
+  static void WriteValue(std::vector<byte> *out, const T &val) {
+    WriteValue(out, &val, sizeof(T));
   }
 
   /**
-   * Serialize the data pointed to by val to current serialization buffer
+   * Serialize the data pointed to by val to the given serialized contents
+   * @param out the serialized contents to append to
    * @param val the value
    * @param size size of the value to serialize
    */
-  void WriteValue(const void *val, uint32_t size);
+  static void WriteValue(std::vector<byte> *out, const void *val, uint32_t size) {
+    const auto *val_byte = reinterpret_cast<const byte *>(val);
+    out->insert(out->end(), val_byte, val_byte + size);
+  }
+
+  /**
+   * Wait until all batches before the given one are handed over, then copy the batch into consumer buffers and notify
+   * the TimestampManager(s) that its transactions are serialized. The batch is cleared for reuse upon return.
+   * @param batch the serialized batch to hand over
+   */
+  void HandOverBatch(SerializationBatch *batch);
 
   /**
-   * Returns the current buffer to serialize logs to
+   * Returns the current buffer to serialize logs to. Must hold handoff_latch_
    * @return buffer to write to
    */
   BufferedLogWriter *GetCurrentWriteBuffer();
 
   /**
-   * Hand over the current buffer and commit callbacks for commit records in that buffer to the log consumer task
+   * Hand over the current buffer and commit callbacks for commit records in that buffer to the log consumer task. Must
+   * hold handoff_latch_
    */
   void HandFilledBufferToWriter();
 };
+
+/**
+ * Additional thread serializing buffers from the flush queue of a LogSerializerTask, alongside that task's own thread
+ */
+class LogSerializerWorkerTask : public common::DedicatedThreadTask {
+ public:
+  /**
+   * @param serializer the serializer task whose flush queue to serialize buffers from
+   */
+  explicit LogSerializerWorkerTask(LogSerializerTask *serializer) : run_task_(false), serializer_(serializer) {}
+
+  /**
+   * Runs the serializer task's loop. Called by thread registry upon initialization of thread
+   */
+  void RunTask() override {
+    run_task_ = true;
+    serializer_->LogSerializerTaskLoop(&run_task_);
+  }
+
+  /**
+   * Signals task to stop. Called by thread registry upon termination of thread
+   */
+  void Terminate() override {
+    // If the task hasn't run yet, yield the thread until it's started
+    while (!run_task_) std::this_thread::yield();
+    TERRIER_ASSERT(run_task_, "Cant terminate a task that isnt running");
+    run_task_ = false;
+  }
+
+ private:
+  // Flag to signal task to run or stop
+  bool run_task_;
+  LogSerializerTask *const serializer_;
+};
 }  // namespace terrier::storage
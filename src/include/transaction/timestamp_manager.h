@@ -1,7 +1,12 @@
 #pragma once
 #include <algorithm>
-#include <unordered_set>
+#include <array>
+#include <atomic>
+#include <set>
+#include <utility>
 #include <vector>
+#include "common/constants.h"
+#include "common/macros.h"
 #include "common/spin_latch.h"
 #include "common/strong_typedef.h"
 #include "transaction/transaction_defs.h"
@@ -32,8 +37,8 @@ class TimestampManager {
    * Get the oldest transaction alive (by start timestamp given out by this timestamp manager at this time)
    * Because of concurrent operations, it is not guaranteed that upon return the txn is still alive. However,
    * it is guaranteed that the return timestamp is older than any transactions live.
-   * @warning If logging is enabled, txns are not removed from the txn set until they are serialized. Thus, the active
-   * txn set can grow greatly in size, making this call expensive. Consider using CachedOldestTransactionStartTime for
+   * @warning This call visits every shard of the active txn set, taking each shard's latch in turn, so it is much more
+   * expensive than beginning or ending a transaction. Consider using CachedOldestTransactionStartTime for
    * better peformance at the cost of a more stale timestamp.
    * @return timestamp that is older than any transactions alive
    */
@@ -41,64 +46,90 @@ class TimestampManager {
 
   /**
    * Get the cached timestamp of the oldest active txn. The cached timestamp is only refreshed upon every invocation of
-   * OldestTransactionStartTime, so it may be stale. On the other hand, this function does not require taking a latch or
-   * iterating through the running txns set, making it much cheaper than OldestTransactionStartTime. This has the same
-   * correctness guarantee as OldestTransactionStartTime, but may cause performance degradations for processes that rely
-   * on very fresh oldest txn timestamps
+   * OldestTransactionStartTime, so it may be stale. On the other hand, this function does not require taking any
+   * latches or visiting the running txns shards, making it much cheaper than OldestTransactionStartTime. This has the
+   * same correctness guarantee as OldestTransactionStartTime, but may cause performance degradations for processes that
+   * rely on very fresh oldest txn timestamps
    * @return timestamp that is older than any transactions alive
    */
   timestamp_t CachedOldestTransactionStartTime();
 
+  /**
+   * Number of partitions the set of running transactions is split into. Each thread registers the transactions it
+   * begins into a single partition, so threads only contend on the running transaction set when there are more active
+   * threads than partitions.
+   */
+  static constexpr uint32_t NUM_ACTIVE_TXN_SHARDS = 64;
+
+  /**
+   * @return the partition of the running transaction set that transactions begun on the calling thread register into
+   */
+  static uint32_t ThreadShard() {
+    static std::atomic<uint32_t> next_shard{0};
+    thread_local const uint32_t shard = next_shard.fetch_add(1) % NUM_ACTIVE_TXN_SHARDS;
+    return shard;
+  }
+
  private:
-  // TransactionManager needs to be able to use the curr_running_txns_latch to guard more than just the
-  // duration of the following method calls --- things such as adding to the GC queue needs to be atomic
-  // along with removing a transaction from the table of active transactions. We need this for correctness
-  // in the deferred action framework when dropping tables.
+  // TransactionManager needs to be able to use a shard's latch to guard more than just the duration of the following
+  // method calls --- things such as adding to the GC queue needs to be atomic along with removing a transaction from
+  // the table of active transactions. We need this for correctness in the deferred action framework when dropping
+  // tables.
   friend class TransactionManager;
   friend class storage::LogSerializerTask;
-  timestamp_t BeginTransaction() {
+
+  // A partition of the running transaction set. Every start time in a shard is checked out while holding the shard's
+  // latch, so start times are inserted in increasing order and the oldest one is always at the front of the set.
+  struct alignas(common::Constants::CACHELINE_SIZE) ActiveTxnShard {
+    mutable common::SpinLatch latch_;
+    std::set<timestamp_t> running_txns_;
+  };
+
+  timestamp_t BeginTransaction(const uint32_t shard) {
+    TERRIER_ASSERT(shard < NUM_ACTIVE_TXN_SHARDS, "shard out of bounds");
+    ActiveTxnShard &txn_shard = shards_[shard];
     timestamp_t start_time;
     {
-      common::SpinLatch::ScopedSpinLatch running_guard(&curr_running_txns_latch_);
+      common::SpinLatch::ScopedSpinLatch running_guard(&txn_shard.latch_);
       // There is a three-way race that needs to be prevented.  Specifically, we
       // cannot allow both a transaction to commit and the GC to poll for the
       // oldest running transaction in between this transaction acquiring its
       // begin timestamp and getting inserted into the current running
-      // transactions list.  Using the current running transactions latch
-      // prevents the GC from polling and stops the race.  This allows us to
-      // replace acquiring a shared instance of the commit latch with a
-      // read-only spin-latch and move the allocation out of a critical section.
+      // transactions list.  Checking out the timestamp under the shard latch
+      // means that the GC either sees this transaction when it visits the
+      // shard, or read the clock before this transaction began (see
+      // OldestTransactionStartTime).
       start_time = time_++;
 
-      const auto ret UNUSED_ATTRIBUTE = curr_running_txns_.emplace(start_time);
-      TERRIER_ASSERT(ret.second, "commit start time should be globally unique");
+      TERRIER_ASSERT(txn_shard.running_txns_.empty() || *txn_shard.running_txns_.rbegin() < start_time,
+                     "start times within a shard should be increasing");
+      txn_shard.running_txns_.emplace_hint(txn_shard.running_txns_.end(), start_time);
     }  // Release latch on current running transactions
     return start_time;
   }
 
   /**
    * Remove a timestamp from active txn set
+   * @param shard the shard the transaction was registered into when it began
    * @param timestamp timestamp to remove
    */
-  void RemoveTransaction(timestamp_t timestamp);
+  void RemoveTransaction(uint32_t shard, timestamp_t timestamp);
 
   /**
-   * Bulk remove a set of timestamps from the active txn set. Only grabs the curr_running_txns_latch_ once for all the
-   * timestamps.
-   * @param timestamps vector of timestamps to remove
+   * Bulk remove a set of timestamps from the active txn set. Only grabs the latch of each shard involved once for all
+   * the timestamps.
+   * @param timestamps vector of (shard, timestamp) pairs to remove
    */
-  void RemoveTransactions(const std::vector<timestamp_t> &timestamps);
+  void RemoveTransactions(const std::vector<std::pair<uint32_t, timestamp_t>> &timestamps);
 
   // TODO(Tianyu): Timestamp generation needs to be more efficient (batches)
   // TODO(Tianyu): We don't handle timestamp wrap-arounds. I doubt this would be an issue any time soon.
   std::atomic<timestamp_t> time_{INITIAL_TXN_TIMESTAMP};
   // We cache the oldest txn start time
   std::atomic<timestamp_t> cached_oldest_txn_start_time_{INITIAL_TXN_TIMESTAMP};
-  // TODO(Matt): consider a different data structure if this becomes a measured bottleneck
   // TODO(Gus): This data structure initially only held items in the order of # of workers. With the logging change, it
   // can hold many more, since txns are only removed when serialized. We should consider if there is a possible better
   // data structure
-  std::unordered_set<timestamp_t> curr_running_txns_;
-  mutable common::SpinLatch curr_running_txns_latch_;
+  std::array<ActiveTxnShard, NUM_ACTIVE_TXN_SHARDS> shards_;
 };
 }  // namespace terrier::transaction
@@ -23,6 +23,8 @@ class RecoveryTests;
 }  // namespace terrier::storage
 
 namespace terrier::transaction {
+class TimestampManager;
+
 /**
  * A transaction context encapsulates the information kept while the transaction is running
  */
@@ -196,11 +198,17 @@ class TransactionContext {
   friend class storage::BlockCompactor;
   friend class storage::LogSerializerTask;
   friend class storage::SqlTable;
+  friend class storage::DataTable;               // Needs access to timestamp_manager_ to prune version chains
   friend class storage::WriteAheadLoggingTests;  // Needs access to redo buffer
   friend class storage::RecoveryManager;         // Needs access to StageRecoveryUpdate
   friend class storage::RecoveryTests;           // Needs access to redo buffer
   const timestamp_t start_time_;
   std::atomic<timestamp_t> finish_time_;
+  // Shard of the TimestampManager's running txn set this txn registered into. Set by the TransactionManager on begin.
+  uint32_t timestamp_shard_ = 0;
+  // TimestampManager that handed out this txn's timestamps, used to look up the oldest running txn when pruning version
+  // chains. Set by the TransactionManager on begin, nullptr for txns constructed by hand.
+  TimestampManager *timestamp_manager_ = nullptr;
   storage::UndoBuffer undo_buffer_;
   storage::RedoBuffer redo_buffer_;
   // TODO(Tianyu): Maybe not so much of a good idea to do this. Make explicit queue in GC?
@@ -1,7 +1,9 @@
 #pragma once
+#include <array>
 #include <queue>
 #include <unordered_set>
 #include <utility>
+#include "common/constants.h"
 #include "common/gate.h"
 #include "common/spin_latch.h"
 #include "common/strong_typedef.h"
@@ -72,7 +74,7 @@ class TransactionManager {
   bool GCEnabled() const { return gc_enabled_; }
 
   /**
-   * Return a copy of the completed txns queue and empty the local version
+   * Return a copy of the completed txns queues of all shards merged together, and empty the local versions
    * @return copy of the completed txns for the GC to process
    */
   TransactionQueue CompletedTransactionsForGC();
@@ -85,7 +87,12 @@ class TransactionManager {
   common::Gate txn_gate_;
 
   bool gc_enabled_ = false;
-  TransactionQueue completed_txns_;
+  // Completed txns are queued up for the GC in the shard their timestamp was registered into, guarded by the latch of
+  // the matching TimestampManager shard. Padded so that committing threads on different shards do not share lines.
+  struct alignas(common::Constants::CACHELINE_SIZE) CompletedTxnShard {
+    TransactionQueue txns_;
+  };
+  std::array<CompletedTxnShard, TimestampManager::NUM_ACTIVE_TXN_SHARDS> completed_txns_;
   storage::LogManager *const log_manager_;
 
   timestamp_t UpdatingCommitCriticalSection(TransactionContext *txn);
@@ -95,6 +102,8 @@ class TransactionManager {
 
   void LogAbort(TransactionContext *txn);
 
+  void QueueForGC(TransactionContext *txn);
+
   void Rollback(TransactionContext *txn, const storage::UndoRecord &record) const;
 
   void DeallocateColumnUpdateIfVarlen(TransactionContext *txn, storage::UndoRecord *undo,
@@ -6,6 +6,9 @@
 #include "loggers/loggers_util.h"
 #include "settings/settings_manager.h"
 #include "settings/settings_param.h"
+#include "storage/access_observer.h"
+#include "storage/block_compactor_thread.h"
+#include "storage/block_tiering_thread.h"
 #include "storage/garbage_collector_thread.h"
 #include "transaction/transaction_manager.h"
 #include "transaction/transaction_util.h"
@@ -33,17 +36,48 @@ DBMain::DBMain(std::unordered_map<settings::Param, settings::ParamInfo> &&param_
       settings_manager_->GetString(settings::Param::log_file_path),
       settings_manager_->GetInt(settings::Param::num_log_manager_buffers),
       std::chrono::milliseconds{settings_manager_->GetInt(settings::Param::log_serialization_interval)},
+      settings_manager_->GetInt(settings::Param::num_log_serializer_threads),
       std::chrono::milliseconds{settings_manager_->GetInt(settings::Param::log_persist_interval)},
-      settings_manager_->GetInt(settings::Param::log_persist_threshold), buffer_segment_pool_,
+      settings_manager_->GetInt(settings::Param::log_persist_threshold),
+      settings_manager_->GetBool(settings::Param::log_group_commit), buffer_segment_pool_,
       common::ManagedPointer(thread_registry_));
   log_manager_->Start();
 
   timestamp_manager_ = new transaction::TimestampManager;
   txn_manager_ = new transaction::TransactionManager(timestamp_manager_, DISABLED, buffer_segment_pool_, true, nullptr);
-  garbage_collector_ = new storage::GarbageCollector(timestamp_manager_, DISABLED, txn_manager_, DISABLED);
+
+  const bool compaction_enabled = settings_manager_->GetBool(settings::Param::compaction_enable);
+  if (compaction_enabled) {
+    // The GC tells the access observer about writes, and cleans up after the compactor through deferred actions
+    deferred_action_manager_ = new transaction::DeferredActionManager(timestamp_manager_);
+    // Only frozen blocks are spilled, so tiering needs compaction to have anything to do
+    if (settings_manager_->GetBool(settings::Param::tiering_enable))
+      block_tiering_manager_ = new storage::BlockTieringManager(
+          settings_manager_->GetString(settings::Param::tiering_directory),
+          static_cast<uint64_t>(settings_manager_->GetInt(settings::Param::tiering_memory_budget)) << 20);
+    block_compactor_ = new storage::BlockCompactor(block_tiering_manager_);
+    access_observer_ = new storage::AccessObserver(
+        block_compactor_,
+        static_cast<uint64_t>(settings_manager_->GetInt(settings::Param::compaction_cold_epoch_threshold)),
+        static_cast<uint16_t>(settings_manager_->GetInt(settings::Param::compaction_cold_access_threshold)));
+  }
+  garbage_collector_ = new storage::GarbageCollector(
+      timestamp_manager_, deferred_action_manager_, txn_manager_, access_observer_,
+      static_cast<uint32_t>(settings_manager_->GetInt(settings::Param::num_gc_threads)));
   gc_thread_ = new storage::GarbageCollectorThread(garbage_collector_,
                                                    std::chrono::milliseconds{type::TransientValuePeeker::PeekInteger(
                                                        param_map_.find(settings::Param::gc_interval)->second.value_)});
+  if (compaction_enabled) {
+    compactor_thread_ = new storage::BlockCompactorThread(
+        block_compactor_, deferred_action_manager_, txn_manager_,
+        static_cast<uint32_t>(settings_manager_->GetInt(settings::Param::num_compaction_threads)),
+        std::chrono::milliseconds{settings_manager_->GetInt(settings::Param::compaction_interval)},
+        static_cast<uint32_t>(settings_manager_->GetInt(settings::Param::compaction_blocks_per_round)));
+    if (block_tiering_manager_ != nullptr)
+      tiering_thread_ = new storage::BlockTieringThread(
+          block_tiering_manager_,
+          std::chrono::milliseconds{settings_manager_->GetInt(settings::Param::tiering_interval)});
+  }
 
   thread_pool_ = new common::WorkerPool(
       type::TransientValuePeeker::PeekInteger(param_map_.find(settings::Param::num_worker_threads)->second.value_), {});
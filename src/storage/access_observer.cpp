@@ -4,10 +4,18 @@
 namespace terrier::storage {
 void AccessObserver::ObserveGCInvocation() {
   gc_epoch_++;
-  for (auto it = last_touched_.begin(), end = last_touched_.end(); it != end;) {
-    if (it->second + COLD_DATA_EPOCH_THRESHOLD < gc_epoch_) {
+  for (auto it = watched_blocks_.begin(), end = watched_blocks_.end(); it != end;) {
+    BlockAccessInfo &info = it->second;
+    // The counter wraps around, so look at how far it moved rather than at its value. Relaxed is fine, a sample that
+    // shows up one invocation late makes no difference.
+    const uint16_t access_count = it->first->access_count_.load(std::memory_order_relaxed);
+    if (static_cast<uint16_t>(access_count - info.last_access_count_) > cold_access_threshold_)
+      info.last_touched_ = gc_epoch_;
+    info.last_access_count_ = access_count;
+
+    if (info.last_touched_ + cold_epoch_threshold_ < gc_epoch_) {
       compactor_->PutInQueue(it->first);
-      it = last_touched_.erase(it);
+      it = watched_blocks_.erase(it);
     } else {
       ++it;
     }
@@ -17,7 +25,8 @@ void AccessObserver::ObserveGCInvocation() {
 void AccessObserver::ObserveWrite(RawBlock *block) {
   // The compactor is only concerned with blocks that are already full. We assume that partially empty blocks are
   // always hot.
-  if (block->GetInsertHead() == block->data_table_->GetBlockLayout().NumSlots()) last_touched_[block] = gc_epoch_;
+  if (block->GetInsertHead() == block->data_table_->GetBlockLayout().NumSlots())
+    watched_blocks_[block] = {gc_epoch_, block->access_count_.load(std::memory_order_relaxed)};
 }
 
 }  // namespace terrier::storage
@@ -0,0 +1,129 @@
+#include "storage/block_allocator.h"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <new>
+#include "common/constants.h"
+#include "storage/storage_defs.h"
+
+namespace terrier::storage {
+
+BlockAllocator::BlockAllocator(const uint32_t region_size, const uint32_t huge_page_size, const bool prefault,
+                               const bool numa_aware)
+    : region_size_(region_size), huge_page_size_(huge_page_size), prefault_(prefault), numa_aware_(numa_aware) {
+  TERRIER_ASSERT(huge_page_size == 0 || huge_page_size == 2 || huge_page_size == 1024,
+                 "huge pages are either 2 MB or 1 GB");
+}
+
+BlockAllocator::~BlockAllocator() {
+  for (const auto &region : regions_) munmap(region.first, region.second.size_);
+}
+
+RawBlock *BlockAllocator::New() {
+  if (region_size_ == 0) return new RawBlock();
+
+  Arena &arena = arenas_[CurrentArena()];
+  common::SpinLatch::ScopedSpinLatch guard(&arena.latch_);
+  if (!arena.free_blocks_.empty()) {
+    RawBlock *result = arena.free_blocks_.back();
+    arena.free_blocks_.pop_back();
+    return result;
+  }
+  if (arena.next_ == arena.end_ && !MapRegion(static_cast<uint32_t>(&arena - &arenas_[0]))) return nullptr;
+  // Memory fresh from the OS is already zeroed, so unlike new RawBlock() this does not touch the block. Without
+  // pre-faulting, its pages are faulted in by the thread that initializes the block, on that thread's NUMA node.
+  auto *result = new (arena.next_) RawBlock;
+  arena.next_ += common::Constants::BLOCK_SIZE;
+  return result;
+}
+
+void BlockAllocator::Delete(RawBlock *const ptr) {
+  if (region_size_ == 0) {
+    delete ptr;
+    return;
+  }
+
+  uint32_t arena_id;
+  bool huge_pages;
+  {
+    common::SpinLatch::ScopedSpinLatch guard(&regions_latch_);
+    // The region holding the block is the one with the last start address not after it
+    auto region = --regions_.upper_bound(reinterpret_cast<byte *>(ptr));
+    arena_id = region->second.arena_;
+    huge_pages = region->second.huge_pages_;
+  }
+  // The object pool only deletes blocks past its reuse limit, so give their memory back to the OS. The pages read as
+  // zeroes when the block is handed out again, just like a fresh region. That includes blocks the tiering manager
+  // spilled, as it maps them back to anonymous memory before their table releases them. This has to happen before the
+  // block is on the free list, where another thread could already be writing to it. A block is smaller than a huge
+  // page, so blocks in regions backed by huge pages keep their memory until the allocator is destroyed.
+  if (!huge_pages) madvise(ptr, common::Constants::BLOCK_SIZE, MADV_DONTNEED);
+  // The block goes back to the node it was allocated on, whichever thread deletes it
+  Arena &arena = arenas_[arena_id];
+  common::SpinLatch::ScopedSpinLatch guard(&arena.latch_);
+  arena.free_blocks_.push_back(ptr);
+}
+
+uint32_t BlockAllocator::CurrentArena() const {
+  if (!numa_aware_) return 0;
+#ifdef SYS_getcpu
+  unsigned cpu, node;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) return node % MAX_NUMA_NODES;
+#endif
+  return 0;
+}
+
+bool BlockAllocator::MapRegion(const uint32_t arena_id) {
+  uint64_t size = static_cast<uint64_t>(region_size_) * common::Constants::BLOCK_SIZE;
+  void *region = MAP_FAILED;
+  bool huge_pages = false;
+
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+  if (huge_page_size_ != 0) {
+    const uint64_t page_size = static_cast<uint64_t>(huge_page_size_) << 20;
+    const uint64_t huge_size = (size + page_size - 1) / page_size * page_size;
+    // log2 of the page size selects the huge page size
+    const int page_size_flag = (huge_page_size_ == 1024 ? 30 : 21) << MAP_HUGE_SHIFT;
+    region = mmap(nullptr, huge_size, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | page_size_flag | (prefault_ ? MAP_POPULATE : 0), -1, 0);
+    // Huge pages are at least 2 MB aligned, so the region is already block aligned
+    if (region != MAP_FAILED) {
+      size = huge_size;
+      huge_pages = true;
+    }
+  }
+#endif
+
+  if (region == MAP_FAILED) {
+    // Regular pages are only page aligned, so map an extra block worth of memory and trim it down to a block aligned
+    // region
+    const uint64_t mapped_size = size + common::Constants::BLOCK_SIZE;
+    auto *const mapped = static_cast<byte *>(
+        mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (mapped == MAP_FAILED) return false;
+    const auto mapped_start = reinterpret_cast<uintptr_t>(mapped);
+    const uint64_t head = (common::Constants::BLOCK_SIZE - mapped_start % common::Constants::BLOCK_SIZE) %
+                          common::Constants::BLOCK_SIZE;
+    if (head != 0) munmap(mapped, head);
+    munmap(mapped + head + size, common::Constants::BLOCK_SIZE - head);
+    region = mapped + head;
+#ifdef MADV_HUGEPAGE
+    if (huge_page_size_ != 0) madvise(region, size, MADV_HUGEPAGE);
+#endif
+    if (prefault_) {
+      // Writing to every page faults it in on the NUMA node of the calling thread
+      const auto page_size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+      for (uint64_t offset = 0; offset < size; offset += page_size)
+        reinterpret_cast<volatile byte *>(region)[offset] = static_cast<byte>(0);
+    }
+  }
+
+  {
+    common::SpinLatch::ScopedSpinLatch guard(&regions_latch_);
+    regions_.emplace(static_cast<byte *>(region), Region{size, arena_id, huge_pages});
+  }
+  arenas_[arena_id].next_ = static_cast<byte *>(region);
+  arenas_[arena_id].end_ = static_cast<byte *>(region) + size;
+  return true;
+}
+}  // namespace terrier::storage
@@ -1,5 +1,6 @@
 #include "storage/block_compactor.h"
 #include <algorithm>
+#include <limits>
 #include <queue>
 #include <unordered_map>
 #include <utility>
@@ -10,60 +11,93 @@
 #include "transaction/transaction_util.h"
 
 namespace terrier::storage {
-void BlockCompactor::ProcessCompactionQueue(transaction::DeferredActionManager *deferred_action_manager,
-                                            transaction::TransactionManager *txn_manager) {
-  std::queue<RawBlock *> to_process = std::move(compaction_queue_);
-  while (!to_process.empty()) {
-    RawBlock *block = to_process.front();
-    BlockAccessController &controller = block->controller_;
-    switch (controller.GetBlockState()->load()) {
-      case BlockState::HOT: {
-        // TODO(Tianyu): The policy about how to group blocks together into compaction group can be a lot
-        // more sophisticated. Compacting more blocks together frees up more memory per compaction run,
-        // but makes the compaction transaction larger, which can have performance impact on the rest
-        // of the system. As it currently stands, no memory is freed from this one-block-per-group scheme.
-        CompactionGroup cg(txn_manager->BeginTransaction(), block->data_table_);
-        // TODO(Tianyu): Additionally, frozen blocks can still have empty slots within them. To make sure
-        // these memory are not gone forever, we still need to periodically shuffle tuples around within
-        // frozen blocks. Although code can be reused for doing the compaction, some logic needs to be
-        // written to enqueue these frozen blocks into the compaction queue.
-        cg.blocks_to_compact_.emplace(block, std::vector<uint32_t>());
-        if (EliminateGaps(&cg)) {
-          controller.GetBlockState()->store(BlockState::COOLING);
-          // If no compaction was performed, we still need to shut out any potentially racey transactions that
-          // are alive at the same time as us flipping the block status flag to cooling. However, we must manually
-          // ask the GC to enqueue this block, because no access will be observed from the empty compaction transaction.
-          if (cg.txn_->IsReadOnly())
-            deferred_action_manager->RegisterDeferredAction([this, block]() { PutInQueue(block); });
-          txn_manager->Commit(cg.txn_, transaction::TransactionUtil::EmptyCallback, nullptr);
-        } else {
-          txn_manager->Abort(cg.txn_);
-        }
-        break;
+uint32_t BlockCompactor::ProcessCompactionQueue(transaction::DeferredActionManager *deferred_action_manager,
+                                                transaction::TransactionManager *txn_manager,
+                                                const uint32_t max_blocks) {
+  std::vector<RawBlock *> to_process;
+  {
+    common::SpinLatch::ScopedSpinLatch guard(&queue_latch_);
+    // Only look at what is in the queue right now, so blocks we put back are left for the next call
+    for (auto num_queued = compaction_queue_.size(); num_queued > 0 && to_process.size() < max_blocks; num_queued--) {
+      const auto entry = compaction_queue_.front();
+      RawBlock *block = entry.first;
+      compaction_queue_.pop();
+      // A writer thawed the block since it was put back. It is only compacted again once it is found cold again.
+      if (entry.second && block->controller_.GetBlockState()->load() == BlockState::HOT) continue;
+      if (in_progress_.insert(block).second)
+        to_process.push_back(block);
+      else
+        // Another thread is working on this block, look at it again later
+        compaction_queue_.push(entry);
+    }
+  }
+
+  for (RawBlock *block : to_process) {
+    ProcessBlock(block, deferred_action_manager, txn_manager);
+    common::SpinLatch::ScopedSpinLatch guard(&queue_latch_);
+    in_progress_.erase(block);
+  }
+  return static_cast<uint32_t>(to_process.size());
+}
+
+void BlockCompactor::ProcessBlock(RawBlock *const block, transaction::DeferredActionManager *deferred_action_manager,
+                                  transaction::TransactionManager *txn_manager) {
+  BlockAccessController &controller = block->controller_;
+  switch (controller.GetBlockState()->load()) {
+    case BlockState::HOT: {
+      // TODO(Tianyu): The policy about how to group blocks together into compaction group can be a lot
+      // more sophisticated. Compacting more blocks together frees up more memory per compaction run,
+      // but makes the compaction transaction larger, which can have performance impact on the rest
+      // of the system. As it currently stands, no memory is freed from this one-block-per-group scheme.
+      CompactionGroup cg(txn_manager->BeginTransaction(), block->data_table_);
+      // TODO(Tianyu): Additionally, frozen blocks can still have empty slots within them. To make sure
+      // these memory are not gone forever, we still need to periodically shuffle tuples around within
+      // frozen blocks. Although code can be reused for doing the compaction, some logic needs to be
+      // written to enqueue these frozen blocks into the compaction queue.
+      cg.blocks_to_compact_.emplace(block, std::vector<uint32_t>());
+      if (EliminateGaps(&cg)) {
+        controller.GetBlockState()->store(BlockState::COOLING);
+        // If no compaction was performed, we still need to shut out any potentially racey transactions that
+        // are alive at the same time as us flipping the block status flag to cooling. However, we must manually
+        // ask the GC to enqueue this block, because no access will be observed from the empty compaction transaction.
+        if (cg.txn_->IsReadOnly())
+          deferred_action_manager->RegisterDeferredAction([this, block]() { RequeueCooling(block); });
+        txn_manager->Commit(cg.txn_, transaction::TransactionUtil::EmptyCallback, nullptr);
+      } else {
+        txn_manager->Abort(cg.txn_);
       }
-      case BlockState::COOLING: {
-        if (!CheckForVersionsAndGaps(block->data_table_->accessor_, block)) continue;
-        // This is used to clean up any dangling pointers using a deferred action in GC.
-        // We need this piece of memory to live on the heap, so its life time extends to
-        // beyond this function call.
-        auto *loose_ptrs = new std::vector<const byte *>;
-        GatherVarlens(loose_ptrs, block, block->data_table_);
-        controller.GetBlockState()->store(BlockState::FROZEN);
-        // When the old variable length values are no longer visible by running transactions, delete them.
-        deferred_action_manager->RegisterDeferredAction([=]() {
-          for (auto *loose_ptr : *loose_ptrs) delete[] loose_ptr;
-          delete loose_ptrs;
-        });
+      break;
+    }
+    case BlockState::COOLING: {
+      // Versions from before the block started cooling are still around. Try again once the GC has pruned them.
+      if (!CheckForVersionsAndGaps(block->data_table_->accessor_, block)) {
+        RequeueCooling(block);
         break;
       }
-      case BlockState::FROZEN:
-        // This is okay. In a rare race, the block can show up in the compaction queue, be accessed, compacted,
-        // and show up again because of the early access.
-        break;
-      default:
-        throw std::runtime_error("unexpected control flow");
+      // This is used to clean up any dangling pointers using a deferred action in GC.
+      // We need this piece of memory to live on the heap, so its life time extends to
+      // beyond this function call.
+      auto *loose_ptrs = new std::vector<const byte *>;
+      GatherVarlens(loose_ptrs, block, block->data_table_);
+      // Nobody writes to the block or reads it in place until it is frozen, so the tiering manager can replace its
+      // memory if it is still mapped to a file from before the block last thawed
+      if (tiering_manager_ != nullptr) tiering_manager_->AddFrozenBlock(block);
+      controller.GetBlockState()->store(BlockState::FROZEN);
+      // When the old variable length values are no longer visible by running transactions, delete them.
+      deferred_action_manager->RegisterDeferredAction([=]() {
+        for (auto *loose_ptr : *loose_ptrs) delete[] loose_ptr;
+        delete loose_ptrs;
+      });
+      break;
     }
-    to_process.pop();
+    case BlockState::FROZEN:
+    case BlockState::FREEZING:
+      // This is okay. In a rare race, the block can show up in the compaction queue, be accessed, compacted,
+      // and show up again because of the early access. It may also be thawing, which the tiering manager does by
+      // way of FREEZING.
+      break;
+    default:
+      throw std::runtime_error("unexpected control flow");
   }
 }
 
@@ -246,6 +280,7 @@ void BlockCompactor::GatherVarlens(std::vector<const byte *> *loose_ptrs, RawBlo
       // Only need to count null for non-varlens
       for (uint32_t i = 0; i < metadata.NumRecords(); i++)
         if (!column_bitmap->Test(i)) metadata.NullCount(col_id)++;
+      ComputeZoneMap(&metadata, col_id, column_bitmap, block, table);
       continue;
     }
 
@@ -265,6 +300,46 @@ void BlockCompactor::GatherVarlens(std::vector<const byte *> *loose_ptrs, RawBlo
   }
 }
 
+namespace {
+template <typename T>
+ZoneMap ComputeZoneMapTyped(const T *const values, common::RawConcurrentBitmap *const column_bitmap,
+                            const uint32_t num_records) {
+  ZoneMap result{std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min()};
+  for (uint32_t i = 0; i < num_records; i++) {
+    if (!column_bitmap->Test(i)) continue;
+    result.min_ = std::min<int64_t>(result.min_, values[i]);
+    result.max_ = std::max<int64_t>(result.max_, values[i]);
+  }
+  return result;
+}
+}  // namespace
+
+void BlockCompactor::ComputeZoneMap(ArrowBlockMetadata *metadata, col_id_t col_id,
+                                    common::RawConcurrentBitmap *column_bitmap, RawBlock *block, DataTable *table) {
+  const TupleAccessStrategy &accessor = table->accessor_;
+  const BlockLayout &layout = accessor.GetBlockLayout();
+  ZoneMap &zone_map = metadata->GetColumnInfo(layout, col_id).GetZoneMap();
+  const byte *values = accessor.ColumnStart(block, col_id);
+  const uint32_t num_records = metadata->NumRecords();
+  switch (layout.AttrSize(col_id)) {
+    case sizeof(int8_t):
+      zone_map = ComputeZoneMapTyped(reinterpret_cast<const int8_t *>(values), column_bitmap, num_records);
+      break;
+    case sizeof(int16_t):
+      zone_map = ComputeZoneMapTyped(reinterpret_cast<const int16_t *>(values), column_bitmap, num_records);
+      break;
+    case sizeof(int32_t):
+      zone_map = ComputeZoneMapTyped(reinterpret_cast<const int32_t *>(values), column_bitmap, num_records);
+      break;
+    case sizeof(int64_t):
+      zone_map = ComputeZoneMapTyped(reinterpret_cast<const int64_t *>(values), column_bitmap, num_records);
+      break;
+    default:
+      // Not something that can be compared as an integer, leave it without a meaningful zone map
+      break;
+  }
+}
+
 void BlockCompactor::CopyToArrowVarlen(std::vector<const byte *> *loose_ptrs, ArrowBlockMetadata *metadata,
                                        col_id_t col_id, common::RawConcurrentBitmap *column_bitmap,
                                        ArrowColumnInfo *col, VarlenEntry *values) {
@@ -347,7 +422,11 @@ void BlockCompactor::BuildDictionary(std::vector<const byte *> *loose_ptrs, Arro
 
   // Swing all references in the table to point there, and build the encoded column
   for (uint32_t i = 0; i < metadata->NumRecords(); i++) {
-    if (!column_bitmap->Test(i)) continue;
+    // NULLs get a valid code, so that readers of the codes never see garbage
+    if (!column_bitmap->Test(i)) {
+      new_col_info.Indices()[i] = 0;
+      continue;
+    }
     // Only do a gather operation if the column is varlen
     VarlenEntry &entry = values[i];
     // Need to GC
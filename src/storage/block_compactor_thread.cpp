@@ -0,0 +1,22 @@
+#include "storage/block_compactor_thread.h"
+
+namespace terrier::storage {
+BlockCompactorThread::BlockCompactorThread(BlockCompactor *const compactor,
+                                           transaction::DeferredActionManager *const deferred_action_manager,
+                                           transaction::TransactionManager *const txn_manager,
+                                           const uint32_t num_threads,
+                                           const std::chrono::milliseconds compaction_period,
+                                           const uint32_t blocks_per_round)
+    : compactor_(compactor),
+      deferred_action_manager_(deferred_action_manager),
+      txn_manager_(txn_manager),
+      run_compaction_(true),
+      compaction_paused_(false),
+      compaction_period_(compaction_period),
+      blocks_per_round_(blocks_per_round) {
+  TERRIER_ASSERT(num_threads > 0, "need at least one compaction thread");
+  for (uint32_t i = 0; i < num_threads; i++)
+    compaction_threads_.emplace_back([this] { CompactionThreadLoop(); });
+}
+
+}  // namespace terrier::storage
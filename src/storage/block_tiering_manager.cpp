@@ -0,0 +1,330 @@
+#include "storage/block_tiering_manager.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+#include "loggers/storage_logger.h"
+#include "storage/arrow_block_metadata.h"
+#include "storage/data_table.h"
+
+namespace terrier::storage {
+namespace {
+// Alignment of the buffers appended after the block image, as recommended by the Arrow format
+constexpr uint64_t BUFFER_ALIGNMENT = 64;
+
+uint64_t AlignUp(const uint64_t offset, const uint64_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+bool WriteFully(const int fd, const void *const data, const uint64_t size, const uint64_t offset) {
+  uint64_t written = 0;
+  while (written < size) {
+    const ssize_t result = pwrite(fd, reinterpret_cast<const byte *>(data) + written, size - written,
+                                  static_cast<off_t>(offset + written));
+    if (result == -1) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    written += static_cast<uint64_t>(result);
+  }
+  return true;
+}
+}  // namespace
+
+BlockTieringManager::BlockTieringManager(std::string directory, const uint64_t memory_budget)
+    : directory_(std::move(directory)),
+      memory_budget_(memory_budget),
+      page_size_(static_cast<uint64_t>(sysconf(_SC_PAGESIZE))) {
+  if (mkdir(directory_.c_str(), 0755) == -1 && errno != EEXIST)
+    throw std::runtime_error("Failed to create block tiering directory with errno " + std::to_string(errno));
+}
+
+BlockTieringManager::~BlockTieringManager() {
+  for (const auto &entry : blocks_) {
+    if (entry.second.file_id_ == 0) continue;
+    Unmap(entry.first);
+    DeleteFile(entry.second.file_id_);
+  }
+}
+
+void BlockTieringManager::AddFrozenBlock(RawBlock *const block) {
+  // The table has to tell us when it releases the block
+  block->data_table_->tiering_manager_.store(this);
+  uint64_t stale_file_id;
+  {
+    common::SpinLatch::ScopedSpinLatch guard(&latch_);
+    // A freshly frozen block counts as just accessed, otherwise it would be the first one spilled
+    auto result = blocks_.emplace(block, BlockInfo{epoch_, block->access_count_.load(std::memory_order_relaxed), 0});
+    if (result.second) return;
+    // The block was spilled and thawed without going through Thaw, and is now frozen again. The pages written to in
+    // between are private copies, so the file no longer tells the whole story.
+    BlockInfo &info = result.first->second;
+    info.last_touched_ = epoch_;
+    stale_file_id = info.file_id_;
+    if (stale_file_id == 0) return;
+    info.file_id_ = 0;
+    num_spilled_--;
+  }
+  // The block is not frozen yet, so nobody reads it in place while its memory is replaced
+  Unmap(block);
+  DeleteFile(stale_file_id);
+}
+
+void BlockTieringManager::Untrack(RawBlock *const block) {
+  uint64_t file_id;
+  while (true) {
+    {
+      common::SpinLatch::ScopedSpinLatch guard(&latch_);
+      if (spilling_ != block) {
+        auto it = blocks_.find(block);
+        if (it == blocks_.end()) return;
+        file_id = it->second.file_id_;
+        if (file_id != 0) num_spilled_--;
+        blocks_.erase(it);
+        break;
+      }
+    }
+    // Spilling does I/O, so the latch is not held for it
+    std::this_thread::yield();
+  }
+  if (file_id == 0) return;
+  // The block goes back to the block store, which must not get a file mapping to hand out
+  Unmap(block);
+  DeleteFile(file_id);
+}
+
+void BlockTieringManager::Thaw(RawBlock *const block) {
+  BlockAccessController &controller = block->controller_;
+  {
+    common::SpinLatch::ScopedSpinLatch guard(&latch_);
+    if (blocks_.count(block) == 0) return;
+  }
+  // Only one writer gets to thaw the block. The others wait in WaitUntilHot until it is hot, just like they wait for
+  // the compactor, and transactional readers keep reading the same contents throughout.
+  BlockState frozen = BlockState::FROZEN;
+  if (!controller.GetBlockState()->compare_exchange_strong(frozen, BlockState::FREEZING)) return;
+  // New in-place readers are turned away from now on, and the ones still in the block have to leave before its memory
+  // is replaced. Spill holds an in-place read too, so after this the block is either spilled or it is not.
+  while (controller.GetReaderCount()->load() != 0) _mm_pause();
+
+  uint64_t file_id = 0;
+  while (true) {
+    {
+      common::SpinLatch::ScopedSpinLatch guard(&latch_);
+      // ProcessBlocks records the file of a block it spilled when it stops spilling it
+      if (spilling_ != block) {
+        auto it = blocks_.find(block);
+        if (it != blocks_.end()) {
+          file_id = it->second.file_id_;
+          if (file_id != 0) num_spilled_--;
+          blocks_.erase(it);
+        }
+        break;
+      }
+    }
+    std::this_thread::yield();
+  }
+  if (file_id != 0) {
+    Unmap(block);
+    DeleteFile(file_id);
+  }
+  controller.GetBlockState()->store(BlockState::HOT);
+}
+
+uint32_t BlockTieringManager::ProcessBlocks() {
+  // Resident blocks, least recently accessed first
+  std::vector<std::pair<uint64_t, RawBlock *>> candidates;
+  uint64_t resident_bytes;
+  {
+    common::SpinLatch::ScopedSpinLatch guard(&latch_);
+    epoch_++;
+    for (auto it = blocks_.begin(); it != blocks_.end();) {
+      RawBlock *block = it->first;
+      BlockInfo &info = it->second;
+      const BlockState state = block->controller_.GetBlockState()->load();
+      if (state != BlockState::FROZEN) {
+        // The block thawed, and is handed back to us if it freezes again. A FREEZING block is being thawed by Thaw,
+        // which stops tracking it. A spilled block that thawed some other way may have writers in it, so its memory
+        // cannot be replaced here. It stays tracked until it freezes again or its table is dropped, and its memory is
+        // replaced then.
+        if (state != BlockState::FREEZING && info.file_id_ == 0) {
+          it = blocks_.erase(it);
+          continue;
+        }
+        ++it;
+        continue;
+      }
+      const uint16_t access_count = block->access_count_.load(std::memory_order_relaxed);
+      if (access_count != info.last_access_count_) {
+        info.last_access_count_ = access_count;
+        info.last_touched_ = epoch_;
+      }
+      if (info.file_id_ == 0) candidates.emplace_back(info.last_touched_, block);
+      ++it;
+    }
+    resident_bytes = candidates.size() * common::Constants::BLOCK_SIZE;
+  }
+  if (resident_bytes <= memory_budget_) return 0;
+
+  std::sort(candidates.begin(), candidates.end());
+  uint32_t num_spilled = 0;
+  for (const auto &candidate : candidates) {
+    if (resident_bytes <= memory_budget_) break;
+    RawBlock *const block = candidate.second;
+    uint64_t file_id;
+    {
+      common::SpinLatch::ScopedSpinLatch guard(&latch_);
+      // The block's table was dropped in the meantime
+      if (blocks_.count(block) == 0) continue;
+      spilling_ = block;
+      file_id = next_file_id_++;
+    }
+    // Spilling does I/O, so no latch is held while doing it. Untrack waits for it to finish, and only this thread
+    // removes thawed blocks from blocks_, so the block is still tracked afterwards, though it may have thawed.
+    const bool spilled = Spill(block, file_id);
+    common::SpinLatch::ScopedSpinLatch guard(&latch_);
+    spilling_ = nullptr;
+    if (!spilled) {
+      // Probably out of disk space or a block on huge pages. Either way, the next block is not likely to fare better.
+      if (block->controller_.GetBlockState()->load() != BlockState::FROZEN) continue;
+      break;
+    }
+    blocks_[block].file_id_ = file_id;
+    num_spilled_++;
+    num_spilled++;
+    resident_bytes -= common::Constants::BLOCK_SIZE;
+  }
+  return num_spilled;
+}
+
+std::string BlockTieringManager::SpilledFile(RawBlock *const block) {
+  common::SpinLatch::ScopedSpinLatch guard(&latch_);
+  auto it = blocks_.find(block);
+  return it == blocks_.end() || it->second.file_id_ == 0 ? "" : FilePath(it->second.file_id_);
+}
+
+bool BlockTieringManager::Spill(RawBlock *const block, const uint64_t file_id) {
+  // Writers have to wait for us to release the read before they can modify the block
+  if (!block->controller_.TryAcquireInPlaceRead()) return false;
+  const std::string path = FilePath(file_id);
+  const int fd = open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  bool success = fd != -1 && WriteBlockFile(block, fd) && fdatasync(fd) == 0;
+  if (success) {
+    // Nobody needs the written pages until the block is read again, so make sure they do not linger in the page cache
+    // on top of the block's own memory
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    // Replacing the mapping is atomic to concurrent readers, who fault the pages back in from the file. Their contents
+    // are the same as before, so readers cannot tell the difference.
+    const uint64_t mapped_offset = BlockOffset(block->data_table_->GetBlockLayout()) + page_size_;
+    void *const mapped = mmap(reinterpret_cast<byte *>(block) + page_size_, common::Constants::BLOCK_SIZE - page_size_,
+                              PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, static_cast<off_t>(mapped_offset));
+    success = mapped != MAP_FAILED;
+  }
+  if (!success) {
+    STORAGE_LOG_WARN("BlockTieringManager::Spill(): failed to spill block to {} with errno {}", path, errno);
+    unlink(path.c_str());
+  }
+  // The mapping holds on to the file
+  if (fd != -1) close(fd);
+  block->controller_.ReleaseInPlaceRead();
+  return success;
+}
+
+bool BlockTieringManager::WriteBlockFile(RawBlock *const block, const int fd) {
+  DataTable *const table = block->data_table_;
+  const BlockLayout &layout = table->GetBlockLayout();
+  const std::vector<col_id_t> columns = layout.AllColumns();
+  const uint64_t block_offset = BlockOffset(layout);
+  auto block_file_offset = [&](const void *ptr) {
+    return block_offset + static_cast<uint64_t>(reinterpret_cast<const byte *>(ptr) - reinterpret_cast<byte *>(block));
+  };
+
+  std::vector<byte> header(sizeof(FileHeader) + columns.size() * sizeof(ColumnDescriptor), static_cast<byte>(0));
+  auto *descriptors = reinterpret_cast<ColumnDescriptor *>(header.data() + sizeof(FileHeader));
+  // Buffers to append after the block image, along with their offset in the file
+  std::vector<std::pair<uint64_t, std::pair<const void *, uint64_t>>> buffers;
+  uint64_t file_size = block_offset + common::Constants::BLOCK_SIZE;
+  auto append = [&](const void *data, const uint64_t size) {
+    file_size = AlignUp(file_size, BUFFER_ALIGNMENT);
+    buffers.push_back({file_size, {data, size}});
+    file_size += size;
+    return buffers.back().first;
+  };
+
+  for (uint32_t i = 0; i < columns.size(); i++) {
+    const col_id_t col_id = columns[i];
+    ColumnDescriptor &descriptor = descriptors[i];
+    ArrowColumnInfo *column_info = table->InPlaceArrowColumnInfo(block, col_id);
+    descriptor.arrow_type_ = static_cast<uint8_t>(column_info->Type());
+    descriptor.attr_size_ = layout.IsVarlen(col_id) ? VARLEN_COLUMN : layout.AttrSize(col_id);
+    descriptor.null_count_ = table->InPlaceNullCount(block, col_id);
+    descriptor.validity_offset_ = block_file_offset(table->InPlaceColumnNullBitmap(block, col_id, 0));
+    if (!layout.IsVarlen(col_id)) {
+      descriptor.values_offset_ = block_file_offset(table->InPlaceColumnValues(block, col_id, 0));
+      descriptor.values_length_ = static_cast<uint64_t>(layout.AttrSize(col_id)) * layout.NumSlots();
+      continue;
+    }
+    ArrowVarlenColumn &varlen_column = column_info->VarlenColumn();
+    descriptor.values_length_ = varlen_column.ValuesLength();
+    descriptor.values_offset_ = append(varlen_column.Values(), varlen_column.ValuesLength());
+    descriptor.offsets_offset_ = append(varlen_column.Offsets(), varlen_column.OffsetsLength() * sizeof(uint32_t));
+    if (column_info->Type() == ArrowColumnType::DICTIONARY_COMPRESSED)
+      descriptor.indices_offset_ =
+          append(column_info->Indices(), table->InPlaceNumRecords(block) * static_cast<uint64_t>(sizeof(uint32_t)));
+  }
+
+  auto *file_header = reinterpret_cast<FileHeader *>(header.data());
+  file_header->magic_ = FILE_MAGIC;
+  file_header->version_ = FILE_VERSION;
+  file_header->num_columns_ = static_cast<uint16_t>(columns.size());
+  file_header->layout_version_ = static_cast<uint16_t>(!block->layout_version_);
+  file_header->num_slots_ = layout.NumSlots();
+  file_header->num_records_ = table->InPlaceNumRecords(block);
+  file_header->block_offset_ = block_offset;
+  file_header->block_size_ = common::Constants::BLOCK_SIZE;
+  file_header->file_size_ = file_size;
+
+  if (!WriteFully(fd, header.data(), header.size(), 0)) return false;
+  if (!WriteFully(fd, block, common::Constants::BLOCK_SIZE, block_offset)) return false;
+  for (const auto &buffer : buffers)
+    if (buffer.second.second != 0 && !WriteFully(fd, buffer.second.first, buffer.second.second, buffer.first))
+      return false;
+  return true;
+}
+
+uint64_t BlockTieringManager::BlockOffset(const BlockLayout &layout) const {
+  // The header always gets its own pages, even if the block only has a few columns, so the block image is
+  // page-aligned and can be mapped
+  const uint64_t num_columns = layout.NumColumns() - NUM_RESERVED_COLUMNS;
+  return AlignUp(sizeof(FileHeader) + num_columns * sizeof(ColumnDescriptor), page_size_);
+}
+
+void BlockTieringManager::Unmap(RawBlock *const block) const {
+  byte *const start = reinterpret_cast<byte *>(block) + page_size_;
+  const uint64_t size = common::Constants::BLOCK_SIZE - page_size_;
+  // Copy the pages into fresh memory and move that over the file mapping, which replaces it in one go. Transactional
+  // readers never see the block without its contents.
+  void *const copy = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (copy != MAP_FAILED) {
+    std::memcpy(copy, start, size);
+    if (mremap(copy, size, size, MREMAP_MAYMOVE | MREMAP_FIXED, start) != MAP_FAILED) return;
+    munmap(copy, size);
+  }
+  // The block keeps working off the file, whose disk space is only given back once the block is released
+  STORAGE_LOG_WARN("BlockTieringManager::Unmap(): failed to copy spilled block back into memory with errno {}", errno);
+}
+
+std::string BlockTieringManager::FilePath(const uint64_t file_id) const {
+  return directory_ + "/block_" + std::to_string(file_id) + ".tbl";
+}
+
+void BlockTieringManager::DeleteFile(const uint64_t file_id) const { unlink(FilePath(file_id).c_str()); }
+
+}  // namespace terrier::storage
@@ -0,0 +1,12 @@
+#include "storage/block_tiering_thread.h"
+
+namespace terrier::storage {
+BlockTieringThread::BlockTieringThread(BlockTieringManager *const tiering_manager,
+                                       const std::chrono::milliseconds tiering_period)
+    : tiering_manager_(tiering_manager),
+      run_tiering_(true),
+      tiering_paused_(false),
+      tiering_period_(tiering_period),
+      tiering_thread_([this] { TieringThreadLoop(); }) {}
+
+}  // namespace terrier::storage
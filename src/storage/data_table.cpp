@@ -1,11 +1,14 @@
 #include "storage/data_table.h"
 #include <pthread.h>
+#include <algorithm>
+#include <atomic>
 #include <cstring>
-#include <list>
 #include <unordered_map>
 #include "common/allocator.h"
 #include "storage/block_access_controller.h"
+#include "storage/block_tiering_manager.h"
 #include "storage/storage_util.h"
+#include "transaction/timestamp_manager.h"
 #include "transaction/transaction_context.h"
 #include "transaction/transaction_util.h"
 
@@ -19,14 +22,17 @@ DataTable::DataTable(BlockStore *const store, const BlockLayout &layout, const l
   if (block_store_ != nullptr) {
     RawBlock *new_block = NewBlock();
     // insert block
-    blocks_.push_back(new_block);
+    blocks_.Append(new_block);
   }
-  insertion_head_ = blocks_.begin();
+  for (auto &block : insertion_blocks_) block.store(nullptr);
 }
 
 DataTable::~DataTable() {
-  common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
-  for (RawBlock *block : blocks_) {
+  BlockTieringManager *const tiering_manager = tiering_manager_.load();
+  for (uint32_t i = 0; i < blocks_.Size(); i++) {
+    RawBlock *block = blocks_[i];
+    // Waits for the block to be written out if it is being spilled, as that reads the buffers freed below
+    if (tiering_manager != nullptr) tiering_manager->Untrack(block);
     StorageUtil::DeallocateVarlens(block, accessor_);
     for (col_id_t i : accessor_.GetBlockLayout().Varlens())
       accessor_.GetArrowBlockMetadata(block).GetColumnInfo(accessor_.GetBlockLayout(), i).Deallocate();
@@ -34,66 +40,209 @@ DataTable::~DataTable() {
   }
 }
 
+void DataTable::WaitUntilHot(RawBlock *const block) const {
+  BlockTieringManager *const tiering_manager = tiering_manager_.load();
+  // A block the tiering manager tracks may be spilled, in which case it has to be copied back into memory before it
+  // can be written to
+  if (tiering_manager != nullptr && block->controller_.GetBlockState()->load() == BlockState::FROZEN)
+    tiering_manager->Thaw(block);
+  block->controller_.WaitUntilHot();
+}
+
 bool DataTable::Select(terrier::transaction::TransactionContext *txn, terrier::storage::TupleSlot slot,
                        terrier::storage::ProjectedRow *out_buffer) const {
   data_table_counter_.IncrementNumSelect(1);
+  SampleAccess(slot.GetBlock());
   return SelectIntoBuffer(txn, slot, out_buffer);
 }
 
 void DataTable::Scan(transaction::TransactionContext *const txn, SlotIterator *const start_pos,
                      ProjectedColumns *const out_buffer) const {
-  // TODO(Tianyu): So far this is not that much better than tuple-at-a-time access,
-  // but can be improved if block is read-only, or if we implement version synopsis, to just use std::memcpy when it's
-  // safe
+  // Snapshot the end of the table once per call instead of once per tuple. Tuples inserted after this point are not
+  // visible to the calling transaction anyway, so stopping early is still transactionally correct.
+  RangeScan(txn, start_pos, end(), out_buffer);
+}
+
+void DataTable::RangeScan(transaction::TransactionContext *const txn, SlotIterator *const start_pos,
+                          const SlotIterator &end_pos, ProjectedColumns *const out_buffer) const {
+  const uint32_t num_slots = accessor_.GetBlockLayout().NumSlots();
   uint32_t filled = 0;
-  while (filled < out_buffer->MaxTuples() && *start_pos != end()) {
+  while (filled < out_buffer->MaxTuples() && *start_pos != end_pos) {
+    RawBlock *const block = start_pos->current_slot_.GetBlock();
+    const uint32_t offset = start_pos->current_slot_.GetOffset();
+    // Only scan up to the end of this block, or up to the end position if it lies within this block.
+    const uint32_t block_end =
+        end_pos.current_slot_.GetBlock() == block ? end_pos.current_slot_.GetOffset() : num_slots;
+    // Never look at more slots than there is room left in the output buffer, so every visible tuple is sure to fit
+    const uint32_t num_to_scan = std::min(block_end - offset, out_buffer->MaxTuples() - filled);
+    filled += SelectBlockRangeIntoBuffer(txn, block, offset, num_to_scan, out_buffer, filled);
+    // Move the iterator onto the last slot scanned and step over it, which moves onto the next block if necessary
+    start_pos->current_slot_ = {block, offset + num_to_scan - 1};
+    ++(*start_pos);
+  }
+  out_buffer->SetNumTuples(filled);
+}
+
+namespace {
+// Returns a mask with num_bits bits set, starting at bit start_bit
+uint64_t BitRangeMask(const uint32_t start_bit, const uint32_t num_bits) {
+  return (num_bits == 64 ? ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << num_bits) - 1) << start_bit;
+}
+
+// Loads the 64 bits of the bitmap that cover slots [word * 64, word * 64 + 64). Bitmaps in a block are always padded
+// up to 8 bytes, so the whole word can be read even if it is the last, partial one. Bit i of the word is the bit for
+// slot word * 64 + i, as the bitmap stores its bits least-significant first and we only run on little-endian machines.
+uint64_t LoadBitmapWord(const common::RawConcurrentBitmap *const bitmap, const uint32_t word) {
+  return reinterpret_cast<const std::atomic<uint64_t> *>(bitmap)[word].load(std::memory_order_relaxed);
+}
+}  // namespace
+
+uint32_t DataTable::SelectBlockRangeIntoBuffer(transaction::TransactionContext *const txn, RawBlock *const block,
+                                               const uint32_t start_offset, const uint32_t num_slots,
+                                               ProjectedColumns *const out_buffer, const uint32_t out_start) const {
+  auto *const version_ptrs =
+      reinterpret_cast<std::atomic<UndoRecord *> *>(accessor_.ColumnStart(block, VERSION_POINTER_COLUMN_ID));
+  const common::RawConcurrentBitmap *const allocation_bitmap = accessor_.AllocationBitmap(block);
+  const common::RawConcurrentBitmap *const presence_bitmap =
+      accessor_.ColumnNullBitmap(block, VERSION_POINTER_COLUMN_ID);
+
+  SampleAccess(block);
+  const uint32_t end_offset = start_offset + num_slots;
+  uint32_t filled = out_start;
+  // Work on the range 64 slots at a time, so that visibility can be decided for the whole word with a few bitwise ops
+  for (uint32_t word_start = start_offset; word_start < end_offset;) {
+    const uint32_t word = word_start / 64;
+    const uint32_t word_end = std::min(end_offset, (word + 1) * 64);
+    const uint64_t in_range = BitRangeMask(word_start % 64, word_end - word_start);
+
+    uint64_t no_version = 0;
+    for (uint32_t i = word_start; i < word_end; i++)
+      no_version |= static_cast<uint64_t>(version_ptrs[i].load(std::memory_order_relaxed) == nullptr) << (i % 64);
+    const uint64_t allocated = LoadBitmapWord(allocation_bitmap, word) & in_range;
+    const uint64_t present = LoadBitmapWord(presence_bitmap, word);
+    // The version pointers must be read before any of the tuple contents
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    // Allocated, not deleted slots without a version chain are visible to everyone and can be copied as is. Allocated
+    // slots with a version chain need to go through the regular MVCC path. Everything else is invisible to everyone.
+    const uint64_t clean = allocated & present & no_version;
+    uint64_t candidates = clean | (allocated & ~no_version);
+    while (candidates != 0) {
+      const auto bit = static_cast<uint32_t>(__builtin_ctzll(candidates));
+      const uint32_t offset = word * 64 + bit;
+      if ((clean >> bit) & 1) {
+        // Extend to the whole run of consecutive clean slots in this word
+        const uint64_t rest = ~(clean >> bit);
+        const uint32_t run_length = rest == 0 ? 64 - bit : static_cast<uint32_t>(__builtin_ctzll(rest));
+        filled += CopyCleanRunIntoBuffer(txn, block, offset, run_length, out_buffer, filled);
+        candidates &= ~BitRangeMask(bit, run_length);
+      } else {
+        const TupleSlot slot(block, offset);
+        ProjectedColumns::RowView row = out_buffer->InterpretAsRow(filled);
+        if (SelectIntoBuffer(txn, slot, &row)) {
+          out_buffer->TupleSlots()[filled] = slot;
+          filled++;
+        }
+        candidates &= candidates - 1;
+      }
+    }
+    word_start = word_end;
+  }
+  return filled - out_start;
+}
+
+uint32_t DataTable::CopyCleanRunIntoBuffer(transaction::TransactionContext *const txn, RawBlock *const block,
+                                           const uint32_t start_offset, const uint32_t num_slots,
+                                           ProjectedColumns *const out_buffer, const uint32_t out_start) const {
+  const BlockLayout &layout = accessor_.GetBlockLayout();
+  for (uint16_t i = 0; i < out_buffer->NumColumns(); i++) {
+    const col_id_t col_id = out_buffer->ColumnIds()[i];
+    TERRIER_ASSERT(col_id != VERSION_POINTER_COLUMN_ID, "Output buffer should not read the version pointer column.");
+    const uint8_t attr_size = layout.AttrSize(col_id);
+    std::memcpy(out_buffer->ColumnStart(i) + attr_size * out_start,
+                accessor_.ColumnStart(block, col_id) + attr_size * start_offset, attr_size * num_slots);
+    const common::RawConcurrentBitmap *const null_bitmap = accessor_.ColumnNullBitmap(block, col_id);
+    common::RawBitmap *const out_null_bitmap = out_buffer->ColumnNullBitmap(i);
+    for (uint32_t j = 0; j < num_slots; j++) out_null_bitmap->Set(out_start + j, null_bitmap->Test(start_offset + j));
+  }
+
+  // Make sure nobody installed a version or deleted any of the tuples while we were copying. This is the bulk
+  // equivalent of the version pointer re-check in SelectIntoBuffer.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  bool unchanged = true;
+  for (uint32_t j = 0; j < num_slots && unchanged; j++) {
+    const TupleSlot slot(block, start_offset + j);
+    unchanged = AtomicallyReadVersionPtr(slot, accessor_) == nullptr && Visible(slot, accessor_);
+  }
+
+  if (unchanged) {
+    for (uint32_t j = 0; j < num_slots; j++)
+      out_buffer->TupleSlots()[out_start + j] = TupleSlot(block, start_offset + j);
+    return num_slots;
+  }
+
+  // Somebody raced with us, fall back to tuple-at-a-time materialization for this run, overwriting what was copied.
+  uint32_t filled = out_start;
+  for (uint32_t j = 0; j < num_slots; j++) {
+    const TupleSlot slot(block, start_offset + j);
     ProjectedColumns::RowView row = out_buffer->InterpretAsRow(filled);
-    const TupleSlot slot = **start_pos;
-    // Only fill the buffer with valid, visible tuples
     if (SelectIntoBuffer(txn, slot, &row)) {
       out_buffer->TupleSlots()[filled] = slot;
       filled++;
     }
-    ++(*start_pos);
   }
-  out_buffer->SetNumTuples(filled);
+  return filled - out_start;
 }
 
 DataTable::SlotIterator &DataTable::SlotIterator::operator++() {
-  common::SpinLatch::ScopedSpinLatch guard(&table_->blocks_latch_);
   // Jump to the next block if already the last slot in the block.
   if (current_slot_.GetOffset() == table_->accessor_.GetBlockLayout().NumSlots() - 1) {
-    ++block_;
-    // Cannot dereference if the next block is end(), so just use nullptr to denote
-    current_slot_ = {block_ == table_->blocks_.end() ? nullptr : *block_, 0};
+    // Only block boundaries need to look at the block directory, which inserts may be appending to concurrently.
+    ++block_index_;
+    // Cannot look up a block past the end of the directory, so just use nullptr to denote
+    current_slot_ = {block_index_ < table_->blocks_.Size() ? table_->blocks_[block_index_] : nullptr, 0};
   } else {
-    current_slot_ = {*block_, current_slot_.GetOffset() + 1};
+    // Within a block the slots are laid out contiguously, so advancing only moves the offset.
+    current_slot_ = {current_slot_.GetBlock(), current_slot_.GetOffset() + 1};
   }
   return *this;
 }
 
 DataTable::SlotIterator DataTable::end() const {  // NOLINT for STL name compability
-  common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
   // TODO(Tianyu): Need to look in detail at how this interacts with compaction when that gets in.
 
   // The end iterator could either point to an unfilled slot in a block, or point to nothing if every block in the
-  // table is full. In the case that it points to nothing, we will use the end-iterator of the blocks list and
+  // table is full. In the case that it points to nothing, we will use the number of blocks as the block index and
   // 0 to denote that this is the case. This solution makes increment logic simple and natural.
-  if (blocks_.empty()) return {this, blocks_.end(), 0};
-  auto last_block = --blocks_.end();
-  uint32_t insert_head = (*last_block)->GetInsertHead();
+  const uint32_t num_blocks = blocks_.Size();
+  if (num_blocks == 0) return {this, 0, 0};
+  const uint32_t last_block = num_blocks - 1;
+  uint32_t insert_head = blocks_[last_block]->GetInsertHead();
   // Last block is full, return the default end iterator that doesn't point to anything
-  if (insert_head == accessor_.GetBlockLayout().NumSlots()) return {this, blocks_.end(), 0};
+  if (insert_head == accessor_.GetBlockLayout().NumSlots()) return {this, num_blocks, 0};
   // Otherwise, insert head points to the slot that will be inserted next, which would be exactly what we want.
   return {this, last_block, insert_head};
 }
 
+DataTable::SlotIterator DataTable::beginAt(const uint32_t block_index) const {  // NOLINT for STL name compability
+  if (block_index < blocks_.Size()) return {this, block_index, 0};
+  return end();
+}
+
+DataTable::SlotIterator DataTable::NextBlock(const SlotIterator &pos) const {
+  SlotIterator result = pos;
+  // Step over the last slot of the block, which moves onto the next block the same way a scan would
+  result.current_slot_ = {pos.current_slot_.GetBlock(), accessor_.GetBlockLayout().NumSlots() - 1};
+  return ++result;
+}
+
 bool DataTable::Update(transaction::TransactionContext *const txn, const TupleSlot slot, const ProjectedRow &redo) {
   TERRIER_ASSERT(redo.NumColumns() <= accessor_.GetBlockLayout().NumColumns() - NUM_RESERVED_COLUMNS,
                  "The input buffer cannot change the reserved columns, so it should have fewer attributes.");
   TERRIER_ASSERT(redo.NumColumns() > 0, "The input buffer should modify at least one attribute.");
   UndoRecord *const undo = txn->UndoRecordForUpdate(this, slot, redo);
-  slot.GetBlock()->controller_.WaitUntilHot();
+  SampleAccess(slot.GetBlock());
+  WaitUntilHot(slot.GetBlock());
   UndoRecord *version_ptr;
   do {
     version_ptr = AtomicallyReadVersionPtr(slot, accessor_);
@@ -115,6 +264,9 @@ bool DataTable::Update(transaction::TransactionContext *const txn, const TupleSl
     undo->Next() = version_ptr;
   } while (!CompareAndSwapVersionPtr(slot, accessor_, version_ptr, undo));
 
+  // We are already at the head of the chain, so drop versions nobody can see anymore while they are cheap to reach
+  PruneVersionChain(*txn, undo);
+
   // Update in place with the new value.
   for (uint16_t i = 0; i < redo.NumColumns(); i++) {
     TERRIER_ASSERT(redo.ColumnIds()[i] != VERSION_POINTER_COLUMN_ID,
@@ -129,23 +281,19 @@ bool DataTable::Update(transaction::TransactionContext *const txn, const TupleSl
   return true;
 }
 
-void DataTable::CheckMoveHead(std::list<RawBlock *>::iterator block) {
+void DataTable::CheckMoveHead(const uint32_t block_index) {
   // Assume block is full
   common::SpinLatch::ScopedSpinLatch guard_head(&header_latch_);
-  if (block == insertion_head_) {
+  if (block_index == insertion_head_.load()) {
     // If the header block is full, move the header to point to the next block
     insertion_head_++;
   }
 
-  // If there are no more free blocks, create a new empty block and  point the insertion_head to it
-  if (insertion_head_ == blocks_.end()) {
+  // If there are no more free blocks, create a new empty block and  point the insertion_head to it. If an insert
+  // appended a block in the meantime, the header already points to that one.
+  if (insertion_head_.load() == blocks_.Size()) {
     RawBlock *new_block = NewBlock();
-    // take latch
-    common::SpinLatch::ScopedSpinLatch guard_block(&blocks_latch_);
-    // insert block
-    blocks_.push_back(new_block);
-    // set insertion header to --end()
-    insertion_head_ = --blocks_.end();
+    insertion_head_.store(blocks_.Append(new_block));
   }
 }
 
@@ -162,48 +310,120 @@ TupleSlot DataTable::Insert(transaction::TransactionContext *const txn, const Pr
   // The first bit of block insert_head_ is used to indicate if the block is busy
   // If the first bit is 1, it indicates one txn is writing to the block.
 
+  // Each thread first tries the block of its insertion lane. As long as there are no more inserting threads than lanes,
+  // no one else inserts into that block, so setting its busy bit is uncontended.
   TupleSlot result;
-  auto block = insertion_head_;
-  while (true) {
+  const uint64_t lane_tag = ThreadInsertionLaneTag();
+  std::atomic<RawBlock *> *const lane_block = lane_tag == 0 ? nullptr : &insertion_blocks_[lane_tag & LANE_INDEX_MASK];
+  RawBlock *const owned_block = lane_block == nullptr ? nullptr : lane_block->load();
+  if (owned_block != nullptr && owned_block->insertion_lane_.load() == lane_tag &&
+      accessor_.SetBlockBusyStatus(owned_block)) {
+    const bool allocated = accessor_.Allocate(owned_block, &result);
+    // The block is full. The lane hands it back to the block list, where other inserters can use slots compaction
+    // frees in it, and looks for a new one from the insertion header.
+    if (!allocated) owned_block->insertion_lane_.store(0);
+    accessor_.ClearBlockBusyStatus(owned_block);
+    if (allocated) {
+      InsertInto(txn, redo, result);
+      data_table_counter_.IncrementNumInsert(1);
+      return result;
+    }
+  }
+
+  RawBlock *block;
+  for (uint32_t block_index = insertion_head_.load();; block_index++) {
     // No free block left
-    if (block == blocks_.end()) {
-      RawBlock *new_block = NewBlock();
-      TERRIER_ASSERT(accessor_.SetBlockBusyStatus(new_block), "Status of new block should not be busy");
+    if (block_index >= blocks_.Size()) {
+      block = NewBlock();
+      TERRIER_ASSERT(accessor_.SetBlockBusyStatus(block), "Status of new block should not be busy");
       // No need to flip the busy status bit
-      accessor_.Allocate(new_block, &result);
-      // take latch
-      common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
+      accessor_.Allocate(block, &result);
       // insert block
-      blocks_.push_back(new_block);
-      block = --blocks_.end();
+      blocks_.Append(block);
       break;
     }
 
-    if (accessor_.SetBlockBusyStatus(*block)) {
-      // No one is inserting into this block
-      if (accessor_.Allocate(*block, &result)) {
+    block = blocks_[block_index];
+    if (!ClaimedByOtherLane(block, lane_tag) && accessor_.SetBlockBusyStatus(block)) {
+      // No one is inserting into this block. Another lane may have claimed it before we set the busy bit though, which
+      // it only does while holding the bit, so checking again now is enough.
+      if (ClaimedByOtherLane(block, lane_tag)) {
+        accessor_.ClearBlockBusyStatus(block);
+        continue;
+      }
+      if (accessor_.Allocate(block, &result)) {
         // The block is not full, succeed
         break;
       }
       // Fail to insert into the block, flip back the status bit
-      accessor_.ClearBlockBusyStatus(*block);
+      accessor_.ClearBlockBusyStatus(block);
       // if the full block is the insertion_header, move the insertion_header
       // Next insert txn will search from the new insertion_header
-      CheckMoveHead(block);
+      CheckMoveHead(block_index);
     }
-    // The block is full or the block is being inserted by other txn, try next block
-    ++block;
+    // The block is full, or another txn or lane is inserting into it, try next block
   }
 
+  // The lane keeps inserting into this block until it is full. The claim is made while still holding the busy bit.
+  if (lane_block != nullptr) {
+    block->insertion_lane_.store(lane_tag);
+    lane_block->store(block);
+  }
   // Do not need to wait unit finish inserting,
   // can flip back the status bit once the thread gets the allocated tuple slot
-  accessor_.ClearBlockBusyStatus(*block);
+  accessor_.ClearBlockBusyStatus(block);
   InsertInto(txn, redo, result);
 
   data_table_counter_.IncrementNumInsert(1);
   return result;
 }
 
+namespace {
+// Generation of every insertion lane. A lane is held by a thread while its generation is odd, and free while even.
+std::array<std::atomic<uint32_t>, DataTable::NUM_INSERTION_LANES> insertion_lane_generations;
+
+// Holds an insertion lane for as long as the thread that created it runs
+class InsertionLaneHolder {
+ public:
+  InsertionLaneHolder() {
+    for (uint32_t lane = 0; lane < DataTable::NUM_INSERTION_LANES; lane++) {
+      uint32_t generation = insertion_lane_generations[lane].load();
+      if (generation % 2 == 0 && insertion_lane_generations[lane].compare_exchange_strong(generation, generation + 1)) {
+        tag_ = static_cast<uint64_t>(generation + 1) << 32 | lane;
+        return;
+      }
+    }
+    // Every lane is held by another thread, so this one inserts without a lane of its own
+  }
+
+  ~InsertionLaneHolder() {
+    // Frees the lane, and lapses every claim made with it in one go
+    if (tag_ != 0) insertion_lane_generations[tag_ & DataTable::LANE_INDEX_MASK]++;
+  }
+
+  DISALLOW_COPY_AND_MOVE(InsertionLaneHolder)
+
+  uint64_t Tag() const { return tag_; }
+
+ private:
+  // Generation of the lane in the upper 32 bits, index of the lane in the lower ones. Never 0 for a held lane, as the
+  // generation is odd.
+  uint64_t tag_ = 0;
+};
+}  // namespace
+
+uint64_t DataTable::ThreadInsertionLaneTag() {
+  thread_local const InsertionLaneHolder lane;
+  return lane.Tag();
+}
+
+bool DataTable::ClaimedByOtherLane(const RawBlock *const block, const uint64_t lane_tag) {
+  const uint64_t block_tag = block->insertion_lane_.load();
+  if (block_tag == 0 || block_tag == lane_tag) return false;
+  // The claim lapses once the thread that made it exits and the generation of its lane moves on
+  return insertion_lane_generations[block_tag & LANE_INDEX_MASK].load() == block_tag >> 32;
+}
+
 void DataTable::InsertInto(transaction::TransactionContext *txn, const ProjectedRow &redo, TupleSlot dest) {
   TERRIER_ASSERT(accessor_.Allocated(dest), "destination slot must already be allocated");
   TERRIER_ASSERT(accessor_.IsNull(dest, VERSION_POINTER_COLUMN_ID),
@@ -227,7 +447,8 @@ void DataTable::InsertInto(transaction::TransactionContext *txn, const Projected
 bool DataTable::Delete(transaction::TransactionContext *const txn, const TupleSlot slot) {
   data_table_counter_.IncrementNumDelete(1);
   UndoRecord *const undo = txn->UndoRecordForDelete(this, slot);
-  slot.GetBlock()->controller_.WaitUntilHot();
+  SampleAccess(slot.GetBlock());
+  WaitUntilHot(slot.GetBlock());
   UndoRecord *version_ptr;
   do {
     version_ptr = AtomicallyReadVersionPtr(slot, accessor_);
@@ -244,6 +465,9 @@ bool DataTable::Delete(transaction::TransactionContext *const txn, const TupleSl
     undo->Next() = version_ptr;
   } while (!CompareAndSwapVersionPtr(slot, accessor_, version_ptr, undo));
 
+  // We are already at the head of the chain, so drop versions nobody can see anymore while they are cheap to reach
+  PruneVersionChain(*txn, undo);
+
   // We have the write lock. Go ahead and flip the logically deleted bit to true
   accessor_.SetNull(slot, VERSION_POINTER_COLUMN_ID);
   return true;
@@ -309,6 +533,8 @@ bool DataTable::SelectIntoBuffer(transaction::TransactionContext *const txn, con
   }
 
   // Apply deltas until we reconstruct a version safe for us to read
+  UndoRecord *last_applied = nullptr;
+  uint32_t num_applied = 0;
   while (version_ptr != nullptr &&
          transaction::TransactionUtil::NewerThan(version_ptr->Timestamp().load(), txn->StartTime())) {
     switch (version_ptr->Type()) {
@@ -325,9 +551,14 @@ bool DataTable::SelectIntoBuffer(transaction::TransactionContext *const txn, con
       default:
         throw std::runtime_error("unexpected delta record type");
     }
+    last_applied = version_ptr;
+    num_applied++;
     version_ptr = version_ptr->Next();
   }
 
+  // Every version we had to walk past is newer than us, but the GC may be behind on cutting off the ones below them
+  if (num_applied >= VERSION_CHAIN_PRUNE_THRESHOLD) PruneVersionChain(*txn, last_applied);
+
   return visible;
 }
 
@@ -356,6 +587,26 @@ bool DataTable::Visible(const TupleSlot slot, const TupleAccessStrategy &accesso
   return present && not_deleted;
 }
 
+bool DataTable::PruneVersionChain(const transaction::TransactionContext &txn, UndoRecord *const from) const {
+  // Txns constructed by hand do not know of a TimestampManager, so there is no way to tell what is safe to cut off
+  if (txn.timestamp_manager_ == nullptr) return false;
+  // The cached timestamp can only be older than the actual oldest running txn, which only makes us cut off less
+  const transaction::timestamp_t oldest = txn.timestamp_manager_->CachedOldestTransactionStartTime();
+  UndoRecord *curr = from;
+  for (uint32_t i = 0; i < VERSION_CHAIN_PRUNE_THRESHOLD; i++) {
+    UndoRecord *const next = curr->Next().load();
+    if (next == nullptr) return false;
+    if (transaction::TransactionUtil::NewerThan(oldest, next->Timestamp().load())) {
+      // Same as the GC's truncation: everything below curr is invisible to all running txns. The records stay in the
+      // undo buffers of their txns until the GC frees them, after everyone who could still be walking them is gone.
+      curr->Next().store(nullptr);
+      return true;
+    }
+    curr = next;
+  }
+  return false;
+}
+
 bool DataTable::HasConflict(const transaction::TransactionContext &txn, UndoRecord *const version_ptr) const {
   if (version_ptr == nullptr) return false;  // Nobody owns this tuple's write lock, no older version visible
   const transaction::timestamp_t version_timestamp = version_ptr->Timestamp().load();
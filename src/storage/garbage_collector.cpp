@@ -1,6 +1,7 @@
 #include "storage/garbage_collector.h"
 #include <unordered_set>
 #include <utility>
+#include <vector>
 #include "common/macros.h"
 #include "loggers/storage_logger.h"
 #include "storage/data_table.h"
@@ -12,6 +13,23 @@
 
 namespace terrier::storage {
 
+GarbageCollector::GarbageCollector(transaction::TimestampManager *const timestamp_manager,
+                                   transaction::DeferredActionManager *const deferred_action_manager,
+                                   transaction::TransactionManager *const txn_manager, AccessObserver *const observer,
+                                   const uint32_t num_gc_threads)
+    : timestamp_manager_(timestamp_manager),
+      deferred_action_manager_(deferred_action_manager),
+      txn_manager_(txn_manager),
+      observer_(observer),
+      last_unlinked_{0},
+      num_gc_threads_(num_gc_threads),
+      partitions_(num_gc_threads) {
+  TERRIER_ASSERT(txn_manager_->GCEnabled(),
+                 "The TransactionManager needs to be instantiated with gc_enabled true for GC to work!");
+  TERRIER_ASSERT(num_gc_threads_ > 0, "GC needs at least one thread");
+  if (num_gc_threads_ > 1) gc_pool_ = std::make_unique<common::WorkerPool>(num_gc_threads_, common::TaskQueue{});
+}
+
 std::pair<uint32_t, uint32_t> GarbageCollector::PerformGarbageCollection() {
   if (observer_ != nullptr) observer_->ObserveGCInvocation();
   timestamp_manager_->CheckOutTimestamp();
@@ -39,9 +57,21 @@ uint32_t GarbageCollector::ProcessDeallocateQueue(transaction::timestamp_t oldes
     // All of the transactions in my deallocation queue were unlinked before the oldest running txn in the system, and
     // have been serialized by the log manager. We are now safe to deallocate these txns because no running
     // transaction should hold a reference to them anymore
-    for (auto &txn : txns_to_deallocate_) {
-      delete txn;
-      txns_processed++;
+    if (gc_pool_ == nullptr) {
+      for (auto &txn : txns_to_deallocate_) {
+        delete txn;
+        txns_processed++;
+      }
+    } else {
+      // Txns are independent of each other, so the workers can simply take turns
+      std::vector<transaction::TransactionContext *> txns(txns_to_deallocate_.begin(), txns_to_deallocate_.end());
+      for (uint32_t worker = 0; worker < num_gc_threads_; worker++) {
+        gc_pool_->SubmitTask([&, worker] {
+          for (auto i = worker; i < txns.size(); i += num_gc_threads_) delete txns[i];
+        });
+      }
+      gc_pool_->WaitUntilAllFinished();
+      txns_processed = static_cast<uint32_t>(txns.size());
     }
     txns_to_deallocate_.clear();
   }
@@ -61,10 +91,8 @@ uint32_t GarbageCollector::ProcessUnlinkQueue(transaction::timestamp_t oldest_tx
   uint32_t txns_processed = 0;
   // Certain transactions might not be yet safe to gc. Need to requeue them
   transaction::TransactionQueue requeue;
-  // It is sufficient to truncate each version chain once in a GC invocation because we only read the maximal safe
-  // timestamp once, and the version chain is sorted by timestamp. Here we keep a set of slots to truncate to avoid
-  // wasteful traversals of the version chain.
-  std::unordered_set<TupleSlot> visited_slots;
+  // Transactions whose records are unlinked in this invocation
+  std::vector<transaction::TransactionContext *> txns_to_truncate;
 
   // Process every transaction in the unlink queue
   while (!txns_to_unlink_.empty()) {
@@ -77,21 +105,7 @@ uint32_t GarbageCollector::ProcessUnlinkQueue(transaction::timestamp_t oldest_tx
       txns_processed++;
     } else if (transaction::TransactionUtil::NewerThan(oldest_txn, txn->FinishTime())) {
       // Safe to garbage collect.
-      for (auto &undo_record : txn->undo_buffer_) {
-        // It is possible for the table field to be null, for aborted transaction's last conflicting record
-        DataTable *&table = undo_record.Table();
-        // Each version chain needs to be traversed and truncated at most once every GC period. Check
-        // if we have already visited this tuple slot; if not, proceed to prune the version chain.
-        if (table != nullptr && visited_slots.insert(undo_record.Slot()).second)
-          TruncateVersionChain(table, undo_record.Slot(), oldest_txn);
-        // Regardless of the version chain we will need to reclaim deleted slots and any dangling pointers to varlens,
-        // unless the transaction is aborted, and the record holds a version that is still visible.
-        if (!txn->Aborted()) {
-          ReclaimSlotIfDeleted(&undo_record);
-          ReclaimBufferIfVarlen(txn, &undo_record);
-        }
-        if (observer_ != nullptr) observer_->ObserveWrite(undo_record.Slot().GetBlock());
-      }
+      txns_to_truncate.push_back(txn);
       txns_to_deallocate_.push_front(txn);
       txns_processed++;
     } else {
@@ -103,9 +117,51 @@ uint32_t GarbageCollector::ProcessUnlinkQueue(transaction::timestamp_t oldest_tx
   // Requeue any txns that we were still visible to running transactions
   txns_to_unlink_ = transaction::TransactionQueue(std::move(requeue));
 
+  if (txns_to_truncate.empty()) return txns_processed;
+  if (gc_pool_ == nullptr) {
+    UnlinkPartition(txns_to_truncate, oldest_txn, 0);
+  } else {
+    for (uint32_t partition = 0; partition < num_gc_threads_; partition++)
+      gc_pool_->SubmitTask([&, partition] { UnlinkPartition(txns_to_truncate, oldest_txn, partition); });
+    gc_pool_->WaitUntilAllFinished();
+  }
+  // Neither the txns nor the observer can be handed results concurrently, so this is done once all partitions finish
+  for (auto &partition : partitions_) {
+    for (const auto &loose_ptr : partition.loose_ptrs_) loose_ptr.first->loose_ptrs_.push_back(loose_ptr.second);
+    partition.loose_ptrs_.clear();
+    for (RawBlock *block : partition.written_blocks_) observer_->ObserveWrite(block);
+    partition.written_blocks_.clear();
+  }
+
   return txns_processed;
 }
 
+void GarbageCollector::UnlinkPartition(const std::vector<transaction::TransactionContext *> &txns,
+                                       const transaction::timestamp_t oldest_txn, const uint32_t partition) {
+  GCPartition &state = partitions_[partition];
+  state.visited_slots_.clear();
+  for (transaction::TransactionContext *txn : txns) {
+    for (auto &undo_record : txn->undo_buffer_) {
+      // Every worker walks all records, but only processes the ones on blocks of its own partition. All records of a
+      // version chain are on the same block, so no other worker touches the chain.
+      if (PartitionOf(undo_record.Slot().GetBlock()) != partition) continue;
+      // It is possible for the table field to be null, for aborted transaction's last conflicting record
+      DataTable *&table = undo_record.Table();
+      // Each version chain needs to be traversed and truncated at most once every GC period. Check
+      // if we have already visited this tuple slot; if not, proceed to prune the version chain.
+      if (table != nullptr && state.visited_slots_.insert(undo_record.Slot()).second)
+        TruncateVersionChain(table, undo_record.Slot(), oldest_txn);
+      // Regardless of the version chain we will need to reclaim deleted slots and any dangling pointers to varlens,
+      // unless the transaction is aborted, and the record holds a version that is still visible.
+      if (!txn->Aborted()) {
+        ReclaimSlotIfDeleted(&undo_record);
+        ReclaimBufferIfVarlen(txn, &undo_record, &state.loose_ptrs_);
+      }
+      if (observer_ != nullptr) state.written_blocks_.insert(undo_record.Slot().GetBlock());
+    }
+  }
+}
+
 void GarbageCollector::ProcessDeferredActions(transaction::timestamp_t oldest_txn) {
   if (deferred_action_manager_ != DISABLED) {
     // TODO(Tianyu): Eventually we will remove the GC and implement version chain pruning with deferred actions
@@ -132,8 +188,10 @@ void GarbageCollector::TruncateVersionChain(DataTable *const table, const TupleS
     return;
   }
 
-  // a version chain is guaranteed to not change when not at the head (assuming single-threaded GC), so we are safe
-  // to traverse and update pointers without CAS
+  // a version chain is guaranteed to not change when not at the head, other than being truncated, so we are safe to
+  // traverse and update pointers without CAS. Besides us, readers and writers of the tuple can truncate it (see
+  // DataTable::PruneVersionChain), but everyone only ever cuts off versions that are invisible to all running
+  // transactions, so it does not matter who gets there first.
   UndoRecord *curr = version_ptr;
   UndoRecord *next;
   // Traverse until we find the earliest UndoRecord that can be unlinked.
@@ -159,8 +217,9 @@ void GarbageCollector::ReclaimSlotIfDeleted(UndoRecord *const undo_record) const
   if (undo_record->Type() == DeltaRecordType::DELETE) undo_record->Table()->accessor_.Deallocate(undo_record->Slot());
 }
 
-void GarbageCollector::ReclaimBufferIfVarlen(transaction::TransactionContext *const txn,
-                                             UndoRecord *const undo_record) const {
+void GarbageCollector::ReclaimBufferIfVarlen(
+    transaction::TransactionContext *const txn, UndoRecord *const undo_record,
+    std::vector<std::pair<transaction::TransactionContext *, const byte *>> *const loose_ptrs) const {
   const TupleAccessStrategy &accessor = undo_record->Table()->accessor_;
   const BlockLayout &layout = accessor.GetBlockLayout();
   switch (undo_record->Type()) {
@@ -173,7 +232,7 @@ void GarbageCollector::ReclaimBufferIfVarlen(transaction::TransactionContext *co
         // Okay to include version vector, as it is never varlen
         if (layout.IsVarlen(col_id)) {
           auto *varlen = reinterpret_cast<VarlenEntry *>(accessor.AccessWithNullCheck(undo_record->Slot(), col_id));
-          if (varlen != nullptr && varlen->NeedReclaim()) txn->loose_ptrs_.push_back(varlen->Content());
+          if (varlen != nullptr && varlen->NeedReclaim()) loose_ptrs->emplace_back(txn, varlen->Content());
         }
       }
       break;
@@ -183,7 +242,7 @@ void GarbageCollector::ReclaimBufferIfVarlen(transaction::TransactionContext *co
         col_id_t col_id = undo_record->Delta()->ColumnIds()[i];
         if (layout.IsVarlen(col_id)) {
           auto *varlen = reinterpret_cast<VarlenEntry *>(undo_record->Delta()->AccessWithNullCheck(i));
-          if (varlen != nullptr && varlen->NeedReclaim()) txn->loose_ptrs_.push_back(varlen->Content());
+          if (varlen != nullptr && varlen->NeedReclaim()) loose_ptrs->emplace_back(txn, varlen->Content());
         }
       }
       break;
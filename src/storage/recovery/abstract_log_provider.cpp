@@ -25,12 +25,12 @@ std::pair<LogRecord *, std::vector<byte *>> AbstractLogProvider::ReadNextRecord(
       // is_read_only argument is set to false, because we do not write out a commit record for a transaction if it is
       // not read-only.
       return {storage::CommitRecord::Initialize(buf, txn_begin, txn_commit, nullptr, nullptr, oldest_active_txn, false,
-                                                nullptr, nullptr),
+                                                nullptr, nullptr, 0),
               varlen_contents};
     }
 
     case (storage::LogRecordType::ABORT): {
-      return {storage::AbortRecord::Initialize(buf, txn_begin, nullptr, nullptr), varlen_contents};
+      return {storage::AbortRecord::Initialize(buf, txn_begin, nullptr, nullptr, 0), varlen_contents};
     }
 
     case (storage::LogRecordType::DELETE): {
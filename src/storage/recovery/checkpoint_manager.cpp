@@ -0,0 +1,225 @@
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "storage/recovery/checkpoint_manager.h"
+
+#include "catalog/database_catalog.h"
+#include "catalog/postgres/pg_attribute.h"
+#include "catalog/postgres/pg_class.h"
+#include "catalog/postgres/pg_constraint.h"
+#include "catalog/postgres/pg_database.h"
+#include "catalog/postgres/pg_index.h"
+#include "catalog/postgres/pg_namespace.h"
+#include "catalog/postgres/pg_type.h"
+#include "loggers/storage_logger.h"
+#include "storage/write_ahead_log/log_serializer_task.h"
+#include "transaction/transaction_util.h"
+
+namespace terrier::storage {
+
+transaction::timestamp_t CheckpointManager::TakeCheckpoint() {
+  // Step 1: Find where the log ends right now. Every txn that has records before this point began before log_time.
+  const uint64_t log_offset = (log_manager_ != DISABLED) ? log_manager_->SerializedLogFileOffset() : 0;
+  const transaction::timestamp_t log_time = timestamp_manager_->CurrentTime();
+
+  // Step 2: Wait for those txns to finish, without blocking anyone. Each of them then either aborted or committed
+  // before the snapshot begins, so its changes are in the checkpoint and recovery does not need the log before
+  // log_offset.
+  while (timestamp_manager_->OldestTransactionStartTime() < log_time) std::this_thread::sleep_for(WAIT_INTERVAL);
+
+  // Step 3: Write everything the snapshot txn sees to a temporary file
+  auto *const txn = txn_manager_->BeginTransaction();
+  const transaction::timestamp_t checkpoint_timestamp = txn->StartTime();
+  const std::string tmp_file_path = checkpoint_file_path_ + ".tmp";
+  unlink(tmp_file_path.c_str());  // BufferedLogWriter appends to existing files
+  BufferedLogWriter out(tmp_file_path.c_str());
+  out_ = &out;
+  checkpoint_txn_ = transaction::timestamp_t(0);
+  checkpoint_txn_records_ = 0;
+  out.BufferWrite(&checkpoint_timestamp, sizeof(checkpoint_timestamp));
+  out.BufferWrite(&log_offset, sizeof(log_offset));
+
+  auto *const databases = catalog_->databases_;
+  const auto pr_init = databases->InitializerForProjectedRow({catalog::postgres::DATOID_COL_OID});
+  auto *const buffer = common::AllocationUtil::AllocateAligned(pr_init.ProjectedRowSize());
+  for (const TupleSlot slot : *databases) {
+    auto *const pr = pr_init.InitializeRow(buffer);
+    if (!databases->Select(txn, slot, pr)) continue;
+    WriteDatabase(txn, *reinterpret_cast<catalog::db_oid_t *>(pr->AccessWithNullCheck(0)), slot);
+  }
+  delete[] buffer;
+  txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  FlushSerializedRecords();
+  out.FlushBuffer();
+  out.Persist();
+  out.Close();
+  out_ = nullptr;
+
+  // Step 4: Make sure the log is persistent up to the checkpoint, then atomically replace the previous checkpoint.
+  // Syncing the directory makes the rename itself persistent.
+  if (log_manager_ != DISABLED) log_manager_->ForceFlush();
+  if (std::rename(tmp_file_path.c_str(), checkpoint_file_path_.c_str()) != 0) {
+    throw std::runtime_error("Failed to rename checkpoint file with errno " + std::to_string(errno));
+  }
+  const auto dir_end = checkpoint_file_path_.find_last_of('/');
+  const std::string dir = (dir_end == std::string::npos) ? "." : checkpoint_file_path_.substr(0, dir_end + 1);
+  const int dir_fd = PosixIoWrappers::Open(dir.c_str(), O_RDONLY);
+  if (fsync(dir_fd) == -1) throw std::runtime_error("fsync failed with errno " + std::to_string(errno));
+  PosixIoWrappers::Close(dir_fd);
+
+  // Step 5: The log before log_offset is now covered by the checkpoint
+  if (log_manager_ != DISABLED) TruncateLog(log_offset);
+  return checkpoint_timestamp;
+}
+
+void CheckpointManager::WriteDatabase(transaction::TransactionContext *const txn, const catalog::db_oid_t db_oid,
+                                      const TupleSlot db_slot) {
+  auto db_catalog = catalog_->GetDatabaseCatalog(txn, db_oid);
+  TERRIER_ASSERT(db_catalog != nullptr, "Database visible in pg_database must have a catalog");
+
+  // The database and its catalog are written in a single txn. Recovery recreates the database when replaying its insert
+  // into pg_database, then inserts the catalog rows, then recreates every table and index from them.
+  const auto &db_pr_init = catalog_->pg_database_all_cols_pri_;
+  auto *const buffer = common::AllocationUtil::AllocateAligned(RedoRecord::Size(db_pr_init));
+  auto *const record = RedoRecord::Initialize(buffer, checkpoint_txn_, catalog::INVALID_DATABASE_OID,
+                                              catalog::postgres::DATABASE_TABLE_OID, db_pr_init);
+  auto *const redo = record->GetUnderlyingRecordBodyAs<RedoRecord>();
+  bool visible UNUSED_ATTRIBUTE = catalog_->databases_->Select(txn, db_slot, redo->Delta());
+  TERRIER_ASSERT(visible, "Database must still be visible to the snapshot");
+  redo->SetTupleSlot(db_slot);
+  WriteRecord(*record);
+  delete[] buffer;
+
+  WriteCatalogTable(txn, db_oid, catalog::postgres::NAMESPACE_TABLE_OID, db_catalog->namespaces_,
+                    catalog::postgres::PG_NAMESPACE_ALL_COL_OIDS);
+  WriteCatalogTable(txn, db_oid, catalog::postgres::CLASS_TABLE_OID, db_catalog->classes_,
+                    catalog::postgres::PG_CLASS_ALL_COL_OIDS);
+  WriteCatalogTable(txn, db_oid, catalog::postgres::COLUMN_TABLE_OID, db_catalog->columns_,
+                    catalog::postgres::PG_ATTRIBUTE_ALL_COL_OIDS);
+  WriteCatalogTable(txn, db_oid, catalog::postgres::INDEX_TABLE_OID, db_catalog->indexes_,
+                    catalog::postgres::PG_INDEX_ALL_COL_OIDS);
+  WriteCatalogTable(txn, db_oid, catalog::postgres::TYPE_TABLE_OID, db_catalog->types_,
+                    catalog::postgres::PG_TYPE_ALL_COL_OIDS);
+  WriteCatalogTable(txn, db_oid, catalog::postgres::CONSTRAINT_TABLE_OID, db_catalog->constraints_,
+                    catalog::postgres::PG_CONSTRAINT_ALL_COL_OIDS);
+  const auto user_tables = WriteClassPointers(txn, db_oid, db_catalog->classes_);
+  CommitCheckpointTxn();
+
+  // User tables only need to be inserted into, so their tuples are spread over txns recovery can replay in parallel
+  for (const auto table_oid : user_tables) {
+    std::vector<catalog::col_oid_t> col_oids;
+    for (const auto &column : db_catalog->GetSchema(txn, table_oid).GetColumns()) col_oids.emplace_back(column.Oid());
+    WriteTable(txn, db_oid, table_oid, db_catalog->GetTable(txn, table_oid).operator->(), col_oids, true);
+  }
+  if (checkpoint_txn_records_ > 0) CommitCheckpointTxn();
+}
+
+void CheckpointManager::WriteTable(transaction::TransactionContext *const txn, const catalog::db_oid_t db_oid,
+                                   const catalog::table_oid_t table_oid, SqlTable *const table,
+                                   const std::vector<catalog::col_oid_t> &col_oids, const bool split_txns) {
+  const auto pr_init = table->InitializerForProjectedRow(col_oids);
+  // Tables and indexes are recreated when replaying the pointer updates written by WriteClassPointers, so rows of
+  // pg_class are inserted without a pointer, like they are when a table or index is created
+  const bool is_pg_class = table_oid == catalog::postgres::CLASS_TABLE_OID;
+  const uint16_t ptr_offset =
+      is_pg_class ? table->ProjectionMapForOids(col_oids)[catalog::postgres::REL_PTR_COL_OID] : 0;
+
+  auto *const buffer = common::AllocationUtil::AllocateAligned(RedoRecord::Size(pr_init));
+  for (const TupleSlot slot : *table) {
+    if (split_txns && checkpoint_txn_records_ == CHECKPOINT_TXN_SIZE) CommitCheckpointTxn();
+    auto *const record = RedoRecord::Initialize(buffer, checkpoint_txn_, db_oid, table_oid, pr_init);
+    auto *const redo = record->GetUnderlyingRecordBodyAs<RedoRecord>();
+    if (!table->Select(txn, slot, redo->Delta())) continue;
+    redo->SetTupleSlot(slot);
+    if (is_pg_class) redo->Delta()->SetNull(ptr_offset);
+    WriteRecord(*record);
+  }
+  delete[] buffer;
+}
+
+std::vector<catalog::table_oid_t> CheckpointManager::WriteClassPointers(transaction::TransactionContext *const txn,
+                                                                        const catalog::db_oid_t db_oid,
+                                                                        SqlTable *const classes) {
+  const std::vector<catalog::col_oid_t> col_oids{catalog::postgres::RELOID_COL_OID, catalog::postgres::RELKIND_COL_OID,
+                                                 catalog::postgres::REL_PTR_COL_OID};
+  const auto pr_init = classes->InitializerForProjectedRow(col_oids);
+  auto pr_map = classes->ProjectionMapForOids(col_oids);
+  const auto ptr_pr_init = classes->InitializerForProjectedRow({catalog::postgres::REL_PTR_COL_OID});
+
+  auto *const buffer = common::AllocationUtil::AllocateAligned(pr_init.ProjectedRowSize());
+  auto *const record_buffer = common::AllocationUtil::AllocateAligned(RedoRecord::Size(ptr_pr_init));
+  std::vector<catalog::table_oid_t> user_tables;
+  for (const TupleSlot slot : *classes) {
+    auto *const pr = pr_init.InitializeRow(buffer);
+    if (!classes->Select(txn, slot, pr)) continue;
+    // Objects whose pointer was never set cannot be used, so there is nothing to recreate
+    const auto *const ptr = pr->AccessWithNullCheck(pr_map[catalog::postgres::REL_PTR_COL_OID]);
+    if (ptr == nullptr) continue;
+
+    auto *const record =
+        RedoRecord::Initialize(record_buffer, checkpoint_txn_, db_oid, catalog::postgres::CLASS_TABLE_OID, ptr_pr_init);
+    auto *const redo = record->GetUnderlyingRecordBodyAs<RedoRecord>();
+    redo->SetTupleSlot(slot);
+    *reinterpret_cast<uintptr_t *>(redo->Delta()->AccessForceNotNull(0)) = *reinterpret_cast<const uintptr_t *>(ptr);
+    WriteRecord(*record);
+
+    const auto class_oid =
+        *reinterpret_cast<uint32_t *>(pr->AccessWithNullCheck(pr_map[catalog::postgres::RELOID_COL_OID]));
+    const auto class_kind = *reinterpret_cast<catalog::postgres::ClassKind *>(
+        pr->AccessWithNullCheck(pr_map[catalog::postgres::RELKIND_COL_OID]));
+    // All catalog tables have OIDS less than START_OID, and are already written with the catalog
+    if (class_kind == catalog::postgres::ClassKind::REGULAR_TABLE && class_oid >= catalog::START_OID) {
+      user_tables.emplace_back(class_oid);
+    }
+  }
+  delete[] record_buffer;
+  delete[] buffer;
+  return user_tables;
+}
+
+void CheckpointManager::WriteRecord(const LogRecord &record) {
+  LogSerializerTask::SerializeRecord(record, &serialized_);
+  checkpoint_txn_records_++;
+  if (serialized_.size() >= common::Constants::LOG_BUFFER_SIZE) FlushSerializedRecords();
+}
+
+void CheckpointManager::CommitCheckpointTxn() {
+  auto *const buffer = common::AllocationUtil::AllocateAligned(CommitRecord::Size());
+  // Checkpoint txns never overlap, so each of them is the oldest active txn when it commits
+  auto *const record = CommitRecord::Initialize(buffer, checkpoint_txn_, checkpoint_txn_, nullptr, nullptr,
+                                                checkpoint_txn_, false, nullptr, nullptr, 0);
+  WriteRecord(*record);
+  delete[] buffer;
+  checkpoint_txn_++;
+  checkpoint_txn_records_ = 0;
+}
+
+void CheckpointManager::FlushSerializedRecords() {
+  const auto size = static_cast<uint32_t>(serialized_.size());
+  uint32_t size_written = 0;
+  while (size_written < size) {
+    size_written += out_->BufferWrite(serialized_.data() + size_written, size - size_written);
+    if (out_->IsBufferFull()) out_->FlushBuffer();
+  }
+  serialized_.clear();
+}
+
+void CheckpointManager::TruncateLog(const uint64_t log_offset) {
+#ifdef FALLOC_FL_PUNCH_HOLE
+  if (log_offset == 0) return;
+  // Punching a hole frees the disk space without moving the rest of the log, which the log manager keeps appending to
+  const int log_fd = PosixIoWrappers::Open(log_manager_->LogFilePath().c_str(), O_WRONLY);
+  if (fallocate(log_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(log_offset)) == -1) {
+    STORAGE_LOG_WARN("Failed to truncate log file with errno {}", errno);
+  }
+  PosixIoWrappers::Close(log_fd);
+#endif
+}
+
+}  // namespace terrier::storage
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -19,10 +20,30 @@
 
 namespace terrier::storage {
 
-void RecoveryManager::RecoverFromLogs() {
+void RecoveryManager::Recover() {
+  // With more than one replay thread, batches of committed txns are applied on a worker pool
+  if (num_replay_threads_ > 1) {
+    replay_pool_ = std::make_unique<common::WorkerPool>(num_replay_threads_, common::TaskQueue{});
+  }
+  if (checkpoint_provider_ != nullptr) RecoverFromCheckpoint();
+  RecoverFromLogs();
+  replay_pool_.reset();
+}
+
+void RecoveryManager::RecoverFromCheckpoint() {
+  defer_user_indexes_ = true;
+  ReplayLogs(checkpoint_provider_);
+  defer_user_indexes_ = false;
+  BulkLoadDeferredIndexes();
+  checkpoint_timestamp_ = checkpoint_provider_->CheckpointTimestamp();
+}
+
+void RecoveryManager::RecoverFromLogs() { ReplayLogs(log_provider_); }
+
+void RecoveryManager::ReplayLogs(AbstractLogProvider *const log_provider) {
   // Replay logs until the log provider no longer gives us logs
   while (true) {
-    auto pair = log_provider_->GetNextRecord();
+    auto pair = log_provider->GetNextRecord();
     auto *log_record = pair.first;
 
     // If we have exhausted all the logs, break from the loop
@@ -41,6 +62,15 @@ void RecoveryManager::RecoverFromLogs() {
         TERRIER_ASSERT(pair.second.empty(), "Commit records should not have any varlen pointers");
         auto *commit_record = log_record->GetUnderlyingRecordBodyAs<CommitRecord>();
 
+        // Txns that committed before the checkpoint was taken are already contained in it, so we skip them like
+        // aborted txns. Their records from before the checkpoint's log file offset were never read in.
+        if (commit_record->CommitTime() < checkpoint_timestamp_) {
+          DeferRecordDeletes(log_record->TxnBegin(), true);
+          buffered_changes_map_.erase(log_record->TxnBegin());
+          deferred_action_manager_->RegisterDeferredAction([=] { delete[] reinterpret_cast<byte *>(log_record); });
+          break;
+        }
+
         // We defer all transactions initially
         deferred_txns_.insert(log_record->TxnBegin());
 
@@ -56,12 +86,18 @@ void RecoveryManager::RecoverFromLogs() {
         TERRIER_ASSERT(
             log_record->RecordType() == LogRecordType::REDO || log_record->RecordType() == LogRecordType::DELETE,
             "We should only buffer changes for redo or delete records");
+        if (defer_user_indexes_ && log_record->RecordType() == LogRecordType::REDO) {
+          auto *redo_record = log_record->GetUnderlyingRecordBodyAs<RedoRecord>();
+          if ((!redo_record->GetTableOid()) >= catalog::START_OID)
+            deferred_index_tables_.emplace(redo_record->GetDatabaseOid(), redo_record->GetTableOid());
+        }
         buffered_changes_map_[log_record->TxnBegin()].push_back(pair);
     }
   }
   // Process all deferred txns
   ProcessDeferredTransactions(transaction::INVALID_TXN_TIMESTAMP);
   TERRIER_ASSERT(deferred_txns_.empty(), "We should have no unprocessed deferred transactions at the end of recovery");
+  if (replay_pool_ != nullptr) ReplayBatchedTransactions();
 
   // If we have unprocessed buffered changes, then these transactions were in-process at the time of system shutdown.
   // They are unrecoverable, so we need to clean up the memory of their records.
@@ -74,8 +110,24 @@ void RecoveryManager::RecoverFromLogs() {
 }
 
 void RecoveryManager::ProcessCommittedTransaction(terrier::transaction::timestamp_t txn_id) {
+  if (replay_pool_ != nullptr) {
+    if (!ModifiesCatalog(txn_id)) {
+      BatchCommittedTransaction(txn_id);
+      if (batched_txns_.size() >= REPLAY_BATCH_SIZE) ReplayBatchedTransactions();
+      return;
+    }
+    // Catalog changes are a barrier. Everything before them must be applied, and the tables or indexes they create
+    // and drop change how later txns are partitioned.
+    ReplayBatchedTransactions();
+    slot_partitioned_tables_.clear();
+  }
+  ReplayCommittedTransaction(txn_id);
+}
+
+void RecoveryManager::ReplayCommittedTransaction(terrier::transaction::timestamp_t txn_id) {
   // Begin a txn to replay changes with.
   auto *txn = txn_manager_->BeginTransaction();
+  std::vector<TupleSlot> erased_slots;
 
   // Apply all buffered changes. They should all succeed. After applying we can safely delete the record
   for (uint32_t idx = 0; idx < buffered_changes_map_[txn_id].size(); idx++) {
@@ -90,6 +142,7 @@ void RecoveryManager::ProcessCommittedTransaction(terrier::transaction::timestam
       ReplayRedoRecord(txn, buffered_record);
     } else {
       ReplayDeleteRecord(txn, buffered_record);
+      erased_slots.push_back(buffered_record->GetUnderlyingRecordBodyAs<DeleteRecord>()->GetTupleSlot());
     }
   }
 
@@ -99,6 +152,113 @@ void RecoveryManager::ProcessCommittedTransaction(terrier::transaction::timestam
 
   // Commit the txn
   txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  for (const auto &slot : erased_slots) PurgeTupleSlotMapping(slot);
+}
+
+bool RecoveryManager::ModifiesCatalog(terrier::transaction::timestamp_t txn_id) {
+  for (const auto &buffered_pair : buffered_changes_map_[txn_id]) {
+    auto *record = buffered_pair.first;
+    auto table_oid = (record->RecordType() == LogRecordType::REDO)
+                         ? record->GetUnderlyingRecordBodyAs<RedoRecord>()->GetTableOid()
+                         : record->GetUnderlyingRecordBodyAs<DeleteRecord>()->GetTableOid();
+    // All catalog tables have OIDS less than START_OID
+    if ((!table_oid) < catalog::START_OID) return true;
+  }
+  return false;
+}
+
+void RecoveryManager::BatchCommittedTransaction(terrier::transaction::timestamp_t txn_id) {
+  // Partitions this txn has already started a record list in
+  std::set<ReplayPartition> txn_partitions;
+  for (const auto &buffered_pair : buffered_changes_map_[txn_id]) {
+    auto *record = buffered_pair.first;
+    catalog::db_oid_t db_oid;
+    catalog::table_oid_t table_oid;
+    TupleSlot slot;
+    if (record->RecordType() == LogRecordType::REDO) {
+      auto *redo_record = record->GetUnderlyingRecordBodyAs<RedoRecord>();
+      db_oid = redo_record->GetDatabaseOid();
+      table_oid = redo_record->GetTableOid();
+      slot = redo_record->GetTupleSlot();
+    } else {
+      auto *delete_record = record->GetUnderlyingRecordBodyAs<DeleteRecord>();
+      db_oid = delete_record->GetDatabaseOid();
+      table_oid = delete_record->GetTableOid();
+      slot = delete_record->GetTupleSlot();
+    }
+
+    // All changes to a tuple carry its old tuple slot, so they land in the same partition and are applied in order
+    uint32_t slot_partition =
+        IsSlotPartitioned(db_oid, table_oid) ? std::hash<TupleSlot>()(slot) % num_replay_threads_ : 0;
+    ReplayPartition partition{db_oid, table_oid, slot_partition};
+    auto &partition_txns = batched_changes_[partition];
+    if (txn_partitions.insert(partition).second) partition_txns.emplace_back();
+    partition_txns.back().push_back(record);
+  }
+  batched_txns_.push_back(txn_id);
+}
+
+void RecoveryManager::ReplayBatchedTransactions() {
+  if (batched_txns_.empty()) return;
+
+  std::vector<std::vector<TupleSlot>> erased_slots(batched_changes_.size());
+  uint32_t task_idx = 0;
+  for (auto &partition : batched_changes_) {
+    auto *txns = &partition.second;
+    auto *task_erased_slots = &erased_slots[task_idx++];
+    replay_pool_->SubmitTask([=] { ReplayPartitionChanges(txns, task_erased_slots); });
+  }
+  replay_pool_->WaitUntilAllFinished();
+
+  // No worker is running anymore, so we can clean up the mappings of deleted tuples and the batched records
+  for (const auto &task_erased_slots : erased_slots) {
+    for (const auto &slot : task_erased_slots) PurgeTupleSlotMapping(slot);
+  }
+  for (const auto txn_id : batched_txns_) {
+    DeferRecordDeletes(txn_id, false);
+    buffered_changes_map_.erase(txn_id);
+  }
+  batched_changes_.clear();
+  batched_txns_.clear();
+}
+
+void RecoveryManager::ReplayPartitionChanges(std::vector<std::vector<LogRecord *>> *txns,
+                                             std::vector<TupleSlot> *erased_slots) {
+  for (const auto &records : *txns) {
+    auto *txn = txn_manager_->BeginTransaction();
+    for (auto *record : records) {
+      if (record->RecordType() == LogRecordType::REDO) {
+        ReplayRedoRecord(txn, record);
+      } else {
+        ReplayDeleteRecord(txn, record);
+        erased_slots->push_back(record->GetUnderlyingRecordBodyAs<DeleteRecord>()->GetTupleSlot());
+      }
+    }
+    txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  }
+}
+
+bool RecoveryManager::IsSlotPartitioned(const catalog::db_oid_t db_oid, const catalog::table_oid_t table_oid) {
+  // Without index maintenance, the inserts of a checkpoint can be applied in any order
+  if (defer_user_indexes_) return true;
+
+  auto it = slot_partitioned_tables_.find({db_oid, table_oid});
+  if (it != slot_partitioned_tables_.end()) return it->second;
+
+  // Changes to different tuples of a table with a unique index can't be reordered. A delete of a key and a later
+  // insert of the same key may have different old tuple slots.
+  auto *txn = txn_manager_->BeginTransaction();
+  bool slot_partitioned = true;
+  for (const auto &index_obj : GetDatabaseCatalog(txn, db_oid)->GetIndexes(txn, table_oid)) {
+    if (index_obj.second.Unique()) {
+      slot_partitioned = false;
+      break;
+    }
+  }
+  txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  slot_partitioned_tables_[{db_oid, table_oid}] = slot_partitioned;
+  return slot_partitioned;
 }
 
 void RecoveryManager::DeferRecordDeletes(terrier::transaction::timestamp_t txn_id, bool delete_varlens) {
@@ -154,9 +314,9 @@ void RecoveryManager::ReplayRedoRecord(transaction::TransactionContext *txn, Log
     TERRIER_ASSERT(staged_record->GetTupleSlot() == new_tuple_slot,
                    "Insert should update redo record with new tuple slot");
     // Create a mapping of the old to new tuple. The new tuple slot should be used for future updates and deletes.
-    tuple_slot_map_[old_tuple_slot] = new_tuple_slot;
+    SetTupleSlotMapping(old_tuple_slot, new_tuple_slot);
   } else {
-    auto new_tuple_slot = tuple_slot_map_[redo_record->GetTupleSlot()];
+    auto new_tuple_slot = GetTupleSlotMapping(redo_record->GetTupleSlot());
     redo_record->SetTupleSlot(new_tuple_slot);
     // Stage the write. This way the recovery operation is logged if logging is enabled
     auto staged_record = txn->StageRecoveryWrite(record);
@@ -194,15 +354,33 @@ void RecoveryManager::ReplayDeleteRecord(transaction::TransactionContext *txn, L
   // Delete from the indexes
   UpdateIndexesOnTable(txn, delete_record->GetDatabaseOid(), delete_record->GetTableOid(), sql_table_ptr,
                        new_tuple_slot, pr, false /* delete */);
-  // We can delete the TupleSlot from the map
-  tuple_slot_map_.erase(delete_record->GetTupleSlot());
+  // We can delete the TupleSlot from the map. Erasing is not safe while replay workers use the map, so we invalidate
+  // the mapping here and the caller purges it.
+  tuple_slot_map_.Find(delete_record->GetTupleSlot())->second = TupleSlot(nullptr, 0);
   delete[] buffer;
 }
 
+void RecoveryManager::BulkLoadDeferredIndexes() {
+  for (const auto &table : deferred_index_tables_) {
+    auto *txn = txn_manager_->BeginTransaction();
+    auto db_catalog_ptr = GetDatabaseCatalog(txn, table.first);
+    auto sql_table_ptr = db_catalog_ptr->GetTable(txn, table.second);
+    for (const auto &index_obj : db_catalog_ptr->GetIndexes(txn, table.second)) {
+      bool result UNUSED_ATTRIBUTE = index_obj.first->BulkLoad(txn, sql_table_ptr, replay_pool_.get());
+      TERRIER_ASSERT(result, "Bulk load of an index should always succeed for a checkpointed table");
+    }
+    txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  }
+  deferred_index_tables_.clear();
+}
+
 void RecoveryManager::UpdateIndexesOnTable(transaction::TransactionContext *txn, catalog::db_oid_t db_oid,
                                            catalog::table_oid_t table_oid,
                                            common::ManagedPointer<storage::SqlTable> table_ptr,
                                            const TupleSlot &tuple_slot, ProjectedRow *table_pr, const bool insert) {
+  // Indexes on user tables are bulk loaded after the checkpoint has been replayed
+  if (defer_user_indexes_ && (!table_oid) >= catalog::START_OID) return;
+
   auto db_catalog_ptr = GetDatabaseCatalog(txn, db_oid);
 
   // Stores index objects and schemas
@@ -431,7 +609,7 @@ uint32_t RecoveryManager::ProcessSpecialCasePGDatabaseRecord(
     std::vector<TupleSlot> tuple_slot_result;
     pg_database_oid_index->ScanKey(*txn, *pr, &tuple_slot_result);
     TERRIER_ASSERT(tuple_slot_result.size() == 1, "Index scan should only yield one result");
-    tuple_slot_map_[redo_record->GetTupleSlot()] = tuple_slot_result[0];
+    SetTupleSlotMapping(redo_record->GetTupleSlot(), tuple_slot_result[0]);
     delete[] buffer;
 
     return 0;  // No additional records processed
@@ -494,9 +672,9 @@ uint32_t RecoveryManager::ProcessSpecialCasePGDatabaseRecord(
           std::vector<TupleSlot> tuple_slot_result;
           pg_database_oid_index->ScanKey(*txn, *pr, &tuple_slot_result);
           TERRIER_ASSERT(tuple_slot_result.size() == 1, "Index scan should only yield one result");
-          tuple_slot_map_[next_redo_record->GetTupleSlot()] = tuple_slot_result[0];
+          SetTupleSlotMapping(next_redo_record->GetTupleSlot(), tuple_slot_result[0]);
           delete[] buffer;
-          tuple_slot_map_.erase(delete_record->GetTupleSlot());
+          tuple_slot_map_.UnsafeErase(delete_record->GetTupleSlot());
           delete[] reinterpret_cast<byte *>(next_redo_record);
 
           return 1;  // We processed an additional record
@@ -510,7 +688,7 @@ uint32_t RecoveryManager::ProcessSpecialCasePGDatabaseRecord(
   TERRIER_ASSERT(result, "Database deletion should succeed");
 
   // Step 4: Clean up any metadata
-  tuple_slot_map_.erase(delete_record->GetTupleSlot());
+  tuple_slot_map_.UnsafeErase(delete_record->GetTupleSlot());
   return 0;  // No additional logs processed
 }
 
@@ -612,9 +790,9 @@ uint32_t RecoveryManager::ProcessSpecialCasePGClassRecord(
 
             // NOLINTNEXTLINE
             col_oids.clear();
-            col_oids = {catalog::postgres::INDISUNIQUE_COL_OID, catalog::postgres::INDISPRIMARY_COL_OID,
-                        catalog::postgres::INDISEXCLUSION_COL_OID, catalog::postgres::INDIMMEDIATE_COL_OID,
-                        catalog::postgres::IND_TYPE_COL_OID};
+            col_oids = {catalog::postgres::INDRELID_COL_OID,       catalog::postgres::INDISUNIQUE_COL_OID,
+                        catalog::postgres::INDISPRIMARY_COL_OID,   catalog::postgres::INDISEXCLUSION_COL_OID,
+                        catalog::postgres::INDIMMEDIATE_COL_OID,   catalog::postgres::IND_TYPE_COL_OID};
             auto pg_index_pr_init = db_catalog->indexes_->InitializerForProjectedRow(col_oids);
             auto pg_index_pr_map = db_catalog->indexes_->ProjectionMapForOids(col_oids);
             delete[] buffer;  // Delete old buffer, it won't be large enough for this PR
@@ -622,6 +800,8 @@ uint32_t RecoveryManager::ProcessSpecialCasePGClassRecord(
             pr = pg_index_pr_init.InitializeRow(buffer);
             bool result UNUSED_ATTRIBUTE = db_catalog->indexes_->Select(txn, tuple_slot_result[0], pr);
             TERRIER_ASSERT(result, "Select into pg_index should succeed during recovery");
+            catalog::table_oid_t table_oid = *(reinterpret_cast<catalog::table_oid_t *>(
+                pr->AccessWithNullCheck(pg_index_pr_map[catalog::postgres::INDRELID_COL_OID])));
             bool is_unique = *(reinterpret_cast<bool *>(
                 pr->AccessWithNullCheck(pg_index_pr_map[catalog::postgres::INDISUNIQUE_COL_OID])));
             bool is_primary = *(reinterpret_cast<bool *>(
@@ -644,7 +824,10 @@ uint32_t RecoveryManager::ProcessSpecialCasePGClassRecord(
             if (class_oid < catalog::START_OID) {  // All catalog tables/indexes have OIDS less than START_OID
               index = GetCatalogIndex(catalog::index_oid_t(class_oid), db_catalog);
             } else {
-              index = index::IndexBuilder().SetKeySchema(*index_schema).Build();
+              // The index covers the tuples its table already holds, e.g. when it was created on a filled table
+              index = index::IndexBuilder().SetKeySchema(*index_schema).BuildAndLoad(
+                  txn, GetSqlTable(txn, redo_record->GetDatabaseOid(), table_oid), replay_pool_.get());
+              TERRIER_ASSERT(index != nullptr, "Index creation should succeed for a committed transaction");
             }
             result = db_catalog->SetIndexPointer(txn, catalog::index_oid_t(class_oid), index);
             TERRIER_ASSERT(result, "Setting index pointer should succeed, entry should be in pg_class already");
@@ -736,9 +919,9 @@ uint32_t RecoveryManager::ProcessSpecialCasePGClassRecord(
           std::vector<TupleSlot> tuple_slot_result;
           pg_class_oid_index->ScanKey(*txn, *pr, &tuple_slot_result);
           TERRIER_ASSERT(tuple_slot_result.size() == 1, "Index scan should only yield one result");
-          tuple_slot_map_[next_redo_record->GetTupleSlot()] = tuple_slot_result[0];
+          SetTupleSlotMapping(next_redo_record->GetTupleSlot(), tuple_slot_result[0]);
           delete[] buffer;
-          tuple_slot_map_.erase(delete_record->GetTupleSlot());
+          tuple_slot_map_.UnsafeErase(delete_record->GetTupleSlot());
           delete[] reinterpret_cast<byte *>(next_redo_record);
 
           return 1;  // We processed an additional record
@@ -766,7 +949,7 @@ uint32_t RecoveryManager::ProcessSpecialCasePGClassRecord(
   TERRIER_ASSERT(result, "Table/index DROP should always succeed");
 
   // Step 5: Clean up metadata
-  tuple_slot_map_.erase(delete_record->GetTupleSlot());
+  tuple_slot_map_.UnsafeErase(delete_record->GetTupleSlot());
 
   return 0;  // No additional logs processed
 }
@@ -25,9 +25,12 @@ void TupleAccessStrategy::InitializeRawBlock(storage::DataTable *const data_tabl
                                              const layout_version_t layout_version) const {
   // Intentional unsafe cast
   raw->data_table_ = data_table;
+  raw->access_count_.store(0);
   raw->layout_version_ = layout_version;
   raw->insert_head_ = 0;
   raw->controller_.Initialize();
+  // The block may be reused from a dropped table, whose insertion lanes are gone
+  raw->insertion_lane_.store(0);
   auto *result = reinterpret_cast<TupleAccessStrategy::Block *>(raw);
   result->GetArrowBlockMetadata().Initialize(GetBlockLayout().NumColumns());
   for (uint16_t i = 0; i < layout_.NumColumns(); i++) result->AttrOffsets(layout_)[i] = column_offsets_[i];
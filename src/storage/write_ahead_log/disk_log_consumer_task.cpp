@@ -19,6 +19,19 @@ void DiskLogConsumerTask::Terminate() {
 void DiskLogConsumerTask::WriteBuffersToLogFile() {
   // Persist all the filled buffers to the disk
   SerializedLogs logs;
+  if (group_commit_) {
+    // Take every buffer that is ready now, and hand them to the kernel all at once
+    while (!filled_buffer_queue_->Empty()) {
+      filled_buffer_queue_->Dequeue(&logs);
+      buffers_in_flight_.push_back(logs.first);
+      commit_callbacks_.insert(commit_callbacks_.end(), logs.second.begin(), logs.second.end());
+    }
+    current_data_written_ += BufferedLogWriter::FlushBuffers(buffers_in_flight_);
+    for (auto *buffer : buffers_in_flight_) empty_buffer_queue_->Enqueue(buffer);
+    buffers_in_flight_.clear();
+    return;
+  }
+
   while (!filled_buffer_queue_->Empty()) {
     // Dequeue filled buffers and flush them to disk, as well as storing commit callbacks
     filled_buffer_queue_->Dequeue(&logs);
@@ -33,7 +46,10 @@ void DiskLogConsumerTask::PersistLogFile() {
   TERRIER_ASSERT(!buffers_->empty(), "Buffers vector should not be empty until Shutdown");
   // Force the buffers to be written to disk. Because all buffers log to the same file, it suffices to call persist on
   // any buffer.
-  buffers_->front().Persist();
+  if (group_commit_)
+    buffers_->front().PersistData();
+  else
+    buffers_->front().Persist();
   // Execute the callbacks for the transactions that have been persisted
   for (auto &callback : commit_callbacks_) callback.first(callback.second);
   commit_callbacks_.clear();
@@ -67,9 +83,11 @@ void DiskLogConsumerTask::DiskLogConsumerTaskLoop() {
     // 2) We have written more data since the last persist than the threshold
     // 3) We are signaled to persist
     // 4) We are shutting down this task
+    // 5) We are doing group commit and just wrote out commit records, whose callbacks should be released right away
     bool timeout = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() -
                                                                          last_persist) > persist_interval_;
-    if (timeout || current_data_written_ > persist_threshold_ || do_persist_ || !run_task_) {
+    bool commits_written = group_commit_ && !commit_callbacks_.empty();
+    if (timeout || current_data_written_ > persist_threshold_ || do_persist_ || !run_task_ || commits_written) {
       {
         std::unique_lock<std::mutex> lock(persist_lock_);
         PersistLogFile();
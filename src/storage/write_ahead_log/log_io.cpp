@@ -1,5 +1,7 @@
 #include "storage/write_ahead_log/log_io.h"
 #include <algorithm>
+#include <climits>
+#include <vector>
 namespace terrier::storage {
 void PosixIoWrappers::Close(int fd) {
   while (true) {
@@ -38,6 +40,55 @@ void PosixIoWrappers::WriteFully(int fd, const void *buf, size_t nbyte) {
   }
 }
 
+void PosixIoWrappers::WritevFully(int fd, struct iovec *iov, int iovcnt) {
+  while (iovcnt > 0) {
+    ssize_t ret = writev(fd, iov, iovcnt);
+    if (ret == -1) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error("Vectored write to log file failed with errno " + std::to_string(errno));
+    }
+    // Skip over the buffers that were fully written, and advance into the one that was partially written, if any
+    auto written = static_cast<size_t>(ret);
+    while (iovcnt > 0 && written >= iov->iov_len) {
+      written -= iov->iov_len;
+      iov++;
+      iovcnt--;
+    }
+    if (iovcnt > 0) {
+      iov->iov_base = reinterpret_cast<char *>(iov->iov_base) + written;
+      iov->iov_len -= written;
+    }
+  }
+}
+
+uint64_t BufferedLogWriter::FlushBuffers(const std::vector<BufferedLogWriter *> &writers) {
+  if (writers.empty()) return 0;
+  uint64_t size = 0;
+  std::vector<struct iovec> iovs;
+  iovs.reserve(writers.size());
+  for (auto *writer : writers) {
+    if (writer->buffer_size_ == 0) continue;
+    iovs.push_back({writer->buffer_, writer->buffer_size_});
+    size += writer->buffer_size_;
+    writer->buffer_size_ = 0;
+  }
+  // All writers append to the same file, so it does not matter which of their file descriptors we write through
+  const int out = writers.front()->out_;
+  for (size_t written = 0; written < iovs.size(); written += IOV_MAX) {
+    const auto count = static_cast<int>(std::min<size_t>(IOV_MAX, iovs.size() - written));
+    PosixIoWrappers::WritevFully(out, &iovs[written], count);
+  }
+  return size;
+}
+
+BufferedLogReader::BufferedLogReader(const char *log_file_path, const uint64_t offset)
+    : in_(PosixIoWrappers::Open(log_file_path, O_RDONLY)) {
+  if (offset != 0 && lseek(in_, static_cast<off_t>(offset), SEEK_SET) == -1) {
+    PosixIoWrappers::Close(in_);
+    throw std::runtime_error("Failed to seek in log file with errno " + std::to_string(errno));
+  }
+}
+
 bool BufferedLogReader::Read(void *dest, uint32_t size) {
   if (read_head_ + size <= filled_size_) {
     // bytes to read are already buffered.
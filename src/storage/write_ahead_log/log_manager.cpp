@@ -6,6 +6,10 @@ namespace terrier::storage {
 
 void LogManager::Start() {
   TERRIER_ASSERT(!run_log_manager_, "Can't call Start on already started LogManager");
+  // Logs are appended to an existing log file, so offsets of newly serialized records start at its current size
+  struct stat log_file_stat;
+  log_file_start_offset_ =
+      (stat(log_file_path_.c_str(), &log_file_stat) == 0) ? static_cast<uint64_t>(log_file_stat.st_size) : 0;
   // Initialize buffers for logging
   for (size_t i = 0; i < num_buffers_; i++) {
     buffers_.emplace_back(BufferedLogWriter(log_file_path_.c_str()));
@@ -18,13 +22,19 @@ void LogManager::Start() {
 
   // Register DiskLogConsumerTask
   disk_log_writer_task_ = thread_registry_->RegisterDedicatedThread<DiskLogConsumerTask>(
-      this /* requester */, persist_interval_, persist_threshold_, &buffers_, &empty_buffer_queue_,
+      this /* requester */, persist_interval_, persist_threshold_, group_commit_, &buffers_, &empty_buffer_queue_,
       &filled_buffer_queue_);
 
   // Register LogSerializerTask
   log_serializer_task_ = thread_registry_->RegisterDedicatedThread<LogSerializerTask>(
       this /* requester */, serialization_interval_, buffer_pool_, &empty_buffer_queue_, &filled_buffer_queue_,
       &disk_log_writer_task_->disk_log_writer_thread_cv_);
+  // Register LogSerializerWorkerTasks to serialize alongside it
+  TERRIER_ASSERT(num_serializer_threads_ > 0, "Need at least one thread to serialize logs");
+  for (uint64_t i = 1; i < num_serializer_threads_; i++) {
+    log_serializer_workers_.push_back(thread_registry_->RegisterDedicatedThread<LogSerializerWorkerTask>(
+        this /* requester */, log_serializer_task_.Get()));
+  }
 }
 
 void LogManager::ForceFlush() {
@@ -39,13 +49,26 @@ void LogManager::ForceFlush() {
   disk_log_writer_task_->persist_cv_.wait(lock, [&] { return !disk_log_writer_task_->do_persist_; });
 }
 
+uint64_t LogManager::SerializedLogFileOffset() {
+  TERRIER_ASSERT(run_log_manager_, "Can't call SerializedLogFileOffset on an un-started LogManager");
+  std::unique_lock<std::mutex> lock(log_serializer_task_->handoff_latch_);
+  return log_file_start_offset_ + log_serializer_task_->bytes_handed_off_;
+}
+
 void LogManager::PersistAndStop() {
   TERRIER_ASSERT(run_log_manager_, "Can't call PersistAndStop on an un-started LogManager");
   run_log_manager_ = false;
 
   // Signal all tasks to stop. The shutdown of the tasks will trigger any remaining logs to be serialized, writen to the
   // log file, and persisted. The order in which we shut down the tasks is important, we must first serialize, then
-  // shutdown the disk consumer task (reverse order of Start())
+  // shutdown the disk consumer task (reverse order of Start()). The serializer task is stopped after its workers, so it
+  // serializes whatever they left in the flush queue.
+  for (const auto &worker : log_serializer_workers_) {
+    auto result UNUSED_ATTRIBUTE =
+        thread_registry_->StopTask(this, worker.CastManagedPointerTo<common::DedicatedThreadTask>());
+    TERRIER_ASSERT(result, "LogSerializerWorkerTask should have been stopped");
+  }
+  log_serializer_workers_.clear();
   auto result UNUSED_ATTRIBUTE =
       thread_registry_->StopTask(this, log_serializer_task_.CastManagedPointerTo<common::DedicatedThreadTask>());
   TERRIER_ASSERT(result, "LogSerializerTask should have been stopped");
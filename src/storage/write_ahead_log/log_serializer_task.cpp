@@ -8,7 +8,7 @@
 
 namespace terrier::storage {
 
-void LogSerializerTask::LogSerializerTaskLoop() {
+void LogSerializerTask::LogSerializerTaskLoop(const bool *const run_task) {
   auto curr_sleep = serialization_interval_;
   // TODO(Gus): Make max back-off a settings manager setting
   const auto max_sleep =
@@ -22,58 +22,91 @@ void LogSerializerTask::LogSerializerTaskLoop() {
     // buffers. We cap the maximum back-off, since in the case of large gaps of no txns, we don't want to unboundedly
     // sleep
     curr_sleep = std::min(Process() ? serialization_interval_ : curr_sleep * 2, max_sleep);
-  } while (run_task_);
+  } while (*run_task);
   // To be extra sure we processed everything
   Process();
-  TERRIER_ASSERT(flush_queue_.empty(), "Termination of LogSerializerTask should hand off all buffers to consumers");
 }
 
 bool LogSerializerTask::Process() {
-  common::SpinLatch::ScopedSpinLatch serialization_guard(&serialization_latch_);
   bool buffers_processed = false;
-  TERRIER_ASSERT(serialized_txns_.empty(), "Aggregated txn timestamps should have been handed off to TimestampManager");
-  // We continually grab all the buffers until we find there are no new buffers. This way we serialize buffers that came
-  // in during the previous serialization loop
+  SerializationBatch batch;
+  uint64_t batches_dequeued;
+  // We continually grab batches of buffers until we find there are no new buffers. This way we serialize buffers that
+  // came in during the previous serialization loop
 
   // Continually loop, break out if there's no new buffers
   while (true) {
-    // In a short critical section, get all buffers to serialize. We move them to a temp queue to reduce contention on
-    // the queue transactions interact with
+    // In a short critical section, get a batch of buffers to serialize. We move them to the batch to reduce contention
+    // on the queue transactions interact with
     {
       common::SpinLatch::ScopedSpinLatch queue_guard(&flush_queue_latch_);
+      batches_dequeued = batches_dequeued_;
 
       // There are no new buffers, so we can break
       if (flush_queue_.empty()) break;
 
-      temp_flush_queue_ = std::move(flush_queue_);
-      flush_queue_ = std::queue<RecordBufferSegment *>();
+      while (!flush_queue_.empty() && batch.buffers_.size() < MAX_BUFFERS_PER_BATCH) {
+        batch.buffers_.push_back(flush_queue_.front());
+        flush_queue_.pop();
+      }
+      batch.id_ = batches_dequeued_++;
     }
 
-    // Loop over all the new buffers we found
-    while (!temp_flush_queue_.empty()) {
-      RecordBufferSegment *buffer = temp_flush_queue_.front();
-      temp_flush_queue_.pop();
-
-      // Serialize the Redo buffer and release it to the buffer pool
+    // Serialize the Redo buffers and release them to the buffer pool. This is where the work is, and it is done
+    // concurrently with the other serializing threads.
+    for (RecordBufferSegment *buffer : batch.buffers_) {
       IterableBufferSegment<LogRecord> task_buffer(buffer);
-      SerializeBuffer(&task_buffer);
+      SerializeBuffer(&task_buffer, &batch);
       buffer_pool_->Release(buffer);
     }
+    batch.buffers_.clear();
 
+    HandOverBatch(&batch);
     buffers_processed = true;
   }
 
+  // Other threads may still be serializing batches they took off the queue before we found it empty. Wait for them, so
+  // that callers such as ForceFlush know every buffer handed to us before the call has been handed over.
+  std::unique_lock<std::mutex> lock(handoff_latch_);
+  handoff_cv_.wait(lock, [&] { return batches_handed_off_ >= batches_dequeued; });
   // Mark the last buffer that was written to as full
   if (filled_buffer_ != nullptr) HandFilledBufferToWriter();
 
-  // Bulk remove all the transactions we serialized. This prevents having to take the TimestampManager's latch once for
-  // each timestamp we remove.
-  for (const auto &txns : serialized_txns_) {
-    txns.first->RemoveTransactions(txns.second);
+  return buffers_processed;
+}
+
+void LogSerializerTask::HandOverBatch(SerializationBatch *const batch) {
+  {
+    std::unique_lock<std::mutex> lock(handoff_latch_);
+    handoff_cv_.wait(lock, [&] { return batches_handed_off_ == batch->id_; });
+
+    const auto size = static_cast<uint32_t>(batch->serialized_.size());
+    uint32_t size_written = 0;
+    while (size_written < size) {
+      BufferedLogWriter *out = GetCurrentWriteBuffer();
+      size_written += out->BufferWrite(batch->serialized_.data() + size_written, size - size_written);
+      // Mark the buffer full for the disk log consumer task thread to flush it
+      if (out->IsBufferFull()) HandFilledBufferToWriter();
+    }
+    // Every commit record of the batch is either in the current buffer or in one handed over before it, so the
+    // callbacks can all be handed over with the current buffer
+    if (!batch->commits_.empty()) {
+      GetCurrentWriteBuffer();
+      commits_in_buffer_.insert(commits_in_buffer_.end(), batch->commits_.begin(), batch->commits_.end());
+    }
+    bytes_handed_off_ += size;
+    batches_handed_off_++;
   }
-  serialized_txns_.clear();
+  handoff_cv_.notify_all();
 
-  return buffers_processed;
+  // Bulk remove all the transactions we serialized. This prevents having to take the TimestampManager's shard latches
+  // once for each timestamp we remove.
+  for (const auto &txns : batch->serialized_txns_) {
+    txns.first->RemoveTransactions(txns.second);
+  }
+  batch->serialized_txns_.clear();
+  batch->serialized_.clear();
+  batch->commits_.clear();
 }
 
 /**
@@ -100,7 +133,8 @@ void LogSerializerTask::HandFilledBufferToWriter() {
   filled_buffer_ = nullptr;
 }
 
-void LogSerializerTask::SerializeBuffer(IterableBufferSegment<LogRecord> *buffer_to_serialize) {
+void LogSerializerTask::SerializeBuffer(IterableBufferSegment<LogRecord> *buffer_to_serialize,
+                                        SerializationBatch *const batch) {
   // Iterate over all redo records in the redo buffer through the provided iterator
   for (LogRecord &record : *buffer_to_serialize) {
     switch (record.RecordType()) {
@@ -110,29 +144,31 @@ void LogSerializerTask::SerializeBuffer(IterableBufferSegment<LogRecord> *buffer
         // If a transaction is read-only, then the only record it generates is its commit record. This commit record is
         // necessary for the transaction's callback function to be invoked, but there is no need to serialize it, as
         // it corresponds to a transaction with nothing to redo.
-        if (!commit_record->IsReadOnly()) SerializeRecord(record);
-        commits_in_buffer_.emplace_back(commit_record->CommitCallback(), commit_record->CommitCallbackArg());
+        if (!commit_record->IsReadOnly()) SerializeRecord(record, &batch->serialized_);
+        batch->commits_.emplace_back(commit_record->CommitCallback(), commit_record->CommitCallbackArg());
         // Once serialization is done, we notify the txn manager to let GC know this txn is ready to clean up
-        serialized_txns_[commit_record->TimestampManager()].push_back(record.TxnBegin());
+        batch->serialized_txns_[commit_record->TimestampManager()].emplace_back(commit_record->TimestampShard(),
+                                                                              record.TxnBegin());
         break;
       }
 
       case (LogRecordType::ABORT): {
         // If an abort record shows up at all, the transaction cannot be read-only
-        SerializeRecord(record);
+        SerializeRecord(record, &batch->serialized_);
         auto *abord_record = record.GetUnderlyingRecordBodyAs<AbortRecord>();
-        serialized_txns_[abord_record->TimestampManager()].push_back(record.TxnBegin());
+        batch->serialized_txns_[abord_record->TimestampManager()].emplace_back(abord_record->TimestampShard(),
+                                                                             record.TxnBegin());
         break;
       }
 
       default:
         // Any record that is not a commit record is always serialized.`
-        SerializeRecord(record);
+        SerializeRecord(record, &batch->serialized_);
     }
   }
 }
 
-void LogSerializerTask::SerializeRecord(const terrier::storage::LogRecord &record) {
+void LogSerializerTask::SerializeRecord(const terrier::storage::LogRecord &record, std::vector<byte> *const out) {
   // First, serialize out fields common across all LogRecordType's.
 
   // Note: This is the in-memory size of the log record itself, i.e. inclusive of padding and not considering the size
@@ -140,23 +176,23 @@ void LogSerializerTask::SerializeRecord(const terrier::storage::LogRecord &recor
   // manager generates in this function. In particular, the later value is very likely to be strictly smaller when the
   // LogRecordType is REDO. On recovery, the goal is to turn the serialized format back into an in-memory log record of
   // this size.
-  WriteValue(record.Size());
+  WriteValue(out, record.Size());
 
-  WriteValue(record.RecordType());
-  WriteValue(record.TxnBegin());
+  WriteValue(out, record.RecordType());
+  WriteValue(out, record.TxnBegin());
 
   switch (record.RecordType()) {
     case LogRecordType::REDO: {
       auto *record_body = record.GetUnderlyingRecordBodyAs<RedoRecord>();
-      WriteValue(record_body->GetDatabaseOid());
-      WriteValue(record_body->GetTableOid());
-      WriteValue(record_body->GetTupleSlot());
+      WriteValue(out, record_body->GetDatabaseOid());
+      WriteValue(out, record_body->GetTableOid());
+      WriteValue(out, record_body->GetTupleSlot());
 
       auto *delta = record_body->Delta();
       // Write out which column ids this redo record is concerned with. On recovery, we can construct the appropriate
       // ProjectedRowInitializer from these ids and their corresponding block layout.
-      WriteValue(delta->NumColumns());
-      WriteValue(delta->ColumnIds(), static_cast<uint32_t>(sizeof(col_id_t)) * delta->NumColumns());
+      WriteValue(out, delta->NumColumns());
+      WriteValue(out, delta->ColumnIds(), static_cast<uint32_t>(sizeof(col_id_t)) * delta->NumColumns());
 
       // Write out the attr sizes boundaries, this way we can deserialize the records without the need of the block
       // layout
@@ -164,10 +200,10 @@ void LogSerializerTask::SerializeRecord(const terrier::storage::LogRecord &recor
       uint16_t boundaries[NUM_ATTR_BOUNDARIES];
       memset(boundaries, 0, sizeof(uint16_t) * NUM_ATTR_BOUNDARIES);
       StorageUtil::ComputeAttributeSizeBoundaries(block_layout, delta->ColumnIds(), delta->NumColumns(), boundaries);
-      WriteValue(boundaries, sizeof(uint16_t) * NUM_ATTR_BOUNDARIES);
+      WriteValue(out, boundaries, sizeof(uint16_t) * NUM_ATTR_BOUNDARIES);
 
       // Write out the null bitmap.
-      WriteValue(&(delta->Bitmap()), common::RawBitmap::SizeInBytes(delta->NumColumns()));
+      WriteValue(out, &(delta->Bitmap()), common::RawBitmap::SizeInBytes(delta->NumColumns()));
 
       // Write out attribute values
       for (uint16_t i = 0; i < delta->NumColumns(); i++) {
@@ -184,34 +220,34 @@ void LogSerializerTask::SerializeRecord(const terrier::storage::LogRecord &recor
           // Inline column value is a pointer to a VarlenEntry, so reinterpret as such.
           const auto *varlen_entry = reinterpret_cast<const VarlenEntry *>(column_value_address);
           // Serialize out length of the varlen entry.
-          WriteValue(varlen_entry->Size());
+          WriteValue(out, varlen_entry->Size());
           if (varlen_entry->IsInlined()) {
             // Serialize out the prefix of the varlen entry.
-            WriteValue(varlen_entry->Prefix(), varlen_entry->Size());
+            WriteValue(out, varlen_entry->Prefix(), varlen_entry->Size());
           } else {
             // Serialize out the content field of the varlen entry.
-            WriteValue(varlen_entry->Content(), varlen_entry->Size());
+            WriteValue(out, varlen_entry->Content(), varlen_entry->Size());
           }
         } else {
           // Inline column value is the actual data we want to serialize out.
           // Note that by writing out AttrSize(col_id) bytes instead of just the difference between successive offsets
           // of the delta record, we avoid serializing out any potential padding.
-          WriteValue(column_value_address, block_layout.AttrSize(col_id));
+          WriteValue(out, column_value_address, block_layout.AttrSize(col_id));
         }
       }
       break;
     }
     case LogRecordType::DELETE: {
       auto *record_body = record.GetUnderlyingRecordBodyAs<DeleteRecord>();
-      WriteValue(record_body->GetDatabaseOid());
-      WriteValue(record_body->GetTableOid());
-      WriteValue(record_body->GetTupleSlot());
+      WriteValue(out, record_body->GetDatabaseOid());
+      WriteValue(out, record_body->GetTableOid());
+      WriteValue(out, record_body->GetTupleSlot());
       break;
     }
     case LogRecordType::COMMIT: {
       auto *record_body = record.GetUnderlyingRecordBodyAs<CommitRecord>();
-      WriteValue(record_body->CommitTime());
-      WriteValue(record_body->OldestActiveTxn());
+      WriteValue(out, record_body->CommitTime());
+      WriteValue(out, record_body->OldestActiveTxn());
       break;
     }
     case LogRecordType::ABORT: {
@@ -221,21 +257,4 @@ void LogSerializerTask::SerializeRecord(const terrier::storage::LogRecord &recor
   }
 }
 
-void LogSerializerTask::WriteValue(const void *val, uint32_t size) {
-  // Serialize the value and copy it to the buffer
-  BufferedLogWriter *out = GetCurrentWriteBuffer();
-  uint32_t size_written = 0;
-
-  while (size_written < size) {
-    const byte *val_byte = reinterpret_cast<const byte *>(val) + size_written;
-    size_written += out->BufferWrite(val_byte, size - size_written);
-    if (out->IsBufferFull()) {
-      // Mark the buffer full for the disk log consumer task thread to flush it
-      HandFilledBufferToWriter();
-      // Get an empty buffer for writing this value
-      out = GetCurrentWriteBuffer();
-    }
-  }
-}
-
 }  // namespace terrier::storage
@@ -1,30 +1,50 @@
 #include "transaction/timestamp_manager.h"
 #include <algorithm>
+#include <utility>
 #include <vector>
 
 namespace terrier::transaction {
 
 timestamp_t TimestampManager::OldestTransactionStartTime() {
-  common::SpinLatch::ScopedSpinLatch guard(&curr_running_txns_latch_);
-  const auto &oldest_txn = std::min_element(curr_running_txns_.cbegin(), curr_running_txns_.cend());
-  timestamp_t result = (oldest_txn != curr_running_txns_.end()) ? *oldest_txn : time_.load();
+  // The clock has to be read before visiting any shard. A transaction that begins on a shard after we have visited it
+  // checks out its start time after this read, so it is never older than the result.
+  timestamp_t result = time_.load();
+  for (const auto &shard : shards_) {
+    common::SpinLatch::ScopedSpinLatch guard(&shard.latch_);
+    if (!shard.running_txns_.empty()) result = std::min(result, *shard.running_txns_.cbegin());
+  }
   cached_oldest_txn_start_time_.store(result);  // Cache the timestamp
   return result;
 }
 
 timestamp_t TimestampManager::CachedOldestTransactionStartTime() { return cached_oldest_txn_start_time_.load(); }
 
-void TimestampManager::RemoveTransaction(timestamp_t timestamp) {
-  common::SpinLatch::ScopedSpinLatch guard(&curr_running_txns_latch_);
-  const size_t ret UNUSED_ATTRIBUTE = curr_running_txns_.erase(timestamp);
+void TimestampManager::RemoveTransaction(const uint32_t shard, const timestamp_t timestamp) {
+  TERRIER_ASSERT(shard < NUM_ACTIVE_TXN_SHARDS, "shard out of bounds");
+  ActiveTxnShard &txn_shard = shards_[shard];
+  common::SpinLatch::ScopedSpinLatch guard(&txn_shard.latch_);
+  const size_t ret UNUSED_ATTRIBUTE = txn_shard.running_txns_.erase(timestamp);
   TERRIER_ASSERT(ret == 1, "erased timestamp did not exist");
 }
 
-void TimestampManager::RemoveTransactions(const std::vector<terrier::transaction::timestamp_t> &timestamps) {
-  common::SpinLatch::ScopedSpinLatch guard(&curr_running_txns_latch_);
+void TimestampManager::RemoveTransactions(const std::vector<std::pair<uint32_t, timestamp_t>> &timestamps) {
+  static_assert(NUM_ACTIVE_TXN_SHARDS <= 64, "shard mask must fit in a word");
+  uint64_t shards_to_visit = 0;
   for (const auto &timestamp : timestamps) {
-    const size_t ret UNUSED_ATTRIBUTE = curr_running_txns_.erase(timestamp);
-    TERRIER_ASSERT(ret == 1, "erased timestamp did not exist");
+    TERRIER_ASSERT(timestamp.first < NUM_ACTIVE_TXN_SHARDS, "shard out of bounds");
+    shards_to_visit |= uint64_t(1) << timestamp.first;
+  }
+
+  // Take every latch only once, however the timestamps are interleaved between shards
+  for (uint32_t shard = 0; shard < NUM_ACTIVE_TXN_SHARDS; shard++) {
+    if ((shards_to_visit & (uint64_t(1) << shard)) == 0) continue;
+    ActiveTxnShard &txn_shard = shards_[shard];
+    common::SpinLatch::ScopedSpinLatch guard(&txn_shard.latch_);
+    for (const auto &timestamp : timestamps) {
+      if (timestamp.first != shard) continue;
+      const size_t ret UNUSED_ATTRIBUTE = txn_shard.running_txns_.erase(timestamp.second);
+      TERRIER_ASSERT(ret == 1, "erased timestamp did not exist");
+    }
   }
 }
 
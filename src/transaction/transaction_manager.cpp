@@ -5,8 +5,11 @@
 
 namespace terrier::transaction {
 TransactionContext *TransactionManager::BeginTransaction() {
-  timestamp_t start_time = timestamp_manager_->BeginTransaction();
+  const uint32_t shard = TimestampManager::ThreadShard();
+  timestamp_t start_time = timestamp_manager_->BeginTransaction(shard);
   auto *const result = new TransactionContext(start_time, start_time + INT64_MIN, buffer_pool_, log_manager_);
+  result->timestamp_shard_ = shard;
+  result->timestamp_manager_ = timestamp_manager_;
   // Ensure we do not return from this function if there are ongoing write commits
   common::Gate::ScopedExit gate(&txn_gate_);
   return result;
@@ -23,11 +26,11 @@ void TransactionManager::LogCommit(TransactionContext *const txn, const timestam
     byte *const commit_record = txn->redo_buffer_.NewEntry(storage::CommitRecord::Size());
     storage::CommitRecord::Initialize(commit_record, txn->StartTime(), commit_time, commit_callback,
                                       commit_callback_arg, oldest_active_txn, txn->IsReadOnly(), txn,
-                                      timestamp_manager_);
+                                      timestamp_manager_, txn->timestamp_shard_);
   } else {
     // Otherwise, logging is disabled. We should pretend to have serialized and flushed the record so the rest of the
     // system proceeds correctly
-    timestamp_manager_->RemoveTransaction(txn->StartTime());
+    timestamp_manager_->RemoveTransaction(txn->timestamp_shard_, txn->StartTime());
     commit_callback(commit_callback_arg);
   }
   txn->redo_buffer_.Finalize(true);
@@ -81,13 +84,7 @@ timestamp_t TransactionManager::Commit(TransactionContext *const txn, transactio
   LogCommit(txn, result, callback, callback_arg, oldest_active_txn);
 
   // We hand off txn to GC, however, it won't be GC'd until the LogManager marks it as serialized
-  if (gc_enabled_) {
-    common::SpinLatch::ScopedSpinLatch guard(&timestamp_manager_->curr_running_txns_latch_);
-    // It is not necessary to have to GC process read-only transactions, but it's probably faster to call free off
-    // the critical path there anyway
-    // Also note here that GC will figure out what varlen entries to GC, as opposed to in the abort case.
-    completed_txns_.push_front(txn);
-  }
+  if (gc_enabled_) QueueForGC(txn);
   return result;
 }
 
@@ -103,7 +100,7 @@ void TransactionManager::LogAbort(TransactionContext *const txn) {
     // currently exist. Only the abort record is needed.
     txn->redo_buffer_.Reset();
     byte *const abort_record = txn->redo_buffer_.NewEntry(storage::AbortRecord::Size());
-    storage::AbortRecord::Initialize(abort_record, txn->StartTime(), txn, timestamp_manager_);
+    storage::AbortRecord::Initialize(abort_record, txn->StartTime(), txn, timestamp_manager_, txn->timestamp_shard_);
     // Signal to the log manager that we are ready to be logged out
     txn->redo_buffer_.Finalize(true);
   } else {
@@ -112,7 +109,7 @@ void TransactionManager::LogAbort(TransactionContext *const txn) {
     // not yet logged out
     txn->redo_buffer_.Finalize(false);
     // Since there is nothing to log, we can mark it as processed
-    timestamp_manager_->RemoveTransaction(txn->StartTime());
+    timestamp_manager_->RemoveTransaction(txn->timestamp_shard_, txn->StartTime());
   }
 }
 
@@ -151,13 +148,7 @@ timestamp_t TransactionManager::Abort(TransactionContext *const txn) {
   LogAbort(txn);
 
   // We hand off txn to GC, however, it won't be GC'd until the LogManager marks it as serialized
-  if (gc_enabled_) {
-    common::SpinLatch::ScopedSpinLatch guard(&timestamp_manager_->curr_running_txns_latch_);
-    // It is not necessary to have to GC process read-only transactions, but it's probably faster to call free off
-    // the critical path there anyway
-    // Also note here that GC will figure out what varlen entries to GC, as opposed to in the abort case.
-    completed_txns_.push_front(txn);
-  }
+  if (gc_enabled_) QueueForGC(txn);
 
   return abort_time;
 }
@@ -196,9 +187,27 @@ void TransactionManager::GCLastUpdateOnAbort(TransactionContext *const txn) {
   }
 }
 
+void TransactionManager::QueueForGC(TransactionContext *const txn) {
+  const uint32_t shard = txn->timestamp_shard_;
+  common::SpinLatch::ScopedSpinLatch guard(&timestamp_manager_->shards_[shard].latch_);
+  // It is not necessary to have to GC process read-only transactions, but it's probably faster to call free off
+  // the critical path there anyway
+  // Also note here that GC will figure out what varlen entries to GC, as opposed to in the abort case.
+  completed_txns_[shard].txns_.push_front(txn);
+}
+
 TransactionQueue TransactionManager::CompletedTransactionsForGC() {
-  common::SpinLatch::ScopedSpinLatch guard(&timestamp_manager_->curr_running_txns_latch_);
-  return std::move(completed_txns_);
+  TransactionQueue result;
+  for (uint32_t shard = 0; shard < TimestampManager::NUM_ACTIVE_TXN_SHARDS; shard++) {
+    TransactionQueue shard_txns;
+    {
+      common::SpinLatch::ScopedSpinLatch guard(&timestamp_manager_->shards_[shard].latch_);
+      shard_txns = std::move(completed_txns_[shard].txns_);
+      completed_txns_[shard].txns_.clear();
+    }
+    result.splice_after(result.cbefore_begin(), std::move(shard_txns));
+  }
+  return result;
 }
 
 void TransactionManager::Rollback(TransactionContext *txn, const storage::UndoRecord &record) const {
@@ -68,6 +68,31 @@ TEST(ObjectPoolTests, ResetLimitTest) {
   }
 }
 
+// Objects a thread releases are cached for it, but other threads can still reuse them once the pool is at its size
+// limit. The limit is large enough for the pool to cache objects per thread at all.
+// NOLINTNEXTLINE
+TEST(ObjectPoolTests, CrossThreadReuseTest) {
+  const uint64_t size_limit = 1000;
+  common::ObjectPool<uint32_t> tested(size_limit, size_limit);
+  std::unordered_set<uint32_t *> used_ptrs;
+  std::thread releasing_thread([&] {
+    for (uint32_t i = 0; i < size_limit; ++i) used_ptrs.insert(tested.Get());
+    for (auto &it : used_ptrs) tested.Release(it);
+  });
+  releasing_thread.join();
+
+  std::vector<uint32_t *> ptrs;
+  for (uint32_t i = 0; i < size_limit; ++i) {
+    // clang-tidy thinks gtest-printers will DefaultPrintTo the released pointer
+    // NOLINTNEXTLINE
+    uint32_t *ptr = tested.Get();
+    EXPECT_FALSE(used_ptrs.find(ptr) == used_ptrs.end());
+    ptrs.emplace_back(ptr);
+  }
+  EXPECT_THROW(tested.Get(), common::NoMoreObjectException);
+  for (auto &it : ptrs) tested.Release(it);
+}
+
 class ObjectPoolTestType {
  public:
   ObjectPoolTestType *Use(uint32_t thread_id) {
@@ -12,6 +12,7 @@
 #include "catalog/catalog.h"
 #include "execution/sql/filter_manager.h"
 #include "execution/sql/table_vector_iterator.h"
+#include "storage/tuple_access_strategy.h"
 #include "type/type_id.h"
 
 namespace terrier::execution::sql::test {
@@ -52,6 +53,11 @@ uint32_t VectorizedLt500(ProjectedColumnsIterator *pci) {
   return pci->FilterColByVal<std::less>(Col::A, type::TypeId ::INTEGER, param);
 }
 
+uint32_t VectorizedGe5(ProjectedColumnsIterator *pci) {
+  ProjectedColumnsIterator::FilterVal param{.i_ = 5};
+  return pci->FilterColByVal<std::greater_equal>(Col::A, type::TypeId ::INTEGER, param);
+}
+
 // NOLINTNEXTLINE
 TEST_F(FilterManagerTest, SimpleFilterManagerTest) {
   FilterManager filter(bandit::Policy::Kind::FixedAction);
@@ -103,4 +109,137 @@ TEST_F(FilterManagerTest, AdaptiveFilterManagerTest) {
   EXPECT_EQ(1u, filter.GetOptimalFlavorForClause(0));
 }
 
+// NOLINTNEXTLINE
+TEST_F(FilterManagerTest, PushDownPredicateTest) {
+  using Op = FilterManager::ColumnPredicate::Op;
+  FilterManager filter(bandit::Policy::Kind::FixedAction);
+  filter.StartNewClause();
+  filter.InsertClauseFlavor(VectorizedLt500);
+  filter.InsertClausePredicate(Col::A, type::TypeId::INTEGER, Op::LessThan, 500);
+  filter.StartNewClause();
+  filter.InsertClauseFlavor(VectorizedGe5);
+  // Truncated to the width of the column, like the values of vectorized filters
+  filter.InsertClausePredicate(Col::A, type::TypeId::INTEGER, Op::GreaterThanEqual, (int64_t{1} << 32) + 5);
+  filter.Finalize();
+
+  // Clauses are conjunctive, so the predicates of all of them apply
+  const std::vector<FilterManager::ColumnPredicate> predicates = filter.GetPredicates();
+  ASSERT_EQ(2u, predicates.size());
+  EXPECT_EQ(Op::LessThan, predicates[0].op_);
+  EXPECT_EQ(500, predicates[0].val_);
+  EXPECT_EQ(Op::GreaterThanEqual, predicates[1].op_);
+  EXPECT_EQ(5, predicates[1].val_);
+
+  // Zone maps entirely on either side of the constant
+  EXPECT_TRUE(predicates[0].MayMatch(0, 499));
+  EXPECT_TRUE(predicates[0].MayMatch(499, 1000));
+  EXPECT_FALSE(predicates[0].MayMatch(500, 1000));
+  EXPECT_TRUE(predicates[1].MayMatch(5, 5));
+  EXPECT_FALSE(predicates[1].MayMatch(-10, 4));
+
+  // Pushing the filter down must not change the result of the scan
+  auto table_oid = exec_ctx_->GetAccessor()->GetTableOid(NSOid(), "test_1");
+  std::array<uint32_t, 1> col_oids{1};
+  TableVectorIterator tvi(exec_ctx_.get(), !table_oid, col_oids.data(), static_cast<uint32_t>(col_oids.size()));
+  tvi.PushDownFilter(filter);
+  uint32_t num_selected = 0;
+  for (tvi.Init(); tvi.Advance();) {
+    auto *pci = tvi.GetProjectedColumnsIterator();
+    filter.RunFilters(pci);
+    pci->ForEach([pci, &num_selected]() {
+      auto cola = *pci->Get<int32_t, false>(Col::A, nullptr);
+      EXPECT_LT(cola, 500);
+      EXPECT_GE(cola, 5);
+      num_selected++;
+    });
+  }
+  EXPECT_GT(num_selected, 0u);
+}
+
+// This tests that a scan with a pushed down filter skips the frozen blocks whose zone maps or null counts rule out a
+// match, and still returns every qualifying tuple of the others.
+// NOLINTNEXTLINE
+TEST_F(FilterManagerTest, PushDownPredicateFrozenTest) {
+  // Create a table with a single nullable integer column
+  catalog::Schema::Column col_a("col_a", type::TypeId::INTEGER, true, DummyCVE());
+  auto table_oid = exec_ctx_->GetAccessor()->CreateTable(NSOid(), "zone_map_test_table", catalog::Schema({col_a}));
+  auto schema = exec_ctx_->GetAccessor()->GetSchema(table_oid);
+  auto sql_table = new storage::SqlTable(BlockStore(), schema);
+  exec_ctx_->GetAccessor()->SetTablePointer(table_oid, sql_table);
+
+  // Fill three blocks
+  const storage::BlockLayout &layout = sql_table->begin()->GetBlock()->data_table_->GetBlockLayout();
+  const uint32_t num_slots = layout.NumSlots();
+  std::vector<catalog::col_oid_t> col_oids{schema.GetColumn("col_a").Oid()};
+  auto pri = sql_table->InitializerForProjectedRow(col_oids);
+  storage::col_id_t col_id;
+  std::vector<storage::RawBlock *> blocks;
+  for (uint32_t i = 0; i < 3 * num_slots; i++) {
+    auto *const redo = exec_ctx_->GetTxn()->StageWrite(exec_ctx_->DBOid(), table_oid, pri);
+    col_id = redo->Delta()->ColumnIds()[0];
+    *reinterpret_cast<int32_t *>(redo->Delta()->AccessForceNotNull(0)) = 0;
+    storage::RawBlock *const block = sql_table->Insert(exec_ctx_->GetTxn(), redo).GetBlock();
+    if (blocks.empty() || blocks.back() != block) blocks.push_back(block);
+  }
+  ASSERT_EQ(3u, blocks.size());
+
+  // Give every block the values 0 to 999 over and over, with every tenth one NULL, and freeze it the way the block
+  // compactor does. Every block has tuples that pass the filter, so any of them showing up from the second or third
+  // block means the scan read that block. The second block claims values 1000 to 1999 in its zone map, and the third
+  // block claims to be all NULL.
+  storage::TupleAccessStrategy accessor(layout);
+  uint32_t num_expected = 0;
+  for (uint32_t block_idx = 0; block_idx < blocks.size(); block_idx++) {
+    storage::RawBlock *const block = blocks[block_idx];
+    storage::ArrowBlockMetadata &metadata = accessor.GetArrowBlockMetadata(block);
+    metadata.NumRecords() = num_slots;
+    metadata.NullCount(col_id) = 0;
+    for (uint32_t i = 0; i < num_slots; i++) {
+      const storage::TupleSlot slot(block, i);
+      if (i % 10 == 0) {
+        accessor.SetNull(slot, col_id);
+        metadata.NullCount(col_id)++;
+        continue;
+      }
+      const auto val = static_cast<int32_t>(i % 1000);
+      *reinterpret_cast<int32_t *>(accessor.AccessForceNotNull(slot, col_id)) = val;
+      if (block_idx == 0 && val >= 5 && val < 500) num_expected++;
+    }
+    metadata.GetColumnInfo(layout, col_id).GetZoneMap() = {0, 999};
+    if (block_idx == 1) metadata.GetColumnInfo(layout, col_id).GetZoneMap() = {1000, 1999};
+    if (block_idx == 2) metadata.NullCount(col_id) = num_slots;
+    block->controller_.GetBlockState()->store(storage::BlockState::FROZEN);
+  }
+
+  FilterManager filter(bandit::Policy::Kind::FixedAction);
+  filter.StartNewClause();
+  filter.InsertClauseFlavor(VectorizedLt500);
+  filter.InsertClausePredicate(Col::A, type::TypeId::INTEGER, FilterManager::ColumnPredicate::Op::LessThan, 500);
+  filter.StartNewClause();
+  filter.InsertClauseFlavor(VectorizedGe5);
+  filter.InsertClausePredicate(Col::A, type::TypeId::INTEGER, FilterManager::ColumnPredicate::Op::GreaterThanEqual,
+                               5);
+  filter.Finalize();
+
+  std::array<uint32_t, 1> scan_col_oids{!col_oids[0]};
+  TableVectorIterator tvi(exec_ctx_.get(), !table_oid, scan_col_oids.data(),
+                          static_cast<uint32_t>(scan_col_oids.size()));
+  tvi.PushDownFilter(filter);
+  uint32_t num_in_place_tuples = 0, num_selected = 0;
+  for (tvi.Init(); tvi.Advance();) {
+    auto *pci = tvi.GetProjectedColumnsIterator();
+    if (pci->IsInPlace()) num_in_place_tuples += pci->NumSelected();
+    filter.RunFilters(pci);
+    pci->ForEach([pci, &num_selected]() {
+      auto cola = *pci->Get<int32_t, false>(Col::A, nullptr);
+      EXPECT_LT(cola, 500);
+      EXPECT_GE(cola, 5);
+      num_selected++;
+    });
+  }
+  // Only the first block was read, in place and in full
+  EXPECT_EQ(num_slots, num_in_place_tuples);
+  EXPECT_EQ(num_expected, num_selected);
+}
+
 }  // namespace terrier::execution::sql::test
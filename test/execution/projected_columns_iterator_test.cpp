@@ -2,6 +2,7 @@
 #include <memory>
 #include <numeric>
 #include <random>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -450,4 +451,261 @@ TEST_F(ProjectedColumnsIteratorTest, MultipleVectorizedFilterTest) {
   EXPECT_LE(count, 10u);
 }
 
+// NOLINTNEXTLINE
+TEST_F(ProjectedColumnsIteratorTest, InPlaceIteratorTest) {
+  //
+  // Point the iterator directly at the raw column data, the way vectors of a
+  // frozen block are read in place, and check that iteration and vectorized
+  // filters see the same values as the materialized projection.
+  //
+
+  ProjectedColumnsIterator iter(GetProjectedColumn());
+  SetSize(common::Constants::K_DEFAULT_VECTOR_SIZE);
+  EXPECT_FALSE(iter.IsInPlace());
+  EXPECT_EQ(nullptr, iter.GetArrowColumnInfo(GetColOffset(ColId::col_c)));
+
+  // All values are present
+  std::vector<uint8_t> present(NumTuples() / common::Constants::K_BITS_PER_BYTE, 0xFF);
+  const auto *present_bitmap = reinterpret_cast<const common::RawBitmap *>(present.data());
+  iter.SetInPlaceTuples(NumTuples(), 2, 0);
+  iter.SetInPlaceColumn(0, ColumnData(ColId::col_a).data_.get(), present_bitmap, nullptr);
+  iter.SetInPlaceColumn(1, ColumnData(ColId::col_c).data_.get(), present_bitmap, nullptr);
+  EXPECT_TRUE(iter.IsInPlace());
+  EXPECT_FALSE(iter.IsFiltered());
+
+  // Compute expected result
+  const auto *col_c = reinterpret_cast<const int32_t *>(ColumnData(ColId::col_c).data_.get());
+  uint32_t expected = 0;
+  for (uint32_t i = 0; i < NumTuples(); i++) {
+    if (col_c[i] < 100) {
+      expected++;
+    }
+  }
+
+  // Iterate
+  uint32_t tuple_count = 0;
+  for (; iter.HasNext(); iter.Advance()) {
+    bool null = true;
+    auto val = *iter.Get<int16_t, true>(0, &null);
+    EXPECT_FALSE(null);
+    EXPECT_EQ(static_cast<int16_t>(tuple_count), val);
+    tuple_count++;
+  }
+  EXPECT_EQ(NumTuples(), tuple_count);
+  iter.Reset();
+
+  // Filter
+  iter.FilterColByVal<std::less>(1, type::TypeId::INTEGER, ProjectedColumnsIterator::FilterVal{.i_ = 100});
+
+  // Check
+  uint32_t count = 0;
+  for (; iter.HasNextFiltered(); iter.AdvanceFiltered()) {
+    auto val = *iter.Get<int32_t, false>(1, nullptr);
+    EXPECT_LT(val, 100);
+    count++;
+  }
+
+  EXPECT_EQ(expected, count);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ProjectedColumnsIteratorTest, DictionaryStringFilterTest) {
+  //
+  // Build a dictionary compressed string column the way the block compactor
+  // does, and check that string filters evaluated on the dictionary codes
+  // select the same tuples as filters comparing every value.
+  //
+
+  const std::vector<std::string> words = {"apple", "banana", "cherry", "durian-is-a-long-word"};
+  const uint32_t num_tuples = NumTuples();
+
+  // The sorted dictionary
+  uint32_t values_length = 0;
+  for (const auto &word : words) values_length += static_cast<uint32_t>(word.size());
+  storage::ArrowColumnInfo arrow_info;
+  arrow_info.Type() = storage::ArrowColumnType::DICTIONARY_COMPRESSED;
+  arrow_info.VarlenColumn() = {values_length, static_cast<uint32_t>(words.size() + 1)};
+  storage::ArrowVarlenColumn &dictionary = arrow_info.VarlenColumn();
+  for (uint32_t code = 0, acc = 0; code < words.size(); code++) {
+    std::memcpy(dictionary.Values() + acc, words[code].data(), words[code].size());
+    dictionary.Offsets()[code] = acc;
+    acc += static_cast<uint32_t>(words[code].size());
+  }
+  dictionary.Offsets()[words.size()] = values_length;
+
+  // The column values, every fifth of which is NULL, and their dictionary codes
+  std::vector<storage::VarlenEntry> values(num_tuples);
+  std::vector<uint8_t> present(num_tuples / common::Constants::K_BITS_PER_BYTE, 0);
+  arrow_info.Indices() = common::AllocationUtil::AllocateAligned<uint32_t>(num_tuples);
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    if (i % 5 == 0) continue;
+    const uint32_t code = (i * 7) % words.size();
+    const byte *word = dictionary.Values() + dictionary.Offsets()[code];
+    const auto size = static_cast<uint32_t>(words[code].size());
+    values[i] = size > storage::VarlenEntry::InlineThreshold() ? storage::VarlenEntry::Create(word, size, false)
+                                                               : storage::VarlenEntry::CreateInline(word, size);
+    arrow_info.Indices()[i] = code;
+    util::BitUtil::Flip(reinterpret_cast<uint32_t *>(present.data()), i);
+  }
+  const auto *present_bitmap = reinterpret_cast<const common::RawBitmap *>(present.data());
+
+  // Run the given filter once against the dictionary and once against the values, and check both agree
+  auto check = [&](auto filter) {
+    ProjectedColumnsIterator dict_iter(GetProjectedColumn());
+    dict_iter.SetInPlaceTuples(num_tuples, 1, 0);
+    dict_iter.SetInPlaceColumn(0, reinterpret_cast<const byte *>(values.data()), present_bitmap, &arrow_info);
+    ProjectedColumnsIterator value_iter(GetProjectedColumn());
+    value_iter.SetInPlaceTuples(num_tuples, 1, 0);
+    value_iter.SetInPlaceColumn(0, reinterpret_cast<const byte *>(values.data()), present_bitmap, nullptr);
+
+    const uint32_t num_selected = filter(&dict_iter);
+    EXPECT_EQ(filter(&value_iter), num_selected);
+    for (; dict_iter.HasNextFiltered() && value_iter.HasNextFiltered();
+         dict_iter.AdvanceFiltered(), value_iter.AdvanceFiltered()) {
+      bool null = true;
+      const auto *expected = value_iter.Get<storage::VarlenEntry, true>(0, &null);
+      const auto *actual = dict_iter.Get<storage::VarlenEntry, true>(0, &null);
+      EXPECT_FALSE(null);
+      EXPECT_EQ(expected->StringView(), actual->StringView());
+    }
+    return num_selected;
+  };
+
+  const auto banana = storage::VarlenEntry::CreateInline(reinterpret_cast<const byte *>("banana"), 6);
+  const auto blueberry = storage::VarlenEntry::CreateInline(reinterpret_cast<const byte *>("blueberry"), 9);
+  const uint32_t num_present = num_tuples - (num_tuples + 4) / 5;
+
+  const uint32_t num_eq = check([&](ProjectedColumnsIterator *iter) {
+    return iter->FilterColByString<std::equal_to>(0, banana);
+  });
+  EXPECT_LT(0u, num_eq);
+  const uint32_t num_ne = check([&](ProjectedColumnsIterator *iter) {
+    return iter->FilterColByString<std::not_equal_to>(0, banana);
+  });
+  EXPECT_EQ(num_present, num_eq + num_ne);
+  const uint32_t num_lt = check([&](ProjectedColumnsIterator *iter) {
+    return iter->FilterColByString<std::less>(0, blueberry);
+  });
+  const uint32_t num_ge = check([&](ProjectedColumnsIterator *iter) {
+    return iter->FilterColByString<std::greater_equal>(0, blueberry);
+  });
+  EXPECT_EQ(num_present, num_lt + num_ge);
+  check([&](ProjectedColumnsIterator *iter) { return iter->FilterColByString<std::less_equal>(0, banana); });
+  check([&](ProjectedColumnsIterator *iter) { return iter->FilterColByString<std::greater>(0, banana); });
+  const uint32_t num_missing = check([&](ProjectedColumnsIterator *iter) {
+    return iter->FilterColByString<std::equal_to>(0, blueberry);
+  });
+  EXPECT_EQ(0u, num_missing);
+
+  // IN list, with a value that is not in the dictionary
+  const storage::VarlenEntry in_list[] = {banana, blueberry};
+  const uint32_t num_in =
+      check([&](ProjectedColumnsIterator *iter) { return iter->FilterColInStrings(0, in_list, 2); });
+  EXPECT_EQ(num_eq, num_in);
+
+  // Filters compose through the selection vector
+  check([&](ProjectedColumnsIterator *iter) {
+    iter->FilterColByString<std::greater>(0, banana);
+    return iter->FilterColInStrings(0, in_list, 2);
+  });
+}
+
+// NOLINTNEXTLINE
+TEST_F(ProjectedColumnsIteratorTest, DictionaryStringFilterNullTest) {
+  //
+  // <> and IN filters look codes up in a bit set sized for the dictionary.
+  // The codes of NULLs can be anything, so check that these filters never
+  // select NULLs and never look at their codes, including when the
+  // dictionary is empty because every value is NULL.
+  //
+
+  const std::vector<std::string> words = {"apple", "banana", "cherry"};
+  const uint32_t num_tuples = NumTuples();
+
+  uint32_t values_length = 0;
+  for (const auto &word : words) values_length += static_cast<uint32_t>(word.size());
+  storage::ArrowColumnInfo arrow_info;
+  arrow_info.Type() = storage::ArrowColumnType::DICTIONARY_COMPRESSED;
+  arrow_info.VarlenColumn() = {values_length, static_cast<uint32_t>(words.size() + 1)};
+  storage::ArrowVarlenColumn &dictionary = arrow_info.VarlenColumn();
+  for (uint32_t code = 0, acc = 0; code < words.size(); code++) {
+    std::memcpy(dictionary.Values() + acc, words[code].data(), words[code].size());
+    dictionary.Offsets()[code] = acc;
+    acc += static_cast<uint32_t>(words[code].size());
+  }
+  dictionary.Offsets()[words.size()] = values_length;
+
+  // Every third value is NULL, with a code far outside the dictionary
+  std::vector<storage::VarlenEntry> values(num_tuples);
+  std::vector<uint8_t> present(num_tuples / common::Constants::K_BITS_PER_BYTE, 0);
+  arrow_info.Indices() = common::AllocationUtil::AllocateAligned<uint32_t>(num_tuples);
+  uint32_t num_banana = 0, num_present = 0;
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    if (i % 3 == 0) {
+      arrow_info.Indices()[i] = std::numeric_limits<uint32_t>::max() - i;
+      continue;
+    }
+    const uint32_t code = i % words.size();
+    values[i] = storage::VarlenEntry::CreateInline(dictionary.Values() + dictionary.Offsets()[code],
+                                                   static_cast<uint32_t>(words[code].size()));
+    arrow_info.Indices()[i] = code;
+    util::BitUtil::Flip(reinterpret_cast<uint32_t *>(present.data()), i);
+    num_present++;
+    num_banana += static_cast<uint32_t>(code == 1);
+  }
+  const auto *present_bitmap = reinterpret_cast<const common::RawBitmap *>(present.data());
+
+  const auto banana = storage::VarlenEntry::CreateInline(reinterpret_cast<const byte *>("banana"), 6);
+  const auto blueberry = storage::VarlenEntry::CreateInline(reinterpret_cast<const byte *>("blueberry"), 9);
+  const storage::VarlenEntry in_list[] = {banana, blueberry};
+  auto in_place = [&](ProjectedColumnsIterator *iter, const common::RawBitmap *bitmap, storage::ArrowColumnInfo *info) {
+    iter->SetInPlaceTuples(num_tuples, 1, 0);
+    iter->SetInPlaceColumn(0, reinterpret_cast<const byte *>(values.data()), bitmap, info);
+  };
+
+  {
+    ProjectedColumnsIterator iter(GetProjectedColumn());
+    in_place(&iter, present_bitmap, &arrow_info);
+    EXPECT_EQ(num_present - num_banana, iter.FilterColByString<std::not_equal_to>(0, banana));
+    for (; iter.HasNextFiltered(); iter.AdvanceFiltered()) {
+      bool null = true;
+      const auto *value = iter.Get<storage::VarlenEntry, true>(0, &null);
+      EXPECT_FALSE(null);
+      EXPECT_NE(banana.StringView(), value->StringView());
+    }
+  }
+  {
+    ProjectedColumnsIterator iter(GetProjectedColumn());
+    in_place(&iter, present_bitmap, &arrow_info);
+    EXPECT_EQ(num_banana, iter.FilterColInStrings(0, in_list, 2));
+  }
+  {
+    // After another filter, through the selection vector
+    ProjectedColumnsIterator iter(GetProjectedColumn());
+    in_place(&iter, present_bitmap, &arrow_info);
+    iter.FilterColByString<std::greater_equal>(0, banana);
+    EXPECT_EQ(num_banana, iter.FilterColInStrings(0, in_list, 2));
+  }
+
+  // A column of NULLs only has an empty dictionary, and so an empty code set
+  storage::ArrowColumnInfo null_info;
+  null_info.Type() = storage::ArrowColumnType::DICTIONARY_COMPRESSED;
+  null_info.VarlenColumn() = {0, 1};
+  null_info.VarlenColumn().Offsets()[0] = 0;
+  null_info.Indices() = common::AllocationUtil::AllocateAligned<uint32_t>(num_tuples);
+  for (uint32_t i = 0; i < num_tuples; i++) null_info.Indices()[i] = std::numeric_limits<uint32_t>::max() - i;
+  const std::vector<uint8_t> absent(num_tuples / common::Constants::K_BITS_PER_BYTE, 0);
+  const auto *absent_bitmap = reinterpret_cast<const common::RawBitmap *>(absent.data());
+  {
+    ProjectedColumnsIterator iter(GetProjectedColumn());
+    in_place(&iter, absent_bitmap, &null_info);
+    EXPECT_EQ(0, iter.FilterColByString<std::not_equal_to>(0, banana));
+  }
+  {
+    ProjectedColumnsIterator iter(GetProjectedColumn());
+    in_place(&iter, absent_bitmap, &null_info);
+    EXPECT_EQ(0, iter.FilterColInStrings(0, in_list, 2));
+  }
+}
+
 }  // namespace terrier::execution::sql::test
@@ -405,6 +405,55 @@ TEST_F(VectorUtilTest, MultiFilterTest) {
   SmallScaleMultiFilterTest<uint64_t>();
 }
 
+// NOLINTNEXTLINE
+TEST_F(VectorUtilTest, RangeAndCodeSetFilterTest) {
+  //
+  // Test: an array of random codes in the range [0, 100) is filtered by the
+  //       range [20, 30), first on its own and then through the selection
+  //       vector of a filter by the set of even codes
+  //
+
+  constexpr const uint32_t num_elems = 1000;
+  constexpr const uint32_t num_codes = 100;
+  constexpr const uint32_t lo = 20, hi = 30;
+
+  std::vector<uint32_t> codes(num_elems);
+  uint32_t in_range_count = 0, even_in_range_count = 0;
+  {
+    std::mt19937 gen;
+    std::uniform_int_distribution<uint32_t> dist(0, num_codes - 1);
+    for (uint32_t i = 0; i < num_elems; i++) {
+      codes[i] = dist(gen);
+      if (codes[i] >= lo && codes[i] < hi) {
+        in_range_count++;
+        even_in_range_count += static_cast<uint32_t>(codes[i] % 2 == 0);
+      }
+    }
+  }
+
+  alignas(common::Constants::CACHELINE_SIZE) uint32_t out[num_elems] = {0};
+  alignas(common::Constants::CACHELINE_SIZE) uint32_t sel[num_elems] = {0};
+
+  auto found = VectorUtil::FilterVectorByRange<uint32_t>(codes.data(), num_elems, lo, hi, out, nullptr);
+  EXPECT_EQ(in_range_count, found);
+  for (uint32_t i = 0; i < found; i++) {
+    EXPECT_GE(codes[out[i]], lo);
+    EXPECT_LT(codes[out[i]], hi);
+  }
+
+  std::vector<uint32_t> code_set(BitUtil::Num32BitWordsFor(num_codes));
+  BitUtil::Clear(code_set.data(), num_codes);
+  for (uint32_t code = 0; code < num_codes; code += 2) BitUtil::Set(code_set.data(), code);
+  found = VectorUtil::FilterVectorByCodeSet(codes.data(), num_elems, code_set.data(), sel, nullptr);
+  found = VectorUtil::FilterVectorByRange<uint32_t>(codes.data(), found, lo, hi, out, sel);
+  EXPECT_EQ(even_in_range_count, found);
+  for (uint32_t i = 0; i < found; i++) {
+    EXPECT_EQ(0u, codes[out[i]] % 2);
+    EXPECT_GE(codes[out[i]], lo);
+    EXPECT_LT(codes[out[i]], hi);
+  }
+}
+
 // NOLINTNEXTLINE
 TEST_F(VectorUtilTest, VectorVectorFilterTest) {
   //
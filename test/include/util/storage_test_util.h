@@ -9,6 +9,7 @@
 #include <vector>
 #include "catalog/index_schema.h"
 #include "catalog/schema.h"
+#include "common/container/concurrent_map.h"
 #include "common/strong_typedef.h"
 #include "gtest/gtest.h"
 #include "parser/expression/abstract_expression.h"
@@ -369,12 +370,12 @@ class StorageTestUtil {
    * @param txn_manager_two manager to begin txn to scan table_two (can be the same as txn_manager_one)
    * @return true if tables are equal
    */
-  static bool SqlTableEqualDeep(const storage::BlockLayout &layout, common::ManagedPointer<storage::SqlTable> table_one,
-                                common::ManagedPointer<storage::SqlTable> table_two,
-                                const std::vector<storage::TupleSlot> &table_one_tuples,
-                                const std::unordered_map<storage::TupleSlot, storage::TupleSlot> &tuple_slot_map,
-                                transaction::TransactionManager *txn_manager_one,
-                                transaction::TransactionManager *txn_manager_two) {
+  static bool SqlTableEqualDeep(
+      const storage::BlockLayout &layout, common::ManagedPointer<storage::SqlTable> table_one,
+      common::ManagedPointer<storage::SqlTable> table_two, const std::vector<storage::TupleSlot> &table_one_tuples,
+      const common::ConcurrentMap<storage::TupleSlot, storage::TupleSlot, std::hash<storage::TupleSlot>>
+          &tuple_slot_map,
+      transaction::TransactionManager *txn_manager_one, transaction::TransactionManager *txn_manager_two) {
     auto *txn_one = txn_manager_one->BeginTransaction();
     auto *txn_two = txn_manager_two->BeginTransaction();
 
@@ -388,9 +389,10 @@ class StorageTestUtil {
     // Select each tuple for both tables and perform equality
     bool result = true;
     for (auto &tuple : table_one_tuples) {
-      TERRIER_ASSERT(tuple_slot_map.find(tuple) != tuple_slot_map.end(), "No mapping for this tuple slot");
+      auto mapping = tuple_slot_map.Find(tuple);
+      TERRIER_ASSERT(mapping != tuple_slot_map.cend(), "No mapping for this tuple slot");
       table_one->Select(txn_one, tuple, row_one);
-      table_two->Select(txn_two, tuple_slot_map.at(tuple), row_two);
+      table_two->Select(txn_two, mapping->second, row_two);
       if (!ProjectionListEqualDeep(layout, row_one, row_two)) {
         result = false;
         break;
@@ -55,8 +55,10 @@ class TPCCTests : public TerrierTest {
   // Settings for log manager
   const uint64_t num_log_buffers_ = 100;
   const std::chrono::microseconds log_serialization_interval_{10};
+  const uint64_t num_log_serializer_threads_ = 1;
   const std::chrono::milliseconds log_persist_interval_{20};
   const uint64_t log_persist_threshold_ = (1U << 20U);  // 1MB
+  const bool log_group_commit_ = false;
 
   storage::GarbageCollector *gc_;
   storage::GarbageCollectorThread *gc_thread_ = nullptr;
@@ -187,8 +189,9 @@ TEST_F(TPCCTests, WithLogging) {
   thread_registry_ = new common::DedicatedThreadRegistry;
   // we need transactions, TPCC database, and GC
   log_manager_ =
-      new storage::LogManager(LOG_FILE_NAME, num_log_buffers_, log_serialization_interval_, log_persist_interval_,
-                              log_persist_threshold_, &buffer_pool_, common::ManagedPointer(thread_registry_));
+      new storage::LogManager(LOG_FILE_NAME, num_log_buffers_, log_serialization_interval_, num_log_serializer_threads_,
+                              log_persist_interval_, log_persist_threshold_, log_group_commit_, &buffer_pool_,
+                              common::ManagedPointer(thread_registry_));
   log_manager_->Start();
   transaction::TimestampManager timestamp_manager;
   transaction::DeferredActionManager deferred_action_manager(&timestamp_manager);
@@ -57,6 +57,69 @@ TEST(AccessObserverTest, FilledBlocksObserved) {
   for (uint32_t i = 0; i <= COLD_DATA_EPOCH_THRESHOLD; i++) tested.ObserveGCInvocation();
   delete fake_block;
 }
+
+// Tests that sampled accesses, such as reads, keep a block from being enqueued, and that it is enqueued once they stop
+// NOLINTNEXTLINE
+TEST(AccessObserverTest, AccessedBlocksNotObserved) {
+  // Obtain a fake block
+  std::default_random_engine generator;
+  // Varlens within the layout has no impact on the observer
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(100, &generator);
+  storage::TupleAccessStrategy accessor(layout);
+  storage::DataTable table(nullptr, layout, storage::layout_version_t(0));
+  auto *fake_block = new storage::RawBlock;
+  accessor.InitializeRawBlock(&table, fake_block, storage::layout_version_t(0));
+
+  MockBlockCompactor mock_compactor;
+  EXPECT_CALL(mock_compactor, PutInQueue(::testing::_)).Times(0);
+  storage::AccessObserver tested(&mock_compactor);
+
+  // Manually set block to be filled
+  fake_block->insert_head_ = layout.NumSlots();
+  tested.ObserveWrite(fake_block);
+  // The block keeps being accessed, should not be called
+  for (uint32_t i = 0; i <= 2 * COLD_DATA_EPOCH_THRESHOLD; i++) {
+    fake_block->access_count_++;
+    tested.ObserveGCInvocation();
+  }
+  ::testing::Mock::VerifyAndClearExpectations(&mock_compactor);
+
+  // NOLINTNEXTLINE
+  EXPECT_CALL(mock_compactor, PutInQueue(fake_block)).Times(1);
+  // Now it should be called
+  for (uint32_t i = 0; i <= COLD_DATA_EPOCH_THRESHOLD; i++) tested.ObserveGCInvocation();
+  delete fake_block;
+}
+
+// Tests that blocks with no more accesses than the configured threshold are still considered cold
+// NOLINTNEXTLINE
+TEST(AccessObserverTest, ColdAccessThreshold) {
+  // Obtain a fake block
+  std::default_random_engine generator;
+  // Varlens within the layout has no impact on the observer
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(100, &generator);
+  storage::TupleAccessStrategy accessor(layout);
+  storage::DataTable table(nullptr, layout, storage::layout_version_t(0));
+  auto *fake_block = new storage::RawBlock;
+  accessor.InitializeRawBlock(&table, fake_block, storage::layout_version_t(0));
+
+  const uint64_t cold_epoch_threshold = 3;
+  const uint16_t cold_access_threshold = 5;
+  MockBlockCompactor mock_compactor;
+  // NOLINTNEXTLINE
+  EXPECT_CALL(mock_compactor, PutInQueue(fake_block)).Times(1);
+  storage::AccessObserver tested(&mock_compactor, cold_epoch_threshold, cold_access_threshold);
+
+  // Manually set block to be filled
+  fake_block->insert_head_ = layout.NumSlots();
+  tested.ObserveWrite(fake_block);
+  // A few accesses every invocation are not enough to keep the block hot
+  for (uint32_t i = 0; i <= cold_epoch_threshold; i++) {
+    fake_block->access_count_ += cold_access_threshold;
+    tested.ObserveGCInvocation();
+  }
+  delete fake_block;
+}
 }  // namespace terrier
 
 int main(int argc, char **argv) {
@@ -0,0 +1,936 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+#include "parser/expression/column_value_expression.h"
+#include "parser/expression/constant_value_expression.h"
+#include "portable_endian/portable_endian.h"
+#include "storage/garbage_collector_thread.h"
+#include "storage/index/adaptive_radix_tree.h"
+#include "storage/index/compact_ints_key.h"
+#include "storage/index/index_builder.h"
+#include "storage/projected_row.h"
+#include "storage/sql_table.h"
+#include "transaction/transaction_context.h"
+#include "transaction/transaction_manager.h"
+#include "type/type_id.h"
+#include "type/type_util.h"
+#include "util/catalog_test_util.h"
+#include "util/data_table_test_util.h"
+#include "util/random_test_util.h"
+#include "util/storage_test_util.h"
+#include "util/test_harness.h"
+
+namespace terrier::storage::index {
+
+class ArtIndexTests : public TerrierTest {
+ private:
+  const std::chrono::milliseconds gc_period_{10};
+  storage::GarbageCollector *gc_;
+  storage::GarbageCollectorThread *gc_thread_;
+
+  storage::BlockStore block_store_{1000, 1000};
+  storage::RecordBufferSegmentPool buffer_pool_{1000000, 1000000};
+  catalog::Schema table_schema_;
+
+ public:
+  ArtIndexTests() {
+    auto col = catalog::Schema::Column(
+        "attribute", type::TypeId::INTEGER, false,
+        parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type::TypeId::INTEGER)));
+    StorageTestUtil::ForceOid(&(col), catalog::col_oid_t(1));
+    table_schema_ = catalog::Schema({col});
+    sql_table_ = new storage::SqlTable(&block_store_, table_schema_);
+    tuple_initializer_ = sql_table_->InitializerForProjectedRow({catalog::col_oid_t(1)});
+
+    std::vector<catalog::IndexSchema::Column> keycols;
+    keycols.emplace_back("", type::TypeId::INTEGER, false,
+                         parser::ColumnValueExpression(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID,
+                                                       catalog::col_oid_t(1)));
+    StorageTestUtil::ForceOid(&(keycols[0]), catalog::indexkeycol_oid_t(1));
+    unique_schema_ = catalog::IndexSchema(keycols, storage::index::IndexType::ART, true, true, false, true);
+    default_schema_ = catalog::IndexSchema(keycols, storage::index::IndexType::ART, false, false, false, true);
+    unique_schema_.ExtractIndexedColOids();
+    default_schema_.ExtractIndexedColOids();
+  }
+
+  std::default_random_engine generator_;
+  const uint32_t num_threads_ = 4;
+
+  // Key schemas of the indexes
+  catalog::IndexSchema unique_schema_;
+  catalog::IndexSchema default_schema_;
+
+  // SqlTable
+  storage::SqlTable *sql_table_;
+  storage::ProjectedRowInitializer tuple_initializer_ =
+      storage::ProjectedRowInitializer::Create(std::vector<uint8_t>{1}, std::vector<uint16_t>{1});
+
+  // ArtIndex
+  Index *default_index_, *unique_index_;
+  transaction::TimestampManager *timestamp_manager_;
+  transaction::DeferredActionManager *deferred_action_manager_;
+  transaction::TransactionManager *txn_manager_;
+
+  byte *key_buffer_1_, *key_buffer_2_;
+
+  common::WorkerPool thread_pool_{num_threads_, {}};
+
+ protected:
+  void SetUp() override {
+    TerrierTest::SetUp();
+
+    timestamp_manager_ = new transaction::TimestampManager;
+    deferred_action_manager_ = new transaction::DeferredActionManager(timestamp_manager_);
+    txn_manager_ = new transaction::TransactionManager(timestamp_manager_, deferred_action_manager_, &buffer_pool_,
+                                                       true, DISABLED);
+    gc_ = new storage::GarbageCollector(timestamp_manager_, deferred_action_manager_, txn_manager_, DISABLED);
+    gc_thread_ = new storage::GarbageCollectorThread(gc_, gc_period_);
+
+    unique_index_ = (IndexBuilder().SetKeySchema(unique_schema_)).Build();
+    default_index_ = (IndexBuilder().SetKeySchema(default_schema_)).Build();
+
+    gc_thread_->GetGarbageCollector().RegisterIndexForGC(unique_index_);
+    gc_thread_->GetGarbageCollector().RegisterIndexForGC(default_index_);
+
+    key_buffer_1_ =
+        common::AllocationUtil::AllocateAligned(default_index_->GetProjectedRowInitializer().ProjectedRowSize());
+    key_buffer_2_ =
+        common::AllocationUtil::AllocateAligned(default_index_->GetProjectedRowInitializer().ProjectedRowSize());
+  }
+  void TearDown() override {
+    gc_thread_->GetGarbageCollector().UnregisterIndexForGC(unique_index_);
+    gc_thread_->GetGarbageCollector().UnregisterIndexForGC(default_index_);
+
+    delete gc_thread_;
+    delete gc_;
+    delete sql_table_;
+    delete default_index_;
+    delete unique_index_;
+    delete[] key_buffer_1_;
+    delete[] key_buffer_2_;
+    delete txn_manager_;
+    delete deferred_action_manager_;
+    delete timestamp_manager_;
+    TerrierTest::TearDown();
+  }
+};
+
+/**
+ * This test creates multiple worker threads that all try to insert [0,num_inserts) as tuples in the table and into the
+ * primary key index. At completion of the workload, only num_inserts_ txns should have committed with visible versions
+ * in the index and table.
+ */
+// NOLINTNEXTLINE
+TEST_F(ArtIndexTests, UniqueInsert) {
+  const uint32_t num_inserts = 100000;  // number of tuples/primary keys for each worker to attempt to insert
+  auto workload = [&](uint32_t worker_id) {
+    auto *const key_buffer =
+        common::AllocationUtil::AllocateAligned(unique_index_->GetProjectedRowInitializer().ProjectedRowSize());
+    auto *const insert_key = unique_index_->GetProjectedRowInitializer().InitializeRow(key_buffer);
+
+    // some threads count up, others count down. This is to mix whether threads abort for write-write conflict or
+    // previously committed versions
+    if (worker_id % 2 == 0) {
+      for (uint32_t i = 0; i < num_inserts; i++) {
+        auto *const insert_txn = txn_manager_->BeginTransaction();
+        auto *const insert_redo =
+            insert_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+        auto *const insert_tuple = insert_redo->Delta();
+        *reinterpret_cast<int32_t *>(insert_tuple->AccessForceNotNull(0)) = i;
+        const auto tuple_slot = sql_table_->Insert(insert_txn, insert_redo);
+
+        *reinterpret_cast<int32_t *>(insert_key->AccessForceNotNull(0)) = i;
+        if (unique_index_->InsertUnique(insert_txn, *insert_key, tuple_slot)) {
+          txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+        } else {
+          txn_manager_->Abort(insert_txn);
+        }
+      }
+
+    } else {
+      for (uint32_t i = num_inserts - 1; i < num_inserts; i--) {
+        auto *const insert_txn = txn_manager_->BeginTransaction();
+        auto *const insert_redo =
+            insert_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+        auto *const insert_tuple = insert_redo->Delta();
+        *reinterpret_cast<int32_t *>(insert_tuple->AccessForceNotNull(0)) = i;
+        const auto tuple_slot = sql_table_->Insert(insert_txn, insert_redo);
+
+        *reinterpret_cast<int32_t *>(insert_key->AccessForceNotNull(0)) = i;
+        if (unique_index_->InsertUnique(insert_txn, *insert_key, tuple_slot)) {
+          txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+        } else {
+          txn_manager_->Abort(insert_txn);
+        }
+      }
+    }
+    delete[] key_buffer;
+  };
+
+  // run the workload
+  for (uint32_t i = 0; i < num_threads_; i++) {
+    thread_pool_.SubmitTask([i, &workload] { workload(i); });
+  }
+  thread_pool_.WaitUntilAllFinished();
+
+  // scan the results
+  auto *const scan_txn = txn_manager_->BeginTransaction();
+
+  std::vector<storage::TupleSlot> results;
+
+  auto *const low_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  auto *const high_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_2_);
+
+  // scan[0,num_inserts_) should hit num_inserts_ keys (no duplicates)
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 0;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = num_inserts - 1;
+  unique_index_->ScanAscending(*scan_txn, *low_key_pr, *high_key_pr, &results);
+  EXPECT_EQ(results.size(), num_inserts);
+
+  txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+/**
+ * This test creates multiple worker threads that all try to insert [0,num_inserts) as tuples in the table and into the
+ * primary key index. At completion of the workload, all num_inserts_ txns * num_threads_ should have committed with
+ * visible versions in the index and table.
+ */
+// NOLINTNEXTLINE
+TEST_F(ArtIndexTests, DefaultInsert) {
+  const uint32_t num_inserts = 100000;  // number of tuples/primary keys for each worker to attempt to insert
+  auto workload = [&](uint32_t worker_id) {
+    auto *const key_buffer =
+        common::AllocationUtil::AllocateAligned(default_index_->GetProjectedRowInitializer().ProjectedRowSize());
+    auto *const insert_key = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer);
+
+    // some threads count up, others count down. Threads shouldn't abort each other
+    if (worker_id % 2 == 0) {
+      for (uint32_t i = 0; i < num_inserts; i++) {
+        auto *const insert_txn = txn_manager_->BeginTransaction();
+        auto *const insert_redo =
+            insert_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+        auto *const insert_tuple = insert_redo->Delta();
+        *reinterpret_cast<int32_t *>(insert_tuple->AccessForceNotNull(0)) = i;
+        const auto tuple_slot = sql_table_->Insert(insert_txn, insert_redo);
+
+        *reinterpret_cast<int32_t *>(insert_key->AccessForceNotNull(0)) = i;
+        EXPECT_TRUE(default_index_->Insert(insert_txn, *insert_key, tuple_slot));
+        txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+      }
+    } else {
+      for (uint32_t i = num_inserts - 1; i < num_inserts; i--) {
+        auto *const insert_txn = txn_manager_->BeginTransaction();
+        auto *const insert_redo =
+            insert_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+        auto *const insert_tuple = insert_redo->Delta();
+        *reinterpret_cast<int32_t *>(insert_tuple->AccessForceNotNull(0)) = i;
+        const auto tuple_slot = sql_table_->Insert(insert_txn, insert_redo);
+
+        *reinterpret_cast<int32_t *>(insert_key->AccessForceNotNull(0)) = i;
+        EXPECT_TRUE(default_index_->Insert(insert_txn, *insert_key, tuple_slot));
+        txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+      }
+    }
+
+    delete[] key_buffer;
+  };
+
+  // run the workload
+  for (uint32_t i = 0; i < num_threads_; i++) {
+    thread_pool_.SubmitTask([i, &workload] { workload(i); });
+  }
+  thread_pool_.WaitUntilAllFinished();
+
+  // scan the results
+  auto *const scan_txn = txn_manager_->BeginTransaction();
+
+  std::vector<storage::TupleSlot> results;
+
+  auto *const low_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  auto *const high_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_2_);
+
+  // scan[0,num_inserts_) should hit num_inserts_ * num_threads_ keys
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 0;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = num_inserts - 1;
+  default_index_->ScanAscending(*scan_txn, *low_key_pr, *high_key_pr, &results);
+  EXPECT_EQ(results.size(), num_inserts * num_threads_);
+
+  txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+/**
+ * Tests basic scan behavior using various windows to scan over (some out of of bounds of keyspace, some matching
+ * exactly, etc.)
+ */
+// NOLINTNEXTLINE
+TEST_F(ArtIndexTests, ScanAscending) {
+  // populate index with [0..20] even keys
+  std::map<int32_t, storage::TupleSlot> reference;
+  auto *const insert_txn = txn_manager_->BeginTransaction();
+  for (int32_t i = 0; i <= 20; i += 2) {
+    auto *const insert_redo =
+        insert_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+    auto *const insert_tuple = insert_redo->Delta();
+    *reinterpret_cast<int32_t *>(insert_tuple->AccessForceNotNull(0)) = i;
+    const auto tuple_slot = sql_table_->Insert(insert_txn, insert_redo);
+
+    auto *const insert_key = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+    *reinterpret_cast<int32_t *>(insert_key->AccessForceNotNull(0)) = i;
+
+    EXPECT_TRUE(default_index_->Insert(insert_txn, *insert_key, tuple_slot));
+    reference[i] = tuple_slot;
+  }
+  txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *const scan_txn = txn_manager_->BeginTransaction();
+
+  std::vector<storage::TupleSlot> results;
+
+  auto *const low_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  auto *const high_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_2_);
+
+  // scan[8,12] should hit keys 8, 10, 12
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 8;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = 12;
+  default_index_->ScanAscending(*scan_txn, *low_key_pr, *high_key_pr, &results);
+  EXPECT_EQ(results.size(), 3);
+  EXPECT_EQ(reference.at(8), results[0]);
+  EXPECT_EQ(reference.at(10), results[1]);
+  EXPECT_EQ(reference.at(12), results[2]);
+  results.clear();
+
+  // scan[7,13] should hit keys 8, 10, 12
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 7;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = 13;
+  default_index_->ScanAscending(*scan_txn, *low_key_pr, *high_key_pr, &results);
+  EXPECT_EQ(results.size(), 3);
+  EXPECT_EQ(reference.at(8), results[0]);
+  EXPECT_EQ(reference.at(10), results[1]);
+  EXPECT_EQ(reference.at(12), results[2]);
+  results.clear();
+
+  // scan[-1,5] should hit keys 0, 2, 4
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = -1;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = 5;
+  default_index_->ScanAscending(*scan_txn, *low_key_pr, *high_key_pr, &results);
+  EXPECT_EQ(results.size(), 3);
+  EXPECT_EQ(reference.at(0), results[0]);
+  EXPECT_EQ(reference.at(2), results[1]);
+  EXPECT_EQ(reference.at(4), results[2]);
+  results.clear();
+
+  // scan[15,21] should hit keys 16, 18, 20
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 15;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = 21;
+  default_index_->ScanAscending(*scan_txn, *low_key_pr, *high_key_pr, &results);
+  EXPECT_EQ(results.size(), 3);
+  EXPECT_EQ(reference.at(16), results[0]);
+  EXPECT_EQ(reference.at(18), results[1]);
+  EXPECT_EQ(reference.at(20), results[2]);
+  results.clear();
+
+  txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+/**
+ * Tests basic scan behavior using various windows to scan over (some out of of bounds of keyspace, some matching
+ * exactly, etc.)
+ */
+// NOLINTNEXTLINE
+TEST_F(ArtIndexTests, ScanDescending) {
+  // populate index with [0..20] even keys
+  std::map<int32_t, storage::TupleSlot> reference;
+  auto *const insert_txn = txn_manager_->BeginTransaction();
+  for (int32_t i = 0; i <= 20; i += 2) {
+    auto *const insert_redo =
+        insert_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+    auto *const insert_tuple = insert_redo->Delta();
+    *reinterpret_cast<int32_t *>(insert_tuple->AccessForceNotNull(0)) = i;
+    const auto tuple_slot = sql_table_->Insert(insert_txn, insert_redo);
+
+    auto *const insert_key = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+    *reinterpret_cast<int32_t *>(insert_key->AccessForceNotNull(0)) = i;
+    EXPECT_TRUE(default_index_->Insert(insert_txn, *insert_key, tuple_slot));
+    reference[i] = tuple_slot;
+  }
+  txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *const scan_txn = txn_manager_->BeginTransaction();
+
+  std::vector<storage::TupleSlot> results;
+
+  auto *const low_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  auto *const high_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_2_);
+
+  // scan[8,12] should hit keys 12, 10, 8
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 8;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = 12;
+  default_index_->ScanDescending(*scan_txn, *low_key_pr, *high_key_pr, &results);
+  EXPECT_EQ(results.size(), 3);
+  EXPECT_EQ(reference.at(12), results[0]);
+  EXPECT_EQ(reference.at(10), results[1]);
+  EXPECT_EQ(reference.at(8), results[2]);
+  results.clear();
+
+  // scan[7,13] should hit keys 12, 10, 8
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 7;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = 13;
+  default_index_->ScanDescending(*scan_txn, *low_key_pr, *high_key_pr, &results);
+  EXPECT_EQ(results.size(), 3);
+  EXPECT_EQ(reference.at(12), results[0]);
+  EXPECT_EQ(reference.at(10), results[1]);
+  EXPECT_EQ(reference.at(8), results[2]);
+  results.clear();
+
+  // scan[-1,5] should hit keys 4, 2, 0
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = -1;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = 5;
+  default_index_->ScanDescending(*scan_txn, *low_key_pr, *high_key_pr, &results);
+  EXPECT_EQ(results.size(), 3);
+  EXPECT_EQ(reference.at(4), results[0]);
+  EXPECT_EQ(reference.at(2), results[1]);
+  EXPECT_EQ(reference.at(0), results[2]);
+  results.clear();
+
+  // scan[15,21] should hit keys 20, 18, 16
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 15;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = 21;
+  default_index_->ScanDescending(*scan_txn, *low_key_pr, *high_key_pr, &results);
+  EXPECT_EQ(results.size(), 3);
+  EXPECT_EQ(reference.at(20), results[0]);
+  EXPECT_EQ(reference.at(18), results[1]);
+  EXPECT_EQ(reference.at(16), results[2]);
+  results.clear();
+
+  txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+/**
+ * Tests basic scan behavior using various windows to scan over (some out of of bounds of keyspace, some matching
+ * exactly, etc.)
+ */
+// NOLINTNEXTLINE
+TEST_F(ArtIndexTests, ScanLimitAscending) {
+  // populate index with [0..20] even keys
+  std::map<int32_t, storage::TupleSlot> reference;
+  auto *const insert_txn = txn_manager_->BeginTransaction();
+  for (int32_t i = 0; i <= 20; i += 2) {
+    auto *const insert_redo =
+        insert_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+    auto *const insert_tuple = insert_redo->Delta();
+    *reinterpret_cast<int32_t *>(insert_tuple->AccessForceNotNull(0)) = i;
+    const auto tuple_slot = sql_table_->Insert(insert_txn, insert_redo);
+
+    auto *const insert_key = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+    *reinterpret_cast<int32_t *>(insert_key->AccessForceNotNull(0)) = i;
+    EXPECT_TRUE(default_index_->Insert(insert_txn, *insert_key, tuple_slot));
+    reference[i] = tuple_slot;
+  }
+  txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *const scan_txn = txn_manager_->BeginTransaction();
+
+  std::vector<storage::TupleSlot> results;
+
+  auto *const low_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  auto *const high_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_2_);
+
+  // scan_limit[8,12] should hit keys 8, 10
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 8;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = 12;
+  default_index_->ScanLimitAscending(*scan_txn, *low_key_pr, *high_key_pr, &results, 2);
+  EXPECT_EQ(results.size(), 2);
+  EXPECT_EQ(reference.at(8), results[0]);
+  EXPECT_EQ(reference.at(10), results[1]);
+  results.clear();
+
+  // scan_limit[7,13] should hit keys 8, 10
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 7;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = 13;
+  default_index_->ScanLimitAscending(*scan_txn, *low_key_pr, *high_key_pr, &results, 2);
+  EXPECT_EQ(results.size(), 2);
+  EXPECT_EQ(reference.at(8), results[0]);
+  EXPECT_EQ(reference.at(10), results[1]);
+  results.clear();
+
+  // scan_limit[-1,5] should hit keys 0, 2
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = -1;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = 5;
+  default_index_->ScanLimitAscending(*scan_txn, *low_key_pr, *high_key_pr, &results, 2);
+  EXPECT_EQ(results.size(), 2);
+  EXPECT_EQ(reference.at(0), results[0]);
+  EXPECT_EQ(reference.at(2), results[1]);
+  results.clear();
+
+  // scan_limit[15,21] should hit keys 16, 18
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 15;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = 21;
+  default_index_->ScanLimitAscending(*scan_txn, *low_key_pr, *high_key_pr, &results, 2);
+  EXPECT_EQ(results.size(), 2);
+  EXPECT_EQ(reference.at(16), results[0]);
+  EXPECT_EQ(reference.at(18), results[1]);
+  results.clear();
+
+  txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+/**
+ * Tests basic scan behavior using various windows to scan over (some out of of bounds of keyspace, some matching
+ * exactly, etc.)
+ */
+// NOLINTNEXTLINE
+TEST_F(ArtIndexTests, ScanLimitDescending) {
+  // populate index with [0..20] even keys
+  std::map<int32_t, storage::TupleSlot> reference;
+  auto *const insert_txn = txn_manager_->BeginTransaction();
+  for (int32_t i = 0; i <= 20; i += 2) {
+    auto *const insert_redo =
+        insert_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+    auto *const insert_tuple = insert_redo->Delta();
+    *reinterpret_cast<int32_t *>(insert_tuple->AccessForceNotNull(0)) = i;
+    const auto tuple_slot = sql_table_->Insert(insert_txn, insert_redo);
+
+    auto *const insert_key = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+    *reinterpret_cast<int32_t *>(insert_key->AccessForceNotNull(0)) = i;
+    EXPECT_TRUE(default_index_->Insert(insert_txn, *insert_key, tuple_slot));
+    reference[i] = tuple_slot;
+  }
+  txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *const scan_txn = txn_manager_->BeginTransaction();
+
+  std::vector<storage::TupleSlot> results;
+
+  auto *const low_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  auto *const high_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_2_);
+
+  // scan_limit[8,12] should hit keys 12, 10
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 8;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = 12;
+  default_index_->ScanLimitDescending(*scan_txn, *low_key_pr, *high_key_pr, &results, 2);
+  EXPECT_EQ(results.size(), 2);
+  EXPECT_EQ(reference.at(12), results[0]);
+  EXPECT_EQ(reference.at(10), results[1]);
+  results.clear();
+
+  // scan_limit[7,13] should hit keys 12, 10
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 7;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = 13;
+  default_index_->ScanLimitDescending(*scan_txn, *low_key_pr, *high_key_pr, &results, 2);
+  EXPECT_EQ(results.size(), 2);
+  EXPECT_EQ(reference.at(12), results[0]);
+  EXPECT_EQ(reference.at(10), results[1]);
+  results.clear();
+
+  // scan_limit[-1,5] should hit keys 4, 2
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = -1;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = 5;
+  default_index_->ScanLimitDescending(*scan_txn, *low_key_pr, *high_key_pr, &results, 2);
+  EXPECT_EQ(results.size(), 2);
+  EXPECT_EQ(reference.at(4), results[0]);
+  EXPECT_EQ(reference.at(2), results[1]);
+  results.clear();
+
+  // scan_limit[15,21] should hit keys 20, 18
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 15;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = 21;
+  default_index_->ScanLimitDescending(*scan_txn, *low_key_pr, *high_key_pr, &results, 2);
+  EXPECT_EQ(results.size(), 2);
+  EXPECT_EQ(reference.at(20), results[0]);
+  EXPECT_EQ(reference.at(18), results[1]);
+  results.clear();
+
+  txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+// Verifies that primary key insert fails on write-write conflict
+// NOLINTNEXTLINE
+TEST_F(ArtIndexTests, UniqueKey1) {
+  auto *txn0 = txn_manager_->BeginTransaction();
+
+  // txn 0 inserts into table
+  auto *insert_redo =
+      txn0->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+  auto *insert_tuple = insert_redo->Delta();
+  *reinterpret_cast<int32_t *>(insert_tuple->AccessForceNotNull(0)) = 15721;
+  const auto tuple_slot = sql_table_->Insert(txn0, insert_redo);
+
+  // txn 0 inserts into index
+  auto *insert_key = unique_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  *reinterpret_cast<int32_t *>(insert_key->AccessForceNotNull(0)) = 15721;
+  EXPECT_TRUE(unique_index_->InsertUnique(txn0, *insert_key, tuple_slot));
+
+  std::vector<storage::TupleSlot> results;
+
+  auto *const scan_key_pr = unique_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+
+  // txn 0 scans index and gets a visible, correct result
+  *reinterpret_cast<int32_t *>(scan_key_pr->AccessForceNotNull(0)) = 15721;
+  unique_index_->ScanKey(*txn0, *scan_key_pr, &results);
+  EXPECT_EQ(results.size(), 1);
+  EXPECT_EQ(tuple_slot, results[0]);
+  results.clear();
+
+  auto *txn1 = txn_manager_->BeginTransaction();
+
+  // txn 1 scans index and gets no visible result
+  unique_index_->ScanKey(*txn1, *scan_key_pr, &results);
+  EXPECT_EQ(results.size(), 0);
+  results.clear();
+
+  // txn 1 inserts into table
+  insert_redo = txn1->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+  insert_tuple = insert_redo->Delta();
+  *reinterpret_cast<int32_t *>(insert_tuple->AccessForceNotNull(0)) = 15721;
+  const auto new_tuple_slot = sql_table_->Insert(txn1, insert_redo);
+
+  // txn 1 inserts into index and fails due to write-write conflict with txn 0
+  insert_key = unique_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  *reinterpret_cast<int32_t *>(insert_key->AccessForceNotNull(0)) = 15721;
+  EXPECT_FALSE(unique_index_->InsertUnique(txn1, *insert_key, new_tuple_slot));
+
+  txn_manager_->Abort(txn1);
+
+  txn_manager_->Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *txn2 = txn_manager_->BeginTransaction();
+
+  // txn 2 scans index and gets a visible, correct result
+  unique_index_->ScanKey(*txn2, *scan_key_pr, &results);
+  EXPECT_EQ(results.size(), 1);
+  EXPECT_EQ(tuple_slot, results[0]);
+  results.clear();
+
+  txn_manager_->Commit(txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+//    Txn #0 | Txn #1 | Txn #2 |
+//    --------------------------
+//    BEGIN  |        |        |
+//    W(X)   |        |        |
+//    R(X)   |        |        |
+//           | BEGIN  |        |
+//           | R(X)   |        |
+//    COMMIT |        |        |
+//           | R(X)   |        |
+//           | COMMIT |        |
+//           |        | BEGIN  |
+//           |        | R(X)   |
+//           |        | COMMIT |
+//
+// Txn #0 should only read Txn #0's version of X
+// Txn #1 should only read the previous version of X because its start time is before #0's commit
+// Txn #2 should only read Txn #0's version of X
+//
+// This test confirms that we are not susceptible to the DIRTY READS and UNREPEATABLE READS anomalies
+// NOLINTNEXTLINE
+TEST_F(ArtIndexTests, CommitDelete1) {
+  auto *insert_txn = txn_manager_->BeginTransaction();
+
+  // insert_txn inserts into table
+  auto *insert_redo =
+      insert_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+  auto *insert_tuple = insert_redo->Delta();
+  *reinterpret_cast<int32_t *>(insert_tuple->AccessForceNotNull(0)) = 15721;
+  const auto tuple_slot = sql_table_->Insert(insert_txn, insert_redo);
+
+  // insert_txn inserts into index
+  auto *insert_key = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  *reinterpret_cast<int32_t *>(insert_key->AccessForceNotNull(0)) = 15721;
+  EXPECT_TRUE(default_index_->Insert(insert_txn, *insert_key, tuple_slot));
+
+  txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  std::vector<storage::TupleSlot> results;
+
+  auto *const scan_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+
+  auto *txn0 = txn_manager_->BeginTransaction();
+
+  // txn 0 scans index for 15721 and gets a visible, correct result
+  *reinterpret_cast<int32_t *>(scan_key_pr->AccessForceNotNull(0)) = 15721;
+  default_index_->ScanKey(*txn0, *scan_key_pr, &results);
+  EXPECT_EQ(results.size(), 1);
+  EXPECT_EQ(tuple_slot, results[0]);
+  results.clear();
+
+  // txn 0 deletes in the table and index
+  txn0->StageDelete(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, results[0]);
+  EXPECT_TRUE(sql_table_->Delete(txn0, results[0]));
+  default_index_->Delete(txn0, *insert_key, results[0]);
+
+  // txn 0 scans index for 15721 and gets no visible result
+  *reinterpret_cast<int32_t *>(scan_key_pr->AccessForceNotNull(0)) = 15721;
+  default_index_->ScanKey(*txn0, *scan_key_pr, &results);
+  EXPECT_EQ(results.size(), 0);
+  results.clear();
+
+  auto *txn1 = txn_manager_->BeginTransaction();
+
+  // txn 1 scans index for 15721 and gets a visible, correct result
+  *reinterpret_cast<int32_t *>(scan_key_pr->AccessForceNotNull(0)) = 15721;
+  default_index_->ScanKey(*txn1, *scan_key_pr, &results);
+  EXPECT_EQ(results.size(), 1);
+  EXPECT_EQ(tuple_slot, results[0]);
+  results.clear();
+
+  txn_manager_->Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // txn 1 scans index for 15721 and gets a visible, correct result
+  *reinterpret_cast<int32_t *>(scan_key_pr->AccessForceNotNull(0)) = 15721;
+  default_index_->ScanKey(*txn1, *scan_key_pr, &results);
+  EXPECT_EQ(results.size(), 1);
+  EXPECT_EQ(tuple_slot, results[0]);
+  results.clear();
+
+  txn_manager_->Commit(txn1, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *txn2 = txn_manager_->BeginTransaction();
+
+  // txn 2 scans index for 15721 and gets no visible result
+  *reinterpret_cast<int32_t *>(scan_key_pr->AccessForceNotNull(0)) = 15721;
+  default_index_->ScanKey(*txn2, *scan_key_pr, &results);
+  EXPECT_EQ(results.size(), 0);
+  results.clear();
+
+  txn_manager_->Commit(txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+// Verifies that scans over a GenericKey with NULLs and varlens that are not inlined return the keys in the order of the
+// BwTree's comparators, which the binary-comparable encoding has to preserve
+// NOLINTNEXTLINE
+TEST_F(ArtIndexTests, GenericKeyOrder) {
+  const uint32_t num_keys = 1000;
+  const uint16_t max_varlen_size = 20;
+
+  // key_schema {VARCHAR(20) NULL, INTEGER NULL}
+  std::vector<catalog::IndexSchema::Column> keycols;
+  keycols.emplace_back("", type::TypeId::VARCHAR, max_varlen_size, true,
+                       parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type::TypeId::VARCHAR)));
+  StorageTestUtil::ForceOid(&(keycols[0]), catalog::indexkeycol_oid_t(1));
+  keycols.emplace_back("", type::TypeId::INTEGER, true,
+                       parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type::TypeId::INTEGER)));
+  StorageTestUtil::ForceOid(&(keycols[1]), catalog::indexkeycol_oid_t(2));
+  catalog::IndexSchema generic_schema(keycols, storage::index::IndexType::ART, false, false, false, true);
+  auto *const generic_index = (IndexBuilder().SetKeySchema(generic_schema)).Build();
+  EXPECT_EQ(generic_index->Type(), storage::index::IndexType::ART);
+
+  const auto &key_oid_to_offset = generic_index->GetKeyOidToOffsetMap();
+  const uint16_t varchar_offset = key_oid_to_offset.at(catalog::indexkeycol_oid_t(1));
+  const uint16_t int_offset = key_oid_to_offset.at(catalog::indexkeycol_oid_t(2));
+  auto *const key_buffer =
+      common::AllocationUtil::AllocateAligned(generic_index->GetProjectedRowInitializer().ProjectedRowSize());
+  auto *const key = generic_index->GetProjectedRowInitializer().InitializeRow(key_buffer);
+
+  struct Key {
+    bool varchar_null_;
+    std::string varchar_;
+    bool int_null_;
+    int32_t int_;
+  };
+  auto set_key = [&](const Key &k) {
+    if (k.varchar_null_) {
+      key->SetNull(varchar_offset);
+    } else {
+      const auto *const content = reinterpret_cast<const byte *>(k.varchar_.data());
+      const auto size = static_cast<uint32_t>(k.varchar_.size());
+      *reinterpret_cast<VarlenEntry *>(key->AccessForceNotNull(varchar_offset)) =
+          size <= VarlenEntry::InlineThreshold() ? VarlenEntry::CreateInline(content, size)
+                                                 : VarlenEntry::Create(content, size, false);
+    }
+    if (k.int_null_) {
+      key->SetNull(int_offset);
+    } else {
+      *reinterpret_cast<int32_t *>(key->AccessForceNotNull(int_offset)) = k.int_;
+    }
+  };
+
+  std::uniform_int_distribution<uint32_t> length_dist(0, max_varlen_size);
+  std::uniform_int_distribution<int32_t> int_dist(-3, 3);
+  std::uniform_int_distribution<uint32_t> char_dist(0, 2);
+  std::vector<std::pair<Key, storage::TupleSlot>> reference;
+  auto *const insert_txn = txn_manager_->BeginTransaction();
+  for (uint32_t i = 0; i < num_keys; i++) {
+    Key k{i % 17 == 0, "", i % 13 == 0, int_dist(generator_)};
+    // A short alphabet makes for many shared prefixes, and its zero bytes exercise the escaping of the encoding
+    const uint32_t length = length_dist(generator_);
+    for (uint32_t j = 0; j < length; j++) {
+      const uint32_t c = char_dist(generator_);
+      k.varchar_.push_back(c == 0 ? '\0' : static_cast<char>(c == 1 ? 'a' : 0xF0));
+    }
+
+    auto *const insert_redo =
+        insert_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+    *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = i;
+    const auto tuple_slot = sql_table_->Insert(insert_txn, insert_redo);
+    reference.emplace_back(k, tuple_slot);
+    set_key(k);
+    EXPECT_TRUE(generic_index->Insert(insert_txn, *key, tuple_slot));
+  }
+  txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // NULL first, varlens by unsigned bytes with the shorter one first on a tie
+  std::stable_sort(reference.begin(), reference.end(), [](const auto &lhs, const auto &rhs) {
+    const Key &l = lhs.first, &r = rhs.first;
+    if (l.varchar_null_ != r.varchar_null_) return l.varchar_null_;
+    if (!l.varchar_null_) {
+      const int cmp = std::memcmp(l.varchar_.data(), r.varchar_.data(), std::min(l.varchar_.size(), r.varchar_.size()));
+      if (cmp != 0) return cmp < 0;
+      if (l.varchar_.size() != r.varchar_.size()) return l.varchar_.size() < r.varchar_.size();
+    }
+    if (l.int_null_ != r.int_null_) return l.int_null_;
+    return !l.int_null_ && l.int_ < r.int_;
+  });
+
+  auto *const high_key_buffer =
+      common::AllocationUtil::AllocateAligned(generic_index->GetProjectedRowInitializer().ProjectedRowSize());
+  auto *const high_key = generic_index->GetProjectedRowInitializer().InitializeRow(high_key_buffer);
+  const std::string max_varchar(max_varlen_size, static_cast<char>(0xFF));
+  *reinterpret_cast<VarlenEntry *>(high_key->AccessForceNotNull(varchar_offset)) =
+      VarlenEntry::Create(reinterpret_cast<const byte *>(max_varchar.data()), max_varlen_size, false);
+  *reinterpret_cast<int32_t *>(high_key->AccessForceNotNull(int_offset)) = std::numeric_limits<int32_t>::max();
+  key->SetNull(varchar_offset);
+  key->SetNull(int_offset);
+
+  auto *const scan_txn = txn_manager_->BeginTransaction();
+  std::vector<storage::TupleSlot> results;
+
+  // Equal keys may come back in any order, so only the sequence of keys is compared
+  auto key_of = [&](const storage::TupleSlot slot) {
+    const auto it = std::find_if(reference.cbegin(), reference.cend(), [=](const auto &p) { return p.second == slot; });
+    const Key &k = it->first;
+    return std::make_tuple(k.varchar_null_, k.varchar_, k.int_null_, k.int_null_ ? 0 : k.int_);
+  };
+
+  generic_index->ScanAscending(*scan_txn, *key, *high_key, &results);
+  EXPECT_EQ(results.size(), num_keys);
+  for (uint32_t i = 0; i < results.size(); i++) EXPECT_EQ(key_of(reference[i].second), key_of(results[i]));
+  results.clear();
+
+  generic_index->ScanDescending(*scan_txn, *key, *high_key, &results);
+  EXPECT_EQ(results.size(), num_keys);
+  for (uint32_t i = 0; i < results.size(); i++)
+    EXPECT_EQ(key_of(reference[num_keys - 1 - i].second), key_of(results[i]));
+  results.clear();
+
+  // Point lookups find every key, including the ones with NULLs
+  for (const auto &p : reference) {
+    set_key(p.first);
+    generic_index->ScanKey(*scan_txn, *key, &results);
+    EXPECT_TRUE(std::find(results.cbegin(), results.cend(), p.second) != results.cend());
+    results.clear();
+  }
+
+  txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  delete generic_index;
+  delete[] key_buffer;
+  delete[] high_key_buffer;
+}
+
+/**
+ * Threads insert and delete their own keys in the tree while looking up keys that stay in it throughout. The keys are
+ * laid out so that the churn splits and re-merges compressed paths, and grows and shrinks the node the churning keys
+ * share. Every stable key has to be found by every lookup and scan, and every churning key whenever its thread expects
+ * it to be there.
+ */
+// NOLINTNEXTLINE
+TEST_F(ArtIndexTests, ConcurrentTreeChurn) {
+  const uint32_t num_stable_keys = 4096;
+  const uint32_t num_churn_keys = 1024;
+  const uint32_t num_rounds = 50;
+  AdaptiveRadixTree tree;
+  storage::BlockStore block_store{1, 1};
+  storage::RawBlock *const block = block_store.Get();
+
+  // Stable keys have zero bytes at positions 1, 2, 4 and 5, which the tree compresses into paths. Churning keys set
+  // byte 1, which splits the path below their first byte, and fan out over byte 6 below it.
+  auto make_key = [](const uint32_t i, const bool churn, byte *const key) {
+    std::memset(key, 0, 8);
+    key[0] = static_cast<byte>((i >> 2) & 3);
+    key[1] = static_cast<byte>(churn ? 1 : 0);
+    key[3] = static_cast<byte>((i & 3) | ((i >> 4) & 1) << 2);
+    key[6] = static_cast<byte>((i >> 5) & 0xFF);
+    key[7] = static_cast<byte>(i >> 13);
+  };
+  auto stable_key_found = [&](const uint32_t i) {
+    byte key[8];
+    make_key(i, false, key);
+    std::vector<storage::TupleSlot> values;
+    tree.GetValue(key, 8, &values);
+    return values.size() == 1 && values[0] == storage::TupleSlot(block, i);
+  };
+
+  for (uint32_t i = 0; i < num_stable_keys; i++) {
+    byte key[8];
+    make_key(i, false, key);
+    EXPECT_TRUE(tree.Insert(key, 8, storage::TupleSlot(block, i)));
+  }
+
+  std::atomic<uint32_t> missing{0};
+  auto workload = [&](const uint32_t worker_id) {
+    std::default_random_engine generator(worker_id);
+    std::uniform_int_distribution<uint32_t> stable_dist(0, num_stable_keys - 1);
+    byte key[8];
+    std::vector<storage::TupleSlot> values;
+    for (uint32_t round = 0; round < num_rounds; round++) {
+      // the thread's churning keys are present after the first pass and gone after the second
+      for (const bool insert : {true, false}) {
+        for (uint32_t i = worker_id; i < num_churn_keys; i += num_threads_) {
+          make_key(i, true, key);
+          const storage::TupleSlot value(block, num_stable_keys + i);
+          if (!(insert ? tree.Insert(key, 8, value) : tree.Delete(key, 8, value))) missing++;
+          if (!stable_key_found(stable_dist(generator))) missing++;
+        }
+        for (uint32_t i = worker_id; i < num_churn_keys; i += num_threads_) {
+          make_key(i, true, key);
+          values.clear();
+          tree.GetValue(key, 8, &values);
+          if (values.size() != (insert ? 1 : 0)) missing++;
+        }
+      }
+      if (worker_id == 0) tree.PerformGarbageCollection();
+
+      // a full scan sees every stable key, whatever the other threads are churning
+      uint32_t num_stable_seen = 0;
+      byte low_key[8], high_key[8];
+      std::memset(low_key, 0, 8);
+      std::memset(high_key, 0xFF, 8);
+      tree.ScanAscending(low_key, 8, high_key, 8, [&](const storage::TupleSlot value) {
+        if (value.GetOffset() < num_stable_keys) num_stable_seen++;
+        return true;
+      });
+      if (num_stable_seen != num_stable_keys) missing++;
+    }
+  };
+
+  for (uint32_t i = 0; i < num_threads_; i++) {
+    thread_pool_.SubmitTask([i, &workload] { workload(i); });
+  }
+  thread_pool_.WaitUntilAllFinished();
+  EXPECT_EQ(missing.load(), 0);
+
+  // The churning keys are all gone again and the paths they split are merged back
+  for (uint32_t i = 0; i < num_stable_keys; i++) EXPECT_TRUE(stable_key_found(i));
+  std::vector<storage::TupleSlot> results;
+  byte low_key[8], high_key[8];
+  std::memset(low_key, 0, 8);
+  std::memset(high_key, 0xFF, 8);
+  tree.ScanDescending(low_key, 8, high_key, 8, [&](const storage::TupleSlot value) {
+    results.push_back(value);
+    return true;
+  });
+  EXPECT_EQ(results.size(), num_stable_keys);
+
+  block_store.Release(block);
+}
+
+}  // namespace terrier::storage::index
@@ -1,8 +1,13 @@
 #include "storage/block_compactor.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include <unordered_map>
 #include <vector>
 #include "common/hash_util.h"
+#include "storage/access_observer.h"
 #include "storage/block_access_controller.h"
+#include "storage/block_compactor_thread.h"
 #include "storage/garbage_collector.h"
 #include "storage/storage_defs.h"
 #include "storage/tuple_access_strategy.h"
@@ -252,6 +257,86 @@ TEST_F(BlockCompactorTest, GatherTest) {
   }
 }
 
+// This tests generates random single blocks and leaves it to the access observer and the background compaction threads
+// to freeze them. It then verifies that the logical content of the table does not change.
+// NOLINTNEXTLINE
+TEST_F(BlockCompactorTest, BackgroundCompactionTest) {
+  uint32_t repeat = 10;
+  for (uint32_t iteration = 0; iteration < repeat; iteration++) {
+    // The GC keeps running while the block is compacted, and frees the varlens the bookkeeping below still points to
+    // once they leave the block. Stay clear of that by not having any.
+    storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(100, &generator_);
+    storage::TupleAccessStrategy accessor(layout);
+    // Technically, the block above is not "in" the table, but since we don't sequential scan that does not matter
+    storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+    storage::RawBlock *block = block_store_.Get();
+    accessor.InitializeRawBlock(&table, block, storage::layout_version_t(0));
+
+    // Enable GC to cleanup transactions started by the block compactor, and to observe their writes
+    transaction::TimestampManager timestamp_manager;
+    transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+    transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                                DISABLED);
+    storage::BlockCompactor compactor;
+    // Consider blocks cold as soon as possible
+    storage::AccessObserver observer(&compactor, 1, storage::AccessObserver::DEFAULT_COLD_ACCESS_THRESHOLD);
+    storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, &observer);
+
+    auto tuples = StorageTestUtil::PopulateBlockRandomly(&table, block, percent_empty_, &generator_);
+    auto num_tuples = tuples.size();
+    auto tuple_set = GetTupleSet(layout, tuples);
+
+    // Manually populate the block header's arrow metadata for test initialization
+    auto &arrow_metadata = accessor.GetArrowBlockMetadata(block);
+    for (storage::col_id_t col_id : layout.AllColumns())
+      arrow_metadata.GetColumnInfo(layout, col_id).Type() = storage::ArrowColumnType::FIXED_LENGTH;
+
+    {
+      storage::BlockCompactorThread compactor_thread(&compactor, &deferred_action_manager, &txn_manager, 2,
+                                                     std::chrono::milliseconds(1), 1);
+      // The block was populated without transactions, so the GC never saw it being written to
+      compactor.PutInQueue(block);
+      // From here on, the GC finds the block again after every step of the compaction
+      auto *const block_state = block->controller_.GetBlockState();
+      for (uint32_t i = 0; i < 10000 && block_state->load() != storage::BlockState::FROZEN; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        gc.PerformGarbageCollection();
+      }
+    }
+    EXPECT_EQ(storage::BlockState::FROZEN, block->controller_.GetBlockState()->load());
+
+    // Read out the rows one-by-one. Check that the logical contents of the table did not change
+    auto initializer =
+        storage::ProjectedRowInitializer::Create(layout, StorageTestUtil::ProjectionListAllColumns(layout));
+    byte *buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedRowSize());
+    auto *read_row = initializer.InitializeRow(buffer);
+    transaction::TransactionContext *txn = txn_manager.BeginTransaction();
+    for (uint32_t i = 0; i < num_tuples; i++) {
+      storage::TupleSlot slot(block, i);
+      bool visible = table.Select(txn, slot, read_row);
+      EXPECT_TRUE(visible);  // Should be filled after compaction
+      auto entry = tuple_set.find(read_row);
+      EXPECT_NE(entry, tuple_set.end());  // Should be present in the original
+      if (entry != tuple_set.end()) {
+        EXPECT_GT(entry->second, 0);
+        entry->second--;
+      }
+    }
+    txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);  // Commit: will be cleaned up by GC
+    delete[] buffer;
+
+    for (auto &entry : tuple_set) {
+      EXPECT_EQ(entry.second, 0);  // All tuples from the original block should have been accounted for.
+    }
+
+    for (auto &entry : tuples) delete[] reinterpret_cast<byte *>(entry.second);  // reclaim memory used for bookkeeping
+
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();  // Second call to deallocate.
+    block_store_.Release(block);
+  }
+}
+
 // This tests generates random single blocks and dictionary compresses them. It then verifies that the logical contents
 // of the table does not change, and the varlens are properly compressed. We only test single blocks because gathering
 // happens block at a time.
@@ -371,4 +456,134 @@ TEST_F(BlockCompactorTest, DictionaryCompressionTest) {
   }
 }
 
+// This tests generates random single blocks, freezes them, and checks the zone maps and null counts recorded for every
+// column against the contents of the block.
+// NOLINTNEXTLINE
+TEST_F(BlockCompactorTest, ZoneMapTest) {
+  uint32_t repeat = 10;
+  for (uint32_t iteration = 0; iteration < repeat; iteration++) {
+    storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(100, &generator_);
+    storage::TupleAccessStrategy accessor(layout);
+    // Technically, the block above is not "in" the table, but since we don't sequential scan that does not matter
+    storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+    storage::RawBlock *block = block_store_.Get();
+    accessor.InitializeRawBlock(&table, block, storage::layout_version_t(0));
+
+    // Enable GC to cleanup transactions started by the block compactor
+    transaction::TimestampManager timestamp_manager;
+    transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+    transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                                DISABLED);
+    storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+
+    auto tuples = StorageTestUtil::PopulateBlockRandomly(&table, block, percent_empty_, &generator_);
+
+    // Manually populate the block header's arrow metadata for test initialization
+    auto &arrow_metadata = accessor.GetArrowBlockMetadata(block);
+    for (storage::col_id_t col_id : layout.AllColumns())
+      arrow_metadata.GetColumnInfo(layout, col_id).Type() = storage::ArrowColumnType::FIXED_LENGTH;
+
+    storage::BlockCompactor compactor;
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);  // compaction pass
+
+    // Need to prune the version chain in order to make sure that the second pass succeeds
+    gc.PerformGarbageCollection();
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);  // gathering pass
+    EXPECT_EQ(storage::BlockState::FROZEN, block->controller_.GetBlockState()->load());
+
+    const uint32_t num_records = table.InPlaceNumRecords(block);
+    EXPECT_EQ(num_records, tuples.size());
+    for (storage::col_id_t col_id : layout.AllColumns()) {
+      uint32_t null_count = 0;
+      int64_t min = std::numeric_limits<int64_t>::max(), max = std::numeric_limits<int64_t>::min();
+      for (uint32_t i = 0; i < num_records; i++) {
+        const byte *value = accessor.AccessWithNullCheck(storage::TupleSlot(block, i), col_id);
+        if (value == nullptr) {
+          null_count++;
+          continue;
+        }
+        int64_t int_value;
+        switch (layout.AttrSize(col_id)) {
+          case sizeof(int8_t):
+            int_value = *reinterpret_cast<const int8_t *>(value);
+            break;
+          case sizeof(int16_t):
+            int_value = *reinterpret_cast<const int16_t *>(value);
+            break;
+          case sizeof(int32_t):
+            int_value = *reinterpret_cast<const int32_t *>(value);
+            break;
+          default:
+            int_value = *reinterpret_cast<const int64_t *>(value);
+            break;
+        }
+        min = std::min(min, int_value);
+        max = std::max(max, int_value);
+      }
+      EXPECT_EQ(null_count, table.InPlaceNullCount(block, col_id));
+      if (null_count == num_records) continue;
+      const storage::ZoneMap &zone_map = table.InPlaceArrowColumnInfo(block, col_id)->GetZoneMap();
+      EXPECT_EQ(min, zone_map.min_);
+      EXPECT_EQ(max, zone_map.max_);
+    }
+
+    for (auto &entry : tuples) delete[] reinterpret_cast<byte *>(entry.second);  // reclaim memory used for bookkeeping
+
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();  // Second call to deallocate.
+    block_store_.Release(block);
+  }
+}
+
+// This tests that a cooling block the compactor puts back in the queue is dropped from it if a writer thaws the block
+// before it comes up again, instead of being compacted again without going through cold detection.
+// NOLINTNEXTLINE
+TEST_F(BlockCompactorTest, ThawedWhileRequeuedTest) {
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(100, &generator_);
+  storage::TupleAccessStrategy accessor(layout);
+  // Technically, the block above is not "in" the table, but since we don't sequential scan that does not matter
+  storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+  storage::RawBlock *block = block_store_.Get();
+  accessor.InitializeRawBlock(&table, block, storage::layout_version_t(0));
+
+  // Enable GC to cleanup transactions started by the block compactor
+  transaction::TimestampManager timestamp_manager;
+  transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+  transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                              DISABLED);
+  storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+
+  // Leave enough gaps that the compaction transaction is certain to move tuples and leave versions behind
+  auto tuples = StorageTestUtil::PopulateBlockRandomly(&table, block, 0.5, &generator_);
+
+  storage::BlockCompactor compactor;
+  compactor.PutInQueue(block);
+  EXPECT_EQ(1, compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager));  // compaction pass
+  ASSERT_EQ(storage::BlockState::COOLING, block->controller_.GetBlockState()->load());
+
+  // Without pruning the versions, the gathering pass puts the block back in the queue
+  compactor.PutInQueue(block);
+  EXPECT_EQ(1, compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager));
+  EXPECT_EQ(storage::BlockState::COOLING, block->controller_.GetBlockState()->load());
+
+  // A writer thaws the block, so the entry that was put back has to go
+  block->controller_.WaitUntilHot();
+  EXPECT_EQ(0, compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager));
+  EXPECT_EQ(storage::BlockState::HOT, block->controller_.GetBlockState()->load());
+
+  // Once the block is found cold again, it is compacted as usual
+  gc.PerformGarbageCollection();
+  compactor.PutInQueue(block);
+  EXPECT_EQ(1, compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager));
+  EXPECT_EQ(storage::BlockState::COOLING, block->controller_.GetBlockState()->load());
+
+  for (auto &entry : tuples) delete[] reinterpret_cast<byte *>(entry.second);  // reclaim memory used for bookkeeping
+
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();  // Second call to deallocate.
+  block_store_.Release(block);
+}
+
 }  // namespace terrier
@@ -0,0 +1,59 @@
+#include "storage/block_directory.h"
+#include <unordered_set>
+#include <vector>
+#include "common/worker_pool.h"
+#include "util/multithread_test_util.h"
+#include "util/test_harness.h"
+
+namespace terrier {
+
+// The directory only stores block pointers and never dereferences them, so tests can use made up ones
+static storage::RawBlock *FakeBlock(const uint32_t id) {
+  return reinterpret_cast<storage::RawBlock *>(static_cast<uintptr_t>(id + 1) * sizeof(uint64_t));
+}
+
+// Tests that blocks are found at the index they were appended at, across several chunks
+// NOLINTNEXTLINE
+TEST(BlockDirectoryTest, SimpleAppend) {
+  const uint32_t num_blocks = 10000;
+  storage::BlockDirectory tested;
+  EXPECT_TRUE(tested.Empty());
+  for (uint32_t i = 0; i < num_blocks; i++) {
+    EXPECT_EQ(tested.Append(FakeBlock(i)), i);
+    EXPECT_EQ(tested.Size(), i + 1);
+  }
+  for (uint32_t i = 0; i < num_blocks; i++) EXPECT_EQ(tested[i], FakeBlock(i));
+}
+
+// Tests that concurrent appends each get their own index, and that readers never see an unpublished entry
+// NOLINTNEXTLINE
+TEST(BlockDirectoryTest, ConcurrentAppend) {
+  const uint32_t num_iterations = 10;
+  const uint32_t num_threads = MultiThreadTestUtil::HardwareConcurrency();
+  const uint32_t blocks_per_thread = 5000;
+  common::WorkerPool thread_pool(num_threads, {});
+  for (uint32_t iteration = 0; iteration < num_iterations; iteration++) {
+    storage::BlockDirectory tested;
+    std::vector<std::vector<uint32_t>> indexes(num_threads);
+    auto workload = [&](uint32_t thread_id) {
+      for (uint32_t i = 0; i < blocks_per_thread; i++) {
+        indexes[thread_id].push_back(tested.Append(FakeBlock(thread_id * blocks_per_thread + i)));
+        // Everything below a snapshot of the size has to be filled in
+        const uint32_t size = tested.Size();
+        EXPECT_GT(size, 0);
+        EXPECT_NE(tested[size - 1], nullptr);
+      }
+    };
+    MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, workload);
+
+    EXPECT_EQ(tested.Size(), num_threads * blocks_per_thread);
+    std::unordered_set<storage::RawBlock *> seen;
+    for (uint32_t thread_id = 0; thread_id < num_threads; thread_id++) {
+      for (uint32_t i = 0; i < blocks_per_thread; i++)
+        EXPECT_EQ(tested[indexes[thread_id][i]], FakeBlock(thread_id * blocks_per_thread + i));
+    }
+    for (uint32_t i = 0; i < tested.Size(); i++) EXPECT_TRUE(seen.insert(tested[i]).second);
+  }
+}
+
+}  // namespace terrier
@@ -0,0 +1,344 @@
+#include "storage/block_tiering_manager.h"
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "storage/block_compactor.h"
+#include "storage/garbage_collector.h"
+#include "storage/storage_defs.h"
+#include "storage/tuple_access_strategy.h"
+#include "transaction/deferred_action_manager.h"
+#include "util/storage_test_util.h"
+#include "util/test_harness.h"
+
+namespace terrier {
+
+struct BlockTieringManagerTest : public ::terrier::TerrierTest {
+  storage::BlockStore block_store_{100, 100};
+  std::default_random_engine generator_;
+  storage::RecordBufferSegmentPool buffer_pool_{100000, 100000};
+  double percent_empty_ = 0.01;
+  const std::string directory_ = "block_tiering_test";
+
+  void TearDown() override {
+    rmdir(directory_.c_str());
+    TerrierTest::TearDown();
+  }
+
+  // Populates a block randomly and freezes it with a compactor that hands it to the given tiering manager. The block is
+  // taken from the block store unless one is given.
+  storage::RawBlock *FrozenBlock(storage::DataTable *table, storage::BlockTieringManager *tiering_manager,
+                                 transaction::DeferredActionManager *deferred_action_manager,
+                                 transaction::TransactionManager *txn_manager, storage::GarbageCollector *gc,
+                                 storage::RawBlock *block = nullptr) {
+    const storage::BlockLayout &layout = table->GetBlockLayout();
+    storage::TupleAccessStrategy accessor(layout);
+    if (block == nullptr) block = block_store_.Get();
+    accessor.InitializeRawBlock(table, block, storage::layout_version_t(0));
+    auto tuples = StorageTestUtil::PopulateBlockRandomly(table, block, percent_empty_, &generator_);
+    for (auto &entry : tuples) delete[] reinterpret_cast<byte *>(entry.second);  // reclaim memory used for bookkeeping
+
+    // Manually populate the block header's arrow metadata for test initialization
+    auto &arrow_metadata = accessor.GetArrowBlockMetadata(block);
+    for (storage::col_id_t col_id : layout.AllColumns())
+      arrow_metadata.GetColumnInfo(layout, col_id).Type() =
+          layout.IsVarlen(col_id) ? storage::ArrowColumnType::GATHERED_VARLEN : storage::ArrowColumnType::FIXED_LENGTH;
+
+    storage::BlockCompactor compactor(tiering_manager);
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(deferred_action_manager, txn_manager);  // compaction pass
+    // Need to prune the version chain in order to make sure that the second pass succeeds
+    gc->PerformGarbageCollection();
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(deferred_action_manager, txn_manager);  // gathering pass
+    EXPECT_EQ(storage::BlockState::FROZEN, block->controller_.GetBlockState()->load());
+    return block;
+  }
+
+  // Releases a block taken from the block store. The tiering manager has to let go of the block first, as tables do.
+  void ReleaseBlock(const storage::BlockLayout &layout, storage::BlockTieringManager *tiering_manager,
+                    storage::RawBlock *block) {
+    tiering_manager->Untrack(block);
+    EXPECT_FALSE(FileBacked(block));
+    storage::TupleAccessStrategy accessor(layout);
+    for (storage::col_id_t col_id : layout.AllColumns())
+      accessor.GetArrowBlockMetadata(block).GetColumnInfo(layout, col_id).Deallocate();
+    block_store_.Release(block);
+  }
+
+  // Whether any of the block's memory is mapped from a file, according to /proc/self/maps
+  static bool FileBacked(storage::RawBlock *block) {
+    const auto block_start = reinterpret_cast<uintptr_t>(block);
+    const uintptr_t block_end = block_start + common::Constants::BLOCK_SIZE;
+    std::FILE *maps = std::fopen("/proc/self/maps", "r");
+    EXPECT_NE(nullptr, maps);
+    if (maps == nullptr) return false;
+    bool file_backed = false;
+    char line[4096];
+    while (std::fgets(line, sizeof(line), maps) != nullptr) {
+      // start-end perms offset dev inode path, where anonymous memory has inode 0
+      uintptr_t start, end;
+      uint64_t inode;
+      if (std::sscanf(line, "%lx-%lx %*s %*s %*s %lu", &start, &end, &inode) != 3) continue;
+      if (start < block_end && block_start < end && inode != 0) file_backed = true;
+    }
+    std::fclose(maps);
+    return file_backed;
+  }
+};
+
+// This tests freezes random blocks with a memory budget of zero, and checks that they are spilled to a well-formed file
+// without any change to their contents as seen by readers.
+// NOLINTNEXTLINE
+TEST_F(BlockTieringManagerTest, SpillTest) {
+  uint32_t repeat = 10;
+  for (uint32_t iteration = 0; iteration < repeat; iteration++) {
+    storage::BlockLayout layout = StorageTestUtil::RandomLayoutWithVarlens(100, &generator_);
+    // The tiering manager has to outlive the tables whose blocks it tracks
+    storage::BlockTieringManager tiering_manager(directory_, 0);
+    // Technically, the block above is not "in" the table, but since we don't sequential scan that does not matter
+    storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+
+    // Enable GC to cleanup transactions started by the block compactor
+    transaction::TimestampManager timestamp_manager;
+    transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+    transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                                DISABLED);
+    storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+
+    storage::RawBlock *block = FrozenBlock(&table, &tiering_manager, &deferred_action_manager, &txn_manager, &gc);
+    EXPECT_EQ(static_cast<uint64_t>(common::Constants::BLOCK_SIZE), tiering_manager.ResidentBytes());
+    auto *snapshot = new storage::RawBlock;
+    std::memcpy(snapshot, block, common::Constants::BLOCK_SIZE);
+
+    EXPECT_EQ(1, tiering_manager.ProcessBlocks());
+    EXPECT_EQ(1, tiering_manager.NumSpilledBlocks());
+    EXPECT_EQ(0, tiering_manager.ResidentBytes());
+    EXPECT_TRUE(FileBacked(block));
+    // The pages of the block fault back in from the file with the same contents
+    EXPECT_EQ(0, std::memcmp(snapshot, block, common::Constants::BLOCK_SIZE));
+    delete snapshot;
+
+    const std::string path = tiering_manager.SpilledFile(block);
+    ASSERT_FALSE(path.empty());
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    ASSERT_NE(nullptr, file);
+    storage::BlockTieringManager::FileHeader header;
+    ASSERT_EQ(1, std::fread(&header, sizeof(header), 1, file));
+    EXPECT_EQ(storage::BlockTieringManager::FILE_MAGIC, header.magic_);
+    EXPECT_EQ(storage::BlockTieringManager::FILE_VERSION, header.version_);
+    EXPECT_EQ(layout.NumColumns() - NUM_RESERVED_COLUMNS, header.num_columns_);
+    EXPECT_EQ(layout.NumSlots(), header.num_slots_);
+    EXPECT_EQ(table.InPlaceNumRecords(block), header.num_records_);
+
+    // Every column's buffers in the file match the ones readers see in memory
+    std::vector<storage::BlockTieringManager::ColumnDescriptor> descriptors(header.num_columns_);
+    ASSERT_EQ(header.num_columns_, std::fread(descriptors.data(), sizeof(descriptors[0]), header.num_columns_, file));
+    const std::vector<storage::col_id_t> columns = layout.AllColumns();
+    for (uint32_t i = 0; i < columns.size(); i++) {
+      const storage::col_id_t col_id = columns[i];
+      const storage::BlockTieringManager::ColumnDescriptor &descriptor = descriptors[i];
+      EXPECT_EQ(table.InPlaceNullCount(block, col_id), descriptor.null_count_);
+      std::vector<byte> values(descriptor.values_length_);
+      ASSERT_EQ(0, std::fseek(file, static_cast<int64_t>(descriptor.values_offset_), SEEK_SET));
+      ASSERT_EQ(values.size(), std::fread(values.data(), 1, values.size(), file));
+      const byte *expected = layout.IsVarlen(col_id)
+                                 ? table.InPlaceArrowColumnInfo(block, col_id)->VarlenColumn().Values()
+                                 : table.InPlaceColumnValues(block, col_id, 0);
+      EXPECT_EQ(0, std::memcmp(expected, values.data(), values.size()));
+    }
+    std::fclose(file);
+
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();  // Second call to deallocate.
+    ReleaseBlock(layout, &tiering_manager, block);
+  }
+}
+
+// This tests spills a block, thaws it like a writer would, and checks that the tiering manager stops tracking it,
+// copies it back into memory and deletes its file while its contents stay intact.
+// NOLINTNEXTLINE
+TEST_F(BlockTieringManagerTest, ThawTest) {
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutWithVarlens(100, &generator_);
+  storage::BlockTieringManager tiering_manager(directory_, 0);
+  storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+  transaction::TimestampManager timestamp_manager;
+  transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+  transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                              DISABLED);
+  storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+
+  storage::RawBlock *block = FrozenBlock(&table, &tiering_manager, &deferred_action_manager, &txn_manager, &gc);
+  EXPECT_EQ(1, tiering_manager.ProcessBlocks());
+  const std::string path = tiering_manager.SpilledFile(block);
+  ASSERT_FALSE(path.empty());
+  auto *snapshot = new storage::RawBlock;
+  std::memcpy(snapshot, block, common::Constants::BLOCK_SIZE);
+
+  // Writers thaw the block through the tiering manager before the access controller, as DataTable does
+  tiering_manager.Thaw(block);
+  EXPECT_EQ(storage::BlockState::HOT, block->controller_.GetBlockState()->load());
+  block->controller_.WaitUntilHot();
+  EXPECT_EQ(0, tiering_manager.NumSpilledBlocks());
+  EXPECT_TRUE(tiering_manager.SpilledFile(block).empty());
+  EXPECT_FALSE(FileBacked(block));
+  struct stat file_stat;
+  EXPECT_EQ(-1, stat(path.c_str(), &file_stat));
+  EXPECT_EQ(0, tiering_manager.ProcessBlocks());
+  EXPECT_EQ(0, tiering_manager.ResidentBytes());
+  // Writes go to the block's own memory, and the rest still reads the same
+  std::memset(block->content_ + common::Constants::BLOCK_SIZE / 2, 0, 1);
+  snapshot->content_[common::Constants::BLOCK_SIZE / 2] = static_cast<byte>(0);
+  EXPECT_EQ(0, std::memcmp(snapshot->content_, block->content_, sizeof(block->content_)));
+  delete snapshot;
+
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();  // Second call to deallocate.
+  ReleaseBlock(layout, &tiering_manager, block);
+}
+
+// This tests thaws a spilled block without going through the tiering manager, and checks that the manager keeps
+// tracking it until it freezes again, at which point the block is copied back into memory and its file deleted.
+// NOLINTNEXTLINE
+TEST_F(BlockTieringManagerTest, RefreezeTest) {
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutWithVarlens(100, &generator_);
+  storage::BlockTieringManager tiering_manager(directory_, 0);
+  storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+  transaction::TimestampManager timestamp_manager;
+  transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+  transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                              DISABLED);
+  storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+
+  storage::RawBlock *block = FrozenBlock(&table, &tiering_manager, &deferred_action_manager, &txn_manager, &gc);
+  EXPECT_EQ(1, tiering_manager.ProcessBlocks());
+  const std::string path = tiering_manager.SpilledFile(block);
+  ASSERT_FALSE(path.empty());
+
+  // Writers may be in the block, so its memory cannot be replaced until it freezes again
+  block->controller_.WaitUntilHot();
+  EXPECT_EQ(0, tiering_manager.ProcessBlocks());
+  EXPECT_EQ(1, tiering_manager.NumSpilledBlocks());
+  EXPECT_TRUE(FileBacked(block));
+
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();  // Second call to deallocate.
+  for (storage::col_id_t col_id : layout.AllColumns())
+    storage::TupleAccessStrategy(layout).GetArrowBlockMetadata(block).GetColumnInfo(layout, col_id).Deallocate();
+  FrozenBlock(&table, &tiering_manager, &deferred_action_manager, &txn_manager, &gc, block);
+  EXPECT_EQ(0, tiering_manager.NumSpilledBlocks());
+  EXPECT_EQ(static_cast<uint64_t>(common::Constants::BLOCK_SIZE), tiering_manager.ResidentBytes());
+  EXPECT_FALSE(FileBacked(block));
+  struct stat file_stat;
+  EXPECT_EQ(-1, stat(path.c_str(), &file_stat));
+
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();  // Second call to deallocate.
+  ReleaseBlock(layout, &tiering_manager, block);
+}
+
+// This tests checks that only the least recently accessed blocks are spilled, and only as many as the budget requires.
+// NOLINTNEXTLINE
+TEST_F(BlockTieringManagerTest, RecencyTest) {
+  const uint32_t num_blocks = 4;
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(100, &generator_);
+  storage::BlockTieringManager tiering_manager(directory_, 2 * common::Constants::BLOCK_SIZE);
+  storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+  transaction::TimestampManager timestamp_manager;
+  transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+  transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                              DISABLED);
+  storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+
+  std::vector<storage::RawBlock *> blocks;
+  for (uint32_t i = 0; i < num_blocks; i++)
+    blocks.push_back(FrozenBlock(&table, &tiering_manager, &deferred_action_manager, &txn_manager, &gc));
+  // Access the first half of the blocks, the other half should be spilled to fit the budget
+  for (uint32_t i = 0; i < num_blocks / 2; i++) blocks[i]->access_count_.fetch_add(1);
+  EXPECT_EQ(num_blocks / 2, tiering_manager.ProcessBlocks());
+  for (uint32_t i = 0; i < num_blocks; i++)
+    EXPECT_EQ(i >= num_blocks / 2, !tiering_manager.SpilledFile(blocks[i]).empty());
+  EXPECT_EQ(2 * common::Constants::BLOCK_SIZE, tiering_manager.ResidentBytes());
+  // Within budget now, so nothing else is spilled
+  EXPECT_EQ(0, tiering_manager.ProcessBlocks());
+
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();  // Second call to deallocate.
+  for (auto *block : blocks) ReleaseBlock(layout, &tiering_manager, block);
+}
+
+// This tests checks that reading a frozen block in place, the way TableVectorIterator scans it, counts as an access
+// that keeps the block from being spilled.
+// NOLINTNEXTLINE
+TEST_F(BlockTieringManagerTest, InPlaceReadTest) {
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(100, &generator_);
+  storage::BlockTieringManager tiering_manager(directory_, common::Constants::BLOCK_SIZE);
+  storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+  transaction::TimestampManager timestamp_manager;
+  transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+  transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                              DISABLED);
+  storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+
+  std::vector<storage::RawBlock *> blocks;
+  for (uint32_t i = 0; i < 2; i++)
+    blocks.push_back(FrozenBlock(&table, &tiering_manager, &deferred_action_manager, &txn_manager, &gc));
+  // Of two blocks accessed equally long ago, the one at the lower address is spilled first, so read that one
+  std::sort(blocks.begin(), blocks.end());
+  ASSERT_TRUE(table.TryAcquireInPlaceRead(blocks[0]));
+  table.ReleaseInPlaceRead(blocks[0]);
+  EXPECT_EQ(1, tiering_manager.ProcessBlocks());
+  EXPECT_TRUE(tiering_manager.SpilledFile(blocks[0]).empty());
+  EXPECT_FALSE(tiering_manager.SpilledFile(blocks[1]).empty());
+
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();  // Second call to deallocate.
+  for (auto *block : blocks) ReleaseBlock(layout, &tiering_manager, block);
+}
+
+// This tests drops tables with a spilled and a resident frozen block, and checks that the tiering manager stops
+// tracking both and deletes the file before the blocks go back to the block store, so that it never touches them again.
+// NOLINTNEXTLINE
+TEST_F(BlockTieringManagerTest, DropTableTest) {
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutWithVarlens(100, &generator_);
+  transaction::TimestampManager timestamp_manager;
+  transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+  transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                              DISABLED);
+  storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+  storage::BlockTieringManager tiering_manager(directory_, common::Constants::BLOCK_SIZE);
+
+  // Freeze the first block of each table, which is part of the table unlike the ones FrozenBlock takes from the store
+  auto *spilled_table = new storage::DataTable(&block_store_, layout, storage::layout_version_t(0));
+  auto *resident_table = new storage::DataTable(&block_store_, layout, storage::layout_version_t(0));
+  storage::RawBlock *spilled_block = FrozenBlock(spilled_table, &tiering_manager, &deferred_action_manager,
+                                                 &txn_manager, &gc, spilled_table->begin()->GetBlock());
+  storage::RawBlock *resident_block = FrozenBlock(resident_table, &tiering_manager, &deferred_action_manager,
+                                                  &txn_manager, &gc, resident_table->begin()->GetBlock());
+  resident_block->access_count_.fetch_add(1);
+  EXPECT_EQ(1, tiering_manager.ProcessBlocks());
+  const std::string path = tiering_manager.SpilledFile(spilled_block);
+  ASSERT_FALSE(path.empty());
+  EXPECT_TRUE(tiering_manager.SpilledFile(resident_block).empty());
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();  // Second call to deallocate.
+
+  delete spilled_table;
+  // The block store keeps the block for reuse, but it must be back in anonymous memory
+  EXPECT_FALSE(FileBacked(spilled_block));
+  EXPECT_EQ(0, tiering_manager.NumSpilledBlocks());
+  EXPECT_EQ(static_cast<uint64_t>(common::Constants::BLOCK_SIZE), tiering_manager.ResidentBytes());
+  EXPECT_TRUE(tiering_manager.SpilledFile(spilled_block).empty());
+  struct stat file_stat;
+  EXPECT_EQ(-1, stat(path.c_str(), &file_stat));
+
+  delete resident_table;
+  EXPECT_EQ(0, tiering_manager.ResidentBytes());
+  EXPECT_EQ(0, tiering_manager.ProcessBlocks());
+}
+
+}  // namespace terrier
@@ -3,6 +3,7 @@
 #include <limits>
 #include <map>
 #include <random>
+#include <unordered_set>
 #include <vector>
 #include "parser/expression/column_value_expression.h"
 #include "portable_endian/portable_endian.h"
@@ -52,6 +53,8 @@ class BwTreeIndexTests : public TerrierTest {
     StorageTestUtil::ForceOid(&(keycols[0]), catalog::indexkeycol_oid_t(1));
     unique_schema_ = catalog::IndexSchema(keycols, storage::index::IndexType::BWTREE, true, true, false, true);
     default_schema_ = catalog::IndexSchema(keycols, storage::index::IndexType::BWTREE, false, false, false, true);
+    unique_schema_.ExtractIndexedColOids();
+    default_schema_.ExtractIndexedColOids();
   }
 
   std::default_random_engine generator_;
@@ -1941,4 +1944,126 @@ TEST_F(BwTreeIndexTests, AbortDelete2) {
   txn_manager_->Commit(txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
 }
 
+/**
+ * Fills the table with two tuples per key and an aborted txn's tuples, then bulk loads the default index from it with
+ * the sort spread over the worker pool. The index should hold exactly the committed tuples and keep working afterwards.
+ */
+// NOLINTNEXTLINE
+TEST_F(BwTreeIndexTests, BulkLoad) {
+  const int32_t num_keys = 50000;
+  const int32_t dup_num = 2;
+  std::map<int32_t, std::vector<storage::TupleSlot>> reference;
+
+  auto *const insert_txn = txn_manager_->BeginTransaction();
+  for (int32_t i = 0; i < num_keys * dup_num; i++) {
+    auto *const insert_redo =
+        insert_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+    *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = i % num_keys;
+    reference[i % num_keys].push_back(sql_table_->Insert(insert_txn, insert_redo));
+  }
+  txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *const aborted_txn = txn_manager_->BeginTransaction();
+  for (int32_t i = 0; i < num_keys; i++) {
+    auto *const insert_redo =
+        aborted_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+    *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = i;
+    sql_table_->Insert(aborted_txn, insert_redo);
+  }
+  txn_manager_->Abort(aborted_txn);
+
+  auto *const load_txn = txn_manager_->BeginTransaction();
+  EXPECT_TRUE(default_index_->BulkLoad(load_txn, common::ManagedPointer<storage::SqlTable>(sql_table_), &thread_pool_));
+  txn_manager_->Commit(load_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *const scan_txn = txn_manager_->BeginTransaction();
+  std::vector<storage::TupleSlot> results;
+  auto *const low_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  auto *const high_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_2_);
+
+  // scan[0,num_keys) should hit every committed tuple
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 0;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = num_keys - 1;
+  default_index_->ScanAscending(*scan_txn, *low_key_pr, *high_key_pr, &results);
+  EXPECT_EQ(results.size(), num_keys * dup_num);
+  results.clear();
+
+  for (int32_t i = 0; i < num_keys; i += 97) {
+    *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = i;
+    default_index_->ScanKey(*scan_txn, *low_key_pr, &results);
+    const auto &expected = reference.at(i);
+    EXPECT_EQ(std::unordered_set<storage::TupleSlot>(expected.cbegin(), expected.cend()),
+              std::unordered_set<storage::TupleSlot>(results.cbegin(), results.cend()));
+    results.clear();
+  }
+  txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // Inserts after the bulk load go into the loaded nodes
+  auto *const insert_txn2 = txn_manager_->BeginTransaction();
+  auto *const insert_redo =
+      insert_txn2->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+  *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = num_keys / 2;
+  const auto tuple_slot = sql_table_->Insert(insert_txn2, insert_redo);
+  auto *const insert_key = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  *reinterpret_cast<int32_t *>(insert_key->AccessForceNotNull(0)) = num_keys / 2;
+  EXPECT_TRUE(default_index_->Insert(insert_txn2, *insert_key, tuple_slot));
+  txn_manager_->Commit(insert_txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *const scan_txn2 = txn_manager_->BeginTransaction();
+  default_index_->ScanKey(*scan_txn2, *insert_key, &results);
+  EXPECT_EQ(results.size(), dup_num + 1);
+  txn_manager_->Commit(scan_txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+/**
+ * Bulk loads the unique index from a table with distinct keys, which should succeed, and then a fresh unique index from
+ * the same table after a duplicate key was committed, which should fail.
+ */
+// NOLINTNEXTLINE
+TEST_F(BwTreeIndexTests, BulkLoadUnique) {
+  const int32_t num_keys = 1000;
+  auto *const insert_txn = txn_manager_->BeginTransaction();
+  for (int32_t i = 0; i < num_keys; i++) {
+    auto *const insert_redo =
+        insert_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+    *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = i;
+    sql_table_->Insert(insert_txn, insert_redo);
+  }
+  txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *const load_txn = txn_manager_->BeginTransaction();
+  EXPECT_TRUE(unique_index_->BulkLoad(load_txn, common::ManagedPointer<storage::SqlTable>(sql_table_), nullptr));
+  txn_manager_->Commit(load_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *const scan_txn = txn_manager_->BeginTransaction();
+  std::vector<storage::TupleSlot> results;
+  auto *const low_key_pr = unique_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  auto *const high_key_pr = unique_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_2_);
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 0;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = num_keys - 1;
+  unique_index_->ScanAscending(*scan_txn, *low_key_pr, *high_key_pr, &results);
+  EXPECT_EQ(results.size(), num_keys);
+  txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *const duplicate_txn = txn_manager_->BeginTransaction();
+  auto *const insert_redo =
+      duplicate_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+  *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = num_keys / 2;
+  sql_table_->Insert(duplicate_txn, insert_redo);
+  txn_manager_->Commit(duplicate_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  std::vector<catalog::IndexSchema::Column> keycols;
+  keycols.emplace_back("", type::TypeId::INTEGER, false,
+                       parser::ColumnValueExpression(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID,
+                                                     catalog::col_oid_t(1)));
+  StorageTestUtil::ForceOid(&(keycols[0]), catalog::indexkeycol_oid_t(1));
+  catalog::IndexSchema unique_schema(keycols, storage::index::IndexType::BWTREE, true, true, false, true);
+  unique_schema.ExtractIndexedColOids();
+
+  auto *const load_txn2 = txn_manager_->BeginTransaction();
+  EXPECT_EQ(nullptr, IndexBuilder().SetKeySchema(unique_schema).BuildAndLoad(
+                         load_txn2, common::ManagedPointer<storage::SqlTable>(sql_table_), nullptr));
+  txn_manager_->Abort(load_txn2);
+}
+
 }  // namespace terrier::storage::index
@@ -221,6 +221,54 @@ TEST_F(BwTreeTests, ReverseIterator) {
   delete tree;
 }
 
+/**
+ * Bulk loads sorted keys with duplicates into an empty tree, then checks that lookups and iteration see all of them and
+ * that inserts between the loaded keys still work.
+ */
+// NOLINTNEXTLINE
+TEST_F(BwTreeTests, BulkLoad) {
+  auto *const tree = BwTreeTestUtil::GetEmptyTree();
+  const int64_t key_num = 1024 * 1024;
+  const int64_t dup_num = 3;
+
+  // Load the even keys, each with several values
+  std::vector<std::pair<int64_t, int64_t>> items;
+  for (int64_t i = 0; i < key_num; i++) {
+    for (int64_t j = 0; j < dup_num; j++) items.emplace_back(2 * i, j);
+  }
+  tree->BulkLoad(items);
+
+  int64_t count = 0;
+  for (auto it = tree->Begin(); !it.IsEnd(); it++) {
+    EXPECT_EQ(it->first, 2 * (count / dup_num));
+    count++;
+  }
+  EXPECT_EQ(count, key_num * dup_num);
+
+  std::vector<int64_t> values;
+  for (int64_t i = 0; i < key_num; i += 1023) {
+    tree->GetValue(2 * i, values);
+    EXPECT_EQ(values.size(), dup_num);
+    values.clear();
+    tree->GetValue(2 * i + 1, values);
+    EXPECT_TRUE(values.empty());
+  }
+
+  // Insert the odd keys in between, which splits the loaded nodes
+  for (int64_t i = 0; i < key_num; i++) EXPECT_TRUE(tree->Insert(2 * i + 1, 0));
+
+  count = 0;
+  int64_t last_key = -1;
+  for (auto it = tree->Begin(); !it.IsEnd(); it++) {
+    EXPECT_LE(last_key, it->first);
+    last_key = it->first;
+    count++;
+  }
+  EXPECT_EQ(count, key_num * (dup_num + 1));
+
+  delete tree;
+}
+
 /**
  * Adapted from https://github.com/wangziqi2013/BwTree/blob/master/test/random_pattern_test.cpp
  */
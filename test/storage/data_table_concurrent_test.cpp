@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 #include "storage/data_table.h"
@@ -77,6 +80,14 @@ struct DataTableConcurrentTests : public TerrierTest {
   storage::RecordBufferSegmentPool buffer_pool_{10000, 10000};
   std::default_random_engine generator_;
   std::uniform_real_distribution<double> null_ratio_{0.0, 1.0};
+
+  // Unlinks the version chain of the tuple, as the GC does once its versions are visible to everyone
+  static void DropVersionChain(const storage::BlockLayout &layout, const storage::TupleSlot slot) {
+    const storage::TupleAccessStrategy accessor(layout);
+    reinterpret_cast<std::atomic<storage::UndoRecord *> *>(
+        accessor.AccessWithoutNullCheck(slot, VERSION_POINTER_COLUMN_ID))
+        ->store(nullptr);
+  }
 };
 
 // Spawns multiple transactions. The timestamps of the transactions don't matter,
@@ -155,4 +166,163 @@ TEST_F(DataTableConcurrentTests, ConcurrentUpdateOneWriterWins) {
   }
 }
 
+// Scans tuples without version chains over and over while another thread updates them. Scans copy runs of such tuples
+// without looking at them one by one, so they have to notice an update that raced with the copy and reconstruct the
+// tuples of that run instead. Every scan should see the tuples as they were before any update.
+// NOLINTNEXTLINE
+TEST_F(DataTableConcurrentTests, ScanRacingUpdates) {
+  const uint32_t num_iterations = 5;
+  const uint32_t num_inserts = 1000;
+  const uint16_t max_columns = 20;
+  for (uint32_t iteration = 0; iteration < num_iterations; iteration++) {
+    storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(max_columns, &generator_);
+    storage::DataTable tested(&block_store_, layout, storage::layout_version_t(0));
+    FakeTransaction inserter(layout, &tested, null_ratio_(generator_), transaction::timestamp_t(0),
+                             transaction::timestamp_t(0), &buffer_pool_);
+    for (uint32_t i = 0; i < num_inserts; i++) DropVersionChain(layout, inserter.InsertRandomTuple(&generator_));
+
+    // The updates commit after the scans start, so none of them is visible to the scans
+    FakeTransaction updater(layout, &tested, null_ratio_(generator_), transaction::timestamp_t(2),
+                            transaction::timestamp_t(2), &buffer_pool_);
+    FakeTransaction scanner(layout, &tested, null_ratio_(generator_), transaction::timestamp_t(1),
+                            transaction::timestamp_t(1), &buffer_pool_);
+    std::vector<storage::TupleSlot> update_order(inserter.InsertedTuples());
+    std::shuffle(update_order.begin(), update_order.end(), generator_);
+    std::atomic<bool> updating = true;
+    std::thread update_thread([&] {
+      std::default_random_engine thread_generator(iteration);
+      for (const auto &slot : update_order) {
+        EXPECT_TRUE(updater.RandomlyUpdateTuple(slot, &thread_generator));
+        std::this_thread::yield();
+      }
+      updating = false;
+    });
+
+    storage::ProjectedColumnsInitializer initializer(layout, StorageTestUtil::ProjectionListAllColumns(layout),
+                                                     num_inserts);
+    auto *buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedColumnsSize());
+    do {
+      storage::ProjectedColumns *columns = initializer.Initialize(buffer);
+      auto it = tested.begin();
+      tested.Scan(scanner.GetTxn(), &it, columns);
+      EXPECT_EQ(num_inserts, columns->NumTuples());
+      for (uint32_t i = 0; i < columns->NumTuples(); i++) {
+        storage::ProjectedColumns::RowView stored = columns->InterpretAsRow(i);
+        EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(
+            layout, &stored, inserter.GetReferenceTuple(columns->TupleSlots()[i])));
+      }
+    } while (updating.load());
+    update_thread.join();
+    delete[] buffer;
+  }
+}
+
+// Alternates inserts of two threads that are alive at the same time. Each thread should keep inserting into a block of
+// its own instead of both going after the first block with free slots.
+// NOLINTNEXTLINE
+TEST_F(DataTableConcurrentTests, InsertionLaneOwnership) {
+  const uint32_t num_inserts = 100;
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(10, &generator_);
+  storage::DataTable tested(&block_store_, layout, storage::layout_version_t(0));
+  std::vector<std::unique_ptr<FakeTransaction>> fake_txns;
+  for (uint32_t thread = 0; thread < 2; thread++)
+    fake_txns.emplace_back(std::make_unique<FakeTransaction>(layout, &tested, null_ratio_(generator_),
+                                                             transaction::timestamp_t(0), transaction::timestamp_t(0),
+                                                             &buffer_pool_));
+  std::atomic<uint32_t> turn = 0;
+  auto workload = [&](uint32_t id) {
+    std::default_random_engine thread_generator(id);
+    for (uint32_t i = 0; i < num_inserts; i++) {
+      while (turn.load() % 2 != id) std::this_thread::yield();
+      fake_txns[id]->InsertRandomTuple(&thread_generator);
+      turn++;
+    }
+  };
+  std::thread first(workload, 0), second(workload, 1);
+  first.join();
+  second.join();
+
+  for (auto &fake_txn : fake_txns)
+    for (auto slot : fake_txn->InsertedTuples()) EXPECT_EQ(slot.GetBlock(), fake_txn->InsertedTuples()[0].GetBlock());
+  EXPECT_NE(fake_txns[0]->InsertedTuples()[0].GetBlock(), fake_txns[1]->InsertedTuples()[0].GetBlock());
+}
+
+// Fills the block of a thread's insertion lane, and checks that the thread then carries on in another block.
+// NOLINTNEXTLINE
+TEST_F(DataTableConcurrentTests, InsertionLaneFullBlockHandoff) {
+  storage::BlockLayout layout(std::vector<uint8_t>(30, 8));
+  storage::DataTable tested(&block_store_, layout, storage::layout_version_t(0));
+  FakeTransaction fake_txn(layout, &tested, 0.0, transaction::timestamp_t(0), transaction::timestamp_t(0),
+                           &buffer_pool_);
+  std::thread inserter([&] {
+    std::default_random_engine thread_generator;
+    for (uint32_t i = 0; i < layout.NumSlots() + 1; i++) fake_txn.InsertRandomTuple(&thread_generator);
+  });
+  inserter.join();
+
+  const std::vector<storage::TupleSlot> &slots = fake_txn.InsertedTuples();
+  for (uint32_t i = 0; i < layout.NumSlots(); i++) EXPECT_EQ(slots[i].GetBlock(), slots[0].GetBlock());
+  EXPECT_NE(slots.back().GetBlock(), slots[0].GetBlock());
+}
+
+// Keeps more inserting threads alive at once than there are insertion lanes, so that some threads have to insert
+// without a lane of their own. Every insert should still succeed.
+// NOLINTNEXTLINE
+TEST_F(DataTableConcurrentTests, MoreInsertingThreadsThanLanes) {
+  const uint32_t num_threads = 2 * storage::DataTable::NUM_INSERTION_LANES;
+  const uint32_t num_inserts = 10;
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(10, &generator_);
+  storage::DataTable tested(&block_store_, layout, storage::layout_version_t(0));
+  std::vector<std::unique_ptr<FakeTransaction>> fake_txns;
+  for (uint32_t thread = 0; thread < num_threads; thread++)
+    fake_txns.emplace_back(std::make_unique<FakeTransaction>(layout, &tested, null_ratio_(generator_),
+                                                             transaction::timestamp_t(0), transaction::timestamp_t(0),
+                                                             &buffer_pool_));
+  // No thread exits before all of them are done inserting, so none of them hands its lane to another
+  std::atomic<uint32_t> num_done = 0;
+  std::vector<std::thread> threads;
+  for (uint32_t thread = 0; thread < num_threads; thread++) {
+    threads.emplace_back([&, thread] {
+      std::default_random_engine thread_generator(thread);
+      for (uint32_t i = 0; i < num_inserts; i++) fake_txns[thread]->InsertRandomTuple(&thread_generator);
+      num_done++;
+      while (num_done.load() < num_threads) std::this_thread::yield();
+    });
+  }
+  for (auto &thread : threads) thread.join();
+
+  storage::ProjectedRowInitializer select_initializer =
+      storage::ProjectedRowInitializer::Create(layout, StorageTestUtil::ProjectionListAllColumns(layout));
+  auto *select_buffer = common::AllocationUtil::AllocateAligned(select_initializer.ProjectedRowSize());
+  for (auto &fake_txn : fake_txns) {
+    EXPECT_EQ(fake_txn->InsertedTuples().size(), num_inserts);
+    for (auto slot : fake_txn->InsertedTuples()) {
+      storage::ProjectedRow *select_row = select_initializer.InitializeRow(select_buffer);
+      tested.Select(fake_txn->GetTxn(), slot, select_row);
+      EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(layout, fake_txn->GetReferenceTuple(slot), select_row));
+    }
+  }
+  delete[] select_buffer;
+}
+
+// Inserts from more short-lived threads, one after the other, than there are insertion lanes. Each thread frees its
+// lane when it exits, so the claim it left on its block lapses and the next thread inserts into the same block.
+// NOLINTNEXTLINE
+TEST_F(DataTableConcurrentTests, InsertionLaneReleasedOnThreadExit) {
+  const uint32_t num_threads = 2 * storage::DataTable::NUM_INSERTION_LANES;
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(10, &generator_);
+  storage::DataTable tested(&block_store_, layout, storage::layout_version_t(0));
+  FakeTransaction fake_txn(layout, &tested, null_ratio_(generator_), transaction::timestamp_t(0),
+                           transaction::timestamp_t(0), &buffer_pool_);
+  for (uint32_t thread = 0; thread < num_threads; thread++) {
+    std::thread inserter([&] {
+      std::default_random_engine thread_generator(thread);
+      fake_txn.InsertRandomTuple(&thread_generator);
+    });
+    inserter.join();
+  }
+
+  for (auto slot : fake_txn.InsertedTuples()) EXPECT_EQ(slot.GetBlock(), fake_txn.InsertedTuples()[0].GetBlock());
+}
+
 }  // namespace terrier
@@ -1,4 +1,5 @@
 #include "storage/data_table.h"
+#include <atomic>
 #include <cstring>
 #include <unordered_map>
 #include <utility>
@@ -138,6 +139,14 @@ class RandomDataTableTestObject {
     table_.Scan(txn, begin, buffer);
   }
 
+  // Unlinks the version chain of the tuple, as the GC does once its versions are visible to everyone
+  void DropVersionChain(const storage::TupleSlot slot) {
+    const storage::TupleAccessStrategy accessor(layout_);
+    reinterpret_cast<std::atomic<storage::UndoRecord *> *>(
+        accessor.AccessWithoutNullCheck(slot, VERSION_POINTER_COLUMN_ID))
+        ->store(nullptr);
+  }
+
   storage::DataTable &GetTable() { return table_; }
 
  private:
@@ -228,6 +237,45 @@ TEST_F(DataTableTests, SimpleSequentialScan) {
   }
 }
 
+// Inserts tuples over several words of the block's bitmaps and drops their version chains, then updates a random
+// scattering of them. Scans have to copy the runs of tuples without a version chain as they are, and reconstruct the
+// updated tuples in between, so that each scan sees its own snapshot of every tuple.
+// NOLINTNEXTLINE
+TEST_F(DataTableTests, ScanInterleavedVersions) {
+  const uint32_t num_iterations = 10;
+  const uint32_t num_inserts = 1000;
+  const uint16_t max_columns = 20;
+  for (uint32_t iteration = 0; iteration < num_iterations; ++iteration) {
+    RandomDataTableTestObject tested(&block_store_, max_columns, null_ratio_(generator_), &generator_);
+    for (uint32_t i = 0; i < num_inserts; ++i) {
+      const storage::TupleSlot slot = tested.InsertRandomTuple(transaction::timestamp_t(0), &generator_, &buffer_pool_);
+      tested.DropVersionChain(slot);
+    }
+    std::bernoulli_distribution updated(0.2);
+    for (const auto &slot : tested.InsertedTuples()) {
+      if (updated(generator_))
+        tested.RandomlyUpdateTuple(transaction::timestamp_t(2), slot, &generator_, &buffer_pool_);
+    }
+
+    std::vector<storage::col_id_t> all_cols = StorageTestUtil::ProjectionListAllColumns(tested.Layout());
+    storage::ProjectedColumnsInitializer initializer(tested.Layout(), all_cols, num_inserts);
+    auto *buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedColumnsSize());
+    // Before the updates, and after them
+    for (const transaction::timestamp_t timestamp : {transaction::timestamp_t(1), transaction::timestamp_t(3)}) {
+      storage::ProjectedColumns *columns = initializer.Initialize(buffer);
+      auto it = tested.GetTable().begin();
+      tested.Scan(&it, timestamp, columns, &buffer_pool_);
+      EXPECT_EQ(num_inserts, columns->NumTuples());
+      for (uint32_t i = 0; i < columns->NumTuples(); i++) {
+        storage::ProjectedColumns::RowView stored = columns->InterpretAsRow(i);
+        const storage::ProjectedRow *ref = tested.GetReferenceVersionedTuple(columns->TupleSlots()[i], timestamp);
+        EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(tested.Layout(), &stored, ref));
+      }
+    }
+    delete[] buffer;
+  }
+}
+
 // Generates a random table layout and coin flip bias for an attribute being null, inserts 1 random tuple into an empty
 // DataTable. Then, randomly updates the tuple num_updates times. Finally, Selects at each timestamp to verify that the
 // delta chain produces the correct tuple. Repeats for num_iterations.
@@ -67,6 +67,17 @@ class GarbageCollectorDataTableTestObject {
     return select_row;
   }
 
+  // Number of records in the version chain of the tuple, read straight from its version pointer
+  uint32_t VersionChainLength(const storage::TupleSlot slot) const {
+    const storage::TupleAccessStrategy accessor(layout_);
+    auto *const version_ptr_location = reinterpret_cast<std::atomic<storage::UndoRecord *> *>(
+        accessor.AccessWithoutNullCheck(slot, VERSION_POINTER_COLUMN_ID));
+    uint32_t length = 0;
+    for (storage::UndoRecord *record = version_ptr_location->load(); record != nullptr; record = record->Next().load())
+      length++;
+    return length;
+  }
+
   storage::BlockLayout layout_;
   storage::DataTable table_;
   // We want null_bias_ to be zero when testing CC. We already evaluate null correctness in other directed tests, and
@@ -674,4 +685,79 @@ TEST_F(GarbageCollectorTests, InsertUpdate1) {
     EXPECT_EQ(std::make_pair(2U, 0U), gc.PerformGarbageCollection());
   }
 }
+
+// Builds a version chain longer than the pruning threshold on a single tuple while a chain of readers holds the oldest
+// running txn back. As the readers finish one by one, the remaining readers and new writers prune the chain on their
+// own. Confirm that the chain only keeps the versions the remaining readers need, that every reader still sees its
+// snapshot, and that the GC still processes every txn, including the ones whose versions were pruned.
+// NOLINTNEXTLINE
+TEST_F(GarbageCollectorTests, VersionChainPruning) {
+  for (uint32_t iteration = 0; iteration < num_iterations_; ++iteration) {
+    transaction::TimestampManager timestamp_manager;
+    transaction::TransactionManager txn_manager(&timestamp_manager, DISABLED, &buffer_pool_, true, DISABLED);
+    GarbageCollectorDataTableTestObject tested(&block_store_, max_columns_, &generator_);
+    storage::GarbageCollector gc(&timestamp_manager, DISABLED, &txn_manager, DISABLED);
+
+    auto *insert_tuple = tested.GenerateRandomTuple(&generator_);
+
+    // insert the tuple to be Updated later
+    auto *txn = txn_manager.BeginTransaction();
+    storage::TupleSlot slot = tested.table_.Insert(txn, *insert_tuple);
+    txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    // Unlink and reclaim the Insert
+    EXPECT_EQ(std::make_pair(0U, 1U), gc.PerformGarbageCollection());
+    EXPECT_EQ(std::make_pair(1U, 0U), gc.PerformGarbageCollection());
+
+    // Reader i sees the version after i updates
+    const uint32_t num_updates = 2 * storage::DataTable::VERSION_CHAIN_PRUNE_THRESHOLD;
+    std::vector<storage::ProjectedRow *> versions{insert_tuple};
+    std::vector<transaction::TransactionContext *> readers{txn_manager.BeginTransaction()};
+    for (uint32_t i = 0; i < num_updates; i++) {
+      storage::ProjectedRow *update = tested.GenerateRandomUpdate(&generator_);
+      txn = txn_manager.BeginTransaction();
+      EXPECT_TRUE(tested.table_.Update(txn, slot, *update));
+      txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+      versions.push_back(tested.GenerateVersionFromUpdate(*update, *versions.back()));
+      readers.push_back(txn_manager.BeginTransaction());
+    }
+    // Reader 0 needs every version, so nothing can be pruned yet
+    EXPECT_EQ(tested.VersionChainLength(slot), num_updates);
+
+    for (uint32_t i = 0; i < readers.size(); i++) {
+      txn_manager.Commit(readers[i], transaction::TransactionUtil::EmptyCallback, nullptr);
+      // Refresh the cached oldest running txn, which is what readers and writers prune against
+      timestamp_manager.OldestTransactionStartTime();
+
+      storage::ProjectedRow *update = tested.GenerateRandomUpdate(&generator_);
+      txn = txn_manager.BeginTransaction();
+      EXPECT_TRUE(tested.table_.Update(txn, slot, *update));
+      txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+      versions.push_back(tested.GenerateVersionFromUpdate(*update, *versions.back()));
+
+      for (uint32_t j = i + 1; j < readers.size(); j++) {
+        storage::ProjectedRow *select_tuple = tested.SelectIntoBuffer(readers[j], slot);
+        EXPECT_TRUE(tested.select_result_);
+        EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(tested.Layout(), select_tuple, versions[j]));
+      }
+      // Reader i + 1 walks past more versions than the threshold, and cuts off the one of update i below them. Once no
+      // reader is left, the writer cuts off everything below its own version.
+      EXPECT_EQ(tested.VersionChainLength(slot), i + 1 < readers.size() ? num_updates : 1);
+    }
+
+    txn = txn_manager.BeginTransaction();
+    storage::ProjectedRow *select_tuple = tested.SelectIntoBuffer(txn, slot);
+    EXPECT_TRUE(tested.select_result_);
+    EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(tested.Layout(), select_tuple, versions.back()));
+    txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    // Unlink the update and read-only txns, then deallocate the update txns
+    const auto num_readers = static_cast<uint32_t>(readers.size()) + 1;
+    const auto num_writers = static_cast<uint32_t>(versions.size()) - 1;
+    EXPECT_EQ(std::make_pair(0U, num_readers + num_writers), gc.PerformGarbageCollection());
+    EXPECT_EQ(tested.VersionChainLength(slot), 0);
+    // The pruned records were only cut off the chain, they are freed with the rest of their txns' undo buffers
+    EXPECT_EQ(std::make_pair(num_writers, 0U), gc.PerformGarbageCollection());
+  }
+}
 }  // namespace terrier
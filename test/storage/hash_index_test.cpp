@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 #include <functional>
 #include <limits>
@@ -1651,4 +1652,85 @@ TEST_F(HashIndexTests, AbortDelete2) {
   txn_manager_->Commit(txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
 }
 
+/**
+ * Gives one key more values than fit inline, then aborts most of them. The remaining values should still be found, and
+ * garbage collection should shrink the array that held them.
+ */
+// NOLINTNEXTLINE
+TEST_F(HashIndexTests, ManyValuesPerKey) {
+  const uint32_t num_committed = 10, num_aborted = 190;
+  std::vector<catalog::IndexSchema::Column> keycols;
+  keycols.emplace_back("", type::TypeId::INTEGER, false,
+                       parser::ColumnValueExpression(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID,
+                                                     catalog::col_oid_t(1)));
+  StorageTestUtil::ForceOid(&(keycols[0]), catalog::indexkeycol_oid_t(1));
+  catalog::IndexSchema schema(keycols, storage::index::IndexType::HASHMAP, false, false, false, true);
+  // Not registered with the GC thread, so that only this test shrinks the index's arrays
+  auto *const index = (IndexBuilder().SetKeySchema(schema)).Build();
+  auto *const insert_key = index->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  *reinterpret_cast<int32_t *>(insert_key->AccessForceNotNull(0)) = 15721;
+  auto insert_values = [&](transaction::TransactionContext *const txn, const uint32_t num_values) {
+    std::vector<storage::TupleSlot> slots;
+    for (uint32_t i = 0; i < num_values; i++) {
+      auto *const insert_redo =
+          txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+      *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = 15721;
+      slots.emplace_back(sql_table_->Insert(txn, insert_redo));
+      EXPECT_TRUE(index->Insert(txn, *insert_key, slots.back()));
+    }
+    return slots;
+  };
+  auto *const hash_index = static_cast<HashIndex<HashKey<8>> *>(index);
+
+  auto *const txn0 = txn_manager_->BeginTransaction();
+  auto committed = insert_values(txn0, num_committed);
+  txn_manager_->Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+  const uint64_t committed_heap_usage = hash_index->GetHeapUsage();
+
+  // txn 1 grows the key's array to 256 values, the abort leaves it with 10
+  auto *const txn1 = txn_manager_->BeginTransaction();
+  insert_values(txn1, num_aborted);
+  txn_manager_->Abort(txn1);
+  index->PerformGarbageCollection();
+
+  // the array grew to 16 values for the committed ones, and got shrunk to exactly their number
+  EXPECT_EQ(hash_index->GetHeapUsage(), committed_heap_usage - (16 - num_committed) * sizeof(storage::TupleSlot));
+
+  auto *const txn2 = txn_manager_->BeginTransaction();
+  std::vector<storage::TupleSlot> results;
+  index->ScanKey(*txn2, *insert_key, &results);
+  EXPECT_EQ(results.size(), num_committed);
+  EXPECT_TRUE(std::is_permutation(results.cbegin(), results.cend(), committed.cbegin(), committed.cend()));
+  txn_manager_->Commit(txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  delete index;
+}
+
+/**
+ * Removes the values of a key that has enough of them to be looked up through its positions table, in random order.
+ * Every value should be found up to its removal, and none after.
+ */
+// NOLINTNEXTLINE
+TEST_F(HashIndexTests, ValuesRemoveInAnyOrder) {
+  const uint32_t num_values = 1000;
+  std::vector<storage::TupleSlot> slots;
+  // Values from a few blocks, which only exist as addresses here
+  for (uint32_t i = 0; i < num_values; i++)
+    slots.emplace_back(reinterpret_cast<storage::RawBlock *>((i % 4 + 1) * common::Constants::BLOCK_SIZE), i / 4);
+  HashIndexValues values(slots[0]);
+  for (uint32_t i = 1; i < num_values; i++) values.Add(slots[i]);
+  EXPECT_EQ(values.Size(), num_values);
+  EXPECT_TRUE(std::is_permutation(values.begin(), values.end(), slots.cbegin(), slots.cend()));
+
+  std::shuffle(slots.begin(), slots.end(), generator_);
+  for (uint32_t i = 0; i < num_values; i++) {
+    EXPECT_TRUE(values.Remove(slots[i]));
+    EXPECT_FALSE(values.Remove(slots[i]));
+    EXPECT_EQ(values.Size(), num_values - i - 1);
+    // Check the rest every now and then, as every check scans them all
+    if (i % 100 == 0)
+      for (uint32_t j = i + 1; j < num_values; j++) EXPECT_TRUE(values.Contains(slots[j]));
+  }
+}
+
 }  // namespace terrier::storage::index
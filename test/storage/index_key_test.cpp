@@ -316,9 +316,8 @@ class IndexKeyTests : public TerrierTest {
   /**
    * Sets the generic key to contain the given string. If c_str is nullptr, the key is zeroed out.
    */
-  template <uint8_t KeySize>
-  void SetGenericKeyFromString(const IndexMetadata &metadata, GenericKey<KeySize> *key, ProjectedRow *pr,
-                               const char *c_str) {
+  template <uint8_t KeySize, typename KeyType = GenericKey<KeySize>>
+  void SetGenericKeyFromString(const IndexMetadata &metadata, KeyType *key, ProjectedRow *pr, const char *c_str) {
     if (c_str != nullptr) {
       auto len = static_cast<uint32_t>(std::strlen(c_str));
 
@@ -343,13 +342,12 @@ class IndexKeyTests : public TerrierTest {
   /**
    * Tests GenericKey's equality and comparison for the two null-terminated c_str's.
    */
-  template <uint8_t KeySize>
+  template <uint8_t KeySize, typename KeyType = GenericKey<KeySize>>
   void TestGenericKeyStrings(const IndexMetadata &metadata, ProjectedRow *pr, char *c_str1, char *c_str2) {
-    const auto generic_eq64 =
-        std::equal_to<GenericKey<KeySize>>();                    // NOLINT transparent functors can't deduce template
-    const auto generic_lt64 = std::less<GenericKey<KeySize>>();  // NOLINT transparent functors can't deduce template
+    const auto generic_eq64 = std::equal_to<KeyType>();  // NOLINT transparent functors can't deduce template
+    const auto generic_lt64 = std::less<KeyType>();      // NOLINT transparent functors can't deduce template
 
-    GenericKey<KeySize> key1, key2;
+    KeyType key1, key2;
     SetGenericKeyFromString<KeySize>(metadata, &key1, pr, c_str1);
     SetGenericKeyFromString<KeySize>(metadata, &key2, pr, c_str2);
 
@@ -1220,6 +1218,59 @@ TEST_F(IndexKeyTests, GenericKeyNonInlineVarlenComparisons) {
   delete[] pr_buffer;
 }
 
+// Test that comparisons fall back to the attributes when the normalized prefixes cannot decide
+// NOLINTNEXTLINE
+TEST_F(IndexKeyTests, GenericKeyNormalizedPrefixFallback) {
+  std::vector<catalog::IndexSchema::Column> key_cols;
+  key_cols.emplace_back("", type::TypeId::VARCHAR, 40, true,
+                        parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type::TypeId::VARCHAR)));
+  StorageTestUtil::ForceOid(&(key_cols.back()), catalog::indexkeycol_oid_t(0));
+
+  const IndexMetadata metadata(
+      catalog::IndexSchema(key_cols, storage::index::IndexType::BWTREE, false, false, false, true));
+  const auto &initializer = metadata.GetProjectedRowInitializer();
+
+  auto *const pr_buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedRowSize());
+  auto *const pr = initializer.InitializeRow(pr_buffer);
+
+  // The encodings of these only differ after NORMALIZED_PREFIX_SIZE bytes
+  char long_a[37] = "abcdefghijklmnopqrstuvwxyz0123456789";
+  char long_b[37] = "abcdefghijklmnopqrstuvwxyz0123456788";
+  char long_short[31] = "abcdefghijklmnopqrstuvwxyz0123";
+  char short_c[6] = "abcde";
+
+  NormalizedGenericKey<128> key1, key2;
+  SetGenericKeyFromString<128>(metadata, &key1, pr, long_a);
+  SetGenericKeyFromString<128>(metadata, &key2, pr, short_c);
+  EXPECT_FALSE(key1.NormalizedPrefixComplete());
+  EXPECT_TRUE(key2.NormalizedPrefixComplete());
+  SetGenericKeyFromString<128>(metadata, &key2, pr, long_b);
+  EXPECT_EQ(NormalizedGenericKey<128>::CompareNormalizedPrefixes(key1, key2), 0);
+
+  // lhs: long_a, rhs: long_a (same prefixes, same strings)
+  TestGenericKeyStrings<128, NormalizedGenericKey<128>>(metadata, pr, long_a, long_a);
+
+  // lhs: long_a, rhs: long_b (same prefixes, different last byte)
+  TestGenericKeyStrings<128, NormalizedGenericKey<128>>(metadata, pr, long_a, long_b);
+
+  // lhs: long_b, rhs: long_a (same prefixes, different last byte)
+  TestGenericKeyStrings<128, NormalizedGenericKey<128>>(metadata, pr, long_b, long_a);
+
+  // lhs: long_a, rhs: long_short (same prefixes, one shorter)
+  TestGenericKeyStrings<128, NormalizedGenericKey<128>>(metadata, pr, long_a, long_short);
+
+  // lhs: long_short, rhs: long_a (same prefixes, one shorter)
+  TestGenericKeyStrings<128, NormalizedGenericKey<128>>(metadata, pr, long_short, long_a);
+
+  // lhs: short_c, rhs: long_a (prefixes decide, one complete)
+  TestGenericKeyStrings<128, NormalizedGenericKey<128>>(metadata, pr, short_c, long_a);
+
+  // lhs: NULL, rhs: long_a (prefixes decide)
+  TestGenericKeyStrings<128, NormalizedGenericKey<128>>(metadata, pr, nullptr, long_a);
+
+  delete[] pr_buffer;
+}
+
 // NOLINTNEXTLINE
 TEST_F(IndexKeyTests, CompactIntsKeyBuilderTest) {
   const uint32_t num_iters = 100;
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <vector>
+#include "parser/expression/column_value_expression.h"
+#include "parser/expression/constant_value_expression.h"
+#include "storage/garbage_collector_thread.h"
+#include "storage/index/index_builder.h"
+#include "storage/projected_row.h"
+#include "storage/sql_table.h"
+#include "transaction/transaction_context.h"
+#include "transaction/transaction_manager.h"
+#include "type/type_id.h"
+#include "util/catalog_test_util.h"
+#include "util/storage_test_util.h"
+#include "util/test_harness.h"
+
+namespace terrier::storage::index {
+
+/**
+ * Tests the behavior that every index type has to share, over a non-unique index on a single INTEGER column
+ */
+class IndexTests : public TerrierTest, public ::testing::WithParamInterface<IndexType> {
+ private:
+  const std::chrono::milliseconds gc_period_{10};
+  storage::GarbageCollector *gc_;
+  storage::GarbageCollectorThread *gc_thread_;
+
+  storage::BlockStore block_store_{1000, 1000};
+  storage::RecordBufferSegmentPool buffer_pool_{1000000, 1000000};
+  catalog::Schema table_schema_;
+
+ public:
+  IndexTests() {
+    auto col = catalog::Schema::Column(
+        "attribute", type::TypeId::INTEGER, false,
+        parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type::TypeId::INTEGER)));
+    StorageTestUtil::ForceOid(&(col), catalog::col_oid_t(1));
+    table_schema_ = catalog::Schema({col});
+    sql_table_ = new storage::SqlTable(&block_store_, table_schema_);
+    tuple_initializer_ = sql_table_->InitializerForProjectedRow({catalog::col_oid_t(1)});
+  }
+
+  // SqlTable
+  storage::SqlTable *sql_table_;
+  storage::ProjectedRowInitializer tuple_initializer_ =
+      storage::ProjectedRowInitializer::Create(std::vector<uint8_t>{1}, std::vector<uint16_t>{1});
+
+  // Index of the type under test
+  Index *default_index_;
+  transaction::TimestampManager *timestamp_manager_;
+  transaction::DeferredActionManager *deferred_action_manager_;
+  transaction::TransactionManager *txn_manager_;
+
+  byte *key_buffer_;
+
+ protected:
+  void SetUp() override {
+    TerrierTest::SetUp();
+
+    timestamp_manager_ = new transaction::TimestampManager;
+    deferred_action_manager_ = new transaction::DeferredActionManager(timestamp_manager_);
+    txn_manager_ = new transaction::TransactionManager(timestamp_manager_, deferred_action_manager_, &buffer_pool_,
+                                                       true, DISABLED);
+    gc_ = new storage::GarbageCollector(timestamp_manager_, deferred_action_manager_, txn_manager_, DISABLED);
+    gc_thread_ = new storage::GarbageCollectorThread(gc_, gc_period_);
+
+    std::vector<catalog::IndexSchema::Column> keycols;
+    keycols.emplace_back("", type::TypeId::INTEGER, false,
+                         parser::ColumnValueExpression(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID,
+                                                       catalog::col_oid_t(1)));
+    StorageTestUtil::ForceOid(&(keycols[0]), catalog::indexkeycol_oid_t(1));
+    catalog::IndexSchema default_schema(keycols, GetParam(), false, false, false, true);
+    default_schema.ExtractIndexedColOids();
+    default_index_ = (IndexBuilder().SetKeySchema(default_schema)).Build();
+    gc_thread_->GetGarbageCollector().RegisterIndexForGC(default_index_);
+
+    key_buffer_ =
+        common::AllocationUtil::AllocateAligned(default_index_->GetProjectedRowInitializer().ProjectedRowSize());
+  }
+  void TearDown() override {
+    gc_thread_->GetGarbageCollector().UnregisterIndexForGC(default_index_);
+
+    delete gc_thread_;
+    delete gc_;
+    delete sql_table_;
+    delete default_index_;
+    delete[] key_buffer_;
+    delete txn_manager_;
+    delete deferred_action_manager_;
+    delete timestamp_manager_;
+    TerrierTest::TearDown();
+  }
+};
+
+/**
+ * Looks up a batch of keys of which some have several values, some none, and some only a value that is not visible to
+ * the scanning txn. The values of every key should be the ones a ScanKey of that key returns.
+ */
+// NOLINTNEXTLINE
+TEST_P(IndexTests, ScanKeyBatch) {
+  const int32_t num_keys = 100;
+  auto *const insert_key = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_);
+
+  // even keys get one value, multiples of four a second one
+  auto *const insert_txn = txn_manager_->BeginTransaction();
+  for (int32_t i = 0; i < num_keys; i += 2) {
+    for (int32_t copy = 0; copy < (i % 4 == 0 ? 2 : 1); copy++) {
+      auto *const insert_redo =
+          insert_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+      *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = i;
+      const auto tuple_slot = sql_table_->Insert(insert_txn, insert_redo);
+      *reinterpret_cast<int32_t *>(insert_key->AccessForceNotNull(0)) = i;
+      EXPECT_TRUE(default_index_->Insert(insert_txn, *insert_key, tuple_slot));
+    }
+  }
+  txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // key 1 gets a value that is never committed
+  auto *const uncommitted_txn = txn_manager_->BeginTransaction();
+  auto *const uncommitted_redo =
+      uncommitted_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+  *reinterpret_cast<int32_t *>(uncommitted_redo->Delta()->AccessForceNotNull(0)) = 1;
+  const auto uncommitted_slot = sql_table_->Insert(uncommitted_txn, uncommitted_redo);
+  *reinterpret_cast<int32_t *>(insert_key->AccessForceNotNull(0)) = 1;
+  EXPECT_TRUE(default_index_->Insert(uncommitted_txn, *insert_key, uncommitted_slot));
+
+  // look up every key in descending order, twice
+  auto *const scan_txn = txn_manager_->BeginTransaction();
+  const auto key_size = default_index_->GetProjectedRowInitializer().ProjectedRowSize();
+  std::vector<byte *> key_buffers;
+  std::vector<const ProjectedRow *> keys;
+  for (int32_t i = 2 * num_keys - 1; i >= 0; i--) {
+    key_buffers.emplace_back(common::AllocationUtil::AllocateAligned(key_size));
+    auto *const key = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffers.back());
+    *reinterpret_cast<int32_t *>(key->AccessForceNotNull(0)) = i % num_keys;
+    keys.emplace_back(key);
+  }
+
+  std::vector<storage::TupleSlot> results;
+  std::vector<uint32_t> offsets;
+  default_index_->ScanKeyBatch(*scan_txn, keys, &results, &offsets);
+  EXPECT_EQ(offsets.size(), keys.size() + 1);
+  EXPECT_EQ(offsets.front(), 0);
+  EXPECT_EQ(offsets.back(), results.size());
+  EXPECT_EQ(results.size(), 2 * (num_keys / 2 + num_keys / 4));
+
+  std::vector<storage::TupleSlot> key_results;
+  for (uint32_t i = 0; i < keys.size(); i++) {
+    default_index_->ScanKey(*scan_txn, *keys[i], &key_results);
+    EXPECT_EQ(key_results.size(), offsets[i + 1] - offsets[i]);
+    EXPECT_TRUE(std::is_permutation(key_results.cbegin(), key_results.cend(), results.cbegin() + offsets[i],
+                                    results.cbegin() + offsets[i + 1]));
+    key_results.clear();
+  }
+
+  txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  txn_manager_->Abort(uncommitted_txn);
+
+  for (auto *const key_buffer : key_buffers) delete[] key_buffer;
+}
+
+INSTANTIATE_TEST_CASE_P(IndexTypes, IndexTests,
+                        ::testing::Values(IndexType::BWTREE, IndexType::HASHMAP, IndexType::ART));
+
+}  // namespace terrier::storage::index
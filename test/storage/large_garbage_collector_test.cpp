@@ -10,7 +10,7 @@
 namespace terrier {
 class LargeGCTests : public TerrierTest {
  public:
-  void RunTest(const LargeDataTableTestConfiguration &config) {
+  void RunTest(const LargeDataTableTestConfiguration &config, const uint32_t num_gc_threads = 1) {
     for (uint32_t iteration = 0; iteration < config.NumIterations(); iteration++) {
       auto injector = di::make_injector<di::TestBindingPolicy>(
           di::storage_injector(), di::bind<storage::AccessObserver>().in(di::disabled),
@@ -24,6 +24,7 @@ class LargeGCTests : public TerrierTest {
           di::bind<uint64_t>().named(storage::RecordBufferSegmentPool::SIZE_LIMIT).to(static_cast<uint64_t>(10000)),
           di::bind<uint64_t>().named(storage::RecordBufferSegmentPool::REUSE_LIMIT).to(static_cast<uint64_t>(10000)),
           di::bind<bool>().named(transaction::TransactionManager::GC_ENABLED).to(true),
+          di::bind<uint32_t>().named(storage::GarbageCollector::NUM_GC_THREADS).to(num_gc_threads),
           di::bind<std::chrono::milliseconds>()
               .named(storage::GarbageCollectorThread::GC_PERIOD)
               .to(std::chrono::milliseconds(10)));
@@ -61,6 +62,23 @@ TEST_F(LargeGCTests, MixedReadWriteWithGC) {
   RunTest(config);
 }
 
+// Same as MixedReadWriteWithGC, but with version chains truncated by several GC workers
+// NOLINTNEXTLINE
+TEST_F(LargeGCTests, MixedReadWriteWithParallelGC) {
+  auto config = LargeDataTableTestConfiguration::Builder()
+                    .SetNumIterations(10)
+                    .SetNumTxns(1000)
+                    .SetBatchSize(100)
+                    .SetNumConcurrentTxns(MultiThreadTestUtil::HardwareConcurrency())
+                    .SetUpdateSelectRatio({0.5, 0.5})
+                    .SetTxnLength(10)
+                    .SetInitialTableSize(1000)
+                    .SetMaxColumns(20)
+                    .SetVarlenAllowed(true)
+                    .Build();
+  RunTest(config, 4);
+}
+
 // Double the thread count to force more thread swapping and try to capture unexpected races
 // NOLINTNEXTLINE
 TEST_F(LargeGCTests, MixedReadWriteHighThreadWithGC) {
@@ -28,7 +28,8 @@
 namespace terrier::storage {
 class WriteAheadLoggingTests : public TerrierTest {
  protected:
-  auto Injector(const LargeDataTableTestConfiguration &config) {
+  auto Injector(const LargeDataTableTestConfiguration &config, const bool group_commit = false,
+                const uint64_t num_serializer_threads = 1) {
     return di::make_injector<di::TestBindingPolicy>(
         di::storage_injector(), di::bind<AccessObserver>().in(di::disabled),
         di::bind<LargeDataTableTestConfiguration>().to(config),
@@ -41,15 +42,18 @@ class WriteAheadLoggingTests : public TerrierTest {
         di::bind<std::chrono::milliseconds>()
             .named(storage::GarbageCollectorThread::GC_PERIOD)
             .to(std::chrono::milliseconds(10)),
+        di::bind<uint32_t>().named(storage::GarbageCollector::NUM_GC_THREADS).to(static_cast<uint32_t>(1)),
         di::bind<std::string>().named(storage::LogManager::LOG_FILE_PATH).to(std::string(LOG_FILE_NAME)),
         di::bind<uint64_t>().named(storage::LogManager::NUM_BUFFERS).to(static_cast<uint64_t>(100)),
         di::bind<std::chrono::microseconds>()
             .named(storage::LogManager::SERIALIZATION_INTERVAL)
             .to(std::chrono::microseconds(10)),
+        di::bind<uint64_t>().named(storage::LogManager::NUM_SERIALIZER_THREADS).to(num_serializer_threads),
         di::bind<std::chrono::milliseconds>()
             .named(storage::LogManager::PERSIST_INTERVAL)
             .to(std::chrono::milliseconds(20)),
-        di::bind<uint64_t>().named(storage::LogManager::PERSIST_THRESHOLD).to(static_cast<uint64_t>((1U << 20U))));
+        di::bind<uint64_t>().named(storage::LogManager::PERSIST_THRESHOLD).to(static_cast<uint64_t>((1U << 20U))),
+        di::bind<bool>().named(storage::LogManager::GROUP_COMMIT).to(group_commit));
   }
 
   void SetUp() override {
@@ -80,11 +84,11 @@ class WriteAheadLoggingTests : public TerrierTest {
       // is_read_only argument is set to false, because we do not write out a commit record for a transaction if it is
       // not read-only.
       return storage::CommitRecord::Initialize(buf, txn_begin, txn_commit, nullptr, nullptr, oldest_active_txn, false,
-                                               nullptr, nullptr);
+                                               nullptr, nullptr, 0);
     }
 
     if (record_type == storage::LogRecordType::ABORT)
-      return storage::AbortRecord::Initialize(buf, txn_begin, nullptr, nullptr);
+      return storage::AbortRecord::Initialize(buf, txn_begin, nullptr, nullptr, 0);
 
     auto database_oid = in->ReadValue<catalog::db_oid_t>();
     auto table_oid = in->ReadValue<catalog::table_oid_t>();
@@ -258,6 +262,115 @@ TEST_F(WriteAheadLoggingTests, LargeLogTest) {
   for (auto *txn : result.second) delete txn;
 }
 
+// This test simulates transactions with group commit turned on, so that filled buffers are written out with vectored
+// writes, and then reads the logged out content to make sure every committed update made it out exactly once
+// NOLINTNEXTLINE
+TEST_F(WriteAheadLoggingTests, GroupCommitLogTest) {
+  auto config = LargeDataTableTestConfiguration::Builder()
+                    .SetNumTxns(100)
+                    .SetNumConcurrentTxns(4)
+                    .SetUpdateSelectRatio({0.5, 0.5})
+                    .SetTxnLength(5)
+                    .SetInitialTableSize(1000)
+                    .SetMaxColumns(5)
+                    .SetVarlenAllowed(true)
+                    .Build();
+  auto injector = Injector(config, true);
+  auto log_manager = injector.create<storage::LogManager *>();
+  log_manager->Start();
+  auto tested = injector.create<std::unique_ptr<LargeDataTableTestObject>>();
+  auto result = tested->SimulateOltp(100, 4);
+  log_manager->PersistAndStop();
+
+  std::unordered_map<transaction::timestamp_t, RandomDataTableTransaction *> txns_map;
+  for (auto *txn : result.first)
+    if (!txn->Updates()->empty()) txns_map[txn->BeginTimestamp()] = txn;
+  storage::BufferedLogReader in(LOG_FILE_NAME);
+  while (in.HasMore()) {
+    storage::LogRecord *log_record = ReadNextRecord(&in);
+    if (log_record->RecordType() == storage::LogRecordType::COMMIT &&
+        log_record->TxnBegin() != transaction::INITIAL_TXN_TIMESTAMP) {
+      auto it = txns_map.find(log_record->TxnBegin());
+      EXPECT_NE(txns_map.end(), it);
+      if (it != txns_map.end()) {
+        EXPECT_EQ(log_record->GetUnderlyingRecordBodyAs<storage::CommitRecord>()->CommitTime(),
+                  it->second->CommitTimestamp());
+        txns_map.erase(it);
+      }
+    }
+    delete[] reinterpret_cast<byte *>(log_record);
+  }
+  // Every committed transaction that made updates must have had its commit record written out
+  EXPECT_TRUE(txns_map.empty());
+
+  auto *gc = injector.create<storage::GarbageCollector *>();
+  gc->PerformGarbageCollection();
+  gc->PerformGarbageCollection();
+
+  for (auto *txn : result.first) delete txn;
+  for (auto *txn : result.second) delete txn;
+}
+
+// This test serializes logs with several threads at once, and then reads the logged out content to make sure every
+// transaction's records are still ordered, i.e. all of a committed transaction's updates come before its commit record
+// NOLINTNEXTLINE
+TEST_F(WriteAheadLoggingTests, ParallelSerializationLogTest) {
+  auto config = LargeDataTableTestConfiguration::Builder()
+                    .SetNumTxns(1000)
+                    .SetNumConcurrentTxns(4)
+                    .SetUpdateSelectRatio({0.8, 0.2})
+                    .SetTxnLength(10)
+                    .SetInitialTableSize(1000)
+                    .SetMaxColumns(5)
+                    .SetVarlenAllowed(true)
+                    .Build();
+  auto injector = Injector(config, false, 4);
+  auto log_manager = injector.create<storage::LogManager *>();
+  log_manager->Start();
+  auto tested = injector.create<std::unique_ptr<LargeDataTableTestObject>>();
+  auto result = tested->SimulateOltp(1000, 4);
+  log_manager->PersistAndStop();
+
+  std::unordered_map<transaction::timestamp_t, RandomDataTableTransaction *> txns_map;
+  for (auto *txn : result.first)
+    if (!txn->Updates()->empty()) txns_map[txn->BeginTimestamp()] = txn;
+  storage::BufferedLogReader in(LOG_FILE_NAME);
+  while (in.HasMore()) {
+    storage::LogRecord *log_record = ReadNextRecord(&in);
+    auto it = txns_map.find(log_record->TxnBegin());
+    if (it == txns_map.end()) {
+      // Initial setup transaction, or an aborted transaction's redos
+      delete[] reinterpret_cast<byte *>(log_record);
+      continue;
+    }
+    if (log_record->RecordType() == storage::LogRecordType::COMMIT) {
+      EXPECT_EQ(log_record->GetUnderlyingRecordBodyAs<storage::CommitRecord>()->CommitTime(),
+                it->second->CommitTimestamp());
+      EXPECT_TRUE(it->second->Updates()->empty());  // All previous updates have been logged out previously
+      txns_map.erase(it);
+    } else if (log_record->RecordType() == storage::LogRecordType::REDO) {
+      auto *redo = log_record->GetUnderlyingRecordBodyAs<storage::RedoRecord>();
+      auto update_it = it->second->Updates()->find(redo->GetTupleSlot());
+      EXPECT_NE(it->second->Updates()->end(), update_it);
+      if (update_it != it->second->Updates()->end()) {
+        EXPECT_TRUE(StorageTestUtil::ProjectionListEqualDeep(tested->Layout(), update_it->second, redo->Delta()));
+        delete[] reinterpret_cast<byte *>(update_it->second);
+        it->second->Updates()->erase(update_it);
+      }
+    }
+    delete[] reinterpret_cast<byte *>(log_record);
+  }
+  // Every committed transaction that made updates must have had its commit record written out
+  EXPECT_TRUE(txns_map.empty());
+
+  auto *gc = injector.create<storage::GarbageCollector *>();
+  gc->PerformGarbageCollection();
+  gc->PerformGarbageCollection();
+
+  for (auto *txn : result.first) delete txn;
+  for (auto *txn : result.second) delete txn;
+}
+
 // This test simulates a series of read-only transactions, and then reads the generated log file back in to ensure that
 // read-only transactions do not generate any log records, as they are not necessary for recovery.
 // NOLINTNEXTLINE
@@ -1,5 +1,5 @@
+#include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 #include "catalog/catalog.h"
 #include "catalog/postgres/pg_namespace.h"
@@ -7,6 +7,8 @@
 #include "main/db_main.h"
 #include "storage/garbage_collector_thread.h"
 #include "storage/index/index_builder.h"
+#include "storage/recovery/checkpoint_manager.h"
+#include "storage/recovery/disk_checkpoint_provider.h"
 #include "storage/recovery/disk_log_provider.h"
 #include "storage/recovery/recovery_manager.h"
 #include "storage/sql_table.h"
@@ -22,6 +24,7 @@
 // executions will read old test's data, and the cause of the errors will be hard to identify. Trust me it will drive
 // you nuts...
 #define LOG_FILE_NAME "./test.log"
+#define CHECKPOINT_FILE_NAME "./test.checkpoint"
 
 namespace terrier::storage {
 class RecoveryTests : public TerrierTest {
@@ -29,8 +32,10 @@ class RecoveryTests : public TerrierTest {
   // Settings for log manager
   const uint64_t num_log_buffers_ = 100;
   const std::chrono::microseconds log_serialization_interval_{10};
+  const uint64_t num_log_serializer_threads_ = 1;
   const std::chrono::milliseconds log_persist_interval_{20};
   const uint64_t log_persist_threshold_ = (1 << 20);  // 1MB
+  const bool log_group_commit_ = false;
 
   std::default_random_engine generator_;
   storage::RecordBufferSegmentPool buffer_pool_{2000, 100};
@@ -61,8 +66,10 @@ class RecoveryTests : public TerrierTest {
     TerrierTest::SetUp();
     // Unlink log file incase one exists from previous test iteration
     unlink(LOG_FILE_NAME);
-    log_manager_ = new LogManager(LOG_FILE_NAME, num_log_buffers_, log_serialization_interval_, log_persist_interval_,
-                                  log_persist_threshold_, &buffer_pool_, common::ManagedPointer(&thread_registry_));
+    unlink(CHECKPOINT_FILE_NAME);
+    log_manager_ = new LogManager(LOG_FILE_NAME, num_log_buffers_, log_serialization_interval_,
+                                  num_log_serializer_threads_, log_persist_interval_, log_persist_threshold_,
+                                  log_group_commit_, &buffer_pool_, common::ManagedPointer(&thread_registry_));
     log_manager_->Start();
     timestamp_manager_ = new transaction::TimestampManager;
     deferred_action_manager_ = new transaction::DeferredActionManager(timestamp_manager_);
@@ -83,8 +90,9 @@ class RecoveryTests : public TerrierTest {
   }
 
   void TearDown() override {
-    // Delete log file
+    // Delete log and checkpoint files
     unlink(LOG_FILE_NAME);
+    unlink(CHECKPOINT_FILE_NAME);
     TerrierTest::TearDown();
 
     // Destroy recovered catalog if the test has not cleaned it up already
@@ -203,18 +211,29 @@ class RecoveryTests : public TerrierTest {
     gc_thread_ = new storage::GarbageCollectorThread(gc_, gc_period_);
   }
 
-  void RunTest(const LargeSqlTableTestConfiguration &config) {
+  void RunTest(const LargeSqlTableTestConfiguration &config, const uint32_t num_replay_threads = 1,
+               const bool checkpoint = false) {
     // Run workload
     auto *tested = new LargeSqlTableTestObject(config, txn_manager_, catalog_, &block_store_, &generator_);
     tested->SimulateOltp(100, 4);
 
+    // Take a checkpoint and keep running the workload, so the rest of it has to be recovered from the log after it
+    if (checkpoint) {
+      CheckpointManager checkpoint_manager(CHECKPOINT_FILE_NAME, common::ManagedPointer(catalog_), txn_manager_,
+                                           timestamp_manager_, log_manager_);
+      checkpoint_manager.TakeCheckpoint();
+      tested->SimulateOltp(100, 4);
+    }
+
     ShutdownAndRestartSystem();
 
     // Instantiate recovery manager, and recover the tables.
-    DiskLogProvider log_provider(LOG_FILE_NAME);
+    std::unique_ptr<DiskCheckpointProvider> checkpoint_provider =
+        checkpoint ? std::make_unique<DiskCheckpointProvider>(CHECKPOINT_FILE_NAME) : nullptr;
+    DiskLogProvider log_provider(LOG_FILE_NAME, checkpoint ? checkpoint_provider->LogFileOffset() : 0);
     RecoveryManager recovery_manager(&log_provider, common::ManagedPointer(recovery_catalog_), recovery_txn_manager_,
                                      recovery_deferred_action_manager_, common::ManagedPointer(&thread_registry_),
-                                     &block_store_);
+                                     &block_store_, num_replay_threads, checkpoint_provider.get());
     recovery_manager.StartRecovery();
     recovery_manager.WaitForRecoveryToFinish();
 
@@ -296,6 +315,53 @@ TEST_F(RecoveryTests, MultiDatabaseTest) {
   RecoveryTests::RunTest(config);
 }
 
+// This test runs the multi database workload, but replays the committed transactions on several threads. Changes to
+// different tables, and to different tuples of the same table, are applied in parallel.
+// NOLINTNEXTLINE
+TEST_F(RecoveryTests, ParallelReplayTest) {
+  LargeSqlTableTestConfiguration config = LargeSqlTableTestConfiguration::Builder()
+                                              .SetNumDatabases(3)
+                                              .SetNumTables(5)
+                                              .SetMaxColumns(5)
+                                              .SetInitialTableSize(100)
+                                              .SetTxnLength(5)
+                                              .SetInsertUpdateSelectDeleteRatio({0.3, 0.6, 0.0, 0.1})
+                                              .SetVarlenAllowed(true)
+                                              .Build();
+  RecoveryTests::RunTest(config, 4);
+}
+
+// This test takes a checkpoint in the middle of the workload. It then recovers the tables from the checkpoint and the
+// log written after it, and verifies that they are the same as the original tables
+// NOLINTNEXTLINE
+TEST_F(RecoveryTests, CheckpointTest) {
+  LargeSqlTableTestConfiguration config = LargeSqlTableTestConfiguration::Builder()
+                                              .SetNumDatabases(2)
+                                              .SetNumTables(3)
+                                              .SetMaxColumns(5)
+                                              .SetInitialTableSize(1000)
+                                              .SetTxnLength(5)
+                                              .SetInsertUpdateSelectDeleteRatio({0.3, 0.6, 0.0, 0.1})
+                                              .SetVarlenAllowed(true)
+                                              .Build();
+  RecoveryTests::RunTest(config, 1, true);
+}
+
+// This test recovers from a checkpoint and the log after it like CheckpointTest, but replays both on several threads
+// NOLINTNEXTLINE
+TEST_F(RecoveryTests, ParallelCheckpointTest) {
+  LargeSqlTableTestConfiguration config = LargeSqlTableTestConfiguration::Builder()
+                                              .SetNumDatabases(2)
+                                              .SetNumTables(3)
+                                              .SetMaxColumns(5)
+                                              .SetInitialTableSize(1000)
+                                              .SetTxnLength(5)
+                                              .SetInsertUpdateSelectDeleteRatio({0.3, 0.6, 0.0, 0.1})
+                                              .SetVarlenAllowed(true)
+                                              .Build();
+  RecoveryTests::RunTest(config, 4, true);
+}
+
 // Tests that we correctly process records corresponding to a drop database command.
 // NOLINTNEXTLINE
 TEST_F(RecoveryTests, DropDatabaseTest) {
@@ -688,8 +754,8 @@ TEST_F(RecoveryTests, DoubleRecoveryTest) {
 
   // We create a new log manager to log the changes replayed during recovery
   LogManager secondary_log_manager(secondary_log_file, num_log_buffers_, log_serialization_interval_,
-                                   log_persist_interval_, log_persist_threshold_, &buffer_pool_,
-                                   common::ManagedPointer(&thread_registry_));
+                                   num_log_serializer_threads_, log_persist_interval_, log_persist_threshold_,
+                                   log_group_commit_, &buffer_pool_, common::ManagedPointer(&thread_registry_));
   secondary_log_manager.Start();
 
   // Override the recovery txn manager to now log out
@@ -782,9 +848,9 @@ TEST_F(RecoveryTests, DoubleRecoveryTest) {
   secondary_recovery_manager.WaitForRecoveryToFinish();
 
   // Maps from tuple slots in original tables to tuple slots in tables after second recovery
-  std::unordered_map<TupleSlot, TupleSlot> new_tuple_slot_map;
+  common::ConcurrentMap<TupleSlot, TupleSlot, std::hash<TupleSlot>> new_tuple_slot_map;
   for (const auto &slot_pair : recovery_manager.tuple_slot_map_) {
-    new_tuple_slot_map[slot_pair.first] = secondary_recovery_manager.tuple_slot_map_[slot_pair.second];
+    new_tuple_slot_map.Insert(slot_pair.first, secondary_recovery_manager.GetTupleSlotMapping(slot_pair.second));
   }
 
   // Check we recovered all the original tables
@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <vector>
+#include "common/worker_pool.h"
+#include "storage/garbage_collector.h"
+#include "transaction/deferred_action_manager.h"
+#include "transaction/timestamp_manager.h"
+#include "transaction/transaction_context.h"
+#include "transaction/transaction_manager.h"
+#include "transaction/transaction_util.h"
+#include "util/multithread_test_util.h"
+#include "util/test_harness.h"
+
+namespace terrier {
+
+class TimestampManagerTests : public TerrierTest {
+ protected:
+  storage::RecordBufferSegmentPool buffer_pool_ = {10000, 10000};
+  transaction::TimestampManager timestamp_manager_;
+  transaction::DeferredActionManager deferred_action_manager_{&timestamp_manager_};
+  transaction::TransactionManager txn_mgr_{&timestamp_manager_, &deferred_action_manager_, &buffer_pool_, true,
+                                           DISABLED};
+  storage::GarbageCollector gc_{&timestamp_manager_, &deferred_action_manager_, &txn_mgr_, DISABLED};
+};
+
+// Transactions begun from many threads land in different shards of the running txn set. The oldest running transaction
+// must still be found across all of them, and every completed transaction must be handed to the GC exactly once.
+// NOLINTNEXTLINE
+TEST_F(TimestampManagerTests, OldestAcrossShards) {
+  const uint32_t num_threads = MultiThreadTestUtil::HardwareConcurrency();
+  const uint32_t txns_per_thread = 100;
+  common::WorkerPool thread_pool(num_threads, {});
+
+  // Every thread begins a batch of transactions, and keeps them open
+  std::vector<std::vector<transaction::TransactionContext *>> txns(num_threads);
+  auto begin = [&](uint32_t id) {
+    for (uint32_t i = 0; i < txns_per_thread; i++) txns[id].push_back(txn_mgr_.BeginTransaction());
+  };
+  MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, begin);
+
+  transaction::timestamp_t oldest = timestamp_manager_.CurrentTime();
+  for (const auto &thread_txns : txns)
+    for (auto *txn : thread_txns) oldest = std::min(oldest, txn->StartTime());
+  EXPECT_EQ(oldest, timestamp_manager_.OldestTransactionStartTime());
+  EXPECT_EQ(oldest, timestamp_manager_.CachedOldestTransactionStartTime());
+
+  // Finish the transactions from other threads than the ones that began them, alternating commits and aborts, so that
+  // transactions leave the shard they entered, not the one of the finishing thread
+  auto finish = [&](uint32_t id) {
+    for (uint32_t i = 0; i < txns_per_thread; i++) {
+      auto *txn = txns[(id + 1) % num_threads][i];
+      if (i % 2 == 0)
+        txn_mgr_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+      else
+        txn_mgr_.Abort(txn);
+    }
+  };
+  MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, finish);
+
+  // With nothing running, the oldest running transaction is bounded by the current time
+  const transaction::timestamp_t now = timestamp_manager_.CurrentTime();
+  EXPECT_EQ(now, timestamp_manager_.OldestTransactionStartTime());
+
+  // None of the transactions wrote anything, so they are all freed as soon as the GC sees them
+  const std::pair<uint32_t, uint32_t> first_pass = gc_.PerformGarbageCollection();
+  EXPECT_EQ(0, first_pass.first);
+  EXPECT_EQ(num_threads * txns_per_thread, first_pass.second);
+  const std::pair<uint32_t, uint32_t> second_pass = gc_.PerformGarbageCollection();
+  EXPECT_EQ(0, second_pass.first);
+  EXPECT_EQ(0, second_pass.second);
+}
+
+}  // namespace terrier
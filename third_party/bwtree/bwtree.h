@@ -71,6 +71,10 @@ namespace third_party::bwtree {
 #define LEAF_NODE_SIZE_UPPER_THRESHOLD ((int)128)
 #define LEAF_NODE_SIZE_LOWER_THRESHOLD ((int)32)
 
+// Nodes built by BulkLoad() are filled up to three quarters of the split threshold
+#define BULK_LOAD_LEAF_FILL ((size_t)(LEAF_NODE_SIZE_UPPER_THRESHOLD * 3 / 4))
+#define BULK_LOAD_INNER_FILL ((size_t)(INNER_NODE_SIZE_UPPER_THRESHOLD * 3 / 4))
+
 #define PREALLOCATE_THREAD_NUM ((size_t)1024)
 
 /*
@@ -6471,6 +6475,107 @@ class BwTree : public BwTreeBase {
     return ret;
   }
 
+  /*
+   * BulkLoad() - Build the tree bottom-up from key-value pairs sorted by key
+   *
+   * Leaf nodes and inner nodes are created fully consolidated and about
+   * three quarters full, such that later inserts could be absorbed without
+   * splitting right away. Items are spread evenly over the nodes of a level
+   * to keep the last node from going below the merge threshold, and as in
+   * FindSplitPoint() items with equal keys are never separated on two leaf
+   * nodes.
+   *
+   * The first leaf keeps its NodeID since iterators start from
+   * FIRST_LEAF_NODE_ID, and the topmost inner node replaces the root under
+   * the current root ID.
+   *
+   * NOTE: This function could only be called on an empty tree that is not
+   * accessed by any other thread, e.g. right after construction
+   */
+  void BulkLoad(const std::vector<KeyValuePair> &items) {
+    TERRIER_ASSERT(std::is_sorted(items.begin(), items.end(), key_value_pair_cmp_obj), "Items must be sorted by key.");
+    const auto *root_node_p = static_cast<const InnerNode *>(GetNode(root_id.load()));
+    const auto *first_leaf_p = static_cast<const LeafNode *>(GetNode(first_leaf_id));
+    TERRIER_ASSERT(root_node_p->GetType() == NodeType::InnerType && root_node_p->GetSize() == 1,
+                   "Bulk load requires the initial node layout.");
+    TERRIER_ASSERT(first_leaf_p->GetType() == NodeType::LeafType && first_leaf_p->GetSize() == 0,
+                   "Bulk load requires an empty tree.");
+    if (items.empty()) return;
+
+    // Cut the items into leaf nodes, moving each cut forward past a run of
+    // equal keys
+    std::vector<size_t> cuts{0};
+    while (cuts.back() < items.size()) {
+      const size_t remaining = items.size() - cuts.back();
+      const size_t remaining_nodes = (remaining + BULK_LOAD_LEAF_FILL - 1) / BULK_LOAD_LEAF_FILL;
+      size_t cut = cuts.back() + (remaining + remaining_nodes - 1) / remaining_nodes;
+      while (cut < items.size() && KeyCmpEqual(items[cut - 1].first, items[cut].first)) cut++;
+      cuts.push_back(cut);
+    }
+    const size_t leaf_count = cuts.size() - 1;
+
+    std::vector<NodeID> leaf_ids{first_leaf_id};
+    while (leaf_ids.size() < leaf_count) leaf_ids.push_back(GetNextNodeID());
+
+    first_leaf_p->~LeafNode();
+    first_leaf_p->Destroy();
+
+    // Separators of the level being built, the left most of which has an
+    // empty key as for the initial root node
+    std::vector<KeyNodeIDPair> level;
+    level.reserve(leaf_count);
+    for (size_t i = 0; i < leaf_count; i++) {
+      const KeyValuePair *copy_start_p = items.data() + cuts[i];
+      const KeyValuePair *copy_end_p = items.data() + cuts[i + 1];
+      const auto size = static_cast<int>(copy_end_p - copy_start_p);
+      const KeyNodeIDPair low_key_pair = i == 0 ? std::make_pair(KeyType{}, INVALID_NODE_ID)
+                                                : std::make_pair(copy_start_p->first, ~INVALID_NODE_ID);
+      const KeyNodeIDPair high_key_pair = i + 1 == leaf_count ? std::make_pair(KeyType{}, INVALID_NODE_ID)
+                                                              : std::make_pair(copy_end_p->first, leaf_ids[i + 1]);
+
+      auto *leaf_node_p = reinterpret_cast<LeafNode *>(
+          ElasticNode<KeyValuePair>::Get(size, NodeType::LeafType, 0, size, low_key_pair, high_key_pair));
+      leaf_node_p->PushBack(copy_start_p, copy_end_p);
+      InstallNewNode(leaf_ids[i], leaf_node_p);
+
+      level.emplace_back(i == 0 ? KeyType{} : copy_start_p->first, leaf_ids[i]);
+    }
+
+    // With a single leaf the initial root node already points to it
+    if (level.size() == 1) return;
+
+    root_node_p->~InnerNode();
+    root_node_p->Destroy();
+
+    while (level.size() > 1) {
+      const size_t node_count = (level.size() + BULK_LOAD_INNER_FILL - 1) / BULK_LOAD_INNER_FILL;
+
+      // The single node of the top level becomes the root
+      std::vector<NodeID> node_ids;
+      if (node_count == 1) node_ids.push_back(root_id.load());
+      while (node_ids.size() < node_count) node_ids.push_back(GetNextNodeID());
+
+      std::vector<KeyNodeIDPair> parent_level;
+      parent_level.reserve(node_count);
+      for (size_t i = 0; i < node_count; i++) {
+        const KeyNodeIDPair *copy_start_p = level.data() + i * level.size() / node_count;
+        const KeyNodeIDPair *copy_end_p = level.data() + (i + 1) * level.size() / node_count;
+        const auto size = static_cast<int>(copy_end_p - copy_start_p);
+        const KeyNodeIDPair high_key_pair = i + 1 == node_count ? std::make_pair(KeyType{}, INVALID_NODE_ID)
+                                                                : std::make_pair(copy_end_p->first, node_ids[i + 1]);
+
+        // The low key of an inner node is always its first separator
+        auto *inner_node_p = reinterpret_cast<InnerNode *>(
+            ElasticNode<KeyNodeIDPair>::Get(size, NodeType::InnerType, 0, size, *copy_start_p, high_key_pair));
+        inner_node_p->PushBack(copy_start_p, copy_end_p);
+        InstallNewNode(node_ids[i], inner_node_p);
+
+        parent_level.emplace_back(copy_start_p->first, node_ids[i]);
+      }
+      level = std::move(parent_level);
+    }
+  }
+
   /*
    * Insert() - Insert a key-value pair
    *